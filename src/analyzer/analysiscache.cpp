@@ -0,0 +1,242 @@
+#include "analyzer/analysiscache.h"
+
+#include <QCryptographicHash>
+#include <QtEndian>
+#include <cmath>
+#include <vector>
+
+#include "analyzer/analyzerebur128.h"
+#include "analyzer/analyzergain.h"
+#include "library/library_prefs.h"
+#include "preferences/beatdetectionsettings.h"
+#include "preferences/keydetectionsettings.h"
+#include "preferences/replaygainsettings.h"
+#include "preferences/waveformsettings.h"
+#include "track/keyfactory.h"
+#include "track/track.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+#include "waveform/waveformfactory.h"
+
+namespace {
+
+const mixxx::Logger kLogger("AnalysisCache");
+
+// The number and size of the chunks that are digested. Only ~0.5 sec
+// of audio at 44.1 kHz need to be decoded.
+constexpr int kContentHashChunkCount = 8;
+constexpr SINT kContentHashFramesPerChunk = 2048;
+
+void addNumber(QCryptographicHash* pHash, qint64 value) {
+    const qint64 littleEndian = qToLittleEndian(value);
+    pHash->addData(reinterpret_cast<const char*>(&littleEndian), sizeof(littleEndian));
+}
+
+// Beats without a sub-version have not been detected by an analyzer,
+// e.g. a constant tempo grid that was created from the BPM in the
+// file tags.
+bool isAnalyzed(const mixxx::BeatsPointer& pBeats) {
+    return pBeats && !pBeats->getSubVersion().isEmpty();
+}
+
+bool isAnalyzed(const Keys& keys) {
+    return keys.getGlobalKey() != mixxx::track::io::key::INVALID &&
+            !keys.getSubVersion().isEmpty();
+}
+
+} // anonymous namespace
+
+AnalysisCache::AnalysisCache(
+        UserSettingsPointer pConfig,
+        const QSqlDatabase& database,
+        bool withWaveform)
+        : m_pConfig(pConfig),
+          m_withWaveform(withWaveform),
+          m_analysisDao(pConfig) {
+    m_dao.initialize(database);
+    m_analysisDao.initialize(database);
+}
+
+// static
+bool AnalysisCache::isEnabled(const UserSettingsPointer& pConfig) {
+    return pConfig->getValue(
+            mixxx::library::prefs::kAnalysisCacheEnabledConfigKey,
+            mixxx::library::prefs::kAnalysisCacheEnabledDefault);
+}
+
+bool AnalysisCache::isMissingResults(const TrackPointer& pTrack) {
+    if (!pTrack->isBpmLocked() &&
+            BeatDetectionSettings(m_pConfig).getBpmDetectionEnabled() &&
+            !isAnalyzed(pTrack->getBeats())) {
+        return true;
+    }
+    if (KeyDetectionSettings(m_pConfig).getKeyDetectionEnabled() &&
+            pTrack->getKeys().getGlobalKey() == mixxx::track::io::key::INVALID) {
+        return true;
+    }
+    const ReplayGainSettings replayGainSettings(m_pConfig);
+    if ((AnalyzerGain::isEnabled(replayGainSettings) ||
+                AnalyzerEbur128::isEnabled(replayGainSettings)) &&
+            !pTrack->getReplayGain().hasRatio()) {
+        return true;
+    }
+    if (m_withWaveform &&
+            WaveformSettings(m_pConfig).waveformCachingEnabled() &&
+            pTrack->getId().isValid() &&
+            m_analysisDao
+                    .getAnalysesForTrackByType(
+                            pTrack->getId(), AnalysisDao::TYPE_WAVESUMMARY)
+                    .isEmpty()) {
+        return true;
+    }
+    return false;
+}
+
+// static
+QByteArray AnalysisCache::contentHash(const mixxx::AudioSourcePointer& pAudioSource) {
+    const mixxx::audio::SignalInfo signalInfo = pAudioSource->getSignalInfo();
+    const mixxx::IndexRange frameIndexRange = pAudioSource->frameIndexRange();
+    if (frameIndexRange.empty()) {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    addNumber(&hash, signalInfo.getSampleRate());
+    addNumber(&hash, signalInfo.getChannelCount());
+    addNumber(&hash, frameIndexRange.length());
+
+    const SINT chunkFrames = math_min(kContentHashFramesPerChunk, frameIndexRange.length());
+    mixxx::SampleBuffer sampleBuffer(signalInfo.frames2samples(chunkFrames));
+    std::vector<qint16> quantized(sampleBuffer.size());
+    const SINT maxOffset = frameIndexRange.length() - chunkFrames;
+    for (int i = 0; i < kContentHashChunkCount; ++i) {
+        const SINT offset = maxOffset * i / (kContentHashChunkCount - 1);
+        const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        mixxx::IndexRange::forward(
+                                frameIndexRange.start() + offset, chunkFrames),
+                        mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
+        const SINT sampleCount = readableSampleFrames.readableLength();
+        if (sampleCount != sampleBuffer.size()) {
+            kLogger.debug()
+                    << "Failed to read"
+                    << chunkFrames
+                    << "frames at"
+                    << frameIndexRange.start() + offset;
+            return QByteArray();
+        }
+        const CSAMPLE* pSamples = readableSampleFrames.readableData();
+        for (SINT j = 0; j < sampleCount; ++j) {
+            quantized[j] = qToLittleEndian(static_cast<qint16>(
+                    std::lround(math_clamp(pSamples[j], -1.0f, 1.0f) * 32767)));
+        }
+        hash.addData(reinterpret_cast<const char*>(quantized.data()),
+                static_cast<int>(quantized.size() * sizeof(qint16)));
+    }
+    return hash.result();
+}
+
+bool AnalysisCache::restoreResults(
+        const QByteArray& contentHash,
+        const TrackPointer& pTrack,
+        mixxx::audio::SampleRate sampleRate) {
+    const auto entry = m_dao.findEntry(contentHash);
+    if (!entry) {
+        return false;
+    }
+    kLogger.debug() << "Restoring cached results of" << pTrack->getLocation();
+
+    if (!entry->beats.isEmpty() &&
+            !pTrack->isBpmLocked() &&
+            !isAnalyzed(pTrack->getBeats())) {
+        const auto pBeats = mixxx::Beats::fromByteArray(sampleRate,
+                entry->beatsVersion,
+                entry->beatsSubVersion,
+                entry->beats);
+        if (pBeats) {
+            pTrack->trySetBeats(pBeats);
+        }
+    }
+
+    if (!entry->keys.isEmpty() &&
+            pTrack->getKeys().getGlobalKey() == mixxx::track::io::key::INVALID) {
+        QByteArray keysSerialized = entry->keys;
+        pTrack->setKeys(KeyFactory::loadKeysFromByteArray(
+                entry->keysVersion, entry->keysSubVersion, &keysSerialized));
+    }
+
+    if (entry->replayGain.hasRatio() && !pTrack->getReplayGain().hasRatio()) {
+        pTrack->setReplayGain(entry->replayGain);
+    }
+
+    // The waveforms are stored for the track, AnalyzerWaveform will
+    // load them instead of analyzing the track again
+    const TrackId trackId = pTrack->getId();
+    if (m_withWaveform &&
+            WaveformSettings(m_pConfig).waveformCachingEnabled() &&
+            trackId.isValid() &&
+            WaveformFactory::waveformVersionToVersionClass(entry->waveformVersion) ==
+                    WaveformFactory::VC_USE &&
+            WaveformFactory::waveformSummaryVersionToVersionClass(
+                    entry->waveSummaryVersion) == WaveformFactory::VC_USE &&
+            m_analysisDao.getAnalysesForTrack(trackId).isEmpty()) {
+        AnalysisDao::AnalysisInfo analysis;
+        analysis.trackId = trackId;
+        analysis.type = AnalysisDao::TYPE_WAVEFORM;
+        analysis.version = entry->waveformVersion;
+        analysis.description = entry->waveformDescription;
+        analysis.data = entry->waveform;
+        m_analysisDao.saveAnalysis(&analysis);
+        analysis.analysisId = -1;
+        analysis.type = AnalysisDao::TYPE_WAVESUMMARY;
+        analysis.version = entry->waveSummaryVersion;
+        analysis.description = entry->waveSummaryDescription;
+        analysis.data = entry->waveSummary;
+        m_analysisDao.saveAnalysis(&analysis);
+    }
+    return true;
+}
+
+void AnalysisCache::storeResults(
+        const QByteArray& contentHash,
+        const TrackPointer& pTrack,
+        const mixxx::BeatsPointer& pBeatsBeforeAnalysis) const {
+    AnalysisCacheDao::Entry entry;
+
+    const auto pBeats = pTrack->getBeats();
+    if (isAnalyzed(pBeats) &&
+            pBeats != pBeatsBeforeAnalysis &&
+            !pTrack->isBpmLocked()) {
+        entry.beatsVersion = pBeats->getVersion();
+        entry.beatsSubVersion = pBeats->getSubVersion();
+        entry.beats = pBeats->toByteArray();
+    }
+
+    const Keys keys = pTrack->getKeys();
+    if (isAnalyzed(keys)) {
+        entry.keysVersion = keys.getVersion();
+        entry.keysSubVersion = keys.getSubVersion();
+        entry.keys = keys.toByteArray();
+    }
+
+    entry.replayGain = pTrack->getReplayGain();
+
+    const ConstWaveformPointer pWaveform = pTrack->getWaveform();
+    const ConstWaveformPointer pWaveSummary = pTrack->getWaveformSummary();
+    if (pWaveform && pWaveSummary &&
+            WaveformFactory::waveformVersionToVersionClass(pWaveform->getVersion()) ==
+                    WaveformFactory::VC_USE &&
+            WaveformFactory::waveformSummaryVersionToVersionClass(
+                    pWaveSummary->getVersion()) == WaveformFactory::VC_USE) {
+        entry.waveformVersion = pWaveform->getVersion();
+        entry.waveformDescription = pWaveform->getDescription();
+        // Restored with all levels of the mip-map pyramid
+        entry.waveform = pWaveform->toFlatByteArray();
+        entry.waveSummaryVersion = pWaveSummary->getVersion();
+        entry.waveSummaryDescription = pWaveSummary->getDescription();
+        entry.waveSummary = pWaveSummary->toByteArray();
+    }
+
+    m_dao.storeEntry(contentHash, entry);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QByteArray>
+#include <QSqlDatabase>
+
+#include "library/dao/analysiscachedao.h"
+#include "library/dao/analysisdao.h"
+#include "preferences/usersettings.h"
+#include "sources/audiosource.h"
+#include "track/beats.h"
+#include "track/track_decl.h"
+
+/// Reuses analysis results by the content of the decoded audio. Tracks
+/// that have been retagged, moved, losslessly converted or imported into
+/// another library are recognized and their beats, keys, ReplayGain and
+/// waveforms are restored without analyzing them again.
+///
+/// Only used from an AnalyzerThread with its own database connection.
+class AnalysisCache final {
+  public:
+    AnalysisCache(
+            UserSettingsPointer pConfig,
+            const QSqlDatabase& database,
+            bool withWaveform);
+
+    static bool isEnabled(const UserSettingsPointer& pConfig);
+
+    /// Returns true if any of the results that could be restored from
+    /// the cache are missing for the track.
+    bool isMissingResults(const TrackPointer& pTrack);
+
+    /// Digests a few chunks that are evenly distributed over the decoded
+    /// audio. The samples are quantized to 16 bit to tolerate rounding
+    /// differences between decoders. Returns an empty hash on failure.
+    static QByteArray contentHash(const mixxx::AudioSourcePointer& pAudioSource);
+
+    /// Applies the cached results that are missing in the track. Returns
+    /// false if the cache doesn't contain any results for the content.
+    bool restoreResults(
+            const QByteArray& contentHash,
+            const TrackPointer& pTrack,
+            mixxx::audio::SampleRate sampleRate);
+
+    /// Stores the current analysis results of the track.
+    ///
+    /// Beats are only stored if they have been replaced by the analysis,
+    /// i.e. if they differ from pBeatsBeforeAnalysis. Existing beats might
+    /// have been edited by the user, e.g. by translating them, and must
+    /// not override the results for other tracks with the same content.
+    /// Locked beats are never stored.
+    void storeResults(
+            const QByteArray& contentHash,
+            const TrackPointer& pTrack,
+            const mixxx::BeatsPointer& pBeatsBeforeAnalysis) const;
+
+  private:
+    const UserSettingsPointer m_pConfig;
+    const bool m_withWaveform;
+    AnalysisCacheDao m_dao;
+    AnalysisDao m_analysisDao;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "analyzer/analyzerinput.h"
 #include "analyzer/analyzertrack.h"
 #include "audio/signalinfo.h"
 #include "audio/types.h"
@@ -29,6 +30,14 @@ class Analyzer {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) = 0;
 
+    // The representation of the audio samples that processSamples()
+    // expects. Only invoked after initialize() returned true. The
+    // AnalyzerThread prepares each format once per chunk for all
+    // analyzers that need it.
+    virtual AnalyzerInputFormat inputFormat() const {
+        return AnalyzerInputFormat::Interleaved;
+    }
+
     // Analyze the next chunk of audio samples and return true if successful.
     // If processing fails the analysis can be aborted early by returning
     // false. After aborting the analysis only cleanup() will be invoked,
@@ -52,7 +61,8 @@ class AnalyzerWithState final {
   public:
     explicit AnalyzerWithState(AnalyzerPtr analyzer)
             : m_analyzer(std::move(analyzer)),
-              m_active(false) {
+              m_active(false),
+              m_inputFormat(AnalyzerInputFormat::Interleaved) {
         DEBUG_ASSERT(m_analyzer);
     }
     AnalyzerWithState(const AnalyzerWithState&) = delete;
@@ -72,7 +82,16 @@ class AnalyzerWithState final {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) {
         DEBUG_ASSERT(!m_active);
-        return m_active = m_analyzer->initialize(track, sampleRate, channelCount, frameLength);
+        m_active = m_analyzer->initialize(track, sampleRate, channelCount, frameLength);
+        if (m_active) {
+            m_inputFormat = m_analyzer->inputFormat();
+        }
+        return m_active;
+    }
+
+    AnalyzerInputFormat inputFormat() const {
+        DEBUG_ASSERT(m_active);
+        return m_inputFormat;
     }
 
     void processSamples(const CSAMPLE* pIn, const int count) {
@@ -86,6 +105,17 @@ class AnalyzerWithState final {
         }
     }
 
+    void processInput(const AnalyzerInputChunk& chunk) {
+        if (!m_active) {
+            return;
+        }
+        const SINT count = chunk.sampleCount(m_inputFormat);
+        // A chunk might be too short for a single decimated sample
+        if (count > 0) {
+            processSamples(chunk.data(m_inputFormat), count);
+        }
+    }
+
     void finish(const AnalyzerTrack& track) {
         if (m_active) {
             m_analyzer->storeResults(track.getTrack());
@@ -104,4 +134,5 @@ class AnalyzerWithState final {
   private:
     AnalyzerPtr m_analyzer;
     bool m_active;
+    AnalyzerInputFormat m_inputFormat;
 };
@@ -13,6 +13,10 @@
 #include "track/beatfactory.h"
 #include "track/track.h"
 
+namespace {
+constexpr int excludeAllButFirstStemMask = ~0x1;
+} // namespace
+
 // static
 QList<mixxx::AnalyzerPluginInfo> AnalyzerBeats::availablePlugins() {
     QList<mixxx::AnalyzerPluginInfo> plugins;
@@ -116,6 +120,23 @@ bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
         if (m_pPlugin) {
             if (m_pPlugin->initialize(m_sampleRate)) {
                 qDebug() << "Beat calculation started with plugin" << m_pluginId;
+                if (m_channelCount == mixxx::audio::ChannelCount::stem() &&
+                        m_bpmSettings.getStemStrategy() ==
+                                BeatDetectionSettings::StemStrategy::Enforced) {
+                    // We have an 8 channel soundsource. The only implemented
+                    // soundsource with 8ch is the NI STEM file format.
+                    // TODO: If we add other soundsources with 8ch, we need to
+                    // rework this condition.
+                    //
+                    // For NI STEM we only use the first stem, which contains
+                    // drums or beats by convention.
+                    m_pStemInput = std::make_unique<AnalyzerInput>();
+                    m_pStemInput->initialize(m_channelCount,
+                            m_pPlugin->inputFormat(),
+                            excludeAllButFirstStemMask);
+                } else {
+                    m_pStemInput.reset();
+                }
             } else {
                 qDebug() << "Beat calculation will not start.";
                 m_pPlugin.reset();
@@ -196,55 +217,41 @@ bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
     return true;
 }
 
-bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
+AnalyzerInputFormat AnalyzerBeats::inputFormat() const {
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
-        return false;
+        return AnalyzerInputFormat::Interleaved;
     }
+    if (m_pStemInput) {
+        return AnalyzerInputFormat::Interleaved;
+    }
+    return m_pPlugin->inputFormat();
+}
 
-    SINT numFrames = count / m_channelCount;
-    const CSAMPLE* pBeatInput = pIn;
-    CSAMPLE* pDrumChannel = nullptr;
-
-    if (m_channelCount == mixxx::audio::ChannelCount::stem()) {
-        // We have an 8 channel soundsource. The only implemented soundsource with
-        // 8ch is the NI STEM file format.
-        // TODO: If we add other soundsources with 8ch, we need to rework this condition.
-        //
-        // For NI STEM we mix all the stems together except the first one,
-        // which contains drums or beats by convention.
-        count = numFrames * mixxx::audio::ChannelCount::stereo();
-        pDrumChannel = SampleUtil::alloc(count);
-
-        VERIFY_OR_DEBUG_ASSERT(pDrumChannel) {
-            return false;
-        }
-
-        if (m_bpmSettings.getStemStrategy() == BeatDetectionSettings::StemStrategy::Enforced) {
-            SampleUtil::copyOneStereoFromMulti(pDrumChannel, pIn, numFrames, m_channelCount, 0);
-        } else {
-            SampleUtil::mixMultichannelToStereo(pDrumChannel, pIn, numFrames, m_channelCount);
-        }
-
-        pBeatInput = pDrumChannel;
-    } else if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
-        DEBUG_ASSERT(!"Unsupported channel count");
+bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
+    VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return false;
     }
 
-    m_currentFrame += numFrames;
+    m_currentFrame += AnalyzerInput::frameCount(inputFormat(), count, m_channelCount);
     if (m_currentFrame > m_maxFramesToProcess) {
         return true; // silently ignore all remaining samples
     }
 
-    bool ret = m_pPlugin->processSamples(pBeatInput, count);
-    if (pDrumChannel) {
-        SampleUtil::free(pDrumChannel);
+    if (m_pStemInput) {
+        m_pStemInput->process(pIn, count, &m_stemInputChunk);
+        const auto pluginFormat = m_pPlugin->inputFormat();
+        count = m_stemInputChunk.sampleCount(pluginFormat);
+        if (count <= 0) {
+            return true;
+        }
+        return m_pPlugin->processSamples(m_stemInputChunk.data(pluginFormat), count);
     }
-    return ret;
+    return m_pPlugin->processSamples(pIn, count);
 }
 
 void AnalyzerBeats::cleanup() {
     m_pPlugin.reset();
+    m_pStemInput.reset();
 }
 
 void AnalyzerBeats::storeResults(TrackPointer pTrack) {
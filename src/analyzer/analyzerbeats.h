@@ -23,6 +23,7 @@ class AnalyzerBeats : public Analyzer {
             mixxx::audio::SampleRate sampleRate,
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
+    AnalyzerInputFormat inputFormat() const override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
@@ -43,6 +44,10 @@ class AnalyzerBeats : public Analyzer {
 
     mixxx::audio::SampleRate m_sampleRate;
     mixxx::audio::ChannelCount m_channelCount;
+    // Only present if the stems need to be mixed differently than
+    // by the AnalyzerThread
+    std::unique_ptr<AnalyzerInput> m_pStemInput;
+    AnalyzerInputChunk m_stemInputChunk;
     SINT m_maxFramesToProcess;
     SINT m_currentFrame;
 };
@@ -0,0 +1,141 @@
+#include <dsp/rateconversion/Decimator.h>
+
+// Class header comes after library includes here since our preprocessor
+// definitions interfere with qm-dsp's headers.
+#include "analyzer/analyzerinput.h"
+
+#include "util/assert.h"
+#include "util/sample.h"
+
+AnalyzerInputChunk::AnalyzerInputChunk()
+        : m_stereo(mixxx::kAnalysisFramesPerChunk * mixxx::audio::ChannelCount::stereo()),
+          m_mono(mixxx::kAnalysisFramesPerChunk),
+          // One more for the mono samples that are left over from the
+          // previous chunk
+          m_monoDecimated(mixxx::kAnalysisFramesPerChunk / mixxx::kAnalysisDecimationFactor + 1) {
+    m_views.fill(View{nullptr, 0});
+}
+
+// static
+int AnalyzerInputChunk::viewIndex(AnalyzerInputFormat format) {
+    switch (format) {
+    case AnalyzerInputFormat::Interleaved:
+        return 0;
+    case AnalyzerInputFormat::Stereo:
+        return 1;
+    case AnalyzerInputFormat::Mono:
+        return 2;
+    case AnalyzerInputFormat::MonoDecimated:
+        return 3;
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return 0;
+}
+
+AnalyzerInput::AnalyzerInput()
+        : m_excludeStemMask(0),
+          m_pendingMonoCount(0) {
+    m_pendingMono.fill(CSAMPLE_ZERO);
+}
+
+AnalyzerInput::~AnalyzerInput() = default;
+
+void AnalyzerInput::initialize(
+        mixxx::audio::ChannelCount channelCount,
+        AnalyzerInputFormats formats,
+        int excludeStemMask) {
+    DEBUG_ASSERT(channelCount.isValid());
+    DEBUG_ASSERT(channelCount % mixxx::audio::ChannelCount::stereo() == 0);
+    m_channelCount = channelCount;
+    m_formats = formats;
+    m_excludeStemMask = excludeStemMask;
+    // The derived formats depend on each other
+    if (m_formats.testFlag(AnalyzerInputFormat::MonoDecimated)) {
+        m_formats |= AnalyzerInputFormat::Mono;
+    }
+    if (m_formats.testFlag(AnalyzerInputFormat::Mono)) {
+        m_formats |= AnalyzerInputFormat::Stereo;
+    }
+
+    if (m_formats.testFlag(AnalyzerInputFormat::MonoDecimated)) {
+        if (m_pDecimator) {
+            m_pDecimator->resetFilter();
+        } else {
+            // Decimates a single block at a time while keeping the
+            // state of the anti-aliasing filter between blocks
+            m_pDecimator = std::make_unique<Decimator>(
+                    mixxx::kAnalysisDecimationFactor,
+                    mixxx::kAnalysisDecimationFactor);
+        }
+    }
+    m_pendingMonoCount = 0;
+}
+
+void AnalyzerInput::process(
+        const CSAMPLE* pIn, SINT sampleCount, AnalyzerInputChunk* pChunk) {
+    DEBUG_ASSERT(m_channelCount.isValid());
+    DEBUG_ASSERT(sampleCount % m_channelCount == 0);
+    const SINT frameCount = sampleCount / m_channelCount;
+
+    pChunk->view(AnalyzerInputFormat::Interleaved) = {pIn, sampleCount};
+    if (!m_formats.testFlag(AnalyzerInputFormat::Stereo)) {
+        return;
+    }
+    VERIFY_OR_DEBUG_ASSERT(frameCount <= mixxx::kAnalysisFramesPerChunk) {
+        return;
+    }
+
+    const CSAMPLE* pStereo = pIn;
+    const SINT stereoCount = frameCount * mixxx::audio::ChannelCount::stereo();
+    if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
+        SampleUtil::mixMultichannelToStereo(pChunk->m_stereo.data(),
+                pIn,
+                frameCount,
+                m_channelCount,
+                m_excludeStemMask);
+        pStereo = pChunk->m_stereo.data();
+    }
+    pChunk->view(AnalyzerInputFormat::Stereo) = {pStereo, stereoCount};
+    if (!m_formats.testFlag(AnalyzerInputFormat::Mono)) {
+        return;
+    }
+
+    CSAMPLE* pMono = pChunk->m_mono.data();
+    SampleUtil::mixMultichannelToMono(pMono, pStereo, stereoCount);
+    pChunk->view(AnalyzerInputFormat::Mono) = {pMono, frameCount};
+    if (!m_formats.testFlag(AnalyzerInputFormat::MonoDecimated)) {
+        return;
+    }
+
+    CSAMPLE* pDecimated = pChunk->m_monoDecimated.data();
+    SINT decimatedCount = 0;
+    for (SINT i = 0; i < frameCount; ++i) {
+        m_pendingMono[m_pendingMonoCount++] = pMono[i];
+        if (m_pendingMonoCount == mixxx::kAnalysisDecimationFactor) {
+            m_pDecimator->process(m_pendingMono.data(), pDecimated + decimatedCount);
+            ++decimatedCount;
+            m_pendingMonoCount = 0;
+        }
+    }
+    DEBUG_ASSERT(decimatedCount <= pChunk->m_monoDecimated.size());
+    pChunk->view(AnalyzerInputFormat::MonoDecimated) = {pDecimated, decimatedCount};
+}
+
+// static
+SINT AnalyzerInput::frameCount(
+        AnalyzerInputFormat format,
+        SINT sampleCount,
+        mixxx::audio::ChannelCount channelCount) {
+    switch (format) {
+    case AnalyzerInputFormat::Interleaved:
+        return sampleCount / channelCount;
+    case AnalyzerInputFormat::Stereo:
+        return sampleCount / mixxx::audio::ChannelCount::stereo();
+    case AnalyzerInputFormat::Mono:
+        return sampleCount;
+    case AnalyzerInputFormat::MonoDecimated:
+        return sampleCount * mixxx::kAnalysisDecimationFactor;
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return 0;
+}
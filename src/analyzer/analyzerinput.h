@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QFlags>
+#include <array>
+#include <memory>
+
+#include "analyzer/constants.h"
+#include "audio/types.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+class Decimator;
+
+/// The representations of the decoded audio that analyzers can request,
+/// see Analyzer::inputFormat().
+enum class AnalyzerInputFormat {
+    /// All channels as decoded
+    Interleaved = 0x01,
+    /// All channels mixed down to stereo
+    Stereo = 0x02,
+    /// The stereo mix downmixed to mono
+    Mono = 0x04,
+    /// The mono mix low-pass filtered and decimated by
+    /// kAnalysisDecimationFactor, i.e. one sample for every
+    /// kAnalysisDecimationFactor frames at the reduced sample rate
+    MonoDecimated = 0x08,
+};
+Q_DECLARE_FLAGS(AnalyzerInputFormats, AnalyzerInputFormat);
+Q_DECLARE_OPERATORS_FOR_FLAGS(AnalyzerInputFormats);
+
+/// A chunk of decoded audio in all formats that have been requested
+/// from the AnalyzerInput that prepared it.
+class AnalyzerInputChunk final {
+  public:
+    AnalyzerInputChunk();
+
+    const CSAMPLE* data(AnalyzerInputFormat format) const {
+        return view(format).pData;
+    }
+    SINT sampleCount(AnalyzerInputFormat format) const {
+        return view(format).sampleCount;
+    }
+
+  private:
+    friend class AnalyzerInput;
+
+    struct View {
+        const CSAMPLE* pData;
+        SINT sampleCount;
+    };
+
+    static int viewIndex(AnalyzerInputFormat format);
+    const View& view(AnalyzerInputFormat format) const {
+        return m_views[viewIndex(format)];
+    }
+    View& view(AnalyzerInputFormat format) {
+        return m_views[viewIndex(format)];
+    }
+
+    std::array<View, 4> m_views;
+    mixxx::SampleBuffer m_stereo;
+    mixxx::SampleBuffer m_mono;
+    mixxx::SampleBuffer m_monoDecimated;
+};
+
+/// Shared preprocessing stage of the analysis. Mixes and decimates
+/// each chunk of decoded audio once for all analyzers instead of
+/// every analyzer doing the same work on its own.
+///
+/// The decimation is stateful, i.e. all chunks of a track must be
+/// processed in order by the same instance.
+class AnalyzerInput final {
+  public:
+    AnalyzerInput();
+    ~AnalyzerInput();
+
+    /// Prepares the processing of a new track. The channels of stems
+    /// that are set in excludeStemMask are omitted from the stereo mix
+    /// and all formats derived from it.
+    void initialize(
+            mixxx::audio::ChannelCount channelCount,
+            AnalyzerInputFormats formats,
+            int excludeStemMask = 0);
+
+    /// Prepares all requested formats of the next chunk of decoded audio.
+    /// The Interleaved format refers to pIn directly.
+    void process(const CSAMPLE* pIn, SINT sampleCount, AnalyzerInputChunk* pChunk);
+
+    /// Returns the number of decoded frames that sampleCount samples in
+    /// the given format correspond to.
+    static SINT frameCount(
+            AnalyzerInputFormat format,
+            SINT sampleCount,
+            mixxx::audio::ChannelCount channelCount);
+
+  private:
+    mixxx::audio::ChannelCount m_channelCount;
+    AnalyzerInputFormats m_formats;
+    int m_excludeStemMask;
+
+    std::unique_ptr<Decimator> m_pDecimator;
+    // Mono samples that have not filled a whole decimation block yet
+    std::array<CSAMPLE, mixxx::kAnalysisDecimationFactor> m_pendingMono;
+    int m_pendingMonoCount;
+};
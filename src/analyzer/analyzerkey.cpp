@@ -111,6 +111,23 @@ bool AnalyzerKey::initialize(const AnalyzerTrack& track,
         if (m_pPlugin) {
             if (m_pPlugin->initialize(mixxx::audio::SampleRate(m_sampleRate))) {
                 qDebug() << "Key calculation started with plugin" << m_pluginId;
+                if (m_channelCount == mixxx::audio::ChannelCount::stem() &&
+                        m_keySettings.getStemStrategy() ==
+                                KeyDetectionSettings::StemStrategy::Enforced) {
+                    // We have an 8 channel soundsource. The only implemented
+                    // soundsource with 8ch is the NI STEM file format.
+                    // TODO: If we add other soundsources with 8ch, we need to
+                    // rework this condition.
+                    //
+                    // For NI STEM we mix all the stems together except the
+                    // first one, which contains drums or beats by convention.
+                    m_pStemInput = std::make_unique<AnalyzerInput>();
+                    m_pStemInput->initialize(m_channelCount,
+                            m_pPlugin->inputFormat(),
+                            excludeFirstChannelMask);
+                } else {
+                    m_pStemInput.reset();
+                }
             } else {
                 qDebug() << "Key calculation will not start.";
                 m_pPlugin.reset();
@@ -156,60 +173,41 @@ bool AnalyzerKey::shouldAnalyze(TrackPointer pTrack) const {
     return true;
 }
 
+AnalyzerInputFormat AnalyzerKey::inputFormat() const {
+    VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
+        return AnalyzerInputFormat::Interleaved;
+    }
+    if (m_pStemInput) {
+        return AnalyzerInputFormat::Interleaved;
+    }
+    return m_pPlugin->inputFormat();
+}
+
 bool AnalyzerKey::processSamples(const CSAMPLE* pIn, SINT count) {
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return false;
     }
 
-    SINT numFrames = count / m_channelCount;
-    m_currentFrame += numFrames;
-
+    m_currentFrame += AnalyzerInput::frameCount(inputFormat(), count, m_channelCount);
     if (m_currentFrame > m_maxFramesToProcess) {
         return true; // silently ignore remaining samples
     }
 
-    const CSAMPLE* pKeyInput = pIn;
-    CSAMPLE* pHarmonicMixedChannel = nullptr;
-
-    if (m_channelCount == mixxx::audio::ChannelCount::stem()) {
-        // We have an 8 channel soundsource. The only implemented soundsource with
-        // 8ch is the NI STEM file format.
-        // TODO: If we add other soundsources with 8ch, we need to rework this condition.
-        //
-        // For NI STEM we mix all the stems together except the first one,
-        // which contains drums or beats by convention.
-        count = numFrames * mixxx::audio::ChannelCount::stereo();
-        pHarmonicMixedChannel = SampleUtil::alloc(count);
-        VERIFY_OR_DEBUG_ASSERT(pHarmonicMixedChannel) {
-            return false;
-        }
-
-        if (m_keySettings.getStemStrategy() == KeyDetectionSettings::StemStrategy::Enforced) {
-            SampleUtil::mixMultichannelToStereo(pHarmonicMixedChannel,
-                    pIn,
-                    numFrames,
-                    m_channelCount,
-                    excludeFirstChannelMask);
-        } else {
-            SampleUtil::mixMultichannelToStereo(
-                    pHarmonicMixedChannel, pIn, numFrames, m_channelCount);
+    if (m_pStemInput) {
+        m_pStemInput->process(pIn, count, &m_stemInputChunk);
+        const auto pluginFormat = m_pPlugin->inputFormat();
+        count = m_stemInputChunk.sampleCount(pluginFormat);
+        if (count <= 0) {
+            return true;
         }
-
-        pKeyInput = pHarmonicMixedChannel;
-    } else if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
-        DEBUG_ASSERT(!"Unsupported channel count");
-        return false;
-    }
-
-    bool ret = m_pPlugin->processSamples(pKeyInput, count);
-    if (pHarmonicMixedChannel) {
-        SampleUtil::free(pHarmonicMixedChannel);
+        return m_pPlugin->processSamples(m_stemInputChunk.data(pluginFormat), count);
     }
-    return ret;
+    return m_pPlugin->processSamples(pIn, count);
 }
 
 void AnalyzerKey::cleanup() {
     m_pPlugin.reset();
+    m_pStemInput.reset();
 }
 
 void AnalyzerKey::storeResults(TrackPointer tio) {
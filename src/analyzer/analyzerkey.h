@@ -22,6 +22,7 @@ class AnalyzerKey : public Analyzer {
             mixxx::audio::SampleRate sampleRate,
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
+    AnalyzerInputFormat inputFormat() const override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
@@ -37,6 +38,10 @@ class AnalyzerKey : public Analyzer {
     QString m_pluginId;
     mixxx::audio::SampleRate m_sampleRate;
     mixxx::audio::ChannelCount m_channelCount;
+    // Only present if the stems need to be mixed differently than
+    // by the AnalyzerThread
+    std::unique_ptr<AnalyzerInput> m_pStemInput;
+    AnalyzerInputChunk m_stemInputChunk;
     SINT m_totalFrames;
     SINT m_maxFramesToProcess;
     SINT m_currentFrame;
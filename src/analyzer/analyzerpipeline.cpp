@@ -0,0 +1,163 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+
+class AnalyzerPipeline::Lane final : public QThread {
+  public:
+    Lane(AnalyzerPipeline* pPipeline, AnalyzerWithState* pAnalyzer)
+            : processedCount(0),
+              m_pPipeline(pPipeline),
+              m_pAnalyzer(pAnalyzer) {
+        setObjectName(QStringLiteral("AnalyzerPipeline"));
+    }
+
+    // Guarded by the mutex of the pipeline
+    quint64 processedCount;
+
+  protected:
+    void run() override {
+        const Chunk* pChunk = nullptr;
+        bool skip = false;
+        while (m_pPipeline->awaitChunk(*this, &pChunk, &skip)) {
+            if (!skip) {
+                m_pAnalyzer->processInput(pChunk->input);
+            }
+            m_pPipeline->chunkProcessed(this);
+        }
+    }
+
+  private:
+    AnalyzerPipeline* const m_pPipeline;
+    AnalyzerWithState* const m_pAnalyzer;
+};
+
+AnalyzerPipeline::AnalyzerPipeline(
+        std::vector<AnalyzerWithState>* pAnalyzers,
+        AnalyzerInput* pInput,
+        int chunkCount,
+        SINT samplesPerChunk)
+        : m_pInput(pInput),
+          m_publishedCount(0),
+          m_skipBelow(0),
+          m_completedCount(0),
+          m_processedFrameCount(0),
+          m_quit(false) {
+    DEBUG_ASSERT(m_pInput);
+    DEBUG_ASSERT(chunkCount > 0);
+    m_chunks.reserve(chunkCount);
+    for (int i = 0; i < chunkCount; ++i) {
+        m_chunks.push_back(Chunk{mixxx::SampleBuffer(samplesPerChunk), AnalyzerInputChunk(), 0});
+    }
+    m_lanes.reserve(pAnalyzers->size());
+    for (auto& analyzer : *pAnalyzers) {
+        m_lanes.push_back(std::make_unique<Lane>(this, &analyzer));
+    }
+    // The lanes inherit the priority of the AnalyzerThread
+    for (const auto& pLane : m_lanes) {
+        pLane->start();
+    }
+}
+
+AnalyzerPipeline::~AnalyzerPipeline() {
+    {
+        const auto locker = lockMutex(&m_mutex);
+        m_quit = true;
+        m_chunkPublished.wakeAll();
+    }
+    for (const auto& pLane : m_lanes) {
+        pLane->wait();
+    }
+}
+
+bool AnalyzerPipeline::hasFreeChunk() const {
+    for (const auto& pLane : m_lanes) {
+        if (m_publishedCount - pLane->processedCount >= m_chunks.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AnalyzerPipeline::isDrained() const {
+    for (const auto& pLane : m_lanes) {
+        if (pLane->processedCount < m_publishedCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+mixxx::SampleBuffer& AnalyzerPipeline::acquireChunk() {
+    auto locker = lockMutex(&m_mutex);
+    while (!hasFreeChunk()) {
+        m_chunkProcessed.wait(&m_mutex);
+    }
+    return m_chunks[m_publishedCount % m_chunks.size()].buffer;
+}
+
+void AnalyzerPipeline::publishChunk(
+        const CSAMPLE* pData, SINT sampleCount, SINT frameCount) {
+    // The count of published chunks is only modified by this thread and
+    // the acquired chunk is not accessed by any lane until published.
+    Chunk& chunk = m_chunks[m_publishedCount % m_chunks.size()];
+    DEBUG_ASSERT(pData >= chunk.buffer.data());
+    DEBUG_ASSERT(pData + sampleCount <= chunk.buffer.data() + chunk.buffer.size());
+    m_pInput->process(pData, sampleCount, &chunk.input);
+    chunk.frameCount = frameCount;
+
+    const auto locker = lockMutex(&m_mutex);
+    DEBUG_ASSERT(hasFreeChunk());
+    ++m_publishedCount;
+    m_chunkPublished.wakeAll();
+}
+
+qint64 AnalyzerPipeline::processedFrameCount() const {
+    const auto locker = lockMutex(&m_mutex);
+    return m_processedFrameCount;
+}
+
+void AnalyzerPipeline::drain() {
+    auto locker = lockMutex(&m_mutex);
+    while (!isDrained()) {
+        m_chunkProcessed.wait(&m_mutex);
+    }
+}
+
+void AnalyzerPipeline::cancel() {
+    auto locker = lockMutex(&m_mutex);
+    m_skipBelow = m_publishedCount;
+    while (!isDrained()) {
+        m_chunkProcessed.wait(&m_mutex);
+    }
+}
+
+bool AnalyzerPipeline::awaitChunk(const Lane& lane, const Chunk** ppChunk, bool* pSkip) {
+    auto locker = lockMutex(&m_mutex);
+    while (!m_quit && lane.processedCount >= m_publishedCount) {
+        m_chunkPublished.wait(&m_mutex);
+    }
+    if (m_quit) {
+        return false;
+    }
+    *ppChunk = &m_chunks[lane.processedCount % m_chunks.size()];
+    *pSkip = lane.processedCount < m_skipBelow;
+    return true;
+}
+
+void AnalyzerPipeline::chunkProcessed(Lane* pLane) {
+    const auto locker = lockMutex(&m_mutex);
+    ++pLane->processedCount;
+    quint64 minProcessedCount = pLane->processedCount;
+    for (const auto& pOtherLane : m_lanes) {
+        minProcessedCount = std::min(minProcessedCount, pOtherLane->processedCount);
+    }
+    // A chunk is not reused before it has been processed by all lanes
+    while (m_completedCount < minProcessedCount) {
+        m_processedFrameCount += m_chunks[m_completedCount % m_chunks.size()].frameCount;
+        ++m_completedCount;
+    }
+    m_chunkProcessed.wakeAll();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <memory>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "analyzer/analyzerinput.h"
+#include "util/samplebuffer.h"
+
+/// Runs the analyzers of an AnalyzerThread concurrently, each one on its
+/// own lane thread. The AnalyzerThread decodes ahead into a bounded ring
+/// of chunks that are shared read-only by all lanes, so the wall-clock
+/// time for a track approaches the maximum of decoding and the slowest
+/// analyzer instead of their sum.
+///
+/// All functions are called from the AnalyzerThread. The analyzers must
+/// only be touched by the AnalyzerThread while the pipeline is drained.
+class AnalyzerPipeline final {
+  public:
+    AnalyzerPipeline(std::vector<AnalyzerWithState>* pAnalyzers,
+            AnalyzerInput* pInput,
+            int chunkCount,
+            SINT samplesPerChunk);
+    ~AnalyzerPipeline();
+
+    /// Blocks until a chunk is no longer used by any analyzer and returns
+    /// it for decoding the next audio data into. The same chunk is returned
+    /// until it has been published.
+    mixxx::SampleBuffer& acquireChunk();
+
+    /// Prepares the audio data of the acquired chunk with the AnalyzerInput
+    /// and hands it to all analyzers. pData must point into the chunk
+    /// returned by acquireChunk() and contains frameCount frames.
+    void publishChunk(const CSAMPLE* pData, SINT sampleCount, SINT frameCount);
+
+    /// The total number of frames in published chunks that have been
+    /// processed (or skipped) by all analyzers.
+    qint64 processedFrameCount() const;
+
+    /// Blocks until all analyzers have processed all published chunks.
+    void drain();
+
+    /// Skips all published chunks that have not been processed yet and
+    /// blocks until the analyzers are idle.
+    void cancel();
+
+  private:
+    class Lane;
+
+    struct Chunk {
+        mixxx::SampleBuffer buffer;
+        AnalyzerInputChunk input;
+        SINT frameCount;
+    };
+
+    // Called from the lane threads
+    bool awaitChunk(const Lane& lane, const Chunk** ppChunk, bool* pSkip);
+    void chunkProcessed(Lane* pLane);
+
+    bool hasFreeChunk() const;
+    bool isDrained() const;
+
+    AnalyzerInput* const m_pInput;
+    std::vector<Chunk> m_chunks;
+    std::vector<std::unique_ptr<Lane>> m_lanes;
+
+    // Protects all members below
+    mutable QMutex m_mutex;
+    QWaitCondition m_chunkPublished;
+    QWaitCondition m_chunkProcessed;
+    // Total number of chunks published since the construction
+    quint64 m_publishedCount;
+    // Chunks with a lower number are skipped by the lanes
+    quint64 m_skipBelow;
+    // Chunks with a lower number have been processed by all lanes
+    quint64 m_completedCount;
+    qint64 m_processedFrameCount;
+    bool m_quit;
+};
@@ -34,6 +34,10 @@ mixxx::Logger kLogger("AnalyzerThread");
 // continuous feedback.
 const mixxx::Duration kBusyProgressInhibitDuration = mixxx::Duration::fromMillis(60);
 
+// Number of chunks that decoding may run ahead of the slowest analyzer
+// in pipelined mode. ~0.7 sec of audio at 44.1 kHz.
+constexpr int kPipelineChunkCount = 8;
+
 void deleteAnalyzerThread(AnalyzerThread* plainPtr) {
     if (plainPtr) {
         plainPtr->deleteAfterFinished();
@@ -76,12 +80,17 @@ AnalyzerThread::AnalyzerThread(
         AnalyzerModeFlags modeFlags)
         : WorkerThread(
             QString("AnalyzerThread %1").arg(id),
+            // Not QThread::IdlePriority, which maps to SCHED_IDLE on Linux.
+            // The workers share the database connections and the locks of
+            // GlobalTrackCache with the GUI thread, which would then wait
+            // for a thread that never gets scheduled on busy cores.
             (modeFlags & AnalyzerModeFlags::LowPriority ? QThread::LowPriority : QThread::InheritPriority)),
           m_id(id),
           m_dbConnectionPool(std::move(dbConnectionPool)),
           m_pConfig(pConfig),
           m_modeFlags(modeFlags),
           m_nextTrack(2), // minimum capacity
+          m_decodedFrameCount(0),
           m_sampleBuffer(mixxx::kAnalysisSamplesPerChunk),
           m_emittedState(AnalyzerThreadState::Void) {
     std::call_once(registerMetaTypesOnceFlag, registerMetaTypesOnce);
@@ -93,16 +102,25 @@ void AnalyzerThread::doRun() {
     // before returning from this function.
     mixxx::DbConnectionPooler dbConnectionPooler;
 
-    if (m_modeFlags & AnalyzerModeFlags::WithWaveform) {
+    const bool withWaveform = m_modeFlags & AnalyzerModeFlags::WithWaveform;
+    const bool withAnalysisCache = AnalysisCache::isEnabled(m_pConfig);
+    if (withWaveform || withAnalysisCache) {
         dbConnectionPooler = mixxx::DbConnectionPooler(m_dbConnectionPool); // move assignment
         if (!dbConnectionPooler.isPooling()) {
             kLogger.warning()
                     << "Failed to obtain database connection for analyzer thread";
             return;
         }
+    }
+    if (withWaveform) {
         QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_dbConnectionPool);
         m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection)));
     }
+    if (withAnalysisCache) {
+        m_pAnalysisCache = std::make_unique<AnalysisCache>(m_pConfig,
+                mixxx::DbConnectionPooled(m_dbConnectionPool),
+                withWaveform);
+    }
     if (AnalyzerGain::isEnabled(ReplayGainSettings(m_pConfig))) {
         m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerGain>(m_pConfig)));
     }
@@ -118,10 +136,22 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
+    if (m_modeFlags & AnalyzerModeFlags::Pipelined) {
+        // The decoding happens in the buffers of the pipeline
+        m_sampleBuffer = mixxx::SampleBuffer();
+        m_pPipeline = std::make_unique<AnalyzerPipeline>(
+                &m_analyzers,
+                &m_input,
+                kPipelineChunkCount,
+                mixxx::kAnalysisSamplesPerChunk);
+    }
+
     m_lastBusyProgressEmittedTimer.start();
 
     mixxx::AudioSource::OpenParams openParams;
     openParams.setChannelCount(mixxx::kAnalysisMaxChannels);
+    // The stems of stem files are decoded in parallel
+    openParams.setConcurrentStreamDecoding(true);
 
     while (awaitWorkItemsFetched()) {
         DEBUG_ASSERT(m_currentTrack.has_value());
@@ -138,6 +168,25 @@ void AnalyzerThread::doRun() {
             continue;
         }
 
+        // Restore the missing results from the cache before the analyzers
+        // decide if they need to analyze the track. An explicit reanalysis
+        // with different options must not be answered from the cache.
+        QByteArray contentHash;
+        if (m_pAnalysisCache &&
+                m_pAnalysisCache->isMissingResults(m_currentTrack->getTrack())) {
+            contentHash = AnalysisCache::contentHash(audioSource);
+            if (!contentHash.isEmpty() &&
+                    !m_currentTrack->getOptions().useFixedTempo.has_value()) {
+                m_pAnalysisCache->restoreResults(contentHash,
+                        m_currentTrack->getTrack(),
+                        audioSource->getSignalInfo().getSampleRate());
+            }
+        }
+
+        // Beats that are not replaced by the analysis are not cached
+        const mixxx::BeatsPointer pBeatsBeforeAnalysis =
+                m_currentTrack->getTrack()->getBeats();
+
         // If we have a non-even multi channel audio source (mono or )
         if (audioSource->getSignalInfo().getChannelCount() % mixxx::kAnalysisChannels) {
             audioSource = std::make_shared<mixxx::AudioSourceStereoProxy>(
@@ -146,6 +195,7 @@ void AnalyzerThread::doRun() {
         }
 
         bool processTrack = false;
+        AnalyzerInputFormats inputFormats;
         for (auto&& analyzer : m_analyzers) {
             // Make sure not to short-circuit initialize(...)
             if (analyzer.initialize(
@@ -154,8 +204,10 @@ void AnalyzerThread::doRun() {
                         audioSource->getSignalInfo().getChannelCount(),
                         audioSource->frameLength())) {
                 processTrack = true;
+                inputFormats |= analyzer.inputFormat();
             }
         }
+        m_input.initialize(audioSource->getSignalInfo().getChannelCount(), inputFormats);
 
         if (processTrack) {
             const auto analysisResult = analyzeAudioSource(audioSource);
@@ -172,6 +224,11 @@ void AnalyzerThread::doRun() {
                 for (auto&& analyzer : m_analyzers) {
                     analyzer.finish(*m_currentTrack);
                 }
+                if (!contentHash.isEmpty()) {
+                    m_pAnalysisCache->storeResults(contentHash,
+                            m_currentTrack->getTrack(),
+                            pBeatsBeforeAnalysis);
+                }
                 emitDoneProgress(kAnalyzerProgressDone);
             } else {
                 for (auto&& analyzer : m_analyzers) {
@@ -187,7 +244,9 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
+    m_pPipeline.reset();
     m_analyzers.clear();
+    m_pAnalysisCache.reset();
 
     kLogger.debug() << "Exiting worker thread";
     emitProgress(AnalyzerThreadState::Exit);
@@ -234,13 +293,25 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     // Analysis starts now
     emitBusyProgress(kAnalyzerProgressNone);
 
+    // The pipeline is reused for all tracks
+    const qint64 processedFrameCountBefore =
+            m_pPipeline ? m_pPipeline->processedFrameCount() : 0;
+
     mixxx::IndexRange remainingFrameRange = audioSource->frameIndexRange();
     while (!remainingFrameRange.empty()) {
         sleepWhileSuspended();
         if (isStopping()) {
+            if (m_pPipeline) {
+                m_pPipeline->cancel();
+            }
             return AnalysisResult::Cancelled;
         }
 
+        // In pipelined mode this blocks while the slowest analyzer
+        // is lagging behind too far
+        mixxx::SampleBuffer& sampleBuffer =
+                m_pPipeline ? m_pPipeline->acquireChunk() : m_sampleBuffer;
+
         // 1st step: Decode next chunk of audio data
 
         // Split the range for the next chunk from the remaining (= to-be-analyzed) frames
@@ -254,7 +325,7 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
                 audioSource->readSampleFrames(
                         mixxx::WritableSampleFrames(
                                 chunkFrameRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+                                mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
         // The returned range fits into the requested range
         DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
 
@@ -294,15 +365,30 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
 
         sleepWhileSuspended();
         if (isStopping()) {
+            if (m_pPipeline) {
+                m_pPipeline->cancel();
+            }
             return AnalysisResult::Cancelled;
         }
 
         // 2nd: step: Analyze chunk of decoded audio data
         if (!readableSampleFrames.frameIndexRange().empty()) {
-            for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
+            m_decodedFrameCount.fetch_add(
+                    readableSampleFrames.frameIndexRange().length(),
+                    std::memory_order_relaxed);
+            if (m_pPipeline) {
+                m_pPipeline->publishChunk(
                         readableSampleFrames.readableData(),
-                        readableSampleFrames.readableLength());
+                        readableSampleFrames.readableLength(),
+                        readableSampleFrames.frameIndexRange().length());
+            } else {
+                m_input.process(
+                        readableSampleFrames.readableData(),
+                        readableSampleFrames.readableLength(),
+                        &m_inputChunk);
+                for (auto&& analyzer : m_analyzers) {
+                    analyzer.processInput(m_inputChunk);
+                }
             }
         }
 
@@ -311,15 +397,19 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
 
         // 3rd step: Update & emit progress
         if (audioSource->frameLength() > 0) {
+            // In pipelined mode the analyzers lag behind decoding
+            const qint64 analyzedFrameCount = m_pPipeline
+                    ? m_pPipeline->processedFrameCount() - processedFrameCountBefore
+                    : audioSource->frameLength() - remainingFrameRange.length();
             const double frameProgress =
-                    static_cast<double>(audioSource->frameLength() - remainingFrameRange.length()) /
+                    static_cast<double>(analyzedFrameCount) /
                     audioSource->frameLength();
             // math_min is required to compensate rounding errors
             const AnalyzerProgress progress =
                     math_min(kAnalyzerProgressFinalizing,
                             frameProgress *
                                     (kAnalyzerProgressFinalizing - kAnalyzerProgressNone));
-            DEBUG_ASSERT(progress > kAnalyzerProgressNone);
+            DEBUG_ASSERT(m_pPipeline || progress > kAnalyzerProgressNone);
             emitBusyProgress(progress);
         } else {
             // Unreadable audio source
@@ -328,6 +418,10 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
         }
     }
 
+    if (m_pPipeline) {
+        // The analyzers are finished on this thread
+        m_pPipeline->drain();
+    }
     return AnalysisResult::Finished;
 }
 
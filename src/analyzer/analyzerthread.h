@@ -1,10 +1,14 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <vector>
 
+#include "analyzer/analysiscache.h"
 #include "analyzer/analyzer.h"
+#include "analyzer/analyzerinput.h"
+#include "analyzer/analyzerpipeline.h"
 #include "analyzer/analyzerprogress.h"
 #include "analyzer/analyzertrack.h"
 #include "preferences/usersettings.h"
@@ -21,7 +25,11 @@ enum AnalyzerModeFlags {
     None = 0x00,
     WithBeats = 0x01,
     WithWaveform = 0x02,
+    // Run the worker threads in the background with a low priority and
+    // an adaptive number of active workers, see TrackAnalysisScheduler
     LowPriority = 0x04,
+    // Run the analyzers concurrently with decoding, see AnalyzerPipeline
+    Pipelined = 0x08,
     All = WithBeats | WithWaveform,
 };
 
@@ -79,6 +87,12 @@ class AnalyzerThread : public WorkerThread {
     // worker thread, yet.
     bool submitNextTrack(const AnalyzerTrack& nextTrack);
 
+    // The total number of frames that have been decoded by this
+    // thread. Used for measuring the throughput of all threads.
+    qint64 decodedFrameCount() const {
+        return m_decodedFrameCount.load(std::memory_order_relaxed);
+    }
+
   signals:
     // Use a single signal for progress updates to ensure that all signals
     // are queued and received in the same order as emitted from the internal
@@ -112,6 +126,8 @@ class AnalyzerThread : public WorkerThread {
     // for this purpose, which will become available in C++20.
     rigtorp::SPSCQueue<AnalyzerTrack> m_nextTrack;
 
+    std::atomic<qint64> m_decodedFrameCount;
+
     /////////////////////////////////////////////////////////////////////////
     // Thread local: Only used in the constructor/destructor and within
     // run() by the worker thread.
@@ -120,6 +136,16 @@ class AnalyzerThread : public WorkerThread {
 
     mixxx::SampleBuffer m_sampleBuffer;
 
+    // Mixes and decimates the decoded audio once for all analyzers
+    AnalyzerInput m_input;
+    AnalyzerInputChunk m_inputChunk;
+
+    // Only present if enabled in the preferences
+    std::unique_ptr<AnalysisCache> m_pAnalysisCache;
+
+    // Only present in pipelined mode, must be destroyed before the analyzers
+    std::unique_ptr<AnalyzerPipeline> m_pPipeline;
+
     std::optional<AnalyzerTrack> m_currentTrack;
 
     AnalyzerThreadState m_emittedState;
@@ -1,5 +1,6 @@
 #include "analyzer/analyzerwaveform.h"
 
+#include <cmath>
 #include <memory>
 #include <vector>
 
@@ -8,6 +9,7 @@
 #include "engine/filters/enginefilterbessel4.h"
 #include "track/track.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "waveform/waveform.h"
 #include "waveform/waveformfactory.h"
 
@@ -19,6 +21,47 @@ constexpr double kLowMidFreqHz = 600.0;
 
 constexpr double kMidHighFreqHz = 4000.0;
 
+
+// A stride ends at each position that is less than a frame behind
+// a multiple of its (fractional) length
+inline bool isStrideEnd(int position, double length) {
+    return fmod(position, length) < 1;
+}
+
+// Returns the first position after the given position at which
+// isStrideEnd() is true
+int nextStrideEndPosition(int position, double length) {
+    if (length <= 1) {
+        return position + 1;
+    }
+    const double nextEnd = (std::floor(position / length) + 1) * length;
+    // Start one frame early to compensate for rounding errors
+    int nextPosition = math_max(position + 1, static_cast<int>(std::ceil(nextEnd)) - 1);
+    while (!isStrideEnd(nextPosition, length)) {
+        ++nextPosition;
+    }
+    return nextPosition;
+}
+
+// Stores the largest absolute value of both channels of a single stem
+// in an interleaved multi-channel buffer
+void maxAbsPerStemChannel(CSAMPLE* pMaxL,
+        CSAMPLE* pMaxR,
+        const CSAMPLE* pStem,
+        SINT numFrames,
+        int channelCount) {
+    CSAMPLE maxL = CSAMPLE_ZERO;
+    CSAMPLE maxR = CSAMPLE_ZERO;
+    for (SINT i = 0; i < numFrames; ++i) {
+        const CSAMPLE absl = fabs(pStem[i * channelCount]);
+        const CSAMPLE absr = fabs(pStem[i * channelCount + 1]);
+        maxL = absl > maxL ? absl : maxL;
+        maxR = absr > maxR ? absr : maxR;
+    }
+    *pMaxL = maxL;
+    *pMaxR = maxR;
+}
+
 } // namespace
 
 AnalyzerWaveform::AnalyzerWaveform(
@@ -123,12 +166,27 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer pTrack) const {
 
             if (analysis.type == AnalysisDao::TYPE_WAVEFORM) {
                 vc = WaveformFactory::waveformVersionToVersionClass(analysis.version);
+                WaveformPointer pWaveform;
                 if (missingWaveform && vc == WaveformFactory::VC_USE) {
-                    pLoadedTrackWaveform = ConstWaveformPointer(
+                    pWaveform = WaveformPointer(
                             WaveformFactory::loadWaveformFromAnalysis(analysis));
+                }
+                if (pWaveform && pWaveform->getDataSize() > 0) {
+                    if (analysis.mappableDataPath.isEmpty()) {
+                        // Stored in the protobuf format without the mip-map
+                        // levels. Stored again with the levels once instead
+                        // of building them on every load.
+                        pWaveform->updateLevels();
+                        AnalysisDao::AnalysisInfo converted = analysis;
+                        converted.data = pWaveform->toFlatByteArray();
+                        m_analysisDao.saveAnalysis(&converted);
+                    }
+                    pLoadedTrackWaveform = pWaveform;
                     missingWaveform = false;
-                } else if (vc != WaveformFactory::VC_KEEP) {
-                    // remove all other Analysis except that one we should keep
+                } else if (pWaveform || vc != WaveformFactory::VC_KEEP) {
+                    // remove all other Analysis except that one we should keep,
+                    // unreadable waveforms, e.g. of an unsupported layout, are
+                    // analyzed again
                     m_analysisDao.deleteAnalysis(analysis.analysisId);
                 }
             }
@@ -233,46 +291,58 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
     m_waveform->setSaveState(Waveform::SaveState::NotSaved);
     m_waveformSummary->setSaveState(Waveform::SaveState::NotSaved);
 
-    for (SINT i = 0; i < count; i += 2) {
-        // Take max value, not average of data
-        CSAMPLE cover[2] = {fabs(pWaveformInput[i]), fabs(pWaveformInput[i + 1])};
-        CSAMPLE clow[2] = {fabs(m_buffers.low[i]), fabs(m_buffers.low[i + 1])};
-        CSAMPLE cmid[2] = {fabs(m_buffers.mid[i]), fabs(m_buffers.mid[i + 1])};
-        CSAMPLE chigh[2] = {fabs(m_buffers.high[i]), fabs(m_buffers.high[i + 1])};
-
-        // This is for if you want to experiment with averaging instead of
-        // maxing.
-        // m_stride.m_overallData[Right] += buffer[i]*buffer[i];
-        // m_stride.m_overallData[Left] += buffer[i + 1]*buffer[i + 1];
-        // m_stride.m_filteredData[Right][Low] += m_buffers.low[i]*m_buffers.low[i];
-        // m_stride.m_filteredData[Left][Low] += m_buffers.low[i + 1]*m_buffers.low[i + 1];
-        // m_stride.m_filteredData[Right][Mid] += m_buffers.mid[i]*m_buffers.mid[i];
-        // m_stride.m_filteredData[Left][Mid] += m_buffers.mid[i + 1]*m_buffers.mid[i + 1];
-        // m_stride.m_filteredData[Right][High] += m_buffers.high[i]*m_buffers.high[i];
-        // m_stride.m_filteredData[Left][High] += m_buffers.high[i + 1]*m_buffers.high[i + 1];
-
-        // Record the max across this stride.
-        storeIfGreater(&m_stride.m_overallData[Left], cover[Left]);
-        storeIfGreater(&m_stride.m_overallData[Right], cover[Right]);
-        storeIfGreater(&m_stride.m_filteredData[Left][Low], clow[Left]);
-        storeIfGreater(&m_stride.m_filteredData[Right][Low], clow[Right]);
-        storeIfGreater(&m_stride.m_filteredData[Left][Mid], cmid[Left]);
-        storeIfGreater(&m_stride.m_filteredData[Right][Mid], cmid[Right]);
-        storeIfGreater(&m_stride.m_filteredData[Left][High], chigh[Left]);
-        storeIfGreater(&m_stride.m_filteredData[Right][High], chigh[Right]);
+    // Instead of checking for the end of a stride after each frame, all
+    // frames until the next end of a stride are processed at once with
+    // vectorized loops. The maximum is independent of the order, so the
+    // results are exactly the same.
+    SINT frame = 0;
+    while (frame < numFrames) {
+        const int nextStrideEnd = nextStrideEndPosition(
+                m_stride.m_position, m_stride.m_length);
+        const int nextSummaryStrideEnd = nextStrideEndPosition(
+                m_stride.m_position, m_stride.m_averageLength);
+        const SINT segmentFrames = math_min(
+                static_cast<SINT>(math_min(nextStrideEnd, nextSummaryStrideEnd) -
+                        m_stride.m_position),
+                numFrames - frame);
+        DEBUG_ASSERT(segmentFrames > 0);
+
+        // Record the max across this stride. Take max value, not average
+        // of data.
+        const SINT offset = frame * mixxx::audio::ChannelCount::stereo();
+        const SINT segmentCount = segmentFrames * mixxx::audio::ChannelCount::stereo();
+        CSAMPLE max[ChannelCount];
+        SampleUtil::maxAbsPerChannel(
+                &max[Left], &max[Right], pWaveformInput + offset, segmentCount);
+        storeIfGreater(&m_stride.m_overallData[Left], max[Left]);
+        storeIfGreater(&m_stride.m_overallData[Right], max[Right]);
+        SampleUtil::maxAbsPerChannel(
+                &max[Left], &max[Right], &m_buffers.low[offset], segmentCount);
+        storeIfGreater(&m_stride.m_filteredData[Left][Low], max[Left]);
+        storeIfGreater(&m_stride.m_filteredData[Right][Low], max[Right]);
+        SampleUtil::maxAbsPerChannel(
+                &max[Left], &max[Right], &m_buffers.mid[offset], segmentCount);
+        storeIfGreater(&m_stride.m_filteredData[Left][Mid], max[Left]);
+        storeIfGreater(&m_stride.m_filteredData[Right][Mid], max[Right]);
+        SampleUtil::maxAbsPerChannel(
+                &max[Left], &max[Right], &m_buffers.high[offset], segmentCount);
+        storeIfGreater(&m_stride.m_filteredData[Left][High], max[Left]);
+        storeIfGreater(&m_stride.m_filteredData[Right][High], max[Right]);
 
         for (int s = 0; s < stemCount; s++) {
-            CSAMPLE cstem[2] = {
-                    fabs(pIn[i * stemCount + s * mixxx::kAnalysisChannels]),
-                    fabs(pIn[i * stemCount + s * mixxx::kAnalysisChannels +
-                            1])};
-            storeIfGreater(&m_stride.m_stemData[Left][s], cstem[Left]);
-            storeIfGreater(&m_stride.m_stemData[Right][s], cstem[Right]);
+            maxAbsPerStemChannel(&max[Left],
+                    &max[Right],
+                    pIn + frame * m_channelCount + s * mixxx::kAnalysisChannels,
+                    segmentFrames,
+                    m_channelCount);
+            storeIfGreater(&m_stride.m_stemData[Left][s], max[Left]);
+            storeIfGreater(&m_stride.m_stemData[Right][s], max[Right]);
         }
 
-        m_stride.m_position++;
+        frame += segmentFrames;
+        m_stride.m_position += static_cast<int>(segmentFrames);
 
-        if (fmod(m_stride.m_position, m_stride.m_length) < 1) {
+        if (m_stride.m_position == nextStrideEnd) {
             VERIFY_OR_DEBUG_ASSERT(m_currentStride + ChannelCount <= m_waveform->getDataSize()) {
                 qWarning() << "AnalyzerWaveform::process - currentStride > waveform size";
                 return false;
@@ -282,7 +352,7 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
             m_waveform->setCompletion(m_currentStride);
         }
 
-        if (fmod(m_stride.m_position, m_stride.m_averageLength) < 1) {
+        if (m_stride.m_position == nextSummaryStrideEnd) {
             VERIFY_OR_DEBUG_ASSERT(m_currentSummaryStride + ChannelCount <= m_waveformSummary->getDataSize()) {
                 qWarning() << "AnalyzerWaveform::process - current summary stride > waveform summary size";
                 return false;
@@ -324,6 +394,7 @@ void AnalyzerWaveform::storeResults(TrackPointer pTrack) {
     if (m_waveform) {
         m_waveform->setSaveState(Waveform::SaveState::SavePending);
         m_waveform->setCompletion(m_waveform->getDataSize());
+        m_waveform->updateLevels();
         m_waveform->setVersion(WaveformFactory::currentWaveformVersion());
         m_waveform->setDescription(WaveformFactory::currentWaveformDescription());
     }
@@ -14,6 +14,11 @@ constexpr SINT kAnalysisFramesPerChunk = 4096;
 constexpr SINT kAnalysisSamplesPerChunk =
         kAnalysisFramesPerChunk * kAnalysisMaxChannels;
 
+// Decimation factor of the shared mono input for analyzers that only need
+// low frequencies, e.g. 5512.5 Hz at 44.1 kHz. This is the highest factor
+// that is supported by the anti-aliasing filters of qm-dsp.
+constexpr int kAnalysisDecimationFactor = 8;
+
 // Only analyze the first minute in fast-analysis mode.
 constexpr SINT kFastAnalysisSecondsToAnalyze = 60;
 
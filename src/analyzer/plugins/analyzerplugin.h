@@ -2,6 +2,7 @@
 
 #include <QString>
 
+#include "analyzer/analyzerinput.h"
 #include "audio/frame.h"
 #include "track/beats.h"
 #include "track/bpm.h"
@@ -60,6 +61,18 @@ class AnalyzerPlugin {
     }
     virtual AnalyzerPluginInfo info() const = 0;
 
+    /// The representation of the samples passed to processSamples().
+    ///
+    /// initialize() always receives the sample rate of the decoded audio.
+    /// The samples of all formats except MonoDecimated have this rate.
+    /// MonoDecimated passes a single channel of low-pass filtered samples
+    /// at sampleRate / kAnalysisDecimationFactor, i.e. one sample for
+    /// every kAnalysisDecimationFactor frames, and iLen counts these
+    /// samples.
+    virtual AnalyzerInputFormat inputFormat() const {
+        return AnalyzerInputFormat::Stereo;
+    }
+
     virtual bool initialize(mixxx::audio::SampleRate sampleRate) = 0;
     virtual bool processSamples(const CSAMPLE* pIn, SINT iLen) = 0;
     virtual bool finalize() = 0;
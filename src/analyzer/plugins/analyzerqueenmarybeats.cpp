@@ -5,8 +5,6 @@
 // definitions interfere with qm-dsp's headers.
 #include "analyzer/plugins/analyzerqueenmarybeats.h"
 
-#include "analyzer/constants.h"
-
 namespace mixxx {
 namespace {
 
@@ -66,12 +64,11 @@ bool AnalyzerQueenMaryBeats::initialize(mixxx::audio::SampleRate sampleRate) {
 }
 
 bool AnalyzerQueenMaryBeats::processSamples(const CSAMPLE* pIn, SINT iLen) {
-    DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
     if (!m_pDetectionFunction) {
         return false;
     }
 
-    return m_helper.processStereoSamples(pIn, iLen);
+    return m_helper.processMonoSamples(pIn, iLen);
 }
 
 bool AnalyzerQueenMaryBeats::finalize() {
@@ -30,6 +30,10 @@ class AnalyzerQueenMaryBeats : public AnalyzerBeatsPlugin {
         return pluginInfo();
     }
 
+    AnalyzerInputFormat inputFormat() const override {
+        return AnalyzerInputFormat::Mono;
+    }
+
     bool initialize(mixxx::audio::SampleRate sampleRate) override;
     bool processSamples(const CSAMPLE* pIn, SINT iLen) override;
     bool finalize() override;
@@ -51,7 +51,11 @@ bool AnalyzerQueenMaryKey::initialize(mixxx::audio::SampleRate sampleRate) {
         }
     };
 
-    GetKeyMode::Config config(sampleRate, kTuningFrequencyHertz);
+    // The input is already decimated by the AnalyzerThread
+    GetKeyMode::Config config(
+            sampleRate.toDouble() / kAnalysisDecimationFactor,
+            kTuningFrequencyHertz);
+    config.decimationFactor = 1;
     m_pKeyMode = std::make_unique<GetKeyMode>(config);
     size_t windowSize = m_pKeyMode->getBlockSize();
     size_t stepSize = m_pKeyMode->getHopSize();
@@ -77,14 +81,13 @@ bool AnalyzerQueenMaryKey::initialize(mixxx::audio::SampleRate sampleRate) {
 }
 
 bool AnalyzerQueenMaryKey::processSamples(const CSAMPLE* pIn, SINT iLen) {
-    DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
     if (!m_pKeyMode) {
         return false;
     }
 
-    const size_t numInputFrames = iLen / kAnalysisChannels;
-    m_currentFrame += numInputFrames;
-    return m_helper.processStereoSamples(pIn, iLen);
+    // The key changes are reported at the original sample rate
+    m_currentFrame += iLen * kAnalysisDecimationFactor;
+    return m_helper.processMonoSamples(pIn, iLen);
 }
 
 bool AnalyzerQueenMaryKey::finalize() {
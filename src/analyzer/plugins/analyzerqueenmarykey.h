@@ -30,6 +30,10 @@ class AnalyzerQueenMaryKey : public AnalyzerKeyPlugin {
         return pluginInfo();
     }
 
+    AnalyzerInputFormat inputFormat() const override {
+        return AnalyzerInputFormat::MonoDecimated;
+    }
+
     bool initialize(mixxx::audio::SampleRate sampleRate) override;
     bool processSamples(const CSAMPLE* pIn, SINT iLen) override;
     bool finalize() override;
@@ -6,8 +6,7 @@
 
 namespace mixxx {
 
-AnalyzerSoundTouchBeats::AnalyzerSoundTouchBeats()
-        : m_downmixBuffer(kAnalysisFramesPerChunk) {
+AnalyzerSoundTouchBeats::AnalyzerSoundTouchBeats() {
 }
 
 AnalyzerSoundTouchBeats::~AnalyzerSoundTouchBeats() {
@@ -24,15 +23,8 @@ bool AnalyzerSoundTouchBeats::processSamples(const CSAMPLE* pIn, SINT iLen) {
         return false;
     }
     DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
-    // We analyze a mono mixdown of the signal since we don't think stereo does
-    // us any good.
-
-    CSAMPLE* pDownmix = m_downmixBuffer.data();
-    for (int i = 0; i < iLen / 2; i += 2) {
-        pDownmix[i] = (pIn[i * 2] + pIn[i * 2 + 1]) * 0.5f;
-    }
-
-    m_pSoundTouch->inputSamples(pIn, iLen / 2);
+    // BPMDetect mixes the stereo input down to mono on its own
+    m_pSoundTouch->inputSamples(pIn, iLen / kAnalysisChannels);
     return true;
 }
 
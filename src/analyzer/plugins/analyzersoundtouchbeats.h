@@ -4,7 +4,6 @@
 #include <memory>
 
 #include "analyzer/plugins/analyzerplugin.h"
-#include "util/samplebuffer.h"
 
 namespace soundtouch {
 class BPMDetect;
@@ -43,8 +42,6 @@ class AnalyzerSoundTouchBeats : public AnalyzerBeatsPlugin {
 
   private:
     std::unique_ptr<soundtouch::BPMDetect> m_pSoundTouch;
-    /// mono, i.e. 1 sample per frame
-    SampleBuffer m_downmixBuffer;
     mixxx::Bpm m_resultBpm;
 };
 
@@ -1,5 +1,7 @@
 #include "analyzer/trackanalysisscheduler.h"
 
+#include <algorithm>
+
 #include "analyzer/analyzerscheduledtrack.h"
 #include "analyzer/analyzertrack.h"
 #include "moc_trackanalysisscheduler.cpp"
@@ -12,6 +14,26 @@ mixxx::Logger kLogger("TrackAnalysisScheduler");
 
 constexpr QThread::Priority kWorkerThreadPriority = QThread::LowPriority;
 
+// The reserved worker for tracks with a high priority must not
+// be starved by other low priority threads
+constexpr QThread::Priority kReservedWorkerThreadPriority = QThread::NormalPriority;
+
+// Interval for adapting the number of active workers in the background
+// mode. Long enough to average out the variations of decoding speed.
+constexpr int kAdaptActiveWorkersIntervalMillis = 2000;
+
+// Above this fraction of the audio callback period used by the engine
+// the number of active workers is reduced
+constexpr double kMaxAudioLatencyUsage = 0.5;
+
+// An additional worker must increase the throughput by at least this
+// fraction, otherwise decoding is considered I/O bound or no idle cores
+// are available
+constexpr double kMinThroughputGainPerWorker = 0.1;
+
+// Number of intervals to wait after an unsuccessful probe
+constexpr int kHoldActiveWorkersIntervals = 15;
+
 // Maximum frequency of progress updates
 constexpr std::chrono::milliseconds kProgressInhibitDuration(100);
 
@@ -53,6 +75,18 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
         const UserSettingsPointer& pConfig,
         AnalyzerModeFlags modeFlags)
         : m_pEnvironment(std::move(pEnvironment)),
+          m_pDbConnectionPool(pDbConnectionPool),
+          m_pConfig(pConfig),
+          m_modeFlags(modeFlags),
+          m_suspended(true),
+          // Start with half of the workers and probe for more
+          m_maxActiveWorkers(modeFlags & AnalyzerModeFlags::LowPriority
+                          ? math_max(1, numWorkerThreads / 2)
+                          : numWorkerThreads),
+          m_lastDecodedFrameCount(0),
+          m_lastThroughput(0),
+          m_lastActiveWorkersChange(0),
+          m_holdActiveWorkersCount(0),
           m_currentTrackProgress(kAnalyzerProgressUnknown),
           m_currentTrackNumber(0),
           m_dequeuedTracksCount(0),
@@ -70,26 +104,40 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
                 << "worker threads. Priority: "
                 << (modeFlags & AnalyzerModeFlags::LowPriority ? "low" : "normal");
     }
-    // 1st pass: Create worker threads
-    m_workers.reserve(numWorkerThreads);
+    // Reserve an additional slot for the reserved worker
+    m_workers.reserve(numWorkerThreads + 1);
     for (int threadId = 0; threadId < numWorkerThreads; ++threadId) {
-        m_workers.emplace_back(AnalyzerThread::createInstance(
-                threadId,
-                pDbConnectionPool,
-                pConfig,
-                modeFlags));
-        connect(m_workers.back().thread(),
-                &AnalyzerThread::progress,
-                this,
-                &TrackAnalysisScheduler::onWorkerThreadProgress);
+        addWorker(false);
     }
-    // 2nd pass: Start worker threads in a suspended state
-    for (const auto& worker: m_workers) {
-        worker.thread()->suspend();
-        worker.thread()->start(kWorkerThreadPriority);
+    if (modeFlags & AnalyzerModeFlags::LowPriority) {
+        m_adaptActiveWorkersTimer.setInterval(kAdaptActiveWorkersIntervalMillis);
+        connect(&m_adaptActiveWorkersTimer,
+                &QTimer::timeout,
+                this,
+                &TrackAnalysisScheduler::slotAdaptActiveWorkers);
     }
 }
 
+void TrackAnalysisScheduler::addWorker(bool reserved) {
+    // The thread id is the index into m_workers
+    const int threadId = static_cast<int>(m_workers.size());
+    m_workers.emplace_back(
+            AnalyzerThread::createInstance(
+                    threadId,
+                    m_pDbConnectionPool,
+                    m_pConfig,
+                    m_modeFlags),
+            reserved);
+    const auto& worker = m_workers.back();
+    connect(worker.thread(),
+            &AnalyzerThread::progress,
+            this,
+            &TrackAnalysisScheduler::onWorkerThreadProgress);
+    // Start the worker thread in a suspended state
+    worker.thread()->suspend();
+    worker.thread()->start(reserved ? kReservedWorkerThreadPriority : kWorkerThreadPriority);
+}
+
 TrackAnalysisScheduler::~TrackAnalysisScheduler() {
     kLogger.debug() << "Destroying";
 }
@@ -169,8 +217,8 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
             m_currentTrackNumber = finishedTracksCount;
         }
     }
-    const int totalTracksCount =
-            m_dequeuedTracksCount + static_cast<int>(m_queuedTracks.size());
+    const int totalTracksCount = m_dequeuedTracksCount +
+            static_cast<int>(m_queuedTracks.size() + m_priorityTracks.size());
     DEBUG_ASSERT(m_currentTrackNumber <= m_dequeuedTracksCount);
     DEBUG_ASSERT(m_dequeuedTracksCount <= totalTracksCount);
     emit progress(
@@ -223,12 +271,17 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
             worker.onAnalyzerProgress(analyzerProgress);
             emit trackProgress(trackId, analyzerProgress);
         }
+        if (worker.trackId() == trackId) {
+            worker.onTrackDone();
+            updatePreemptedWorkers();
+        }
         break;
     case AnalyzerThreadState::Exit:
         DEBUG_ASSERT(!trackId.isValid());
         DEBUG_ASSERT(analyzerProgress == kAnalyzerProgressUnknown);
         worker.onThreadExit();
         DEBUG_ASSERT(!worker);
+        updatePreemptedWorkers();
         break;
     default:
         DEBUG_ASSERT(!"Unhandled signal from worker thread");
@@ -236,14 +289,26 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
     emitProgressOrFinished();
 }
 
-bool TrackAnalysisScheduler::scheduleTrack(AnalyzerScheduledTrack track) {
+bool TrackAnalysisScheduler::scheduleTrack(
+        AnalyzerScheduledTrack track, Priority priority) {
     VERIFY_OR_DEBUG_ASSERT(track.getTrackId().isValid()) {
         qWarning()
                 << "Cannot schedule track with invalid id"
                 << track.getTrackId();
         return false;
     }
-    m_queuedTracks.push_back(track);
+    if (priority == Priority::High) {
+        if (std::none_of(m_workers.begin(),
+                    m_workers.end(),
+                    [](const Worker& worker) { return worker.isReserved(); })) {
+            kLogger.debug() << "Adding reserved worker thread";
+            addWorker(true);
+        }
+        m_priorityTracks.push_back(track);
+        updatePreemptedWorkers();
+    } else {
+        m_queuedTracks.push_back(track);
+    }
     // Don't wake up the suspended thread now to avoid race conditions
     // if multiple threads are added in a row by calling this function
     // multiple times. The caller is responsible to finish the scheduling
@@ -263,6 +328,8 @@ int TrackAnalysisScheduler::scheduleTracks(const QList<AnalyzerScheduledTrack>&
 
 void TrackAnalysisScheduler::suspend() {
     kLogger.debug() << "Suspending";
+    m_suspended = true;
+    m_adaptActiveWorkersTimer.stop();
     for (auto& worker: m_workers) {
         worker.suspendThread();
     }
@@ -270,15 +337,174 @@ void TrackAnalysisScheduler::suspend() {
 
 void TrackAnalysisScheduler::resume() {
     kLogger.debug() << "Resuming";
+    m_suspended = false;
     for (auto& worker: m_workers) {
-        worker.resumeThread();
+        if (!worker.isPreempted()) {
+            worker.resumeThread();
+        }
+    }
+    if (m_modeFlags & AnalyzerModeFlags::LowPriority &&
+            !m_adaptActiveWorkersTimer.isActive()) {
+        // Measurements across suspended periods are meaningless
+        m_lastThroughput = 0;
+        m_lastActiveWorkersChange = 0;
+        m_adaptActiveWorkersTimer.start();
+        m_throughputTimer.start();
+        m_lastDecodedFrameCount = 0;
+        for (const auto& worker : m_workers) {
+            if (worker) {
+                m_lastDecodedFrameCount += worker.thread()->decodedFrameCount();
+            }
+        }
+    }
+}
+
+int TrackAnalysisScheduler::busyWorkersCount() const {
+    return static_cast<int>(std::count_if(m_workers.begin(),
+            m_workers.end(),
+            [](const Worker& worker) {
+                return !worker.isReserved() && worker.trackId().isValid();
+            }));
+}
+
+void TrackAnalysisScheduler::wakeIdleWorkers() {
+    if (m_suspended) {
+        return;
+    }
+    for (auto& worker : m_workers) {
+        if (!worker.trackId().isValid() && !worker.isPreempted()) {
+            worker.resumeThread();
+        }
+    }
+}
+
+void TrackAnalysisScheduler::slotAdaptActiveWorkers() {
+    qint64 decodedFrameCount = 0;
+    int workersCount = 0;
+    for (const auto& worker : m_workers) {
+        if (worker && !worker.isReserved()) {
+            decodedFrameCount += worker.thread()->decodedFrameCount();
+            ++workersCount;
+        }
+    }
+    const double elapsedSeconds = m_throughputTimer.restart().toDoubleSeconds();
+    const double throughput = elapsedSeconds > 0
+            ? (decodedFrameCount - m_lastDecodedFrameCount) / elapsedSeconds
+            : 0;
+    m_lastDecodedFrameCount = decodedFrameCount;
+
+    int activeWorkersChange = 0;
+    const auto audioLatencyUsage = m_pEnvironment->audioLatencyUsage();
+    if (audioLatencyUsage && *audioLatencyUsage > kMaxAudioLatencyUsage) {
+        // The audio engine is busy, e.g. with heavy effects
+        activeWorkersChange = -1;
+        m_holdActiveWorkersCount = kHoldActiveWorkersIntervals;
+    } else if (busyWorkersCount() < m_maxActiveWorkers || m_queuedTracks.empty()) {
+        // Not saturated, nothing to learn from the measurement
+    } else if (m_lastActiveWorkersChange > 0 &&
+            throughput < m_lastThroughput * (1 + kMinThroughputGainPerWorker)) {
+        // The additional worker didn't pay off
+        activeWorkersChange = -1;
+        m_holdActiveWorkersCount = kHoldActiveWorkersIntervals;
+    } else if (m_holdActiveWorkersCount > 0) {
+        --m_holdActiveWorkersCount;
+    } else {
+        // Probe one more worker
+        activeWorkersChange = 1;
+    }
+
+    const int maxActiveWorkers = math_clamp(
+            m_maxActiveWorkers + activeWorkersChange, 1, math_max(1, workersCount));
+    m_lastActiveWorkersChange = maxActiveWorkers - m_maxActiveWorkers;
+    m_lastThroughput = throughput;
+    if (m_lastActiveWorkersChange == 0) {
+        return;
+    }
+    kLogger.debug()
+            << "Adjusting the number of active workers from"
+            << m_maxActiveWorkers
+            << "to"
+            << maxActiveWorkers
+            << "at"
+            << throughput
+            << "frames/s";
+    setMaxActiveWorkers(maxActiveWorkers);
+}
+
+void TrackAnalysisScheduler::setMaxActiveWorkers(int maxActiveWorkers) {
+    VERIFY_OR_DEBUG_ASSERT(maxActiveWorkers > 0) {
+        maxActiveWorkers = 1;
+    }
+    if (m_maxActiveWorkers == maxActiveWorkers) {
+        return;
+    }
+    const bool raised = m_maxActiveWorkers < maxActiveWorkers;
+    m_maxActiveWorkers = maxActiveWorkers;
+    updatePreemptedWorkers();
+    if (raised) {
+        wakeIdleWorkers();
+    }
+}
+
+void TrackAnalysisScheduler::updatePreemptedWorkers() {
+    const bool highPriorityPending = !m_priorityTracks.empty() ||
+            std::any_of(m_workers.begin(),
+                    m_workers.end(),
+                    [](const Worker& worker) {
+                        return worker.trackId().isValid() &&
+                                worker.priority() == Priority::High;
+                    });
+    int activeWorkersCount = 0;
+    for (auto& worker : m_workers) {
+        bool preempted = false;
+        if (worker.trackId().isValid() && worker.priority() == Priority::Normal) {
+            // Workers beyond the limit have been busy before the limit
+            // has been lowered
+            preempted = highPriorityPending ||
+                    ++activeWorkersCount > m_maxActiveWorkers;
+        }
+        if (preempted == worker.isPreempted()) {
+            continue;
+        }
+        worker.setPreempted(preempted);
+        if (preempted) {
+            kLogger.debug()
+                    << "Suspending worker thread"
+                    << worker.thread()->id()
+                    << (highPriorityPending
+                                       ? "in favor of tracks with a high priority"
+                                       : "beyond the maximum number of active workers");
+            worker.suspendThread();
+        } else if (!m_suspended) {
+            worker.resumeThread();
+        }
     }
 }
 
 bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
     DEBUG_ASSERT(worker);
-    while (!m_queuedTracks.empty()) {
-        AnalyzerScheduledTrack nextScheduledTrack = m_queuedTracks.front();
+    if (submitNextQueuedTrack(worker, &m_priorityTracks, Priority::High)) {
+        return true;
+    }
+    if (worker->isReserved() || !m_priorityTracks.empty()) {
+        // Either not allowed to take tracks with normal priority
+        // or the worker is busy
+        return false;
+    }
+    if (busyWorkersCount() >= m_maxActiveWorkers) {
+        return false;
+    }
+    return submitNextQueuedTrack(worker, &m_queuedTracks, Priority::Normal);
+}
+
+bool TrackAnalysisScheduler::submitNextQueuedTrack(
+        Worker* worker,
+        std::deque<AnalyzerScheduledTrack>* pQueuedTracks,
+        Priority priority) {
+    DEBUG_ASSERT(worker);
+    DEBUG_ASSERT(pQueuedTracks);
+    while (!pQueuedTracks->empty()) {
+        AnalyzerScheduledTrack nextScheduledTrack = pQueuedTracks->front();
         TrackId nextTrackId = nextScheduledTrack.getTrackId();
         DEBUG_ASSERT(nextTrackId.isValid());
         if (nextTrackId.isValid()) {
@@ -287,9 +513,9 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
             if (nextTrackPtr) {
                 AnalyzerTrack nextTrack(nextTrackPtr, nextScheduledTrack.getOptions());
                 if (m_pendingTrackIds.insert(nextTrackId).second) {
-                    if (worker->submitNextTrack(std::move(nextTrack))) {
-                        m_queuedTracks.pop_front();
-                        ++m_dequeuedTracksCount;
+                    if (worker->submitNextTrack(std::move(nextTrack), priority)) {
+                        dequeueTrack(pQueuedTracks);
+                        updatePreemptedWorkers();
                         return true;
                     } else {
                         // The worker may already have been assigned new tasks
@@ -307,6 +533,14 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
                     kLogger.debug()
                             << "Skipping duplicate track id"
                             << nextTrackId;
+                    if (priority == Priority::High) {
+                        // Continue the analysis with a high priority
+                        for (auto& otherWorker : m_workers) {
+                            if (otherWorker.trackId() == nextTrackId) {
+                                otherWorker.raisePriority();
+                            }
+                        }
+                    }
                 }
             } else {
                 kLogger.warning()
@@ -319,12 +553,27 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
                     << nextTrackId;
         }
         // Skip this track
-        m_queuedTracks.pop_front();
-        ++m_dequeuedTracksCount;
+        dequeueTrack(pQueuedTracks);
+    }
+    if (priority == Priority::High) {
+        updatePreemptedWorkers();
     }
     return false;
 }
 
+void TrackAnalysisScheduler::dequeueTrack(
+        std::deque<AnalyzerScheduledTrack>* pQueuedTracks) {
+    DEBUG_ASSERT(pQueuedTracks);
+    DEBUG_ASSERT(!pQueuedTracks->empty());
+    pQueuedTracks->pop_front();
+    ++m_dequeuedTracksCount;
+    if (pQueuedTracks == &m_priorityTracks && m_priorityTracks.empty()) {
+        // Idle workers have refused tracks with a normal priority
+        // while tracks with a high priority were pending
+        wakeIdleWorkers();
+    }
+}
+
 void TrackAnalysisScheduler::stop() {
     kLogger.debug() << "Stopping";
     for (auto& worker: m_workers) {
@@ -332,7 +581,9 @@ void TrackAnalysisScheduler::stop() {
     }
     // The worker threads are still running at this point
     // and m_workers must not be modified!
+    m_adaptActiveWorkersTimer.stop();
     m_queuedTracks.clear();
+    m_priorityTracks.clear();
     m_pendingTrackIds.clear();
     DEBUG_ASSERT((allTracksFinished()));
 }
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <gtest/gtest_prod.h>
+
 #include <QList>
+#include <QTimer>
 #include <deque>
 #include <memory>
+#include <optional>
 #include <set>
 #include <vector>
 
@@ -20,6 +24,12 @@ class TrackAnalysisSchedulerEnvironment {
     virtual ~TrackAnalysisSchedulerEnvironment() = default;
 
     virtual TrackPointer loadTrackById(TrackId trackId) const = 0;
+
+    /// The fraction of the audio callback period that is currently used
+    /// by the audio engine, or std::nullopt without an audio engine.
+    virtual std::optional<double> audioLatencyUsage() const {
+        return std::nullopt;
+    }
 };
 
 class TrackAnalysisScheduler : public QObject {
@@ -27,6 +37,26 @@ class TrackAnalysisScheduler : public QObject {
 
   public:
     typedef std::unique_ptr<TrackAnalysisScheduler, void(*)(TrackAnalysisScheduler*)> Pointer;
+
+    /// Tracks with a high priority, e.g. a track that has just been loaded
+    /// into a deck, overtake all queued tracks with a normal priority of
+    /// the same scheduler. While they are analyzed all workers that are
+    /// busy with tracks of normal priority are suspended, and an additional
+    /// worker thread is reserved for them in case all other workers are busy.
+    ///
+    /// The priority only applies within a single scheduler. Other schedulers,
+    /// e.g. for the batch analysis of the library, are not affected.
+    ///
+    /// The priority only decides when a track is analyzed, not how. Tracks
+    /// are always decoded from start to end, there is no region-first
+    /// analysis around the play position or the hotcues. Like for all
+    /// tracks, only the waveform becomes visible while it is analyzed, the
+    /// other results are published when the analysis is finished.
+    enum class Priority {
+        Normal,
+        High,
+    };
+
     // Subclass that provides a default constructor and nothing else
     class NullPointer: public Pointer {
       public:
@@ -50,9 +80,15 @@ class TrackAnalysisScheduler : public QObject {
 
     // Schedule single or multiple tracks. After all tracks have been scheduled
     // the caller must invoke resume() once.
-    bool scheduleTrack(AnalyzerScheduledTrack track);
+    bool scheduleTrack(AnalyzerScheduledTrack track, Priority priority = Priority::Normal);
     int scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks);
 
+    /// Limits the number of workers that analyze tracks with a normal
+    /// priority. If the limit is lowered while the workers are busy the
+    /// workers beyond the limit are suspended until the others have
+    /// finished their current track.
+    void setMaxActiveWorkers(int maxActiveWorkers);
+
   public slots:
     void suspend();
 
@@ -73,6 +109,9 @@ class TrackAnalysisScheduler : public QObject {
   private slots:
     void onWorkerThreadProgress(int threadId, AnalyzerThreadState threadState, TrackId trackId, AnalyzerProgress analyzerProgress);
 
+    // Adjusts the number of active workers in the background mode
+    void slotAdaptActiveWorkers();
+
   private:
     // Owns an analyzer thread and buffers the most recent progress update
     // received from this thread during analysis. It does not need to be
@@ -80,9 +119,14 @@ class TrackAnalysisScheduler : public QObject {
     // that runs the TrackAnalysisScheduler.
     class Worker {
       public:
-        explicit Worker(AnalyzerThread::Pointer thread = AnalyzerThread::NullPointer())
-            : m_thread(std::move(thread)),
-              m_analyzerProgress(kAnalyzerProgressUnknown) {
+        explicit Worker(
+                AnalyzerThread::Pointer thread = AnalyzerThread::NullPointer(),
+                bool reserved = false)
+                : m_thread(std::move(thread)),
+                  m_analyzerProgress(kAnalyzerProgressUnknown),
+                  m_reserved(reserved),
+                  m_priority(Priority::Normal),
+                  m_preempted(false) {
         }
         Worker(const Worker&) = delete;
         Worker(Worker&&) = default;
@@ -100,9 +144,47 @@ class TrackAnalysisScheduler : public QObject {
             return m_analyzerProgress;
         }
 
-        bool submitNextTrack(const AnalyzerTrack& track) {
+        // Reserved workers only analyze tracks with a high priority
+        bool isReserved() const {
+            return m_reserved;
+        }
+
+        // The id of the submitted track until it has been reported
+        // back as done
+        const TrackId& trackId() const {
+            return m_trackId;
+        }
+
+        Priority priority() const {
+            return m_priority;
+        }
+
+        void raisePriority() {
+            m_priority = Priority::High;
+        }
+
+        bool isPreempted() const {
+            return m_preempted;
+        }
+
+        void setPreempted(bool preempted) {
+            m_preempted = preempted;
+        }
+
+        bool submitNextTrack(const AnalyzerTrack& track, Priority priority) {
             DEBUG_ASSERT(m_thread);
-            return m_thread->submitNextTrack(std::move(track));
+            const TrackId trackId = track.getTrack()->getId();
+            if (!m_thread->submitNextTrack(track)) {
+                return false;
+            }
+            m_trackId = trackId;
+            m_priority = priority;
+            return true;
+        }
+
+        void onTrackDone() {
+            m_trackId = TrackId();
+            m_priority = Priority::Normal;
         }
 
         void suspendThread() {
@@ -132,27 +214,77 @@ class TrackAnalysisScheduler : public QObject {
             DEBUG_ASSERT(m_thread);
             m_thread.reset();
             m_analyzerProgress = kAnalyzerProgressUnknown;
+            onTrackDone();
         }
 
       private:
         AnalyzerThread::Pointer m_thread;
         AnalyzerProgress m_analyzerProgress;
+        bool m_reserved;
+        TrackId m_trackId;
+        Priority m_priority;
+        bool m_preempted;
     };
 
+    void addWorker(bool reserved);
+
     bool submitNextTrack(Worker* worker);
+    bool submitNextQueuedTrack(
+            Worker* worker,
+            std::deque<AnalyzerScheduledTrack>* pQueuedTracks,
+            Priority priority);
+    void dequeueTrack(std::deque<AnalyzerScheduledTrack>* pQueuedTracks);
+
+    // Suspends or resumes the workers that are busy with tracks of
+    // normal priority depending on pending tracks with high priority
+    // and the maximum number of active workers
+    void updatePreemptedWorkers();
+
+    int busyWorkersCount() const;
+    // Wakes up idle workers that are allowed to fetch the next track
+    void wakeIdleWorkers();
+
     void emitProgressOrFinished();
 
     bool allTracksFinished() const {
         return m_queuedTracks.empty() &&
+                m_priorityTracks.empty() &&
                 m_pendingTrackIds.empty();
     }
 
     const std::unique_ptr<const TrackAnalysisSchedulerEnvironment> m_pEnvironment;
 
+    // Needed for adding the reserved worker on demand
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const UserSettingsPointer m_pConfig;
+    const AnalyzerModeFlags m_modeFlags;
+
     std::vector<Worker> m_workers;
 
+    // Suspended by suspend() until resumed by resume()
+    bool m_suspended;
+
     std::deque<AnalyzerScheduledTrack> m_queuedTracks;
 
+    std::deque<AnalyzerScheduledTrack> m_priorityTracks;
+
+    // Only tracks with a normal priority are limited. The limit is adapted
+    // in the background mode (AnalyzerModeFlags::LowPriority) while
+    // tracks are analyzed by measuring the decoding throughput of all
+    // workers. More workers are only kept if they actually increase
+    // the throughput, i.e. not if the decoding is I/O bound or if no
+    // idle cores are available. The headroom of the audio engine always
+    // takes precedence.
+    int m_maxActiveWorkers;
+    QTimer m_adaptActiveWorkersTimer;
+    qint64 m_lastDecodedFrameCount;
+    double m_lastThroughput;
+    // -1, 0, or +1 depending on the previous adjustment
+    int m_lastActiveWorkersChange;
+    // Intervals to wait until probing more workers again
+    int m_holdActiveWorkersCount;
+    PerformanceTimer m_throughputTimer;
+
     // Tracks that have already been submitted to workers
     // and not yet reported back as finished.
     std::set<TrackId> m_pendingTrackIds;
@@ -165,4 +297,6 @@ class TrackAnalysisScheduler : public QObject {
 
     typedef std::chrono::steady_clock Clock;
     Clock::time_point m_lastProgressEmittedAt;
+
+    FRIEND_TEST(TrackAnalysisSchedulerTest, LowerMaxActiveWorkersWhileBusy);
 };
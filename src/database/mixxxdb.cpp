@@ -3,6 +3,7 @@
 #include <QDir>
 
 #include "database/schemamanager.h"
+#include "library/library_prefs.h"
 #include "moc_mixxxdb.cpp"
 #include "util/assert.h"
 #include "util/logger.h"
@@ -12,7 +13,7 @@
 const QString MixxxDb::kDefaultSchemaFile(":/schema.xml");
 
 //static
-const int MixxxDb::kRequiredSchemaVersion = 39;
+const int MixxxDb::kRequiredSchemaVersion = 41;
 
 namespace {
 
@@ -30,6 +31,37 @@ const QString kUserName = QStringLiteral("mixxx");
 
 const QString kPassword = QStringLiteral("mixxx");
 
+// The connection profile for the main Mixxx DB
+QStringList dbConnectionPragmas(
+        const UserSettingsPointer& pConfig) {
+    if (!pConfig->getValue(
+                mixxx::library::prefs::kDatabaseTuningEnabledConfigKey,
+                mixxx::library::prefs::kDatabaseTuningEnabledDefault)) {
+        // The journal mode is stored persistently in the database
+        // file and needs to be reverted explicitly
+        return {QStringLiteral("PRAGMA journal_mode=DELETE")};
+    }
+    const int cacheSizeMiB = pConfig->getValue(
+            mixxx::library::prefs::kDatabaseCacheSizeMiBConfigKey,
+            mixxx::library::prefs::kDatabaseCacheSizeMiBDefault);
+    const int mmapSizeMiB = pConfig->getValue(
+            mixxx::library::prefs::kDatabaseMmapSizeMiBConfigKey,
+            mixxx::library::prefs::kDatabaseMmapSizeMiBDefault);
+    return {
+            // Readers in the GUI thread don't wait for writers in
+            // other threads, e.g. the library scanner, and vice versa
+            QStringLiteral("PRAGMA journal_mode=WAL"),
+            // Durable enough in WAL mode, only the most recent
+            // transactions might get lost on power failure
+            QStringLiteral("PRAGMA synchronous=NORMAL"),
+            // Negative values are interpreted as KiB instead of pages
+            QStringLiteral("PRAGMA cache_size=-%1").arg(cacheSizeMiB * 1024),
+            QStringLiteral("PRAGMA mmap_size=%1")
+                    .arg(static_cast<qint64>(mmapSizeMiB) * 1024 * 1024),
+            QStringLiteral("PRAGMA temp_store=MEMORY"),
+    };
+}
+
 // The connection parameters for the main Mixxx DB
 mixxx::DbConnection::Params dbConnectionParams(
         const UserSettingsPointer& pConfig,
@@ -58,6 +90,9 @@ mixxx::DbConnection::Params dbConnectionParams(
     }
     params.userName = kUserName;
     params.password = kPassword;
+    if (!inMemoryConnection) {
+        params.pragmas = dbConnectionPragmas(pConfig);
+    }
     return params;
 }
 
@@ -3,6 +3,7 @@
 #include <QDomElement>
 #include <QDomNode>
 #include <QDomNodeList>
+#include <QRegularExpression>
 
 #include "util/assert.h"
 #include "util/db/fwdsqlquery.h"
@@ -25,6 +26,44 @@ const QString SETTINGS_VERSION_KEY = QStringLiteral("mixxx.schema.version");
 const QString SETTINGS_LASTUSED_VERSION_KEY = QStringLiteral("mixxx.schema.last_used_version");
 const QString SETTINGS_MINCOMPATIBLE_KEY = QStringLiteral("mixxx.schema.min_compatible_version");
 
+// Leading comments are skipped
+const QRegularExpression kCreateTriggerRegex(
+        QStringLiteral("^(\\s*--[^\\n]*\\n)*\\s*CREATE\\s+(TEMP\\s+|TEMPORARY\\s+)?TRIGGER\\b"),
+        QRegularExpression::CaseInsensitiveOption);
+const QRegularExpression kEndOfTriggerRegex(
+        QStringLiteral("\\bEND\\s*$"),
+        QRegularExpression::CaseInsensitiveOption);
+
+#define OPTIONAL_MIGRATION_SAVEPOINT "optional_migration"
+
+bool execSql(const QSqlDatabase& database, const QString& statement) {
+    FwdSqlQuery query(database, statement);
+    return query.isPrepared() && query.execPrepared();
+}
+
+// Semicolons in schema.xml are statement separators, except within
+// the body of a trigger that ends with END.
+QStringList splitSqlStatements(const QString& sql) {
+    QStringList sqlStatements;
+    QString sqlStatement;
+    const QStringList parts = sql.split(QChar(';'));
+    for (const auto& part : parts) {
+        sqlStatement += part;
+        if (kCreateTriggerRegex.match(sqlStatement).hasMatch() &&
+                !kEndOfTriggerRegex.match(sqlStatement).hasMatch()) {
+            sqlStatement += QChar(';');
+            continue;
+        }
+        sqlStatements.append(sqlStatement);
+        sqlStatement.clear();
+    }
+    // An incomplete trigger fails when it is executed
+    if (!sqlStatement.isEmpty()) {
+        sqlStatements.append(sqlStatement);
+    }
+    return sqlStatements;
+}
+
 std::optional<int> readSchemaVersion(
         const SettingsDAO& settings,
         const QString& key) {
@@ -202,6 +241,9 @@ SchemaManager::Result SchemaManager::upgradeToSchemaVersion(
         QDomElement eSql = revision.firstChildElement("sql");
 
         QString minCompatibleVersion = revision.attribute("min_compatible");
+        // Optional revisions depend on features of SQLite that are not
+        // available in every build. They are skipped if they fail.
+        const bool optional = revision.attribute("optional") == QLatin1String("true");
         // Default the min-compatible version to the current version string if
         // it's not in the schema.xml
         if (minCompatibleVersion.isNull()) {
@@ -225,13 +267,16 @@ SchemaManager::Result SchemaManager::upgradeToSchemaVersion(
 
         SqlTransaction transaction(m_settingsDao.database());
 
-        // TODO(XXX) We can't have semicolons in schema.xml for anything other
-        // than statement separators.
-        QStringList sqlStatements = sql.split(";");
+        QStringList sqlStatements = splitSqlStatements(sql);
 
         QStringListIterator it(sqlStatements);
 
         bool result = true;
+        if (optional) {
+            // Only the changes of this revision are rolled back on failure
+            result = execSql(m_settingsDao.database(),
+                    QStringLiteral("SAVEPOINT " OPTIONAL_MIGRATION_SAVEPOINT));
+        }
         while (result && it.hasNext()) {
             QString statement = it.next().trimmed();
             if (statement.isEmpty()) {
@@ -258,6 +303,20 @@ SchemaManager::Result SchemaManager::upgradeToSchemaVersion(
             }
         }
 
+        if (optional) {
+            if (!result) {
+                kLogger.warning()
+                        << "Skipping optional database schema migration"
+                        << "to version" << nextVersion;
+                result = execSql(m_settingsDao.database(),
+                        QStringLiteral("ROLLBACK TO " OPTIONAL_MIGRATION_SAVEPOINT));
+            }
+            if (!execSql(m_settingsDao.database(),
+                        QStringLiteral("RELEASE " OPTIONAL_MIGRATION_SAVEPOINT))) {
+                result = false;
+            }
+        }
+
         if (result) {
             if (nextVersion > currentVersion) {
                 currentVersion = nextVersion;
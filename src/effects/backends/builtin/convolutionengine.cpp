@@ -0,0 +1,763 @@
+#include "effects/backends/builtin/convolutionengine.h"
+
+#include <dsp/transforms/FFT.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "moc_convolutionengine.cpp"
+#include "sources/audiosourcestereoproxy.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/compatibility/qmutex.h"
+#include "util/defs.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("ConvolutionEngine");
+
+constexpr SINT kMinHeadBlockFrames = 64;
+constexpr SINT kMaxHeadBlockFrames = 1024;
+constexpr SINT kMinTailBlockFrames = 2048;
+
+// Longer impulse responses are truncated
+constexpr SINT kMaxImpulseSeconds = 10;
+// Number of frames that are decoded at once between calls of the yield
+// function while loading an impulse response
+constexpr SINT kLoadChunkFrames = 8192;
+
+// Tail blocks that can be queued for the worker before the audio thread
+// starts dropping them. One entry per engine is sufficient, because an
+// engine only submits a new block after the previous one has completed.
+constexpr int kTailBlockQueueSize = 256;
+
+// Number of loaded impulse responses kept by the worker
+constexpr std::size_t kImpulseCacheSize = 4;
+
+constexpr int kChannelCount = kEngineChannelOutputCount;
+
+/// Split the impulse response into partitions of blockFrames frames and
+/// store the non-redundant half of the spectrum of each zero padded
+/// partition.
+int transformPartitions(
+        const double* pImpulse,
+        SINT impulseFrames,
+        SINT blockFrames,
+        std::vector<double>* pReal,
+        std::vector<double>* pImag) {
+    const int partitionCount =
+            static_cast<int>((impulseFrames + blockFrames - 1) / blockFrames);
+    const SINT bins = blockFrames + 1;
+    pReal->assign(partitionCount * bins, 0.0);
+    pImag->assign(partitionCount * bins, 0.0);
+    if (partitionCount == 0) {
+        return 0;
+    }
+
+    FFTReal fft(static_cast<int>(2 * blockFrames));
+    std::vector<double> timeDomain(2 * blockFrames);
+    std::vector<double> spectrumReal(2 * blockFrames);
+    std::vector<double> spectrumImag(2 * blockFrames);
+    for (int partition = 0; partition < partitionCount; ++partition) {
+        const SINT offset = partition * blockFrames;
+        const SINT frames = math_min(blockFrames, impulseFrames - offset);
+        std::fill(timeDomain.begin(), timeDomain.end(), 0.0);
+        std::copy(pImpulse + offset, pImpulse + offset + frames, timeDomain.begin());
+        fft.forward(timeDomain.data(), spectrumReal.data(), spectrumImag.data());
+        std::copy(spectrumReal.begin(),
+                spectrumReal.begin() + bins,
+                pReal->begin() + partition * bins);
+        std::copy(spectrumImag.begin(),
+                spectrumImag.begin() + bins,
+                pImag->begin() + partition * bins);
+    }
+    return partitionCount;
+}
+
+/// Linear interpolation is sufficient here, because impulse responses are
+/// usually provided in the common sample rates anyway and the reverb tail
+/// is mostly diffuse noise.
+std::vector<double> resample(
+        const std::vector<double>& input,
+        audio::SampleRate inputSampleRate,
+        audio::SampleRate outputSampleRate) {
+    if (inputSampleRate == outputSampleRate || input.empty()) {
+        return input;
+    }
+    const double ratio = static_cast<double>(inputSampleRate) / outputSampleRate;
+    const auto outputFrames = static_cast<SINT>(input.size() / ratio);
+    std::vector<double> output(outputFrames);
+    for (SINT i = 0; i < outputFrames; ++i) {
+        const double position = i * ratio;
+        const auto index = static_cast<std::size_t>(position);
+        const double fraction = position - index;
+        const double next = index + 1 < input.size() ? input[index + 1] : 0.0;
+        output[i] = input[index] + (next - input[index]) * fraction;
+    }
+    return output;
+}
+
+} // anonymous namespace
+
+// static
+ConvolutionPartitioning ConvolutionPartitioning::forFramesPerBuffer(
+        SINT framesPerBuffer) {
+    const auto bufferFrames = static_cast<SINT>(
+            roundUpToPowerOf2(static_cast<unsigned int>(math_max<SINT>(framesPerBuffer, 1))));
+    // Small head blocks keep the latency below the audio buffer size.
+    // The tail blocks must be at least twice the audio buffer size,
+    // otherwise the worker would have to deliver a tail block within
+    // the same callback that submitted it.
+    return ConvolutionPartitioning(
+            math_clamp(bufferFrames / 4, kMinHeadBlockFrames, kMaxHeadBlockFrames),
+            math_max(kMinTailBlockFrames, 2 * bufferFrames));
+}
+
+ConvolutionKernel::ConvolutionKernel(
+        const double* pImpulse,
+        SINT impulseFrames,
+        ConvolutionPartitioning partitioning)
+        : m_partitioning(partitioning) {
+    DEBUG_ASSERT(m_partitioning.isValid());
+    const SINT headFrames = math_min(impulseFrames, m_partitioning.headLengthFrames());
+    m_headPartitionCount = transformPartitions(pImpulse,
+            headFrames,
+            m_partitioning.headBlockFrames(),
+            &m_headReal,
+            &m_headImag);
+    m_tailPartitionCount = transformPartitions(pImpulse + headFrames,
+            impulseFrames - headFrames,
+            m_partitioning.tailBlockFrames(),
+            &m_tailReal,
+            &m_tailImag);
+}
+
+const double* ConvolutionKernel::headReal(int partition) const {
+    return &m_headReal[partition * (m_partitioning.headBlockFrames() + 1)];
+}
+
+const double* ConvolutionKernel::headImag(int partition) const {
+    return &m_headImag[partition * (m_partitioning.headBlockFrames() + 1)];
+}
+
+const double* ConvolutionKernel::tailReal(int partition) const {
+    return &m_tailReal[partition * (m_partitioning.tailBlockFrames() + 1)];
+}
+
+const double* ConvolutionKernel::tailImag(int partition) const {
+    return &m_tailImag[partition * (m_partitioning.tailBlockFrames() + 1)];
+}
+
+// static
+ConvolutionImpulsePointer ConvolutionImpulse::load(
+        const QString& filePath,
+        audio::SampleRate sampleRate,
+        ConvolutionPartitioning partitioning,
+        const std::function<void()>& yieldFn) {
+    VERIFY_OR_DEBUG_ASSERT(sampleRate.isValid() && partitioning.isValid()) {
+        return nullptr;
+    }
+
+    AudioSource::OpenParams openParams;
+    openParams.setChannelCount(kEngineChannelOutputCount);
+    auto pAudioSource = SoundSourceProxy(Track::newTemporary(filePath))
+                                .openAudioSource(openParams);
+    if (!pAudioSource) {
+        kLogger.warning() << "Failed to open impulse response" << filePath;
+        return nullptr;
+    }
+
+    const auto sourceSampleRate = pAudioSource->getSignalInfo().getSampleRate();
+    const auto readRange = intersect(pAudioSource->frameIndexRange(),
+            IndexRange::forward(pAudioSource->frameIndexMin(),
+                    kMaxImpulseSeconds * sourceSampleRate));
+    AudioSourceStereoProxy audioSourceProxy(pAudioSource, kLoadChunkFrames);
+    SampleBuffer sampleBuffer(kLoadChunkFrames * kChannelCount);
+
+    std::vector<double> channels[kChannelCount];
+    for (auto& channel : channels) {
+        channel.reserve(readRange.length());
+    }
+    SINT frameIndex = readRange.start();
+    while (frameIndex < readRange.end()) {
+        const auto chunkRange = IndexRange::forward(frameIndex,
+                math_min(kLoadChunkFrames, readRange.end() - frameIndex));
+        const auto readableSampleFrames = audioSourceProxy.readSampleFrames(
+                WritableSampleFrames(chunkRange,
+                        SampleBuffer::WritableSlice(sampleBuffer.data(),
+                                chunkRange.length() * kChannelCount)));
+        if (readableSampleFrames.frameIndexRange().empty()) {
+            break;
+        }
+        const CSAMPLE* pSamples = readableSampleFrames.readableData();
+        for (SINT i = 0; i < readableSampleFrames.frameLength(); ++i) {
+            for (int c = 0; c < kChannelCount; ++c) {
+                channels[c].push_back(pSamples[i * kChannelCount + c]);
+            }
+        }
+        frameIndex = readableSampleFrames.frameIndexRange().end();
+        yieldFn();
+    }
+    pAudioSource->close();
+
+    double maxEnergy = 0.0;
+    for (auto& channel : channels) {
+        channel = resample(channel, sourceSampleRate, sampleRate);
+        double energy = 0.0;
+        for (const double sample : channel) {
+            energy += sample * sample;
+        }
+        maxEnergy = math_max(maxEnergy, energy);
+    }
+    if (maxEnergy <= 0.0) {
+        kLogger.warning() << "Impulse response is silent" << filePath;
+        return nullptr;
+    }
+
+    // Normalize to unit energy, so the reverb is about as loud as the
+    // input signal regardless of the length of the impulse response
+    const double gain = 1.0 / std::sqrt(maxEnergy);
+    for (auto& channel : channels) {
+        for (double& sample : channel) {
+            sample *= gain;
+        }
+    }
+
+    kLogger.debug() << "Loaded impulse response" << filePath
+                    << channels[0].size() << "frames";
+    return std::make_shared<const ConvolutionImpulse>(partitioning,
+            std::make_unique<ConvolutionKernel>(channels[0].data(),
+                    static_cast<SINT>(channels[0].size()),
+                    partitioning),
+            std::make_unique<ConvolutionKernel>(channels[1].data(),
+                    static_cast<SINT>(channels[1].size()),
+                    partitioning));
+}
+
+ConvolutionEngine::Partitions::Partitions(SINT blockFrames, int partitionCount)
+        : blockFrames(blockFrames),
+          // The delay line needs at least one slot even without partitions
+          partitionCount(math_max(partitionCount, 1)),
+          pFft(std::make_unique<FFTReal>(static_cast<int>(2 * blockFrames))),
+          delayLinePos(0),
+          spectrumReal(2 * blockFrames),
+          spectrumImag(2 * blockFrames),
+          accumReal(blockFrames + 1),
+          accumImag(blockFrames + 1),
+          timeDomain(2 * blockFrames) {
+    for (int c = 0; c < kChannelCount; ++c) {
+        window[c].resize(2 * blockFrames);
+        delayLineReal[c].resize(this->partitionCount * (blockFrames + 1));
+        delayLineImag[c].resize(this->partitionCount * (blockFrames + 1));
+    }
+}
+
+void ConvolutionEngine::Partitions::clear() {
+    for (int c = 0; c < kChannelCount; ++c) {
+        std::fill(window[c].begin(), window[c].end(), 0.0);
+        std::fill(delayLineReal[c].begin(), delayLineReal[c].end(), 0.0);
+        std::fill(delayLineImag[c].begin(), delayLineImag[c].end(), 0.0);
+    }
+    delayLinePos = 0;
+}
+
+ConvolutionEngine::ConvolutionEngine(ConvolutionImpulsePointer pImpulse)
+        : m_pImpulse(std::move(pImpulse)),
+          m_partitioning(m_pImpulse->partitioning()),
+          m_head(m_partitioning.headBlockFrames(),
+                  m_pImpulse->kernel(0).headPartitionCount()),
+          m_headBlockPos(0),
+          m_headBlockCount(0),
+          m_firstValidTailBlock(0),
+          m_pTailOutput(nullptr),
+          m_tailOutputBlock{-1, -1},
+          m_tailSubmittedBlock(-1),
+          m_tailCompletedBlock(-1),
+          m_tailFirstValidBlock(0),
+          m_tail(m_partitioning.tailBlockFrames(),
+                  m_pImpulse->kernel(0).tailPartitionCount()),
+          m_tailProcessedBlock(-1) {
+    const SINT headBlockFrames = m_partitioning.headBlockFrames();
+    const SINT tailBlockFrames = m_partitioning.tailBlockFrames();
+    for (int c = 0; c < kChannelCount; ++c) {
+        m_headInput[c].resize(headBlockFrames);
+        m_headOutput[c].resize(headBlockFrames);
+        m_tailCollect[c].resize(tailBlockFrames);
+        m_tailInput[c].resize(tailBlockFrames);
+        m_tailOutput[0][c].resize(tailBlockFrames);
+        m_tailOutput[1][c].resize(tailBlockFrames);
+    }
+}
+
+ConvolutionEngine::~ConvolutionEngine() = default;
+
+void ConvolutionEngine::clear() {
+    m_head.clear();
+    for (int c = 0; c < kChannelCount; ++c) {
+        std::fill(m_headInput[c].begin(), m_headInput[c].end(), 0.0);
+        std::fill(m_headOutput[c].begin(), m_headOutput[c].end(), 0.0);
+        std::fill(m_tailCollect[c].begin(), m_tailCollect[c].end(), 0.0);
+    }
+    m_headBlockPos = 0;
+    // Results of tail blocks that have been submitted before are stale.
+    // The worker clears its delay line before processing the first valid
+    // block, so the large tail buffers are never touched by this thread.
+    m_firstValidTailBlock =
+            m_headBlockCount * m_partitioning.headBlockFrames() /
+            m_partitioning.tailBlockFrames();
+    m_pTailOutput = nullptr;
+    m_tailFirstValidBlock.store(m_firstValidTailBlock, std::memory_order_release);
+}
+
+void ConvolutionEngine::process(
+        ConvolutionWorker* pWorker,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        SINT frames) {
+    const SINT headBlockFrames = m_partitioning.headBlockFrames();
+    SINT frame = 0;
+    while (frame < frames) {
+        const SINT chunkFrames = math_min(headBlockFrames - m_headBlockPos, frames - frame);
+        for (SINT i = 0; i < chunkFrames; ++i) {
+            const SINT sampleIndex = (frame + i) * kChannelCount;
+            for (int c = 0; c < kChannelCount; ++c) {
+                m_headInput[c][m_headBlockPos + i] = pInput[sampleIndex + c];
+                pOutput[sampleIndex + c] =
+                        static_cast<CSAMPLE>(m_headOutput[c][m_headBlockPos + i]);
+            }
+        }
+        frame += chunkFrames;
+        m_headBlockPos += chunkFrames;
+        if (m_headBlockPos == headBlockFrames) {
+            processHeadBlock(pWorker);
+            m_headBlockPos = 0;
+        }
+    }
+}
+
+void ConvolutionEngine::convolveBlock(
+        Partitions* pPartitions,
+        int channel,
+        KernelPartitionFn kernelReal,
+        KernelPartitionFn kernelImag,
+        const double* pInput,
+        double* pOutput) {
+    const SINT blockFrames = pPartitions->blockFrames;
+    const SINT bins = blockFrames + 1;
+    const ConvolutionKernel& kernel = m_pImpulse->kernel(channel);
+
+    // Overlap-save: transform the previous and the current input block
+    std::vector<double>& window = pPartitions->window[channel];
+    std::copy(window.begin() + blockFrames, window.end(), window.begin());
+    std::copy(pInput, pInput + blockFrames, window.begin() + blockFrames);
+    pPartitions->pFft->forward(window.data(),
+            pPartitions->spectrumReal.data(),
+            pPartitions->spectrumImag.data());
+    const SINT delayLineOffset = pPartitions->delayLinePos * bins;
+    std::copy(pPartitions->spectrumReal.begin(),
+            pPartitions->spectrumReal.begin() + bins,
+            pPartitions->delayLineReal[channel].begin() + delayLineOffset);
+    std::copy(pPartitions->spectrumImag.begin(),
+            pPartitions->spectrumImag.begin() + bins,
+            pPartitions->delayLineImag[channel].begin() + delayLineOffset);
+
+    // Multiply the spectra of the past input blocks with the
+    // corresponding kernel partitions and sum them up
+    double* pAccumReal = pPartitions->accumReal.data();
+    double* pAccumImag = pPartitions->accumImag.data();
+    std::fill(pAccumReal, pAccumReal + bins, 0.0);
+    std::fill(pAccumImag, pAccumImag + bins, 0.0);
+    const int kernelPartitionCount = math_min(pPartitions->partitionCount,
+            kernelReal == &ConvolutionKernel::headReal
+                    ? kernel.headPartitionCount()
+                    : kernel.tailPartitionCount());
+    for (int partition = 0; partition < kernelPartitionCount; ++partition) {
+        const int slot = (pPartitions->delayLinePos - partition + pPartitions->partitionCount) %
+                pPartitions->partitionCount;
+        const double* pInputReal = &pPartitions->delayLineReal[channel][slot * bins];
+        const double* pInputImag = &pPartitions->delayLineImag[channel][slot * bins];
+        const double* pKernelReal = (kernel.*kernelReal)(partition);
+        const double* pKernelImag = (kernel.*kernelImag)(partition);
+        for (SINT bin = 0; bin < bins; ++bin) {
+            pAccumReal[bin] += pInputReal[bin] * pKernelReal[bin] -
+                    pInputImag[bin] * pKernelImag[bin];
+            pAccumImag[bin] += pInputReal[bin] * pKernelImag[bin] +
+                    pInputImag[bin] * pKernelReal[bin];
+        }
+    }
+
+    // Only the second half of the circular convolution is aliasing free
+    pPartitions->pFft->inverse(pAccumReal, pAccumImag, pPartitions->timeDomain.data());
+    std::copy(pPartitions->timeDomain.begin() + blockFrames,
+            pPartitions->timeDomain.end(),
+            pOutput);
+}
+
+void ConvolutionEngine::processHeadBlock(ConvolutionWorker* pWorker) {
+    const SINT headBlockFrames = m_partitioning.headBlockFrames();
+    const SINT tailBlockFrames = m_partitioning.tailBlockFrames();
+    const SINT position = m_headBlockCount * headBlockFrames;
+    const SINT tailBlock = position / tailBlockFrames;
+    const SINT tailOffset = position % tailBlockFrames;
+
+    if (tailOffset == 0) {
+        // The tail kernel starts two tail blocks after the impulse, so the
+        // tail output that belongs here has been submitted two blocks ago.
+        const SINT resultBlock = tailBlock - 2;
+        m_pTailOutput = nullptr;
+        if (resultBlock >= m_firstValidTailBlock) {
+            const int slot = static_cast<int>(resultBlock % 2);
+            if (m_tailOutputBlock[slot].load(std::memory_order_acquire) == resultBlock) {
+                m_pTailOutput = m_tailOutput[slot];
+            }
+        }
+    }
+
+    for (int c = 0; c < kChannelCount; ++c) {
+        convolveBlock(&m_head,
+                c,
+                &ConvolutionKernel::headReal,
+                &ConvolutionKernel::headImag,
+                m_headInput[c].data(),
+                m_headOutput[c].data());
+        if (m_pTailOutput) {
+            const double* pTail = m_pTailOutput[c].data() + tailOffset;
+            for (SINT i = 0; i < headBlockFrames; ++i) {
+                m_headOutput[c][i] += pTail[i];
+            }
+        }
+        std::copy(m_headInput[c].begin(),
+                m_headInput[c].end(),
+                m_tailCollect[c].begin() + tailOffset);
+    }
+    m_head.delayLinePos = (m_head.delayLinePos + 1) % m_head.partitionCount;
+    ++m_headBlockCount;
+
+    if (tailOffset + headBlockFrames < tailBlockFrames ||
+            m_pImpulse->kernel(0).tailPartitionCount() == 0) {
+        return;
+    }
+    // A full tail block has been collected. Only submit it if the worker
+    // has finished the previous one, otherwise this tail block is dropped.
+    const SINT previousBlock = m_tailSubmittedBlock.load(std::memory_order_relaxed);
+    if (m_tailCompletedBlock.load(std::memory_order_acquire) != previousBlock) {
+        return;
+    }
+    for (int c = 0; c < kChannelCount; ++c) {
+        m_tailInput[c].swap(m_tailCollect[c]);
+    }
+    m_tailSubmittedBlock.store(tailBlock, std::memory_order_release);
+    if (!pWorker->scheduleTailBlock(this)) {
+        m_tailSubmittedBlock.store(previousBlock, std::memory_order_relaxed);
+    }
+}
+
+void ConvolutionEngine::processTailBlock() {
+    const SINT block = m_tailSubmittedBlock.load(std::memory_order_acquire);
+    if (block <= m_tailProcessedBlock) {
+        return;
+    }
+
+    const SINT firstValidBlock = m_tailFirstValidBlock.load(std::memory_order_acquire);
+    if (m_tailProcessedBlock < firstValidBlock && block >= firstValidBlock) {
+        m_tail.clear();
+    } else {
+        // Blocks that have been dropped by the audio thread are silence
+        const SINT skippedBlocks = math_min<SINT>(
+                block - m_tailProcessedBlock - 1, m_tail.partitionCount);
+        if (skippedBlocks > 0) {
+            for (int c = 0; c < kChannelCount; ++c) {
+                std::fill(m_tail.window[c].begin(), m_tail.window[c].end(), 0.0);
+            }
+        }
+        const SINT bins = m_tail.blockFrames + 1;
+        for (SINT i = 0; i < skippedBlocks; ++i) {
+            for (int c = 0; c < kChannelCount; ++c) {
+                const auto offset = m_tail.delayLinePos * bins;
+                std::fill_n(m_tail.delayLineReal[c].begin() + offset, bins, 0.0);
+                std::fill_n(m_tail.delayLineImag[c].begin() + offset, bins, 0.0);
+            }
+            m_tail.delayLinePos = (m_tail.delayLinePos + 1) % m_tail.partitionCount;
+        }
+    }
+
+    const int slot = static_cast<int>(block % 2);
+    for (int c = 0; c < kChannelCount; ++c) {
+        convolveBlock(&m_tail,
+                c,
+                &ConvolutionKernel::tailReal,
+                &ConvolutionKernel::tailImag,
+                m_tailInput[c].data(),
+                m_tailOutput[slot][c].data());
+    }
+    m_tail.delayLinePos = (m_tail.delayLinePos + 1) % m_tail.partitionCount;
+    m_tailProcessedBlock = block;
+
+    m_tailOutputBlock[slot].store(block, std::memory_order_release);
+    m_tailCompletedBlock.store(block, std::memory_order_release);
+}
+
+namespace {
+
+constexpr int kImpulseIndexBits = 16;
+constexpr int kSampleRateBits = 24;
+constexpr int kFramesPerBufferBits = 16;
+
+quint64 requestKey(
+        int impulseIndex,
+        audio::SampleRate sampleRate,
+        SINT framesPerBuffer) {
+    // The key is packed into a single word, so it can be handed
+    // to the worker atomically. 0 is reserved for "no request".
+    return (static_cast<quint64>(impulseIndex + 1)
+                   << (kSampleRateBits + kFramesPerBufferBits)) |
+            (static_cast<quint64>(sampleRate.value()) << kFramesPerBufferBits) |
+            static_cast<quint64>(framesPerBuffer);
+}
+
+int impulseIndexFromKey(quint64 key) {
+    return static_cast<int>(key >> (kSampleRateBits + kFramesPerBufferBits)) - 1;
+}
+
+audio::SampleRate sampleRateFromKey(quint64 key) {
+    return audio::SampleRate(static_cast<audio::SampleRate::value_t>(
+            (key >> kFramesPerBufferBits) & ((1 << kSampleRateBits) - 1)));
+}
+
+SINT framesPerBufferFromKey(quint64 key) {
+    return static_cast<SINT>(key & ((1 << kFramesPerBufferBits) - 1));
+}
+
+static_assert(audio::SampleRate::kValueMax < (1 << kSampleRateBits));
+static_assert(kMaxEngineFrames < (1 << kFramesPerBufferBits));
+
+} // anonymous namespace
+
+ConvolutionEngineSlot::ConvolutionEngineSlot(const QStringList& impulseFilePaths)
+        : m_impulseFilePaths(impulseFilePaths),
+          m_pWorker(ConvolutionWorker::acquire()),
+          m_pActiveEngine(nullptr),
+          m_requestedKey(0),
+          m_pendingKey(0),
+          m_pPendingEngine(nullptr),
+          m_pRetiredEngine(nullptr),
+          m_deliveredKey(0) {
+    m_pWorker->addSlot(this);
+}
+
+ConvolutionEngineSlot::~ConvolutionEngineSlot() {
+    // Hands over all engines to the worker for disposal
+    m_pWorker->removeSlot(this);
+}
+
+void ConvolutionEngineSlot::request(
+        int impulseIndex,
+        audio::SampleRate sampleRate,
+        SINT framesPerBuffer) {
+    if (impulseIndex < 0 || impulseIndex >= m_impulseFilePaths.size()) {
+        return;
+    }
+    const quint64 key = requestKey(impulseIndex, sampleRate, framesPerBuffer);
+    if (key == m_requestedKey) {
+        return;
+    }
+    m_requestedKey = key;
+    m_pendingKey.store(key, std::memory_order_release);
+    m_pWorker->wake();
+}
+
+ConvolutionEngine* ConvolutionEngineSlot::engine() {
+    // The previously active engine must have been picked up by the
+    // worker before the next one can be swapped in
+    if (m_pRetiredEngine.load(std::memory_order_acquire) == nullptr) {
+        ConvolutionEngine* pEngine =
+                m_pPendingEngine.exchange(nullptr, std::memory_order_acq_rel);
+        if (pEngine) {
+            m_pRetiredEngine.store(m_pActiveEngine, std::memory_order_release);
+            m_pActiveEngine = pEngine;
+            m_pWorker->wake();
+        }
+    }
+    return m_pActiveEngine;
+}
+
+namespace {
+
+std::weak_ptr<ConvolutionWorker> s_pWorker;
+
+} // anonymous namespace
+
+// static
+std::shared_ptr<ConvolutionWorker> ConvolutionWorker::acquire() {
+    auto pWorker = s_pWorker.lock();
+    if (!pWorker) {
+        pWorker = std::shared_ptr<ConvolutionWorker>(new ConvolutionWorker());
+        pWorker->start(QThread::HighPriority);
+        s_pWorker = pWorker;
+    }
+    return pWorker;
+}
+
+ConvolutionWorker::ConvolutionWorker()
+        : m_tailBlocks(kTailBlockQueueSize),
+          m_stop(false) {
+}
+
+ConvolutionWorker::~ConvolutionWorker() {
+    m_stop.store(true);
+    m_semaWork.release();
+    wait();
+    disposeRetiredEngines();
+    DEBUG_ASSERT(m_slots.empty());
+}
+
+bool ConvolutionWorker::scheduleTailBlock(ConvolutionEngine* pEngine) {
+    if (m_tailBlocks.write(&pEngine, 1) != 1) {
+        return false;
+    }
+    m_semaWork.release();
+    return true;
+}
+
+void ConvolutionWorker::wake() {
+    m_semaWork.release();
+}
+
+void ConvolutionWorker::addSlot(ConvolutionEngineSlot* pSlot) {
+    const auto locker = lockMutex(&m_mutex);
+    m_slots.push_back(pSlot);
+}
+
+void ConvolutionWorker::removeSlot(ConvolutionEngineSlot* pSlot) {
+    {
+        const auto locker = lockMutex(&m_mutex);
+        m_slots.erase(std::remove(m_slots.begin(), m_slots.end(), pSlot), m_slots.end());
+        for (ConvolutionEngine* pEngine : {pSlot->m_pActiveEngine,
+                     pSlot->m_pPendingEngine.exchange(nullptr),
+                     pSlot->m_pRetiredEngine.exchange(nullptr)}) {
+            if (pEngine) {
+                m_retiredEngines.push_back(pEngine);
+            }
+        }
+        pSlot->m_pActiveEngine = nullptr;
+    }
+    m_semaWork.release();
+}
+
+void ConvolutionWorker::run() {
+    QThread::currentThread()->setObjectName(QStringLiteral("ConvolutionWorker"));
+    while (!m_stop.load()) {
+        m_semaWork.acquire();
+        // Multiple wake ups are handled at once
+        m_semaWork.tryAcquire(m_semaWork.available());
+
+        processTailBlocks();
+        deliverRequestedEngines();
+        disposeRetiredEngines();
+    }
+}
+
+void ConvolutionWorker::processTailBlocks() {
+    ConvolutionEngine* pEngine;
+    while (m_tailBlocks.read(&pEngine, 1) == 1) {
+        pEngine->processTailBlock();
+    }
+}
+
+void ConvolutionWorker::deliverRequestedEngines() {
+    // Collect the requests while holding the lock, but build the engines
+    // without it to not block the main thread
+    struct Request {
+        ConvolutionEngineSlot* pSlot;
+        quint64 key;
+        QString filePath;
+    };
+    std::vector<Request> requests;
+    {
+        const auto locker = lockMutex(&m_mutex);
+        for (ConvolutionEngineSlot* pSlot : m_slots) {
+            if (ConvolutionEngine* pEngine = pSlot->m_pRetiredEngine.exchange(nullptr)) {
+                m_retiredEngines.push_back(pEngine);
+            }
+            const quint64 key = pSlot->m_pendingKey.load(std::memory_order_acquire);
+            if (key != 0 && key != pSlot->m_deliveredKey) {
+                requests.push_back(Request{pSlot,
+                        key,
+                        pSlot->m_impulseFilePaths.value(impulseIndexFromKey(key))});
+            }
+        }
+    }
+
+    for (const auto& request : requests) {
+        const auto pImpulse = loadImpulse(request.filePath,
+                sampleRateFromKey(request.key),
+                ConvolutionPartitioning::forFramesPerBuffer(
+                        framesPerBufferFromKey(request.key)));
+        auto pEngine = pImpulse ? std::make_unique<ConvolutionEngine>(pImpulse) : nullptr;
+
+        const auto locker = lockMutex(&m_mutex);
+        if (std::find(m_slots.begin(), m_slots.end(), request.pSlot) == m_slots.end()) {
+            // The slot has been removed in the meantime
+            continue;
+        }
+        request.pSlot->m_deliveredKey = request.key;
+        if (!pEngine) {
+            // Keep the current engine if loading failed
+            continue;
+        }
+        if (ConvolutionEngine* pPrevious =
+                        request.pSlot->m_pPendingEngine.exchange(pEngine.release())) {
+            m_retiredEngines.push_back(pPrevious);
+        }
+    }
+}
+
+ConvolutionImpulsePointer ConvolutionWorker::loadImpulse(
+        const QString& filePath,
+        audio::SampleRate sampleRate,
+        ConvolutionPartitioning partitioning) {
+    const QString cacheKey = QStringLiteral("%1:%2:%3:%4")
+                                     .arg(filePath,
+                                             QString::number(sampleRate.value()),
+                                             QString::number(partitioning.headBlockFrames()),
+                                             QString::number(partitioning.tailBlockFrames()));
+    for (const auto& entry : m_impulseCache) {
+        if (entry.first == cacheKey) {
+            return entry.second;
+        }
+    }
+
+    // Tail blocks of other engines keep being served while decoding
+    const auto pImpulse = ConvolutionImpulse::load(
+            filePath, sampleRate, partitioning, [this] {
+                processTailBlocks();
+            });
+    if (pImpulse) {
+        if (m_impulseCache.size() >= kImpulseCacheSize) {
+            m_impulseCache.erase(m_impulseCache.begin());
+        }
+        m_impulseCache.emplace_back(cacheKey, pImpulse);
+    }
+    return pImpulse;
+}
+
+void ConvolutionWorker::disposeRetiredEngines() {
+    std::vector<ConvolutionEngine*> retiredEngines;
+    {
+        const auto locker = lockMutex(&m_mutex);
+        retiredEngines.swap(m_retiredEngines);
+    }
+    // Tail blocks that have been scheduled before the engine was
+    // retired must be processed before it is deleted
+    processTailBlocks();
+    for (ConvolutionEngine* pEngine : retiredEngines) {
+        delete pEngine;
+    }
+}
+
+} // namespace mixxx
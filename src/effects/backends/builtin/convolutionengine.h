@@ -0,0 +1,352 @@
+#pragma once
+
+#include <QMutex>
+#include <QSemaphore>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "engine/engine.h"
+#include "util/class.h"
+#include "util/fifo.h"
+#include "util/types.h"
+
+class FFTReal;
+
+namespace mixxx {
+
+/// The two partition sizes of a non-uniformly partitioned convolution.
+///
+/// The head of the impulse response, i.e. the first headLengthFrames(),
+/// is split into small partitions of headBlockFrames that are convolved in
+/// the audio callback. The tail is split into large partitions of
+/// tailBlockFrames that are convolved on the ConvolutionWorker thread.
+/// The head is exactly two tail blocks long, which gives the worker the
+/// duration of one full tail block to deliver its result.
+class ConvolutionPartitioning {
+  public:
+    constexpr ConvolutionPartitioning()
+            : m_headBlockFrames(0),
+              m_tailBlockFrames(0) {
+    }
+
+    /// Derive the partition sizes from the size of the audio buffer
+    static ConvolutionPartitioning forFramesPerBuffer(SINT framesPerBuffer);
+
+    SINT headBlockFrames() const {
+        return m_headBlockFrames;
+    }
+    SINT tailBlockFrames() const {
+        return m_tailBlockFrames;
+    }
+    SINT headLengthFrames() const {
+        return 2 * m_tailBlockFrames;
+    }
+
+    bool isValid() const {
+        return m_headBlockFrames > 0 && m_tailBlockFrames >= m_headBlockFrames;
+    }
+
+    friend bool operator==(
+            const ConvolutionPartitioning& lhs,
+            const ConvolutionPartitioning& rhs) {
+        return lhs.m_headBlockFrames == rhs.m_headBlockFrames &&
+                lhs.m_tailBlockFrames == rhs.m_tailBlockFrames;
+    }
+
+  private:
+    ConvolutionPartitioning(SINT headBlockFrames, SINT tailBlockFrames)
+            : m_headBlockFrames(headBlockFrames),
+              m_tailBlockFrames(tailBlockFrames) {
+    }
+
+    SINT m_headBlockFrames;
+    SINT m_tailBlockFrames;
+};
+
+/// The spectra of all partitions of a single channel of an impulse
+/// response. Only the non-redundant bins [0, blockFrames] of each
+/// 2 * blockFrames point FFT are stored.
+class ConvolutionKernel {
+  public:
+    ConvolutionKernel(
+            const double* pImpulse,
+            SINT impulseFrames,
+            ConvolutionPartitioning partitioning);
+
+    int headPartitionCount() const {
+        return m_headPartitionCount;
+    }
+    int tailPartitionCount() const {
+        return m_tailPartitionCount;
+    }
+
+    const double* headReal(int partition) const;
+    const double* headImag(int partition) const;
+    const double* tailReal(int partition) const;
+    const double* tailImag(int partition) const;
+
+  private:
+    const ConvolutionPartitioning m_partitioning;
+    int m_headPartitionCount;
+    int m_tailPartitionCount;
+    std::vector<double> m_headReal;
+    std::vector<double> m_headImag;
+    std::vector<double> m_tailReal;
+    std::vector<double> m_tailImag;
+};
+
+/// An impulse response in the frequency domain, ready to be convolved
+/// with a stereo signal. Instances are immutable and shared between all
+/// ConvolutionEngines that use the same file.
+class ConvolutionImpulse {
+  public:
+    /// Decode an impulse response file with SoundSourceProxy, resample it to
+    /// sampleRate and transform it into the frequency domain. yieldFn is
+    /// invoked periodically while decoding to allow the caller to serve
+    /// pending work. Returns nullptr if the file could not be decoded.
+    static std::shared_ptr<const ConvolutionImpulse> load(
+            const QString& filePath,
+            audio::SampleRate sampleRate,
+            ConvolutionPartitioning partitioning,
+            const std::function<void()>& yieldFn);
+
+    ConvolutionImpulse(
+            ConvolutionPartitioning partitioning,
+            std::unique_ptr<ConvolutionKernel> pLeftKernel,
+            std::unique_ptr<ConvolutionKernel> pRightKernel)
+            : m_partitioning(partitioning),
+              m_kernels{std::move(pLeftKernel), std::move(pRightKernel)} {
+    }
+
+    ConvolutionPartitioning partitioning() const {
+        return m_partitioning;
+    }
+
+    const ConvolutionKernel& kernel(int channel) const {
+        return *m_kernels[channel];
+    }
+
+  private:
+    const ConvolutionPartitioning m_partitioning;
+    const std::unique_ptr<ConvolutionKernel> m_kernels[kEngineChannelOutputCount];
+};
+
+typedef std::shared_ptr<const ConvolutionImpulse> ConvolutionImpulsePointer;
+
+class ConvolutionWorker;
+
+/// Runtime state for convolving a stereo signal with a ConvolutionImpulse.
+///
+/// All buffers are allocated in the constructor, so process() is safe to
+/// call from the audio callback. The head partitions are convolved in
+/// process() with a fixed amount of work per head block. Every time a full
+/// tail block has been collected it is handed to the ConvolutionWorker and
+/// the result is mixed in two tail blocks later. If the worker misses its
+/// deadline the tail contribution of that block is dropped instead of
+/// blocking the audio thread.
+///
+/// The output is delayed by headBlockFrames() frames.
+class ConvolutionEngine {
+  public:
+    explicit ConvolutionEngine(ConvolutionImpulsePointer pImpulse);
+    ~ConvolutionEngine();
+
+    const ConvolutionImpulsePointer& impulse() const {
+        return m_pImpulse;
+    }
+
+    SINT latencyFrames() const {
+        return m_partitioning.headBlockFrames();
+    }
+
+    /// Called from the audio thread
+    void process(
+            ConvolutionWorker* pWorker,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            SINT frames);
+
+    /// Called from the audio thread. Drops all buffered signal.
+    void clear();
+
+    /// Called from the ConvolutionWorker thread
+    void processTailBlock();
+
+    /// Returns true while the ConvolutionWorker has not finished the last
+    /// tail block that has been submitted. Only used by tests.
+    bool isTailBlockPending() const {
+        return m_tailCompletedBlock.load(std::memory_order_acquire) !=
+                m_tailSubmittedBlock.load(std::memory_order_acquire);
+    }
+
+  private:
+    struct Partitions {
+        Partitions(SINT blockFrames, int partitionCount);
+        void clear();
+
+        const SINT blockFrames;
+        const int partitionCount;
+        std::unique_ptr<FFTReal> pFft;
+        // The last two input blocks of each channel as FFT input
+        std::vector<double> window[kEngineChannelOutputCount];
+        // Frequency domain delay line with the spectra of the
+        // past partitionCount input blocks of each channel
+        std::vector<double> delayLineReal[kEngineChannelOutputCount];
+        std::vector<double> delayLineImag[kEngineChannelOutputCount];
+        int delayLinePos;
+        // Scratch buffers for the transforms
+        std::vector<double> spectrumReal;
+        std::vector<double> spectrumImag;
+        std::vector<double> accumReal;
+        std::vector<double> accumImag;
+        std::vector<double> timeDomain;
+    };
+
+    typedef const double* (ConvolutionKernel::*KernelPartitionFn)(int) const;
+
+    /// Shift the next input block into the window and convolve it with
+    /// the given kernel partitions.
+    void convolveBlock(
+            Partitions* pPartitions,
+            int channel,
+            KernelPartitionFn kernelReal,
+            KernelPartitionFn kernelImag,
+            const double* pInput,
+            double* pOutput);
+    void processHeadBlock(ConvolutionWorker* pWorker);
+
+    const ConvolutionImpulsePointer m_pImpulse;
+    const ConvolutionPartitioning m_partitioning;
+
+    // Owned by the audio thread
+    Partitions m_head;
+    // Deinterleaved input block that is collected until headBlockFrames
+    // frames are available and the output of the previous head block
+    std::vector<double> m_headInput[kEngineChannelOutputCount];
+    std::vector<double> m_headOutput[kEngineChannelOutputCount];
+    SINT m_headBlockPos;
+    // Input of the tail block that is currently being collected
+    std::vector<double> m_tailCollect[kEngineChannelOutputCount];
+    // Number of head blocks since the engine was created
+    SINT m_headBlockCount;
+    // Tail blocks with a lower index are stale after clear()
+    SINT m_firstValidTailBlock;
+    // The tail result slot used for the current tail block
+    const std::vector<double>* m_pTailOutput;
+
+    // Handoff between the audio thread and the worker
+    std::vector<double> m_tailInput[kEngineChannelOutputCount];
+    std::vector<double> m_tailOutput[2][kEngineChannelOutputCount];
+    std::atomic<SINT> m_tailOutputBlock[2];
+    std::atomic<SINT> m_tailSubmittedBlock;
+    std::atomic<SINT> m_tailCompletedBlock;
+    std::atomic<SINT> m_tailFirstValidBlock;
+
+    // Owned by the worker
+    Partitions m_tail;
+    SINT m_tailProcessedBlock;
+
+    DISALLOW_COPY_AND_ASSIGN(ConvolutionEngine);
+};
+
+/// The handoff point between an effect state on the audio thread and the
+/// ConvolutionWorker that (re-)builds ConvolutionEngines on request.
+///
+/// Slots are created and destroyed on the main thread.
+class ConvolutionEngineSlot {
+  public:
+    /// impulseFilePaths is the list of files that can be requested by index
+    explicit ConvolutionEngineSlot(const QStringList& impulseFilePaths);
+    ~ConvolutionEngineSlot();
+
+    /// Called from the audio thread. Requests an engine for the given
+    /// impulse response and engine parameters. The engine is built
+    /// asynchronously and becomes available in a later callback.
+    void request(
+            int impulseIndex,
+            audio::SampleRate sampleRate,
+            SINT framesPerBuffer);
+
+    /// Called from the audio thread. Returns the most recent engine,
+    /// or nullptr if none has been built yet.
+    ConvolutionEngine* engine();
+
+    ConvolutionWorker* worker() const {
+        return m_pWorker.get();
+    }
+
+  private:
+    friend class ConvolutionWorker;
+
+    const QStringList m_impulseFilePaths;
+    const std::shared_ptr<ConvolutionWorker> m_pWorker;
+
+    // Owned by the audio thread
+    ConvolutionEngine* m_pActiveEngine;
+    quint64 m_requestedKey;
+
+    // Handoff between the audio thread and the worker
+    std::atomic<quint64> m_pendingKey;
+    std::atomic<ConvolutionEngine*> m_pPendingEngine;
+    std::atomic<ConvolutionEngine*> m_pRetiredEngine;
+
+    // Owned by the worker
+    quint64 m_deliveredKey;
+
+    DISALLOW_COPY_AND_ASSIGN(ConvolutionEngineSlot);
+};
+
+/// A background thread shared by all ConvolutionEngineSlots that convolves
+/// the tail partitions, loads impulse responses and builds and disposes
+/// ConvolutionEngines, so none of this happens in the audio callback.
+class ConvolutionWorker : public QThread {
+    Q_OBJECT
+  public:
+    /// Called from the main thread. Returns the shared instance and starts
+    /// it if necessary. The thread stops when the last reference is dropped.
+    static std::shared_ptr<ConvolutionWorker> acquire();
+
+    ~ConvolutionWorker() override;
+
+    /// Called from the audio thread. Returns false if the queue is full.
+    bool scheduleTailBlock(ConvolutionEngine* pEngine);
+    void wake();
+
+  protected:
+    void run() override;
+
+  private:
+    ConvolutionWorker();
+
+    friend class ConvolutionEngineSlot;
+    void addSlot(ConvolutionEngineSlot* pSlot);
+    void removeSlot(ConvolutionEngineSlot* pSlot);
+
+    void processTailBlocks();
+    void deliverRequestedEngines();
+    ConvolutionImpulsePointer loadImpulse(
+            const QString& filePath,
+            audio::SampleRate sampleRate,
+            ConvolutionPartitioning partitioning);
+    void disposeRetiredEngines();
+
+    FIFO<ConvolutionEngine*> m_tailBlocks;
+    QSemaphore m_semaWork;
+    std::atomic<bool> m_stop;
+
+    // m_mutex protects m_slots and m_retiredEngines
+    QMutex m_mutex;
+    std::vector<ConvolutionEngineSlot*> m_slots;
+    std::vector<ConvolutionEngine*> m_retiredEngines;
+
+    // A small cache of the most recently loaded impulse responses,
+    // only accessed from the worker thread
+    std::vector<std::pair<QString, ConvolutionImpulsePointer>> m_impulseCache;
+};
+
+} // namespace mixxx
@@ -0,0 +1,169 @@
+#include "effects/backends/builtin/convolutionreverbeffect.h"
+
+#include <QDir>
+#include <QFileInfo>
+
+#include "effects/backends/effectmanifest.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "sources/soundsourceproxy.h"
+#include "util/cmdlineargs.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+// The impulse selector is a step control, so the number
+// of selectable files must be limited
+constexpr int kMaxImpulseFiles = 64;
+
+const QString kImpulsesDirName = QStringLiteral("impulses");
+
+} // anonymous namespace
+
+ConvolutionReverbGroupState::ConvolutionReverbGroupState(
+        const mixxx::EngineParameters& engineParameters)
+        : EffectState(engineParameters),
+          engineSlot(ConvolutionReverbEffect::impulseFilePaths()),
+          sendPrevious(0) {
+}
+
+// static
+QString ConvolutionReverbEffect::getId() {
+    return "org.mixxx.effects.convolutionreverb";
+}
+
+// static
+const QStringList& ConvolutionReverbEffect::impulseFilePaths() {
+    static const QStringList filePaths = [] {
+        QStringList filePaths;
+        const QDir dir(CmdlineArgs::Instance().getSettingsPath() + kImpulsesDirName);
+        const auto fileInfos = dir.entryInfoList(
+                SoundSourceProxy::getSupportedFileNamePatterns(),
+                QDir::Files | QDir::Readable,
+                QDir::Name | QDir::IgnoreCase);
+        for (const auto& fileInfo : fileInfos) {
+            if (filePaths.size() >= kMaxImpulseFiles) {
+                qWarning() << "Ignoring impulse response" << fileInfo.absoluteFilePath()
+                           << "- only" << kMaxImpulseFiles << "files are supported";
+                continue;
+            }
+            filePaths.append(fileInfo.absoluteFilePath());
+        }
+        return filePaths;
+    }();
+    return filePaths;
+}
+
+// static
+EffectManifestPointer ConvolutionReverbEffect::getManifest() {
+    EffectManifestPointer pManifest(new EffectManifest());
+    pManifest->setAddDryToWet(true);
+    pManifest->setEffectRampsFromDry(true);
+
+    pManifest->setId(getId());
+    pManifest->setName(QObject::tr("Convolution Reverb"));
+    pManifest->setShortName(QObject::tr("Conv Reverb"));
+    pManifest->setAuthor("The Mixxx Team");
+    pManifest->setVersion("1.0");
+    pManifest->setDescription(QObject::tr(
+            "Places the signal in a real room by convolving it with a "
+            "recorded impulse response.\n"
+            "Impulse response files are loaded from the \"%1\" folder "
+            "in the Mixxx settings directory.")
+                                      .arg(kImpulsesDirName));
+
+    const QStringList& filePaths = impulseFilePaths();
+    EffectManifestParameterPointer impulse = pManifest->addParameter();
+    impulse->setId("impulse");
+    impulse->setName(QObject::tr("Impulse Response"));
+    impulse->setShortName(QObject::tr("IR"));
+    impulse->setDescription(QObject::tr(
+            "The recorded room that is applied to the signal"));
+    impulse->setValueScaler(EffectManifestParameter::ValueScaler::Toggle);
+    // The range and the steps must agree, i.e. there is always
+    // at least one step
+    const int stepCount = math_max(static_cast<int>(filePaths.size()), 1);
+    impulse->setRange(0, 0, stepCount - 1);
+    if (filePaths.isEmpty()) {
+        impulse->appendStep(qMakePair(QObject::tr("None"), 0.0));
+    }
+    for (int i = 0; i < filePaths.size(); ++i) {
+        impulse->appendStep(qMakePair(
+                QFileInfo(filePaths[i]).completeBaseName(),
+                static_cast<double>(i)));
+    }
+
+    EffectManifestParameterPointer send = pManifest->addParameter();
+    send->setId("send_amount");
+    send->setName(QObject::tr("Send"));
+    send->setShortName(QObject::tr("Send"));
+    send->setDescription(QObject::tr(
+            "How much of the signal to send in to the effect"));
+    send->setValueScaler(EffectManifestParameter::ValueScaler::Linear);
+    send->setUnitsHint(EffectManifestParameter::UnitsHint::Unknown);
+    send->setDefaultLinkType(EffectManifestParameter::LinkType::Linked);
+    send->setDefaultLinkInversion(EffectManifestParameter::LinkInversion::NotInverted);
+    send->setRange(0, 0, 1);
+
+    return pManifest;
+}
+
+void ConvolutionReverbEffect::loadEngineEffectParameters(
+        const QMap<QString, EngineEffectParameterPointer>& parameters) {
+    m_pImpulseParameter = parameters.value("impulse");
+    m_pSendParameter = parameters.value("send_amount");
+}
+
+void ConvolutionReverbEffect::processChannel(
+        ConvolutionReverbGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        const mixxx::EngineParameters& engineParameters,
+        const EffectEnableState enableState,
+        const GroupFeatureState& groupFeatures) {
+    Q_UNUSED(groupFeatures);
+
+    const auto sendCurrent = static_cast<CSAMPLE_GAIN>(m_pSendParameter->value());
+
+    // Loading the impulse response happens on the worker thread and the
+    // engine becomes available in one of the following callbacks. The
+    // request is a no-op if nothing has changed.
+    pState->engineSlot.request(
+            static_cast<int>(m_pImpulseParameter->value()),
+            engineParameters.sampleRate(),
+            engineParameters.framesPerBuffer());
+    mixxx::ConvolutionEngine* pEngine = pState->engineSlot.engine();
+    if (!pEngine) {
+        SampleUtil::clear(pOutput, engineParameters.samplesPerBuffer());
+        pState->sendPrevious = sendCurrent;
+        return;
+    }
+
+    // Prevent replaying the old buffer from the last time the effect was enabled.
+    if (enableState == EffectEnableState::Enabling) {
+        pEngine->clear();
+    }
+
+    // The convolution delays the wet signal by the head block size, which is
+    // never longer than the audio buffer and works like a short pre-delay,
+    // so no group delay is reported for compensating the dry signal.
+    SampleUtil::copyWithRampingGain(pOutput,
+            pInput,
+            pState->sendPrevious,
+            sendCurrent,
+            engineParameters.samplesPerBuffer());
+    pEngine->process(pState->engineSlot.worker(),
+            pOutput,
+            pOutput,
+            engineParameters.framesPerBuffer());
+
+    // The ramping of the send parameter handles ramping when enabling, so
+    // this effect must handle ramping to dry when disabling itself (instead
+    // of being handled by EngineEffect::process).
+    if (enableState == EffectEnableState::Disabling) {
+        SampleUtil::applyRampingGain(pOutput, 1.0, 0.0, engineParameters.samplesPerBuffer());
+        pState->sendPrevious = 0;
+    } else {
+        pState->sendPrevious = sendCurrent;
+    }
+}
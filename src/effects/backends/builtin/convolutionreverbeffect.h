@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QMap>
+#include <QStringList>
+
+#include "effects/backends/builtin/convolutionengine.h"
+#include "effects/backends/effectprocessor.h"
+#include "util/class.h"
+#include "util/types.h"
+
+class ConvolutionReverbGroupState : public EffectState {
+  public:
+    ConvolutionReverbGroupState(const mixxx::EngineParameters& engineParameters);
+    ~ConvolutionReverbGroupState() override = default;
+
+    mixxx::ConvolutionEngineSlot engineSlot;
+    CSAMPLE_GAIN sendPrevious;
+};
+
+/// Reverb that convolves the signal with a recorded impulse response of a
+/// real room. The impulse response files are read from the "impulses"
+/// folder in the settings directory and selected by index.
+class ConvolutionReverbEffect : public EffectProcessorImpl<ConvolutionReverbGroupState> {
+  public:
+    ConvolutionReverbEffect() = default;
+    ~ConvolutionReverbEffect() override = default;
+
+    static QString getId();
+    static EffectManifestPointer getManifest();
+
+    /// The impulse response files that are available for selection.
+    /// The list is built once on first use.
+    static const QStringList& impulseFilePaths();
+
+    void loadEngineEffectParameters(
+            const QMap<QString, EngineEffectParameterPointer>& parameters) override;
+
+    void processChannel(
+            ConvolutionReverbGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            const mixxx::EngineParameters& engineParameters,
+            const EffectEnableState enableState,
+            const GroupFeatureState& groupFeatures) override;
+
+  private:
+    QString debugString() const {
+        return getId();
+    }
+
+    EngineEffectParameterPointer m_pImpulseParameter;
+    EngineEffectParameterPointer m_pSendParameter;
+
+    DISALLOW_COPY_AND_ASSIGN(ConvolutionReverbEffect);
+};
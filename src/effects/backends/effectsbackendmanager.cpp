@@ -12,7 +12,7 @@
 #endif
 #include "effects/presets/effectpreset.h"
 
-EffectsBackendManager::EffectsBackendManager() {
+EffectsBackendManager::EffectsBackendManager(UserSettingsPointer pConfig) {
     m_pNumEffectsAvailable = std::make_unique<ControlObject>(
             ConfigKey("[Master]", "num_effectsavailable"));
     m_pNumEffectsAvailable->setReadOnly();
@@ -22,7 +22,9 @@ EffectsBackendManager::EffectsBackendManager() {
     addBackend(createAudioUnitBackend());
 #endif
 #ifdef __LILV__
-    addBackend(EffectsBackendPointer(new LV2Backend()));
+    addBackend(EffectsBackendPointer(new LV2Backend(pConfig)));
+#else
+    Q_UNUSED(pConfig);
 #endif
 }
 
@@ -1,11 +1,19 @@
 #include "effects/backends/lv2/lv2backend.h"
 
 #include <lv2/units/units.h>
+#include <lv2/worker/worker.h>
 
 #include "effects/backends/lv2/lv2effectprocessor.h"
 #include "effects/backends/lv2/lv2manifest.h"
 
-LV2Backend::LV2Backend() {
+namespace {
+
+const ConfigKey kThreadedPluginsConfigKey("[Effects]", "LV2ThreadedPlugins");
+
+} // anonymous namespace
+
+LV2Backend::LV2Backend(UserSettingsPointer pConfig)
+        : m_pConfig(pConfig) {
     m_pWorld = lilv_world_new();
     initializeProperties();
     lilv_world_load_all(m_pWorld);
@@ -44,6 +52,8 @@ void LV2Backend::initializeProperties() {
     m_properties["unit"] = lilv_new_uri(m_pWorld, LV2_UNITS__unit);
     m_properties["unit_prefix"] = lilv_new_uri(m_pWorld, LV2_UNITS_PREFIX);
     m_properties["unit_symbol"] = lilv_new_uri(m_pWorld, LV2_UNITS__symbol);
+    m_properties["worker_schedule"] = lilv_new_uri(m_pWorld, LV2_WORKER__schedule);
+    m_properties["worker_interface"] = lilv_new_uri(m_pWorld, LV2_WORKER__interface);
 }
 
 const QList<QString> LV2Backend::getEffectIds() const {
@@ -92,7 +102,18 @@ std::unique_ptr<EffectProcessor> LV2Backend::createProcessor(
     VERIFY_OR_DEBUG_ASSERT(pLV2Manifest) {
         return nullptr;
     }
-    return std::make_unique<LV2EffectProcessor>(pLV2Manifest);
+    // Plugins listed in the config are run outside of the audio callback,
+    // delayed by one buffer.
+    const QStringList threadedPluginIds =
+            m_pConfig->getValueString(kThreadedPluginsConfigKey)
+                    .split(' ',
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+                            Qt::SkipEmptyParts);
+#else
+                            QString::SkipEmptyParts);
+#endif
+    const bool processInThread = threadedPluginIds.contains(pLV2Manifest->id());
+    return std::make_unique<LV2EffectProcessor>(pLV2Manifest, processInThread);
 }
 
 LV2EffectManifestPointer LV2Backend::getLV2Manifest(const QString& effectId) const {
@@ -5,11 +5,12 @@
 #include "effects/backends/effectsbackend.h"
 #include "effects/backends/lv2/lv2manifest.h"
 #include "effects/defs.h"
+#include "preferences/usersettings.h"
 
 /// Refer to EffectsBackend for documentation
 class LV2Backend : public EffectsBackend {
   public:
-    LV2Backend();
+    explicit LV2Backend(UserSettingsPointer pConfig);
     virtual ~LV2Backend();
 
     EffectBackendType getType() const {
@@ -28,6 +29,7 @@ class LV2Backend : public EffectsBackend {
   private:
     void enumeratePlugins();
     void initializeProperties();
+    UserSettingsPointer m_pConfig;
     LilvWorld* m_pWorld;
     QHash<QString, LilvNode*> m_properties;
     QHash<QString, LV2EffectManifestPointer> m_registeredEffects;
@@ -1,24 +1,228 @@
 #include "effects/backends/lv2/lv2effectprocessor.h"
 
+#include "effects/backends/effectmanifestparameter.h"
+#include "effects/backends/lv2/lv2effectthread.h"
 #include "engine/effects/engineeffectparameter.h"
 #include "util/defs.h"
 
-LV2EffectProcessor::LV2EffectProcessor(LV2EffectManifestPointer pManifest)
+namespace {
+
+// Maximum size of the pending messages of the LV2 worker extension per
+// direction, including a header of 4 bytes per message
+constexpr int kWorkMessageQueueSize = 8192;
+
+} // anonymous namespace
+
+LV2EffectGroupState::LV2EffectGroupState(
+        const mixxx::EngineParameters& engineParameters)
+        : LV2EffectState(engineParameters),
+          m_workerSchedule{this, &LV2EffectGroupState::scheduleWork},
+          m_workerScheduleFeature{LV2_WORKER__schedule, &m_workerSchedule},
+          m_pInstance(nullptr),
+          m_pWorkerInterface(nullptr),
+          m_workRequests(kWorkMessageQueueSize),
+          m_workResponses(kWorkMessageQueueSize),
+          m_workRequestMessage(kWorkMessageQueueSize),
+          m_workResponseMessage(kWorkMessageQueueSize),
+          m_workScheduled(false),
+          m_instanceActive(false) {
+}
+
+void LV2EffectGroupState::instantiate(LV2EffectManifestPointer pManifest,
+        const mixxx::EngineParameters& engineParameters,
+        bool processInThread) {
+    VERIFY_OR_DEBUG_ASSERT(!m_pInstance) {
+        return;
+    }
+    if (pManifest->usesWorker()) {
+        m_pWorkerThread = LV2EffectThread::acquire(LV2EffectThread::Task::Work);
+    }
+
+    const LV2_Feature* features[] = {&m_workerScheduleFeature, nullptr};
+    m_pInstance = lilv_plugin_instantiate(
+            pManifest->getPlugin(), engineParameters.sampleRate(), features);
+    if (!m_pInstance) {
+        return;
+    }
+    m_pWorkerInterface = static_cast<const LV2_Worker_Interface*>(
+            lilv_instance_get_extension_data(m_pInstance, LV2_WORKER__interface));
+
+    m_controlPortIndices = pManifest->getControlPortIndices();
+    const auto& manifestParameters = pManifest->parameters();
+    std::vector<float> controlValues(m_controlPortIndices.size());
+    for (int i = 0; i < m_controlPortIndices.size() && i < manifestParameters.size(); i++) {
+        controlValues[i] = static_cast<float>(manifestParameters[i]->getDefault());
+    }
+    initControlValues(controlValues);
+
+    // We assume the audio ports are in the following order:
+    // input_left, input_right, output_left, output_right
+    m_audioPortIndices = pManifest->getAudioPortIndices();
+
+    if (processInThread) {
+        startProcessThread();
+    }
+    if (m_pWorkerThread) {
+        m_pWorkerThread->addState(this);
+    }
+}
+
+LV2EffectGroupState::~LV2EffectGroupState() {
+    // Waits until the threads have finished with this state
+    stopProcessThread();
+    if (m_pWorkerThread) {
+        m_pWorkerThread->removeState(this);
+    }
+    if (m_pInstance) {
+        setPluginActive(false);
+        lilv_instance_free(m_pInstance);
+    }
+}
+
+void LV2EffectGroupState::scheduleWorkerThread() {
+    // Retried after the next run() if the queue is full
+    if (m_workScheduled && m_pWorkerThread) {
+        m_workScheduled = !m_pWorkerThread->schedule(this);
+    }
+}
+
+void LV2EffectGroupState::processWork() {
+    if (!m_pWorkerInterface) {
+        return;
+    }
+    uint32_t size;
+    while (readMessage(&m_workRequests, &size, &m_workRequestMessage)) {
+        m_pWorkerInterface->work(lilv_instance_get_handle(m_pInstance),
+                &LV2EffectGroupState::respond,
+                this,
+                size,
+                m_workRequestMessage.data());
+    }
+}
+
+void LV2EffectGroupState::setPluginActive(bool active) {
+    if (active == m_instanceActive) {
+        return;
+    }
+    if (active) {
+        lilv_instance_activate(m_pInstance);
+    } else {
+        lilv_instance_deactivate(m_pInstance);
+    }
+    m_instanceActive = active;
+}
+
+void LV2EffectGroupState::runPlugin(Buffers* pBuffers, SINT framesPerBuffer) {
+    // The blocks of buffers are used alternately
+    for (int i = 0; i < m_controlPortIndices.size(); i++) {
+        lilv_instance_connect_port(m_pInstance,
+                m_controlPortIndices[i],
+                &pBuffers->controlValues[i]);
+    }
+    lilv_instance_connect_port(m_pInstance, m_audioPortIndices[0], pBuffers->inputL.data());
+    lilv_instance_connect_port(m_pInstance, m_audioPortIndices[1], pBuffers->inputR.data());
+    lilv_instance_connect_port(m_pInstance, m_audioPortIndices[2], pBuffers->outputL.data());
+    lilv_instance_connect_port(m_pInstance, m_audioPortIndices[3], pBuffers->outputR.data());
+
+    if (m_pWorkerInterface && m_pWorkerInterface->work_response) {
+        uint32_t size;
+        while (readMessage(&m_workResponses, &size, &m_workResponseMessage)) {
+            m_pWorkerInterface->work_response(lilv_instance_get_handle(m_pInstance),
+                    size,
+                    m_workResponseMessage.data());
+        }
+    }
+
+    lilv_instance_run(m_pInstance, framesPerBuffer);
+
+    if (m_pWorkerInterface && m_pWorkerInterface->end_run) {
+        m_pWorkerInterface->end_run(lilv_instance_get_handle(m_pInstance));
+    }
+
+    scheduleWorkerThread();
+}
+
+// static
+LV2_Worker_Status LV2EffectGroupState::scheduleWork(
+        LV2_Worker_Schedule_Handle handle,
+        uint32_t size,
+        const void* pData) {
+    auto* pState = static_cast<LV2EffectGroupState*>(handle);
+    // The work would never be done without the interface
+    if (!pState->m_pWorkerThread || !pState->m_pWorkerInterface) {
+        return LV2_WORKER_ERR_UNKNOWN;
+    }
+    if (!writeMessage(&pState->m_workRequests, size, pData)) {
+        return LV2_WORKER_ERR_NO_SPACE;
+    }
+    // The worker thread is woken up after run()
+    pState->m_workScheduled = true;
+    return LV2_WORKER_SUCCESS;
+}
+
+// static
+LV2_Worker_Status LV2EffectGroupState::respond(
+        LV2_Worker_Respond_Handle handle,
+        uint32_t size,
+        const void* pData) {
+    auto* pState = static_cast<LV2EffectGroupState*>(handle);
+    if (!writeMessage(&pState->m_workResponses, size, pData)) {
+        return LV2_WORKER_ERR_NO_SPACE;
+    }
+    return LV2_WORKER_SUCCESS;
+}
+
+// static
+bool LV2EffectGroupState::writeMessage(FIFO<char>* pFifo, uint32_t size, const void* pData) {
+    const int messageSize = static_cast<int>(sizeof(size) + size);
+    if (pFifo->writeAvailable() < messageSize) {
+        return false;
+    }
+    // The header and the data are written at once, so the reader
+    // never sees an incomplete message.
+    char* pRegion1;
+    ring_buffer_size_t regionSize1;
+    char* pRegion2;
+    ring_buffer_size_t regionSize2;
+    pFifo->aquireWriteRegions(messageSize, &pRegion1, &regionSize1, &pRegion2, &regionSize2);
+    int pos = 0;
+    const auto writeBytes = [&](const char* pBytes, int count) {
+        for (int i = 0; i < count; ++i, ++pos) {
+            if (pos < regionSize1) {
+                pRegion1[pos] = pBytes[i];
+            } else {
+                pRegion2[pos - regionSize1] = pBytes[i];
+            }
+        }
+    };
+    writeBytes(reinterpret_cast<const char*>(&size), sizeof(size));
+    writeBytes(static_cast<const char*>(pData), size);
+    pFifo->releaseWriteRegions(messageSize);
+    return true;
+}
+
+// static
+bool LV2EffectGroupState::readMessage(
+        FIFO<char>* pFifo, uint32_t* pSize, std::vector<char>* pBuffer) {
+    if (pFifo->readAvailable() < static_cast<int>(sizeof(*pSize))) {
+        return false;
+    }
+    pFifo->read(reinterpret_cast<char*>(pSize), sizeof(*pSize));
+    // A message never exceeds the size of the FIFO
+    DEBUG_ASSERT(*pSize <= pBuffer->size());
+    pFifo->read(pBuffer->data(), *pSize);
+    return true;
+}
+
+LV2EffectProcessor::LV2EffectProcessor(LV2EffectManifestPointer pManifest,
+        bool processInThread)
         : m_pManifest(pManifest),
-          m_LV2parameters(nullptr),
-          m_pPlugin(pManifest->getPlugin()),
-          m_audioPortIndices(pManifest->getAudioPortIndices()),
-          m_controlPortIndices(pManifest->getControlPortIndices()) {
-    m_inputL = new float[kMaxEngineSamples];
-    m_inputR = new float[kMaxEngineSamples];
-    m_outputL = new float[kMaxEngineSamples];
-    m_outputR = new float[kMaxEngineSamples];
+          m_processInThread(processInThread),
+          m_groupDelayFrames(0) {
 }
 
 void LV2EffectProcessor::loadEngineEffectParameters(
         const QMap<QString, EngineEffectParameterPointer>& parameters) {
-    m_LV2parameters = new float[parameters.size()];
-
     // EngineEffect passes the EngineEffectParameters indexed by ID string, which
     // is used directly by built-in EffectProcessorImpl subclasseses to access
     // specific named parameters. However, LV2EffectProcessor::process iterates
@@ -31,14 +235,6 @@ void LV2EffectProcessor::loadEngineEffectParameters(
     }
 }
 
-LV2EffectProcessor::~LV2EffectProcessor() {
-    delete[] m_inputL;
-    delete[] m_inputR;
-    delete[] m_outputL;
-    delete[] m_outputR;
-    delete[] m_LV2parameters;
-}
-
 void LV2EffectProcessor::processChannel(
         LV2EffectGroupState* channelState,
         const CSAMPLE* pInput,
@@ -48,62 +244,31 @@ void LV2EffectProcessor::processChannel(
         const GroupFeatureState& groupFeatures) {
     Q_UNUSED(groupFeatures);
 
-    for (int i = 0; i < m_engineEffectParameters.size(); i++) {
-        m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
-    }
-
-    SINT framesPerBuffer = engineParameters.framesPerBuffer();
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < framesPerBuffer; ++i) {
-        m_inputL[i] = pInput[i * 2];
-        m_inputR[i] = pInput[i * 2 + 1];
-    }
-
-    LilvInstance* instance = channelState->lilvInstance(m_pPlugin, engineParameters);
-
-    if (enableState == EffectEnableState::Enabling) {
-        lilv_instance_activate(instance);
-    }
-
-    lilv_instance_run(instance, framesPerBuffer);
-
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < framesPerBuffer; ++i) {
-        pOutput[i * 2] = m_outputL[i];
-        pOutput[i * 2 + 1] = m_outputR[i];
-    }
-
-    if (enableState == EffectEnableState::Disabling) {
-        lilv_instance_deactivate(instance);
+    if (!channelState->isValid()) {
+        m_groupDelayFrames.store(0, std::memory_order_relaxed);
+        SampleUtil::copy(pOutput, pInput, engineParameters.samplesPerBuffer());
+        return;
     }
+    m_groupDelayFrames.store(
+            channelState->getGroupDelayFrames(engineParameters.framesPerBuffer()),
+            std::memory_order_relaxed);
+    channelState->process(m_engineEffectParameters,
+            pInput,
+            pOutput,
+            engineParameters.framesPerBuffer(),
+            enableState);
 }
 
 LV2EffectGroupState* LV2EffectProcessor::createSpecificState(
         const mixxx::EngineParameters& engineParameters) {
     LV2EffectGroupState* pState = new LV2EffectGroupState(engineParameters);
-    LilvInstance* pInstance = pState->lilvInstance(m_pPlugin, engineParameters);
-    VERIFY_OR_DEBUG_ASSERT(pInstance) {
+    pState->instantiate(m_pManifest, engineParameters, m_processInThread);
+    VERIFY_OR_DEBUG_ASSERT(pState->isValid()) {
         return pState;
     }
 
     if (kEffectDebugOutput) {
         qDebug() << this << "LV2EffectProcessor creating LV2EffectGroupState" << pState;
     }
-
-    if (pInstance) {
-        for (int i = 0; i < m_engineEffectParameters.size(); i++) {
-            m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
-            lilv_instance_connect_port(pInstance,
-                    m_controlPortIndices[i],
-                    &m_LV2parameters[i]);
-        }
-
-        // We assume the audio ports are in the following order:
-        // input_left, input_right, output_left, output_right
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[0], m_inputL);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[1], m_inputR);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[2], m_outputL);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[3], m_outputR);
-    }
     return pState;
 };
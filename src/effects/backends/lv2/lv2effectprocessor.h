@@ -1,44 +1,91 @@
 #pragma once
 
 #include <lilv/lilv.h>
+#include <lv2/worker/worker.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
 
 #include "effects/backends/effectprocessor.h"
+#include "effects/backends/lv2/lv2effectstate.h"
 #include "effects/backends/lv2/lv2manifest.h"
 #include "effects/defs.h"
 #include "engine/engine.h"
+#include "util/fifo.h"
+
+class LV2EffectThread;
 
 // Refer to EffectProcessor for documentation
-class LV2EffectGroupState final : public EffectState {
+//
+// Each state owns a plugin instance. See LV2EffectState for how the
+// buffers that are connected to its ports are processed.
+class LV2EffectGroupState final : public LV2EffectState {
   public:
-    LV2EffectGroupState(const mixxx::EngineParameters& engineParameters)
-            : EffectState(engineParameters),
-              m_pInstance(nullptr) {
-    }
+    LV2EffectGroupState(const mixxx::EngineParameters& engineParameters);
+    ~LV2EffectGroupState() override;
 
-    ~LV2EffectGroupState() override {
-        if (m_pInstance) {
-            lilv_instance_deactivate(m_pInstance);
-            lilv_instance_free(m_pInstance);
-        }
-    }
+    /// Called from the main thread. Creates the plugin instance.
+    void instantiate(LV2EffectManifestPointer pManifest,
+            const mixxx::EngineParameters& engineParameters,
+            bool processInThread);
 
-    LilvInstance* lilvInstance(const LilvPlugin* pPlugin,
-            const mixxx::EngineParameters& engineParameters) {
-        if (!m_pInstance) {
-            m_pInstance = lilv_plugin_instantiate(
-                    pPlugin, engineParameters.sampleRate(), nullptr);
-        }
-        return m_pInstance;
+    bool isValid() const {
+        return m_pInstance != nullptr;
     }
 
+    /// Called from the LV2EffectThread that does the work scheduled
+    /// by the plugin
+    void processWork() override;
+
+  protected:
+    void setPluginActive(bool active) override;
+    /// Runs the plugin and delivers the pending responses of the
+    /// LV2 worker extension before.
+    void runPlugin(Buffers* pBuffers, SINT framesPerBuffer) override;
+
   private:
+    /// Wakes up the worker thread after run() has scheduled work
+    void scheduleWorkerThread();
+
+    // Callbacks of the LV2 worker extension
+    static LV2_Worker_Status scheduleWork(
+            LV2_Worker_Schedule_Handle handle,
+            uint32_t size,
+            const void* pData);
+    static LV2_Worker_Status respond(
+            LV2_Worker_Respond_Handle handle,
+            uint32_t size,
+            const void* pData);
+    static bool writeMessage(FIFO<char>* pFifo, uint32_t size, const void* pData);
+    static bool readMessage(FIFO<char>* pFifo, uint32_t* pSize, std::vector<char>* pBuffer);
+
+    LV2_Worker_Schedule m_workerSchedule;
+    LV2_Feature m_workerScheduleFeature;
     LilvInstance* m_pInstance;
+    const LV2_Worker_Interface* m_pWorkerInterface;
+    QList<int> m_controlPortIndices;
+    QList<int> m_audioPortIndices;
+
+    // Messages of the LV2 worker extension. Requests are written in the
+    // context of the plugin's run() and read by the worker thread,
+    // responses vice versa.
+    FIFO<char> m_workRequests;
+    FIFO<char> m_workResponses;
+    std::vector<char> m_workRequestMessage;
+    std::vector<char> m_workResponseMessage;
+    bool m_workScheduled;
+
+    std::shared_ptr<LV2EffectThread> m_pWorkerThread;
+
+    // Owned by the thread that runs the plugin
+    bool m_instanceActive;
 };
 
 class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState> {
   public:
-    LV2EffectProcessor(LV2EffectManifestPointer pManifest);
-    ~LV2EffectProcessor() override;
+    LV2EffectProcessor(LV2EffectManifestPointer pManifest, bool processInThread);
+    ~LV2EffectProcessor() override = default;
 
     void loadEngineEffectParameters(
             const QMap<QString, EngineEffectParameterPointer>& parameters) override;
@@ -51,18 +98,19 @@ class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState>
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    /// Plugins processed in the LV2EffectThread are delayed by one buffer
+    SINT getGroupDelayFrames() override {
+        return m_groupDelayFrames.load(std::memory_order_relaxed);
+    }
+
   private:
     LV2EffectGroupState* createSpecificState(
             const mixxx::EngineParameters& engineParameters) override;
 
     LV2EffectManifestPointer m_pManifest;
+    const bool m_processInThread;
     QList<EngineEffectParameterPointer> m_engineEffectParameters;
-    float* m_inputL;
-    float* m_inputR;
-    float* m_outputL;
-    float* m_outputR;
-    float* m_LV2parameters;
-    const LilvPlugin* m_pPlugin;
-    const QList<int> m_audioPortIndices;
-    const QList<int> m_controlPortIndices;
+    // Only written by the engine in processChannel(), which always runs
+    // before the group delay is queried for the same buffer
+    std::atomic<SINT> m_groupDelayFrames;
 };
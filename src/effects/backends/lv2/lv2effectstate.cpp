@@ -0,0 +1,217 @@
+#include "effects/backends/lv2/lv2effectstate.h"
+
+#include "effects/backends/lv2/lv2effectthread.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "util/defs.h"
+#include "util/sample.h"
+
+LV2EffectState::LV2EffectState(const mixxx::EngineParameters& engineParameters)
+        : EffectState(engineParameters),
+          m_active(false),
+          m_previousBlock(-1),
+          m_nextSequence(0),
+          m_scheduleFailed(false) {
+    for (auto& block : m_blocks) {
+        block.buffers.inputL.resize(kMaxEngineFrames);
+        block.buffers.inputR.resize(kMaxEngineFrames);
+        block.buffers.outputL.resize(kMaxEngineFrames);
+        block.buffers.outputR.resize(kMaxEngineFrames);
+        block.active = false;
+        block.framesPerBuffer = 0;
+        block.sequence = 0;
+        block.state.store(BlockState::Free);
+    }
+}
+
+LV2EffectState::~LV2EffectState() {
+    // The subclass must have stopped the thread before freeing the plugin
+    DEBUG_ASSERT(!m_pProcessThread);
+}
+
+void LV2EffectState::initControlValues(const std::vector<float>& controlValues) {
+    for (auto& block : m_blocks) {
+        block.buffers.controlValues = controlValues;
+    }
+}
+
+void LV2EffectState::startProcessThread() {
+    VERIFY_OR_DEBUG_ASSERT(!m_pProcessThread) {
+        return;
+    }
+    m_pProcessThread = LV2EffectThread::acquire(LV2EffectThread::Task::Process);
+    m_pProcessThread->addState(this);
+}
+
+void LV2EffectState::stopProcessThread() {
+    if (!m_pProcessThread) {
+        return;
+    }
+    m_pProcessThread->removeState(this);
+    m_pProcessThread.reset();
+}
+
+void LV2EffectState::process(const QList<EngineEffectParameterPointer>& parameters,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        SINT framesPerBuffer,
+        const EffectEnableState enableState) {
+    if (m_pProcessThread) {
+        processInThread(parameters, pInput, pOutput, framesPerBuffer, enableState);
+    } else {
+        processInCallback(parameters, pInput, pOutput, framesPerBuffer, enableState);
+    }
+}
+
+void LV2EffectState::processInCallback(
+        const QList<EngineEffectParameterPointer>& parameters,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        SINT framesPerBuffer,
+        const EffectEnableState enableState) {
+    Buffers* pBuffers = &m_blocks[0].buffers;
+    loadInput(pBuffers, parameters, pInput, framesPerBuffer);
+
+    if (enableState == EffectEnableState::Enabling) {
+        setPluginActive(true);
+    }
+
+    runPlugin(pBuffers, framesPerBuffer);
+    storeOutput(*pBuffers, pOutput, framesPerBuffer);
+
+    if (enableState == EffectEnableState::Disabling) {
+        setPluginActive(false);
+    }
+}
+
+void LV2EffectState::processInThread(
+        const QList<EngineEffectParameterPointer>& parameters,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        SINT framesPerBuffer,
+        const EffectEnableState enableState) {
+    if (enableState == EffectEnableState::Enabling) {
+        // Prevent replaying the output from the last time the effect was enabled
+        m_previousBlock = -1;
+        m_active = true;
+    }
+
+    // The output of the previous callback, unless the thread missed
+    // its deadline
+    bool hasOutput = false;
+    if (m_previousBlock >= 0) {
+        const Block& previous = m_blocks[m_previousBlock];
+        if (previous.state.load(std::memory_order_acquire) == BlockState::Processed &&
+                previous.framesPerBuffer == framesPerBuffer) {
+            storeOutput(previous.buffers, pOutput, framesPerBuffer);
+            hasOutput = true;
+        }
+    }
+    if (!hasOutput) {
+        SampleUtil::clear(pOutput, framesPerBuffer * mixxx::kEngineChannelOutputCount);
+    }
+
+    // All processed blocks have either been returned now or
+    // are too late to be returned at all
+    int freeBlock = -1;
+    for (int i = 0; i < static_cast<int>(m_blocks.size()); ++i) {
+        Block& block = m_blocks[i];
+        if (block.state.load(std::memory_order_acquire) == BlockState::Processed) {
+            block.state.store(BlockState::Free, std::memory_order_relaxed);
+        }
+        if (block.state.load(std::memory_order_relaxed) == BlockState::Free &&
+                (freeBlock < 0 || i != m_previousBlock)) {
+            freeBlock = i;
+        }
+    }
+
+    if (freeBlock < 0) {
+        // The thread is more than one buffer behind and still uses both
+        // blocks. Drop this buffer, the next output is silent as well.
+        m_previousBlock = -1;
+        if (enableState == EffectEnableState::Disabling) {
+            m_active = false;
+        }
+        if (m_scheduleFailed) {
+            scheduleProcessThread();
+        }
+        return;
+    }
+
+    Block& block = m_blocks[freeBlock];
+    if (enableState == EffectEnableState::Disabling) {
+        // This is the last callback until the effect is enabled again,
+        // nothing but deactivating the plugin is left to do.
+        m_active = false;
+        m_previousBlock = -1;
+        block.framesPerBuffer = 0;
+    } else {
+        loadInput(&block.buffers, parameters, pInput, framesPerBuffer);
+        m_previousBlock = freeBlock;
+        block.framesPerBuffer = framesPerBuffer;
+    }
+    block.active = m_active;
+    block.sequence = m_nextSequence++;
+    block.state.store(BlockState::Queued, std::memory_order_release);
+    scheduleProcessThread();
+}
+
+void LV2EffectState::scheduleProcessThread() {
+    // Retried in the next callback if the queue is full
+    m_scheduleFailed = !m_pProcessThread->schedule(this);
+}
+
+void LV2EffectState::processPending() {
+    while (true) {
+        Block* pNext = nullptr;
+        for (auto& block : m_blocks) {
+            if (block.state.load(std::memory_order_acquire) == BlockState::Queued &&
+                    (!pNext || block.sequence < pNext->sequence)) {
+                pNext = &block;
+            }
+        }
+        if (!pNext) {
+            return;
+        }
+        setPluginActive(pNext->active);
+        if (pNext->framesPerBuffer > 0) {
+            runPlugin(&pNext->buffers, pNext->framesPerBuffer);
+        }
+        pNext->state.store(BlockState::Processed, std::memory_order_release);
+    }
+}
+
+bool LV2EffectState::hasQueuedBlocks() const {
+    for (const auto& block : m_blocks) {
+        if (block.state.load(std::memory_order_acquire) == BlockState::Queued) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// static
+void LV2EffectState::loadInput(Buffers* pBuffers,
+        const QList<EngineEffectParameterPointer>& parameters,
+        const CSAMPLE* pInput,
+        SINT framesPerBuffer) {
+    DEBUG_ASSERT(parameters.size() <= static_cast<int>(pBuffers->controlValues.size()));
+    for (int i = 0; i < parameters.size(); i++) {
+        pBuffers->controlValues[i] = static_cast<float>(parameters[i]->value());
+    }
+
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < framesPerBuffer; ++i) {
+        pBuffers->inputL[i] = pInput[i * 2];
+        pBuffers->inputR[i] = pInput[i * 2 + 1];
+    }
+}
+
+// static
+void LV2EffectState::storeOutput(
+        const Buffers& buffers, CSAMPLE* pOutput, SINT framesPerBuffer) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < framesPerBuffer; ++i) {
+        pOutput[i * 2] = buffers.outputL[i];
+        pOutput[i * 2 + 1] = buffers.outputR[i];
+    }
+}
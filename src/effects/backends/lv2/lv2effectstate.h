@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "effects/backends/effectprocessor.h"
+#include "effects/defs.h"
+#include "engine/engine.h"
+
+class LV2EffectThread;
+
+/// Base class of the states of LV2 effects. It owns the buffers that are
+/// connected to the plugin ports and runs the plugin either directly in the
+/// audio callback or in the LV2EffectThread, one buffer behind the audio
+/// callback.
+///
+/// In the latter case two blocks of buffers are used alternately. Each
+/// callback returns the output of the previous callback from one block and
+/// hands over its input in the other block, so the next input can be queued
+/// while the thread still processes the previous one. The latency is always
+/// one buffer: if the thread has not finished the previous block in time,
+/// its output is replaced with silence. The input is dropped only if the
+/// thread still uses both blocks.
+class LV2EffectState : public EffectState {
+  public:
+    /// The buffers of one block that are connected to the plugin ports
+    struct Buffers {
+        std::vector<float> controlValues;
+        std::vector<float> inputL;
+        std::vector<float> inputR;
+        std::vector<float> outputL;
+        std::vector<float> outputR;
+    };
+
+    LV2EffectState(const mixxx::EngineParameters& engineParameters);
+    ~LV2EffectState() override;
+
+    /// Called from the audio thread
+    void process(const QList<EngineEffectParameterPointer>& parameters,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            SINT framesPerBuffer,
+            const EffectEnableState enableState);
+
+    /// Called from the audio thread. Returns the number of frames by which
+    /// process() delays the output.
+    SINT getGroupDelayFrames(SINT framesPerBuffer) const {
+        return m_pProcessThread ? framesPerBuffer : 0;
+    }
+
+    /// Returns true until the LV2EffectThread has processed all blocks
+    /// that have been handed over. Only used by tests.
+    bool hasQueuedBlocks() const;
+
+    /// Called from the LV2EffectThread that runs the plugin. Processes
+    /// the blocks handed over by the audio thread in order.
+    void processPending();
+
+    /// Called from the LV2EffectThread that does the work scheduled
+    /// by the plugin
+    virtual void processWork() {
+    }
+
+  protected:
+    /// Called from the main thread before processing. Sets the number and
+    /// the initial values of the control ports in all blocks.
+    void initControlValues(const std::vector<float>& controlValues);
+    /// Called from the main thread before processing. Subsequent buffers
+    /// are processed in the LV2EffectThread.
+    void startProcessThread();
+    /// Called from the main thread. Blocks while the state is processed,
+    /// afterwards the LV2EffectThread no longer accesses the state. Must be
+    /// called by the destructor of the subclass before the plugin is freed.
+    void stopProcessThread();
+
+    /// Called from the thread that runs the plugin
+    virtual void setPluginActive(bool active) = 0;
+    /// Called from the thread that runs the plugin. The buffers must be
+    /// connected to the plugin ports before running it, they change
+    /// between the calls.
+    virtual void runPlugin(Buffers* pBuffers, SINT framesPerBuffer) = 0;
+
+  private:
+    enum class BlockState {
+        /// Owned by the audio thread
+        Free,
+        /// Handed over to the thread that runs the plugin
+        Queued,
+        /// Handed back to the audio thread with the output
+        Processed,
+    };
+
+    struct Block {
+        Buffers buffers;
+        bool active;
+        SINT framesPerBuffer;
+        // Blocks are processed in the order in which they were queued
+        quint64 sequence;
+        std::atomic<BlockState> state;
+    };
+
+    void processInCallback(const QList<EngineEffectParameterPointer>& parameters,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            SINT framesPerBuffer,
+            const EffectEnableState enableState);
+    void processInThread(const QList<EngineEffectParameterPointer>& parameters,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            SINT framesPerBuffer,
+            const EffectEnableState enableState);
+    static void loadInput(Buffers* pBuffers,
+            const QList<EngineEffectParameterPointer>& parameters,
+            const CSAMPLE* pInput,
+            SINT framesPerBuffer);
+    static void storeOutput(const Buffers& buffers, CSAMPLE* pOutput, SINT framesPerBuffer);
+    void scheduleProcessThread();
+
+    std::shared_ptr<LV2EffectThread> m_pProcessThread;
+    std::array<Block, 2> m_blocks;
+
+    // Owned by the audio thread
+    bool m_active;
+    // The block with the input of the previous callback, or -1 if
+    // there is none
+    int m_previousBlock;
+    quint64 m_nextSequence;
+    bool m_scheduleFailed;
+};
@@ -0,0 +1,91 @@
+#include "effects/backends/lv2/lv2effectthread.h"
+
+#include <algorithm>
+
+#include "effects/backends/lv2/lv2effectstate.h"
+#include "moc_lv2effectthread.cpp"
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+// Every state has at most two processing requests and a few work
+// requests in flight
+constexpr int kScheduledStatesQueueSize = 1024;
+
+std::weak_ptr<LV2EffectThread> s_pProcessThread;
+std::weak_ptr<LV2EffectThread> s_pWorkThread;
+
+} // anonymous namespace
+
+// static
+std::shared_ptr<LV2EffectThread> LV2EffectThread::acquire(Task task) {
+    std::weak_ptr<LV2EffectThread>& pSharedThread =
+            task == Task::Process ? s_pProcessThread : s_pWorkThread;
+    auto pThread = pSharedThread.lock();
+    if (!pThread) {
+        pThread = std::shared_ptr<LV2EffectThread>(new LV2EffectThread(task));
+        if (task == Task::Process) {
+            // The plugins processed here have a deadline of one audio buffer
+            pThread->start(QThread::TimeCriticalPriority);
+        } else {
+            // The scheduled work is non-realtime by definition, e.g.
+            // loading files, and must not compete with the audio
+            pThread->start(QThread::LowPriority);
+        }
+        pSharedThread = pThread;
+    }
+    return pThread;
+}
+
+LV2EffectThread::LV2EffectThread(Task task)
+        : m_task(task),
+          m_scheduledStates(kScheduledStatesQueueSize),
+          m_stop(false) {
+}
+
+LV2EffectThread::~LV2EffectThread() {
+    m_stop.store(true);
+    m_semaWork.release();
+    wait();
+    DEBUG_ASSERT(m_states.empty());
+}
+
+void LV2EffectThread::addState(LV2EffectState* pState) {
+    const auto locker = lockMutex(&m_mutex);
+    m_states.push_back(pState);
+}
+
+void LV2EffectThread::removeState(LV2EffectState* pState) {
+    const auto locker = lockMutex(&m_mutex);
+    m_states.erase(std::remove(m_states.begin(), m_states.end(), pState), m_states.end());
+}
+
+bool LV2EffectThread::schedule(LV2EffectState* pState) {
+    if (m_scheduledStates.write(&pState, 1) != 1) {
+        return false;
+    }
+    m_semaWork.release();
+    return true;
+}
+
+void LV2EffectThread::run() {
+    QThread::currentThread()->setObjectName(m_task == Task::Process
+                    ? QStringLiteral("LV2EffectThread")
+                    : QStringLiteral("LV2WorkerThread"));
+    while (!m_stop.load()) {
+        m_semaWork.acquire();
+        LV2EffectState* pState;
+        while (m_scheduledStates.read(&pState, 1) == 1) {
+            const auto locker = lockMutex(&m_mutex);
+            // The state might have been removed after it was scheduled
+            if (std::find(m_states.begin(), m_states.end(), pState) == m_states.end()) {
+                continue;
+            }
+            if (m_task == Task::Process) {
+                pState->processPending();
+            } else {
+                pState->processWork();
+            }
+        }
+    }
+}
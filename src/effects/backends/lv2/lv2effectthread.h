@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QMutex>
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "util/fifo.h"
+
+class LV2EffectState;
+
+/// A background thread shared by all LV2 effects. There is one instance
+/// for running the plugins that are configured to be processed outside of
+/// the audio callback with a deadline of one audio buffer, and a low
+/// priority instance for the non-realtime work that plugins schedule with
+/// the LV2 worker extension.
+class LV2EffectThread : public QThread {
+    Q_OBJECT
+  public:
+    enum class Task {
+        /// Runs the plugins, see LV2EffectState::processPending()
+        Process,
+        /// Does the scheduled work, see LV2EffectState::processWork()
+        Work,
+    };
+
+    /// Called from the main thread. Returns the shared instance for the
+    /// task and starts it if necessary. The thread stops when the last
+    /// reference is dropped.
+    static std::shared_ptr<LV2EffectThread> acquire(Task task);
+
+    ~LV2EffectThread() override;
+
+    /// Called from the main thread
+    void addState(LV2EffectState* pState);
+    /// Called from the main thread. Blocks while the state is being
+    /// processed, afterwards the state is no longer accessed.
+    void removeState(LV2EffectState* pState);
+
+    /// Called from the audio thread or the thread that runs the plugin.
+    /// Wakes up the thread to process the pending task of the state. Returns false if the
+    /// queue is full.
+    bool schedule(LV2EffectState* pState);
+
+  protected:
+    void run() override;
+
+  private:
+    explicit LV2EffectThread(Task task);
+
+    const Task m_task;
+    FIFO<LV2EffectState*> m_scheduledStates;
+    QSemaphore m_semaWork;
+    std::atomic<bool> m_stop;
+
+    // m_mutex protects m_states and is held while a state is processed
+    QMutex m_mutex;
+    std::vector<LV2EffectState*> m_states;
+};
@@ -14,7 +14,8 @@ LV2Manifest::LV2Manifest(LilvWorld* world,
           m_minimum(lilv_plugin_get_num_ports(plug)),
           m_maximum(lilv_plugin_get_num_ports(plug)),
           m_default(lilv_plugin_get_num_ports(plug)),
-          m_status(AVAILABLE) {
+          m_status(AVAILABLE),
+          m_usesWorker(false) {
     m_pLV2plugin = plug;
 
     // Get and set the ID
@@ -180,10 +181,18 @@ LV2Manifest::LV2Manifest(LilvWorld* world,
         m_status = IO_NOT_STEREO;
     }
 
-    // We don't support any features
+    m_usesWorker = lilv_plugin_has_feature(m_pLV2plugin, properties["worker_schedule"]) &&
+            lilv_plugin_has_extension_data(m_pLV2plugin, properties["worker_interface"]);
+
+    // The only feature we support is the LV2 worker extension. Plugins
+    // that require it without providing the interface for doing the
+    // scheduled work would never get their work done.
     LilvNodes* features = lilv_plugin_get_required_features(m_pLV2plugin);
-    if (lilv_nodes_size(features) > 0) {
-        m_status = HAS_REQUIRED_FEATURES;
+    LILV_FOREACH(nodes, i, features) {
+        if (!lilv_node_equals(lilv_nodes_get(features, i), properties["worker_schedule"]) ||
+                !m_usesWorker) {
+            m_status = HAS_REQUIRED_FEATURES;
+        }
     }
     lilv_nodes_free(features);
 }
@@ -204,6 +213,10 @@ LV2Manifest::Status LV2Manifest::getStatus() {
     return m_status;
 }
 
+bool LV2Manifest::usesWorker() {
+    return m_usesWorker;
+}
+
 bool LV2Manifest::isValid() {
     return m_status == AVAILABLE;
 }
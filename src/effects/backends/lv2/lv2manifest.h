@@ -23,6 +23,8 @@ class LV2Manifest : public EffectManifest {
     const LilvPlugin* getPlugin();
     bool isValid();
     Status getStatus();
+    /// The plugin schedules non-realtime work with the LV2 worker extension
+    bool usesWorker();
 
   private:
     void buildEnumerationOptions(const LilvPort* port,
@@ -43,6 +45,7 @@ class LV2Manifest : public EffectManifest {
     std::vector<float> m_maximum;
     std::vector<float> m_default;
     Status m_status;
+    bool m_usesWorker;
 };
 
 typedef QSharedPointer<LV2Manifest> LV2EffectManifestPointer;
@@ -2,16 +2,18 @@
 
 #include <QtDebug>
 
-#include "effects/effectsmessenger.h"
 #include "effects/presets/effectparameterpreset.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectparameter.h"
 
 EffectParameter::EffectParameter(EngineEffect* pEngineEffect,
-        EffectsMessengerPointer pEffectsMessenger,
         EffectManifestParameterPointer pParameterManifest,
         const EffectParameterPreset& preset)
-        : m_pEngineEffect(pEngineEffect),
-          m_pMessenger(pEffectsMessenger),
-          m_pParameterManifest(pParameterManifest) {
+        : m_pParameterManifest(pParameterManifest) {
+    if (pEngineEffect) {
+        m_pEngineEffectParameter = pEngineEffect->getParameter(pParameterManifest->index());
+        DEBUG_ASSERT(m_pEngineEffectParameter);
+    }
     if (preset.isNull()) {
         setValue(pParameterManifest->getDefault());
     } else {
@@ -65,13 +67,8 @@ void EffectParameter::setValue(double value) {
 }
 
 void EffectParameter::updateEngineState() {
-    if (!m_pEngineEffect) {
+    if (!m_pEngineEffectParameter) {
         return;
     }
-    EffectsRequest* pRequest = new EffectsRequest();
-    pRequest->type = EffectsRequest::SET_PARAMETER_PARAMETERS;
-    pRequest->pTargetEffect = m_pEngineEffect;
-    pRequest->SetParameterParameters.iParameter = m_pParameterManifest->index();
-    pRequest->value = m_value;
-    m_pMessenger->writeRequest(pRequest);
+    m_pEngineEffectParameter->publishValue(m_value);
 }
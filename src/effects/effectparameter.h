@@ -1,6 +1,7 @@
 #pragma once
 
 #include "effects/backends/effectmanifestparameter.h"
+#include "effects/defs.h"
 #include "util/class.h"
 
 class EngineEffect;
@@ -21,7 +22,6 @@ class EffectParameterPreset;
 class EffectParameter {
   public:
     EffectParameter(EngineEffect* pEngineEffect,
-            EffectsMessengerPointer pEffectsMessenger,
             EffectManifestParameterPointer pParameterManifest,
             const EffectParameterPreset& preset);
     virtual ~EffectParameter();
@@ -56,8 +56,9 @@ class EffectParameter {
             const double& maximum);
     bool clampValue();
 
-    EngineEffect* m_pEngineEffect;
-    EffectsMessengerPointer m_pMessenger;
+    // Lock-free link to the audio thread. Parameter changes are frequent,
+    // so they don't go through the EffectsMessenger.
+    EngineEffectParameterPointer m_pEngineEffectParameter;
     EffectManifestParameterPointer m_pParameterManifest;
     double m_value;
     // Hidden parameters cannot be linked to the metaknob, but EffectParameter
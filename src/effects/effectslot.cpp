@@ -308,7 +308,6 @@ void EffectSlot::loadEffectInner(const EffectManifestPointer pManifest,
         }
         EffectParameterPointer pParameter(new EffectParameter(
                 m_pEngineEffect,
-                m_pMessenger,
                 pManifestParameter,
                 parameterPreset));
         m_allParameters[pManifestParameter->parameterType()].append(pParameter);
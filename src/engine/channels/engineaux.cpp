@@ -86,9 +86,6 @@ void EngineAux::process(CSAMPLE* pOut, const std::size_t bufferSize) {
     } else {
         SampleUtil::clear(pOut, bufferSize);
     }
-
-    // Update VU meter
-    m_vuMeter.process(pOut, bufferSize);
 }
 
 void EngineAux::collectFeatures(GroupFeatureState* pGroupFeatures) const {
@@ -70,6 +70,15 @@ class EngineChannel : public EngineObject {
         Q_UNUSED(bufferSize)
     }
 
+    /// Updates the VU meter with the processed channel buffer. Called by
+    /// the EngineMixer once all channels have been processed.
+    void processVuMeter(const CSAMPLE* pIn,
+            const std::size_t bufferSize,
+            mixxx::audio::SampleRate sampleRate,
+            bool truePeak) {
+        m_vuMeter.process(pIn, bufferSize, sampleRate, truePeak);
+    }
+
     // TODO(XXX) This hack needs to be removed.
     virtual EngineBuffer* getEngineBuffer() {
         return nullptr;
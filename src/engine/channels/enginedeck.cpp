@@ -1,6 +1,7 @@
 #include "engine/channels/enginedeck.h"
 
 #include <QStringView>
+#include <array>
 
 #include "control/controlpushbutton.h"
 #include "effects/effectsmanager.h"
@@ -127,6 +128,10 @@ void EngineDeck::processStem(CSAMPLE* pOut, const std::size_t bufferSize) {
     };
     mixxx::audio::SampleRate sampleRate = mixxx::audio::SampleRate::fromDouble(m_sampleRate.get());
     unsigned int stemCount = chCount / mixxx::kEngineChannelOutputCount;
+    VERIFY_OR_DEBUG_ASSERT(stemCount <= mixxx::kMaxSupportedStems &&
+            m_stemsGainCache.size() >= stemCount) {
+        return;
+    };
     SINT numFrames = bufferSize / mixxx::kEngineChannelOutputCount;
     std::size_t allChannelBufferSize = bufferSize * stemCount;
     if (m_stemBuffer.size() < static_cast<SINT>(allChannelBufferSize)) {
@@ -149,48 +154,34 @@ void EngineDeck::processStem(CSAMPLE* pOut, const std::size_t bufferSize) {
 
     // We will now mix each stem (stereo channel) into a single "output"
     // stereo channel. In order to mix the steam, we will use the engine
-    // effect manager so we can also apply the individual stem quick FX
+    // effect manager so we can also apply the individual stem quick FX.
+    // All stems are processed in one batch using the effect manager's
+    // shared buffers.
     GroupFeatureState featureState;
     collectFeatures(&featureState);
-    for (unsigned int stemIdx = 0; stemIdx < stemCount;
-            stemIdx++) {
-        int chOffset = stemIdx * mixxx::audio::ChannelCount::stereo();
-        float stemGain = m_stemMute[stemIdx]->toBool()
+    std::array<CSAMPLE_GAIN, mixxx::kMaxSupportedStems> stemGains;
+    for (unsigned int stemIdx = 0; stemIdx < stemCount; stemIdx++) {
+        stemGains[stemIdx] = m_stemMute[stemIdx]->toBool()
                 ? 0.0f
                 : static_cast<float>(m_stemGain[stemIdx]->get());
-        // Extract the stem frames into the output buffer (LR......LR...... -> LRLR)
-        SampleUtil::copyOneStereoFromMulti(
-                pOut,
-                pIn,
-                numFrames,
-                chCount,
-                chOffset);
-        // Mix the stem frames with the right gain after proceeding its effect.
-        pEngineEffectsManager->processPostFaderInPlace(m_stems[stemIdx].handle(),
-                m_pEffectsManager->getMainHandle(),
-                pOut,
-                bufferSize,
-                sampleRate,
-                featureState,
-                m_stemsGainCache[stemIdx],
-                stemGain,
-                false);
-        // We cache the current gain so we can use it to fade the frame on
-        // next iteration. Without this, (e.g using a static "previous"
-        // gain) gain changes will yield to audio cracks.
-        m_stemsGainCache[stemIdx] = stemGain;
-
-        // Put back the stem frames into the steam buffer (LRLR -> LR......LR......)
-        SampleUtil::insertStereoToMulti(
-                pIn,
-                pOut,
-                numFrames,
-                chCount,
-                chOffset);
     }
-
-    // Mixxx all the stem tracks together
-    SampleUtil::mixMultichannelToStereo(pOut, pIn, numFrames, chCount);
+    pEngineEffectsManager->processStemsPostFaderAndMix(m_stems,
+            m_pEffectsManager->getMainHandle(),
+            pIn,
+            pOut,
+            numFrames,
+            chCount,
+            sampleRate,
+            featureState,
+            m_stemsGainCache,
+            std::span<const CSAMPLE_GAIN>(stemGains.data(), stemCount),
+            false);
+    // We cache the current gain so we can use it to fade the frame on
+    // next iteration. Without this, (e.g using a static "previous"
+    // gain) gain changes will yield to audio cracks.
+    for (unsigned int stemIdx = 0; stemIdx < stemCount; stemIdx++) {
+        m_stemsGainCache[stemIdx] = stemGains[stemIdx];
+    }
 }
 
 void EngineDeck::cloneStemState(const EngineDeck* deckToClone) {
@@ -257,9 +248,6 @@ void EngineDeck::process(CSAMPLE* pOut, const std::size_t bufferSize) {
                 bufferSize,
                 mixxx::audio::SampleRate::fromDouble(m_sampleRate.get()));
     }
-
-    // Update VU meter
-    m_vuMeter.process(pOut, bufferSize);
 }
 
 void EngineDeck::collectFeatures(GroupFeatureState* pGroupFeatures) const {
@@ -87,9 +87,6 @@ void EngineMicrophone::process(CSAMPLE* pOut, const std::size_t bufferSize) {
         SampleUtil::clear(pOut, bufferSize);
     }
     m_sampleBuffer = nullptr;
-
-    // Update VU meter
-    m_vuMeter.process(pOut, bufferSize);
 }
 
 void EngineMicrophone::collectFeatures(GroupFeatureState* pGroupFeatures) const {
@@ -68,7 +68,6 @@ void EngineEffect::initalizeInputChannel(ChannelHandle inputChannel) {
 
 bool EngineEffect::processEffectsRequest(EffectsRequest& message,
                                          EffectsResponsePipe* pResponsePipe) {
-    EngineEffectParameterPointer pParameter;
     EffectsResponse response(message);
 
     switch (message.type) {
@@ -100,23 +99,6 @@ bool EngineEffect::processEffectsRequest(EffectsRequest& message,
         pResponsePipe->writeMessage(response);
         return true;
         break;
-    case EffectsRequest::SET_PARAMETER_PARAMETERS:
-        if (kEffectDebugOutput) {
-            qDebug() << debugString() << "SET_PARAMETER_PARAMETERS"
-                     << "parameter" << message.SetParameterParameters.iParameter
-                     << "value" << message.value;
-        }
-        pParameter = m_parameters.value(
-                message.SetParameterParameters.iParameter, EngineEffectParameterPointer());
-        if (pParameter) {
-            pParameter->setValue(message.value);
-            response.success = true;
-        } else {
-            response.success = false;
-            response.status = EffectsResponse::NO_SUCH_PARAMETER;
-        }
-        pResponsePipe->writeMessage(response);
-        return true;
     default:
         break;
     }
@@ -177,6 +159,11 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
     bool processingOccured = false;
 
     if (effectiveEffectEnableState != EffectEnableState::Disabled) {
+        // Pick up the parameter values published by the main thread
+        for (const auto& pParameter : std::as_const(m_parameters)) {
+            pParameter->updateValue();
+        }
+
         //TODO: refactor rest of audio engine to use mixxx::AudioParameters
         const mixxx::EngineParameters engineParameters(
                 sampleRate,
@@ -55,6 +55,12 @@ class EngineEffect final : public EffectsRequestHandler {
         return m_pManifest->name();
     }
 
+    /// Called from the main thread by EffectParameter for publishing values
+    /// to the audio thread. Returns null if there is no such parameter.
+    EngineEffectParameterPointer getParameter(int index) const {
+        return m_parameters.value(index);
+    }
+
     SINT getGroupDelayFrames() {
         return m_pProcessor->getGroupDelayFrames();
     }
@@ -10,9 +10,7 @@ EngineEffectChain::EngineEffectChain(const QString& group,
         : m_group(group),
           m_enableState(EffectEnableState::Enabled),
           m_mixMode(EffectChainMixMode::DrySlashWet),
-          m_dMix(0),
-          m_buffer1(kMaxEngineSamples),
-          m_buffer2(kMaxEngineSamples) {
+          m_dMix(0) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 
@@ -178,8 +176,12 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         const std::size_t numSamples,
         const mixxx::audio::SampleRate sampleRate,
         const GroupFeatureState& groupFeatures,
-        bool fadeout) {
+        bool fadeout,
+        CSAMPLE* pScratch1,
+        CSAMPLE* pScratch2) {
     DEBUG_ASSERT(numSamples <= kMaxEngineSamples);
+    DEBUG_ASSERT(pScratch1 != pIn && pScratch1 != pOut);
+    DEBUG_ASSERT(pScratch2 != pIn && pScratch2 != pOut);
 
     // Compute the effective enable state from the channel input routing switch and
     // the chain's enable state. When either of these are turned on/off, send the
@@ -225,10 +227,10 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         for (EngineEffect* pEffect : std::as_const(m_effects)) {
             if (pEffect != nullptr) {
                 // Select an unused intermediate buffer for the next output
-                if (pIntermediateInput == m_buffer1.data()) {
-                    pIntermediateOutput = m_buffer2.data();
+                if (pIntermediateInput == pScratch1) {
+                    pIntermediateOutput = pScratch2;
                 } else {
-                    pIntermediateOutput = m_buffer1.data();
+                    pIntermediateOutput = pScratch1;
                 }
 
                 if (pEffect->process(inputHandle,
@@ -254,7 +256,7 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                                 m_mixMode == EffectChainMixMode::DryPlusWet;
 
                         if (!skipAddingDry) {
-                            for (SINT i = 0; i <= static_cast<SINT>(numSamples); ++i) {
+                            for (SINT i = 0; i < static_cast<SINT>(numSamples); ++i) {
                                 pIntermediateOutput[i] += pIntermediateInput[i];
                             }
                         }
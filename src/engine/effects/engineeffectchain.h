@@ -8,7 +8,6 @@
 #include "engine/effects/engineeffectsdelay.h"
 #include "engine/effects/message.h"
 #include "util/class.h"
-#include "util/samplebuffer.h"
 #include "util/types.h"
 
 class EngineEffect;
@@ -36,6 +35,10 @@ class EngineEffectChain final : public EffectsRequestHandler {
             EffectsResponsePipe* pResponsePipe) override;
 
     /// called from audio thread
+    /// pScratch1 and pScratch2 are temporary buffers of kMaxEngineSamples
+    /// samples for passing the signal from one effect to the next. They
+    /// are owned by EngineEffectsManager and shared by all chains, so
+    /// they must neither alias pIn nor pOut.
     bool process(const ChannelHandle& inputHandle,
             const ChannelHandle& outputHandle,
             CSAMPLE* pIn,
@@ -43,7 +46,9 @@ class EngineEffectChain final : public EffectsRequestHandler {
             const std::size_t numSamples,
             const mixxx::audio::SampleRate sampleRate,
             const GroupFeatureState& groupFeatures,
-            bool fadeout);
+            bool fadeout,
+            CSAMPLE* pScratch1,
+            CSAMPLE* pScratch2);
 
   private:
     struct ChannelStatus {
@@ -70,8 +75,6 @@ class EngineEffectChain final : public EffectsRequestHandler {
     EffectChainMixMode::Type m_mixMode;
     CSAMPLE m_dMix;
     QList<EngineEffect*> m_effects;
-    mixxx::SampleBuffer m_buffer1;
-    mixxx::SampleBuffer m_buffer2;
     ChannelHandleMap<ChannelHandleMap<ChannelStatus>> m_chainStatusForChannelMatrix;
     EngineEffectsDelay m_effectsDelay;
 
@@ -2,15 +2,21 @@
 
 #include <QString>
 #include <QVariant>
+#include <atomic>
 
 #include "effects/backends/effectmanifestparameter.h"
 #include "util/class.h"
 
+/// The engine side value of an effect parameter. The value is published
+/// by the main thread without a round trip through the EffectsMessenger
+/// and picked up by the audio thread once per call to EngineEffect::process,
+/// so it doesn't change while the EffectProcessor is running.
 class EngineEffectParameter {
   public:
     EngineEffectParameter(EffectManifestParameterPointer pParameterManifest)
-            : m_pParameterManifest(pParameterManifest) {
-        m_value = m_pParameterManifest->getDefault();
+            : m_pParameterManifest(pParameterManifest),
+              m_value(m_pParameterManifest->getDefault()),
+              m_publishedValue(m_value) {
     }
     virtual ~EngineEffectParameter() {
     }
@@ -22,15 +28,22 @@ class EngineEffectParameter {
     inline double value() const {
         return m_value;
     }
-    inline void setValue(const double value) {
+
+    /// Called from the main thread
+    void publishValue(const double value) {
         // Values should be clamped by EffectParameter before sending to the engine.
         VERIFY_OR_DEBUG_ASSERT(
                 value >= m_pParameterManifest->getMinimum() &&
                 value <= m_pParameterManifest->getMaximum()) {
             return;
         }
-        m_value = value;
+        m_publishedValue.store(value, std::memory_order_relaxed);
+    }
+    /// Called from the audio thread
+    inline void updateValue() {
+        m_value = m_publishedValue.load(std::memory_order_relaxed);
     }
+
     inline int toInt() const {
         return static_cast<int>(m_value);
     }
@@ -41,6 +54,8 @@ class EngineEffectParameter {
   private:
     EffectManifestParameterPointer m_pParameterManifest;
     double m_value;
+    std::atomic<double> m_publishedValue;
+    static_assert(std::atomic<double>::is_always_lock_free);
 
     DISALLOW_COPY_AND_ASSIGN(EngineEffectParameter);
 };
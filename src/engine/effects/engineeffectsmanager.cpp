@@ -3,13 +3,17 @@
 #include "audio/types.h"
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
+#include "engine/engine.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
 EngineEffectsManager::EngineEffectsManager(EffectsResponsePipe&& responsePipe)
         : m_responsePipe(std::move(responsePipe)),
           m_buffer1(kMaxEngineSamples),
-          m_buffer2(kMaxEngineSamples) {
+          m_buffer2(kMaxEngineSamples),
+          m_chainBuffer1(kMaxEngineSamples),
+          m_chainBuffer2(kMaxEngineSamples),
+          m_stemBuffer(kMaxEngineSamples * mixxx::kMaxSupportedStems) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 }
@@ -63,7 +67,6 @@ void EngineEffectsManager::onCallbackStart() {
             break;
         }
         case EffectsRequest::SET_EFFECT_PARAMETERS:
-        case EffectsRequest::SET_PARAMETER_PARAMETERS:
             VERIFY_OR_DEBUG_ASSERT(m_effects.contains(request->pTargetEffect)) {
                 response.success = false;
                 response.status = EffectsResponse::NO_SUCH_EFFECT;
@@ -157,6 +160,64 @@ void EngineEffectsManager::processPostFaderAndMix(
             fadeout);
 }
 
+void EngineEffectsManager::processStemsPostFaderAndMix(
+        std::span<const ChannelHandleAndGroup> stemHandles,
+        const ChannelHandle& outputHandle,
+        const CSAMPLE* pIn,
+        CSAMPLE* pOut,
+        SINT numFrames,
+        mixxx::audio::ChannelCount channelCount,
+        mixxx::audio::SampleRate sampleRate,
+        const GroupFeatureState& groupFeatures,
+        std::span<const CSAMPLE_GAIN> oldGains,
+        std::span<const CSAMPLE_GAIN> newGains,
+        bool fadeout) {
+    const int stemCount = channelCount / mixxx::audio::ChannelCount::stereo();
+    const std::size_t numSamples = numFrames * mixxx::audio::ChannelCount::stereo();
+    VERIFY_OR_DEBUG_ASSERT(stemCount <= mixxx::kMaxSupportedStems &&
+            stemHandles.size() >= static_cast<std::size_t>(stemCount) &&
+            oldGains.size() >= static_cast<std::size_t>(stemCount) &&
+            newGains.size() >= static_cast<std::size_t>(stemCount) &&
+            numSamples <= kMaxEngineSamples) {
+        SampleUtil::mixMultichannelToStereo(pOut, pIn, numFrames, channelCount);
+        return;
+    }
+
+    // Split the stems into one contiguous stereo block per stem
+    // (1L1R2L2R3L3R4L4R... -> 1L1R... 2L2R... 3L3R... 4L4R...)
+    // with a single pass over the interleaved input.
+    CSAMPLE* pStems = m_stemBuffer.data();
+    for (SINT frame = 0; frame < numFrames; ++frame) {
+        const CSAMPLE* pFrame = pIn + frame * channelCount;
+        for (int stemIdx = 0; stemIdx < stemCount; ++stemIdx) {
+            CSAMPLE* pStemFrame = pStems + stemIdx * kMaxEngineSamples +
+                    frame * mixxx::audio::ChannelCount::stereo();
+            pStemFrame[0] = pFrame[stemIdx * mixxx::audio::ChannelCount::stereo()];
+            pStemFrame[1] = pFrame[stemIdx * mixxx::audio::ChannelCount::stereo() + 1];
+        }
+    }
+
+    for (int stemIdx = 0; stemIdx < stemCount; ++stemIdx) {
+        CSAMPLE* pStem = pStems + stemIdx * kMaxEngineSamples;
+        processInner(SignalProcessingStage::Postfader,
+                stemHandles[stemIdx].handle(),
+                outputHandle,
+                pStem,
+                pStem,
+                numSamples,
+                sampleRate,
+                groupFeatures,
+                oldGains[stemIdx],
+                newGains[stemIdx],
+                fadeout);
+        if (stemIdx == 0) {
+            SampleUtil::copy(pOut, pStem, numSamples);
+        } else {
+            SampleUtil::add(pOut, pStem, numSamples);
+        }
+    }
+}
+
 void EngineEffectsManager::processInner(
         const SignalProcessingStage stage,
         const ChannelHandle& inputHandle,
@@ -184,7 +245,9 @@ void EngineEffectsManager::processInner(
                             numSamples,
                             sampleRate,
                             groupFeatures,
-                            fadeout)) {
+                            fadeout,
+                            m_chainBuffer1.data(),
+                            m_chainBuffer2.data())) {
                 }
             }
         }
@@ -222,7 +285,9 @@ void EngineEffectsManager::processInner(
                             numSamples,
                             sampleRate,
                             groupFeatures,
-                            fadeout)) {
+                            fadeout,
+                            m_chainBuffer1.data(),
+                            m_chainBuffer2.data())) {
                     // Output of this chain becomes the input of the next chain.
                     pIntermediateInput = pIntermediateOutput;
                 }
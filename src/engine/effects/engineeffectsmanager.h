@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+
 #include "audio/types.h"
 #include "engine/channelhandle.h"
 #include "engine/effects/message.h"
@@ -65,6 +67,26 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    /// Process the postfader EngineEffectChains of all stems of a deck in one
+    /// batch and mix the result into the stereo pOut buffer. pIn contains
+    /// numFrames frames of interleaved multi-channel samples with one stereo
+    /// pair per stem, as read from a stem file. It is left unmodified.
+    /// The stems are split into EngineEffectsManager's stem buffer in a single
+    /// pass, so all stem chains of all decks share the same memory and
+    /// the processing of each stem works on a contiguous block.
+    void processStemsPostFaderAndMix(
+            std::span<const ChannelHandleAndGroup> stemHandles,
+            const ChannelHandle& outputHandle,
+            const CSAMPLE* pIn,
+            CSAMPLE* pOut,
+            SINT numFrames,
+            mixxx::audio::ChannelCount channelCount,
+            mixxx::audio::SampleRate sampleRate,
+            const GroupFeatureState& groupFeatures,
+            std::span<const CSAMPLE_GAIN> oldGains,
+            std::span<const CSAMPLE_GAIN> newGains,
+            bool fadeout = false);
+
     bool processEffectsRequest(
             EffectsRequest& message,
             EffectsResponsePipe* pResponsePipe) override;
@@ -100,6 +122,14 @@ class EngineEffectsManager final : public EffectsRequestHandler {
     QHash<SignalProcessingStage, QList<EngineEffectChain*>> m_chainsByStage;
     QList<EngineEffect*> m_effects;
 
+    // Passing the signal from one chain to the next
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
+    // Passing the signal from one effect to the next inside of a chain.
+    // Chains are processed one after another, so a single pair is shared
+    // by all of them.
+    mixxx::SampleBuffer m_chainBuffer1;
+    mixxx::SampleBuffer m_chainBuffer2;
+    // One block of kMaxEngineSamples per stem
+    mixxx::SampleBuffer m_stemBuffer;
 };
@@ -27,8 +27,8 @@ struct EffectsRequest {
         DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL,
 
         // Messages for EngineEffect
+        // Parameter values are not sent as messages, see EngineEffectParameter
         SET_EFFECT_PARAMETERS,
-        SET_PARAMETER_PARAMETERS,
 
         // Must come last.
         NUM_REQUEST_TYPES
@@ -93,9 +93,6 @@ struct EffectsRequest {
         struct {
             bool enabled;
         } SetEffectParameters;
-        struct {
-            int iParameter;
-        } SetParameterParameters;
     };
 
     // Used by SET_EFFECT_PARAMETER.
@@ -121,6 +121,8 @@ EngineMixer::EngineMixer(UserSettingsPointer pConfig,
                   ConfigKey(EngineXfader::kXfaderConfigKey, "xFaderReverse"))),
           m_pHeadSplitEnabled(std::make_unique<ControlPushButton>(
                   ConfigKey(group, "headSplit"), true, 0.0)),
+          m_pVuMeterTruePeak(std::make_unique<ControlPushButton>(
+                  ConfigKey(group, QStringLiteral("vu_meter_true_peak")), true)),
 
           m_pKeylockEngine(std::make_unique<ControlObject>(
                   ConfigKey(kAppGroup, QStringLiteral("keylock_engine")),
@@ -191,6 +193,10 @@ EngineMixer::EngineMixer(UserSettingsPointer pConfig,
     m_pHeadSplitEnabled->setButtonMode(mixxx::control::ButtonMode::Toggle);
     m_pHeadSplitEnabled->set(0.0);
 
+    // Peak levels and peak indicators of all VU meters are based on the
+    // oversampled signal if enabled
+    m_pVuMeterTruePeak->setButtonMode(mixxx::control::ButtonMode::Toggle);
+
     // zero out otherwise uninitialized buffers
     m_head.clear();
     m_main.clear();
@@ -332,6 +338,14 @@ void EngineMixer::processChannels(std::size_t bufferSize) {
             pChannelInfo->m_features = features;
         }
     }
+
+    // Meter all processed channels in one go, with the same settings
+    const bool truePeak = m_pVuMeterTruePeak->toBool();
+    for (int i = activeChannelsStartIndex; i < m_activeChannels.size(); ++i) {
+        ChannelInfo* pChannelInfo = m_activeChannels[i];
+        pChannelInfo->m_pChannel->processVuMeter(
+                pChannelInfo->m_pBuffer.data(), bufferSize, m_sampleRate, truePeak);
+    }
     // Do internal sync lock post-processing before the other
     // channels.
     // Note, because we call this on the internal clock first,
@@ -771,7 +785,10 @@ void EngineMixer::process(const std::size_t bufferSize) {
         // Update VU meter (it does not return anything). Needs to be here so that
         // main balance and talkover is reflected in the VU meter.
         if (m_pVumeter != nullptr) {
-            m_pVumeter->process(m_main.data(), bufferSize);
+            m_pVumeter->process(m_main.data(),
+                    bufferSize,
+                    m_sampleRate,
+                    m_pVuMeterTruePeak->toBool());
         }
     }
 
@@ -2,6 +2,7 @@
 
 #include "audio/types.h"
 #include "moc_enginevumeter.cpp"
+#include "util/math.h"
 #include "util/sample.h"
 
 namespace {
@@ -21,9 +22,14 @@ EngineVuMeter::EngineVuMeter(const QString& group, const QString& legacyGroup)
         : m_vuMeter(ConfigKey(group, QStringLiteral("vu_meter"))),
           m_vuMeterLeft(ConfigKey(group, QStringLiteral("vu_meter_left"))),
           m_vuMeterRight(ConfigKey(group, QStringLiteral("vu_meter_right"))),
+          m_rmsLevelLeft(ConfigKey(group, QStringLiteral("rms_level_left"))),
+          m_rmsLevelRight(ConfigKey(group, QStringLiteral("rms_level_right"))),
+          m_peakLevelLeft(ConfigKey(group, QStringLiteral("peak_level_left"))),
+          m_peakLevelRight(ConfigKey(group, QStringLiteral("peak_level_right"))),
           m_peakIndicator(ConfigKey(group, QStringLiteral("peak_indicator"))),
           m_peakIndicatorLeft(ConfigKey(group, QStringLiteral("peak_indicator_left"))),
           m_peakIndicatorRight(ConfigKey(group, QStringLiteral("peak_indicator_right"))),
+          m_truePeak(false),
           m_sampleRate(QStringLiteral("[App]"), QStringLiteral("samplerate")) {
     const QString& aliasGroup = legacyGroup.isEmpty() ? group : legacyGroup;
     m_vuMeter.addAlias(ConfigKey(aliasGroup, QStringLiteral("VuMeter")));
@@ -37,16 +43,57 @@ EngineVuMeter::EngineVuMeter(const QString& group, const QString& legacyGroup)
 }
 
 void EngineVuMeter::process(CSAMPLE* pIn, const std::size_t bufferSize) {
-    CSAMPLE fVolSumL, fVolSumR;
+    process(pIn,
+            bufferSize,
+            mixxx::audio::SampleRate::fromDouble(m_sampleRate.get()),
+            false);
+}
 
-    const auto sampleRate = mixxx::audio::SampleRate::fromDouble(m_sampleRate.get());
+void EngineVuMeter::process(const CSAMPLE* pIn,
+        const std::size_t bufferSize,
+        mixxx::audio::SampleRate sampleRate,
+        bool truePeak) {
+    CSAMPLE fVolSumL, fVolSumR;
+    CSAMPLE fSquaredSumL, fSquaredSumR;
+    CSAMPLE fPeakL, fPeakR;
 
-    SampleUtil::CLIP_STATUS clipped = SampleUtil::sumAbsPerChannel(&fVolSumL,
+    SampleUtil::CLIP_STATUS clipped = SampleUtil::meterPerChannel(&fVolSumL,
             &fVolSumR,
+            &fSquaredSumL,
+            &fSquaredSumR,
+            &fPeakL,
+            &fPeakR,
             pIn,
-            bufferSize);
+            static_cast<SINT>(bufferSize));
+
+    if (truePeak != m_truePeak) {
+        // Don't interpolate from the samples of the last time the
+        // true peak has been detected
+        m_truePeakDetector.reset();
+        m_truePeak = truePeak;
+    }
+    if (truePeak) {
+        CSAMPLE fTruePeakL, fTruePeakR;
+        m_truePeakDetector.process(&fTruePeakL,
+                &fTruePeakR,
+                pIn,
+                static_cast<SINT>(bufferSize));
+        fPeakL = math_max(fPeakL, fTruePeakL);
+        fPeakR = math_max(fPeakR, fTruePeakR);
+        if (fPeakL > CSAMPLE_PEAK) {
+            clipped |= SampleUtil::CLIPPING_LEFT;
+        }
+        if (fPeakR > CSAMPLE_PEAK) {
+            clipped |= SampleUtil::CLIPPING_RIGHT;
+        }
+    }
+
     m_fRMSvolumeSumL += fVolSumL;
     m_fRMSvolumeSumR += fVolSumR;
+    m_fSquaredSumL += fSquaredSumL;
+    m_fSquaredSumR += fSquaredSumR;
+    m_fPeakL = math_max(m_fPeakL, fPeakL);
+    m_fPeakR = math_max(m_fPeakR, fPeakR);
 
     m_samplesCalculated += static_cast<unsigned int>(bufferSize / 2);
 
@@ -75,29 +122,41 @@ void EngineVuMeter::process(CSAMPLE* pIn, const std::size_t bufferSize) {
             m_vuMeter.set(fRMSvolume);
         }
 
+        const double rmsLevelL = std::sqrt(m_fSquaredSumL / m_samplesCalculated);
+        const double rmsLevelR = std::sqrt(m_fSquaredSumR / m_samplesCalculated);
+        if (fabs(rmsLevelL - m_rmsLevelLeft.get()) > epsilon) {
+            m_rmsLevelLeft.set(rmsLevelL);
+        }
+        if (fabs(rmsLevelR - m_rmsLevelRight.get()) > epsilon) {
+            m_rmsLevelRight.set(rmsLevelR);
+        }
+        if (fabs(m_fPeakL - m_peakLevelLeft.get()) > epsilon) {
+            m_peakLevelLeft.set(m_fPeakL);
+        }
+        if (fabs(m_fPeakR - m_peakLevelRight.get()) > epsilon) {
+            m_peakLevelRight.set(m_fPeakR);
+        }
+
         // Reset calculation:
         m_samplesCalculated = 0;
         m_fRMSvolumeSumL = 0;
         m_fRMSvolumeSumR = 0;
+        m_fSquaredSumL = 0;
+        m_fSquaredSumR = 0;
+        m_fPeakL = 0;
+        m_fPeakR = 0;
     }
 
-    if (clipped & SampleUtil::CLIPPING_LEFT) {
-        m_peakIndicatorLeft.set(1.0);
-        m_peakDurationL = static_cast<int>(kPeakDuration * sampleRate / bufferSize / 2000);
-    } else if (m_peakDurationL <= 0) {
-        m_peakIndicatorLeft.set(0.0);
-    } else {
-        --m_peakDurationL;
-    }
-
-    if (clipped & SampleUtil::CLIPPING_RIGHT) {
-        m_peakIndicatorRight.set(1.0);
-        m_peakDurationR = static_cast<int>(kPeakDuration * sampleRate / bufferSize / 2000);
-    } else if (m_peakDurationR <= 0) {
-        m_peakIndicatorRight.set(0.0);
-    } else {
-        --m_peakDurationR;
-    }
+    updatePeakIndicator(&m_peakIndicatorLeft,
+            &m_peakDurationL,
+            clipped.testFlag(SampleUtil::CLIPPING_LEFT),
+            sampleRate,
+            bufferSize);
+    updatePeakIndicator(&m_peakIndicatorRight,
+            &m_peakDurationR,
+            clipped.testFlag(SampleUtil::CLIPPING_RIGHT),
+            sampleRate,
+            bufferSize);
 
     m_peakIndicator.set(
             (m_peakIndicatorRight.toBool() || m_peakIndicatorLeft.toBool())
@@ -105,6 +164,21 @@ void EngineVuMeter::process(CSAMPLE* pIn, const std::size_t bufferSize) {
                     : 0.0);
 }
 
+void EngineVuMeter::updatePeakIndicator(ControlObject* pPeakIndicator,
+        int* pPeakDuration,
+        bool clipped,
+        mixxx::audio::SampleRate sampleRate,
+        const std::size_t bufferSize) {
+    if (clipped) {
+        pPeakIndicator->set(1.0);
+        *pPeakDuration = static_cast<int>(kPeakDuration * sampleRate / bufferSize / 2000);
+    } else if (*pPeakDuration <= 0) {
+        pPeakIndicator->set(0.0);
+    } else {
+        --(*pPeakDuration);
+    }
+}
+
 void EngineVuMeter::doSmooth(CSAMPLE &currentVolume, CSAMPLE newVolume)
 {
     if (currentVolume > newVolume) {
@@ -127,6 +201,10 @@ void EngineVuMeter::reset() {
     m_peakIndicator.set(0);
     m_peakIndicatorLeft.set(0);
     m_peakIndicatorRight.set(0);
+    m_rmsLevelLeft.set(0);
+    m_rmsLevelRight.set(0);
+    m_peakLevelLeft.set(0);
+    m_peakLevelRight.set(0);
 
     m_samplesCalculated = 0;
     m_fRMSvolumeL = 0;
@@ -135,4 +213,9 @@ void EngineVuMeter::reset() {
     m_fRMSvolumeSumR = 0;
     m_peakDurationL = 0;
     m_peakDurationR = 0;
+    m_fSquaredSumL = 0;
+    m_fSquaredSumR = 0;
+    m_fPeakL = 0;
+    m_fPeakR = 0;
+    m_truePeakDetector.reset();
 }
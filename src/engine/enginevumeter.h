@@ -1,8 +1,10 @@
 #pragma once
 
+#include "audio/types.h"
 #include "control/controlobject.h"
 #include "control/pollingcontrolproxy.h"
 #include "engine/engineobject.h"
+#include "util/truepeakdetector.h"
 
 class EngineVuMeter : public EngineObject {
     Q_OBJECT
@@ -11,10 +13,23 @@ class EngineVuMeter : public EngineObject {
 
     virtual void process(CSAMPLE* pInOut, const std::size_t bufferSize);
 
+    /// Meters the stereo buffer pIn in a single pass. If truePeak is set,
+    /// the peak values and the peak indicator are based on the 4x
+    /// oversampled signal instead of the samples.
+    void process(const CSAMPLE* pIn,
+            const std::size_t bufferSize,
+            mixxx::audio::SampleRate sampleRate,
+            bool truePeak);
+
     void reset();
 
   private:
     void doSmooth(CSAMPLE &currentVolume, CSAMPLE newVolume);
+    void updatePeakIndicator(ControlObject* pPeakIndicator,
+            int* pPeakDuration,
+            bool clipped,
+            mixxx::audio::SampleRate sampleRate,
+            const std::size_t bufferSize);
 
     ControlObject m_vuMeter;
     ControlObject m_vuMeterLeft;
@@ -25,11 +40,24 @@ class EngineVuMeter : public EngineObject {
     CSAMPLE m_fRMSvolumeSumR;
     unsigned int m_samplesCalculated;
 
+    // Linear levels of the last update interval, 1.0 is full scale
+    ControlObject m_rmsLevelLeft;
+    ControlObject m_rmsLevelRight;
+    ControlObject m_peakLevelLeft;
+    ControlObject m_peakLevelRight;
+    CSAMPLE m_fSquaredSumL;
+    CSAMPLE m_fSquaredSumR;
+    CSAMPLE m_fPeakL;
+    CSAMPLE m_fPeakR;
+
     ControlObject m_peakIndicator;
     ControlObject m_peakIndicatorLeft;
     ControlObject m_peakIndicatorRight;
     int m_peakDurationL;
     int m_peakDurationR;
 
+    TruePeakDetector m_truePeakDetector;
+    bool m_truePeak;
+
     PollingControlProxy m_sampleRate;
 };
@@ -19,7 +19,8 @@ const mixxx::Logger kLogger("AnalysisFeature");
 
 const QString kViewName = QStringLiteral("Analysis");
 
-// Utilize all available cores for batch analysis of tracks
+// Utilize up to all available cores for batch analysis of tracks. The
+// number of active workers adapts to the available resources.
 const int kNumberOfAnalyzerThreads = math_max(1, QThread::idealThreadCount());
 
 inline
@@ -39,6 +40,12 @@ AnalyzerModeFlags getAnalyzerModeFlags(
     if (pConfig->getValue<bool>(ConfigKey("[Library]", "EnableWaveformGenerationWithAnalysis"), true)) {
         modeFlags |= AnalyzerModeFlags::WithWaveform;
     }
+    // Batch analysis already keeps all cores busy with one track per
+    // thread, so running the analyzers of each track concurrently is
+    // only worth it if there are fewer tracks than cores.
+    if (pConfig->getValue<bool>(ConfigKey("[Library]", "PipelinedAnalysis"), false)) {
+        modeFlags |= AnalyzerModeFlags::Pipelined;
+    }
     return static_cast<AnalyzerModeFlags>(modeFlags);
 }
 
@@ -0,0 +1,330 @@
+#include "library/analysis/headlessanalysis.h"
+
+#include <QDirIterator>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QThread>
+#include <QUrl>
+#include <cstdio>
+
+#include "control/controlobject.h"
+#include "database/mixxxdb.h"
+#include "library/coverartcache.h"
+#include "library/dao/analysiscachedao.h"
+#include "library/dao/trackschema.h"
+#include "library/library_prefs.h"
+#include "library/trackcollection.h"
+#include "library/trackcollectionmanager.h"
+#include "moc_headlessanalysis.cpp"
+#include "preferences/settingsmanager.h"
+#include "sources/soundsourceproxy.h"
+#include "util/cmdlineargs.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/fwdsqlquery.h"
+#include "util/logger.h"
+#include "util/logging.h"
+#include "util/math.h"
+#include "util/performancetimer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("HeadlessAnalysis");
+
+constexpr int kSuccessExitCode = 0;
+constexpr int kFailureExitCode = 1;
+
+class TrackAnalysisSchedulerEnvironmentImpl final : public TrackAnalysisSchedulerEnvironment {
+  public:
+    explicit TrackAnalysisSchedulerEnvironmentImpl(
+            const TrackCollectionManager* pTrackCollectionManager)
+            : m_pTrackCollectionManager(pTrackCollectionManager) {
+        DEBUG_ASSERT(m_pTrackCollectionManager);
+    }
+    ~TrackAnalysisSchedulerEnvironmentImpl() final = default;
+
+    TrackPointer loadTrackById(TrackId trackId) const final {
+        return m_pTrackCollectionManager->getTrackById(trackId);
+    }
+
+  private:
+    const TrackCollectionManager* const m_pTrackCollectionManager;
+};
+
+void printLine(const QString& line) {
+    fputs(qPrintable(line + QChar('\n')), stdout);
+    fflush(stdout);
+}
+
+} // anonymous namespace
+
+HeadlessAnalysis::HeadlessAnalysis(const CmdlineArgs& args)
+        : m_locations(args.getMusicFiles()),
+          m_settingsPath(args.getSettingsPath()),
+          m_analyze(args.getAnalyze()),
+          m_importAnalysisCachePath(args.getImportAnalysisCache()),
+          m_exportAnalysisCachePath(args.getExportAnalysisCache()),
+          m_lastReportedTrackNumber(0) {
+    m_pSettingsManager = std::make_unique<SettingsManager>(m_settingsPath);
+
+    mixxx::LogFlags logFlags = mixxx::LogFlag::LogToFile;
+    if (args.getDebugAssertBreak()) {
+        logFlags.setFlag(mixxx::LogFlag::DebugAssertBreak);
+    }
+    mixxx::Logging::initialize(
+            m_pSettingsManager->settings()->getSettingsPath(),
+            args.getLogLevel(),
+            args.getLogFlushLevel(),
+            logFlags);
+}
+
+HeadlessAnalysis::~HeadlessAnalysis() {
+    finalize();
+}
+
+bool HeadlessAnalysis::initialize() {
+    if (!SoundSourceProxy::registerProviders()) {
+        kLogger.critical() << "Failed to register any SoundSource providers";
+        return false;
+    }
+
+    const UserSettingsPointer pConfig = m_pSettingsManager->settings();
+    m_pDbConnectionPool = MixxxDb(pConfig).connectionPool();
+    if (!m_pDbConnectionPool) {
+        return false;
+    }
+    // Create a connection for the main thread
+    m_pDbConnectionPool->createThreadLocalConnection();
+    const QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+    if (!dbConnection.isOpen()) {
+        kLogger.critical() << "Unable to establish a database connection";
+        return false;
+    }
+    if (!MixxxDb::initDatabaseSchema(dbConnection)) {
+        return false;
+    }
+
+    // Required by the track cache of the library
+    m_pKeyNotation = std::make_unique<ControlObject>(
+            mixxx::library::prefs::kKeyNotationConfigKey);
+    CoverArtCache::createInstance();
+
+    m_pTrackCollectionManager = std::make_unique<TrackCollectionManager>(
+            this,
+            pConfig,
+            m_pDbConnectionPool);
+    return true;
+}
+
+void HeadlessAnalysis::finalize() {
+    // Save the analysis results of all tracks that are still cached
+    // before closing the database
+    m_pTrackCollectionManager.reset();
+    if (m_pKeyNotation) {
+        CoverArtCache::destroy();
+        m_pKeyNotation.reset();
+    }
+    if (m_pDbConnectionPool) {
+        m_pDbConnectionPool->destroyThreadLocalConnection();
+        m_pDbConnectionPool.reset();
+    }
+    if (m_pSettingsManager) {
+        m_pSettingsManager->save();
+        m_pSettingsManager.reset();
+    }
+}
+
+int HeadlessAnalysis::run() {
+    if (!initialize()) {
+        printLine(tr("Failed to open the library database in %1").arg(m_settingsPath));
+        return kFailureExitCode;
+    }
+
+    if (!m_importAnalysisCachePath.isEmpty() && !importAnalysisCache()) {
+        return kFailureExitCode;
+    }
+    if (m_analyze) {
+        analyzeTracks();
+    }
+    if (!m_exportAnalysisCachePath.isEmpty() && !exportAnalysisCache()) {
+        return kFailureExitCode;
+    }
+    return kSuccessExitCode;
+}
+
+bool HeadlessAnalysis::importAnalysisCache() {
+    AnalysisCacheDao dao;
+    dao.initialize(mixxx::DbConnectionPooled(m_pDbConnectionPool));
+    const int importedCount = dao.importEntries(m_importAnalysisCachePath);
+    if (importedCount < 0) {
+        printLine(tr("Failed to import the analysis cache from %1")
+                          .arg(m_importAnalysisCachePath));
+        return false;
+    }
+    printLine(tr("Imported %1 analysis cache entries from %2")
+                      .arg(QString::number(importedCount), m_importAnalysisCachePath));
+    return true;
+}
+
+bool HeadlessAnalysis::exportAnalysisCache() {
+    AnalysisCacheDao dao;
+    dao.initialize(mixxx::DbConnectionPooled(m_pDbConnectionPool));
+    if (!dao.exportEntries(m_exportAnalysisCachePath)) {
+        printLine(tr("Failed to export the analysis cache into %1")
+                          .arg(m_exportAnalysisCachePath));
+        return false;
+    }
+    printLine(tr("Exported the analysis cache into %1").arg(m_exportAnalysisCachePath));
+    return true;
+}
+
+void HeadlessAnalysis::analyzeTracks() {
+    qint64 totalBytes = 0;
+    const QList<TrackId> trackIds = collectTrackIds(&totalBytes);
+    if (trackIds.isEmpty()) {
+        printLine(tr("No tracks to analyze"));
+        return;
+    }
+
+    const UserSettingsPointer pConfig = m_pSettingsManager->settings();
+    // Same analyzers as the batch analysis in the GUI, but without lowering
+    // the priority of the worker threads
+    int modeFlags = AnalyzerModeFlags::WithBeats;
+    if (pConfig->getValue<bool>(
+                ConfigKey("[Library]", "EnableWaveformGenerationWithAnalysis"), true)) {
+        modeFlags |= AnalyzerModeFlags::WithWaveform;
+    }
+    const int numWorkerThreads = math_max(1, QThread::idealThreadCount());
+
+    printLine(tr("Analyzing %1 tracks with %2 threads")
+                      .arg(QString::number(trackIds.size()),
+                              QString::number(numWorkerThreads)));
+
+    PerformanceTimer timer;
+    timer.start();
+    {
+        TrackAnalysisScheduler::Pointer pScheduler =
+                TrackAnalysisScheduler::createInstance(
+                        std::make_unique<const TrackAnalysisSchedulerEnvironmentImpl>(
+                                m_pTrackCollectionManager.get()),
+                        numWorkerThreads,
+                        m_pDbConnectionPool,
+                        pConfig,
+                        static_cast<AnalyzerModeFlags>(modeFlags));
+        connect(pScheduler.get(),
+                &TrackAnalysisScheduler::progress,
+                this,
+                &HeadlessAnalysis::slotProgress);
+
+        QEventLoop eventLoop;
+        connect(pScheduler.get(),
+                &TrackAnalysisScheduler::finished,
+                &eventLoop,
+                &QEventLoop::quit);
+
+        QList<AnalyzerScheduledTrack> scheduledTracks;
+        scheduledTracks.reserve(trackIds.size());
+        for (const auto& trackId : trackIds) {
+            scheduledTracks.append(AnalyzerScheduledTrack(trackId));
+        }
+        pScheduler->scheduleTracks(scheduledTracks);
+        pScheduler->resume();
+        eventLoop.exec();
+    }
+    // Delete the scheduler and the tracks that have been released
+    // by the worker threads
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    const double elapsedSeconds = timer.elapsed().toDoubleSeconds();
+
+    const double tracksPerMinute = elapsedSeconds > 0
+            ? trackIds.size() * 60 / elapsedSeconds
+            : 0;
+    const double megabytesPerSecond = elapsedSeconds > 0
+            ? totalBytes / (1024.0 * 1024.0) / elapsedSeconds
+            : 0;
+    printLine(tr("Analyzed %1 tracks (%2 MB) in %3 s: %4 tracks/min, %5 MB/s decoded")
+                      .arg(QString::number(trackIds.size()),
+                              QString::number(totalBytes / (1024.0 * 1024.0), 'f', 1),
+                              QString::number(elapsedSeconds, 'f', 1),
+                              QString::number(tracksPerMinute, 'f', 1),
+                              QString::number(megabytesPerSecond, 'f', 2)));
+}
+
+void HeadlessAnalysis::slotProgress(AnalyzerProgress currentTrackProgress,
+        int currentTrackNumber,
+        int totalTracksCount) {
+    Q_UNUSED(currentTrackProgress);
+    if (currentTrackNumber <= m_lastReportedTrackNumber) {
+        return;
+    }
+    m_lastReportedTrackNumber = currentTrackNumber;
+    printLine(tr("Track %1 of %2")
+                      .arg(QString::number(currentTrackNumber),
+                              QString::number(totalTracksCount)));
+}
+
+QList<TrackId> HeadlessAnalysis::collectTrackIds(qint64* pTotalBytes) const {
+    if (m_locations.isEmpty()) {
+        return collectLibraryTrackIds(pTotalBytes);
+    } else {
+        return collectFileTrackIds(pTotalBytes);
+    }
+}
+
+QList<TrackId> HeadlessAnalysis::collectLibraryTrackIds(qint64* pTotalBytes) const {
+    const QString statement =
+            QStringLiteral(
+                    "SELECT " LIBRARY_TABLE ".%1,track_locations.%2 "
+                    "FROM " LIBRARY_TABLE " INNER JOIN track_locations "
+                    "ON " LIBRARY_TABLE ".%3=track_locations.%4 "
+                    "WHERE " LIBRARY_TABLE ".%5=0 AND track_locations.%6=0")
+                    .arg(LIBRARYTABLE_ID,
+                            TRACKLOCATIONSTABLE_LOCATION,
+                            LIBRARYTABLE_LOCATION,
+                            TRACKLOCATIONSTABLE_ID,
+                            LIBRARYTABLE_MIXXXDELETED,
+                            TRACKLOCATIONSTABLE_FSDELETED);
+    FwdSqlQuery query(
+            mixxx::DbConnectionPooled(m_pDbConnectionPool),
+            statement);
+    VERIFY_OR_DEBUG_ASSERT(query.execPrepared()) {
+        return {};
+    }
+
+    QList<TrackId> trackIds;
+    const auto idIndex = query.fieldIndex(LIBRARYTABLE_ID);
+    const auto locationIndex = query.fieldIndex(TRACKLOCATIONSTABLE_LOCATION);
+    while (query.next()) {
+        trackIds.append(TrackId(query.fieldValue(idIndex)));
+        *pTotalBytes += QFileInfo(query.fieldValue(locationIndex).toString()).size();
+    }
+    return trackIds;
+}
+
+QList<TrackId> HeadlessAnalysis::collectFileTrackIds(qint64* pTotalBytes) const {
+    QList<QUrl> urls;
+    const auto addFile = [&urls, pTotalBytes](const QFileInfo& fileInfo) {
+        if (!SoundSourceProxy::isFileNameSupported(fileInfo.fileName())) {
+            return;
+        }
+        urls.append(QUrl::fromLocalFile(fileInfo.absoluteFilePath()));
+        *pTotalBytes += fileInfo.size();
+    };
+    for (const auto& location : m_locations) {
+        const QFileInfo fileInfo(location);
+        if (fileInfo.isDir()) {
+            QDirIterator it(fileInfo.absoluteFilePath(),
+                    QDir::Files | QDir::Readable,
+                    QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
+            while (it.hasNext()) {
+                it.next();
+                addFile(it.fileInfo());
+            }
+        } else if (fileInfo.isFile()) {
+            addFile(fileInfo);
+        } else {
+            kLogger.warning() << "Skipping non-existent file or directory" << location;
+        }
+    }
+    // Adds all files to the library that are not there yet
+    return m_pTrackCollectionManager->resolveTrackIdsFromUrls(urls, true);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <memory>
+
+#include "analyzer/trackanalysisscheduler.h"
+#include "preferences/usersettings.h"
+#include "track/trackid.h"
+#include "util/db/dbconnectionpool.h"
+
+class CmdlineArgs;
+class ControlObject;
+class SettingsManager;
+class TrackCollectionManager;
+
+/// Analyzes tracks without the user interface, the audio engine or any
+/// controllers, e.g. for preparing a shared library on a build server. The
+/// results are stored in the library database and the analysis files in
+/// the settings directory like when analyzing tracks in the GUI.
+///
+/// Files and directories that are not in the library yet are added.
+///
+/// The analysis cache can be imported before and exported after the
+/// analysis for sharing the results with other installations.
+class HeadlessAnalysis : public QObject {
+    Q_OBJECT
+  public:
+    explicit HeadlessAnalysis(const CmdlineArgs& args);
+    ~HeadlessAnalysis() override;
+
+    /// Runs all requested actions, blocks until finished
+    /// and returns the exit code.
+    int run();
+
+  private slots:
+    void slotProgress(AnalyzerProgress currentTrackProgress,
+            int currentTrackNumber,
+            int totalTracksCount);
+
+  private:
+    bool initialize();
+    void finalize();
+
+    bool importAnalysisCache();
+    bool exportAnalysisCache();
+
+    /// Analyzes all tracks on all cores
+    void analyzeTracks();
+
+    /// Returns the ids of the tracks that are analyzed and adds
+    /// the total size of their files to *pTotalBytes
+    QList<TrackId> collectTrackIds(qint64* pTotalBytes) const;
+    QList<TrackId> collectLibraryTrackIds(qint64* pTotalBytes) const;
+    QList<TrackId> collectFileTrackIds(qint64* pTotalBytes) const;
+
+    const QStringList m_locations;
+    const QString m_settingsPath;
+    const bool m_analyze;
+    const QString m_importAnalysisCachePath;
+    const QString m_exportAnalysisCachePath;
+
+    std::unique_ptr<SettingsManager> m_pSettingsManager;
+    mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    std::unique_ptr<ControlObject> m_pKeyNotation;
+    std::unique_ptr<TrackCollectionManager> m_pTrackCollectionManager;
+
+    int m_lastReportedTrackNumber;
+};
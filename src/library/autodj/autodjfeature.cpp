@@ -317,34 +317,45 @@ void AutoDJFeature::slotCrateChanged(CrateId crateId) {
 void AutoDJFeature::slotAddRandomTrack() {
     if (m_iAutoDJPlaylistId >= 0) {
         TrackPointer pRandomTrack;
-        for (int failedRetrieveAttempts = 0;
-                !pRandomTrack && (failedRetrieveAttempts < 2 * kMaxRetrieveAttempts); // 2 rounds
-                ++failedRetrieveAttempts) {
-            TrackId randomTrackId;
-            if (m_crateList.isEmpty()) {
-                // Fetch Track from Library since we have no assigned crates
-                randomTrackId = m_autoDjCratesDao.getRandomTrackIdFromLibrary(
-                        m_iAutoDJPlaylistId);
-            } else {
-                // Fetch track from crates.
-                // We do not fall back to Library if this fails because this
-                // may add banned tracks
-                randomTrackId = m_autoDjCratesDao.getRandomTrackId();
+        for (int round = 0; !pRandomTrack && round < 2; ++round) {
+            QList<TrackId> randomTrackIds;
+            randomTrackIds.reserve(kMaxRetrieveAttempts);
+            for (int i = 0; i < kMaxRetrieveAttempts; ++i) {
+                TrackId randomTrackId;
+                if (m_crateList.isEmpty()) {
+                    // Fetch Track from Library since we have no assigned crates
+                    randomTrackId = m_autoDjCratesDao.getRandomTrackIdFromLibrary(
+                            m_iAutoDJPlaylistId);
+                } else {
+                    // Fetch track from crates.
+                    // We do not fall back to Library if this fails because this
+                    // may add banned tracks
+                    randomTrackId = m_autoDjCratesDao.getRandomTrackId();
+                }
+                if (randomTrackId.isValid()) {
+                    randomTrackIds.append(randomTrackId);
+                }
+            }
+            if (randomTrackIds.isEmpty()) {
+                continue;
             }
 
-            if (randomTrackId.isValid()) {
-                pRandomTrack = m_pLibrary->trackCollectionManager()->getTrackById(randomTrackId);
-                VERIFY_OR_DEBUG_ASSERT(pRandomTrack) {
-                    qWarning() << "Track does not exist:"
-                            << randomTrackId;
-                    continue;
-                }
-                if (!pRandomTrack->getFileInfo().checkFileExists()) {
-                    qWarning() << "Track does not exist:"
-                               << pRandomTrack->getInfo()
-                               << pRandomTrack->getLocation();
-                    pRandomTrack.reset();
+            // Load all candidates of this round at once
+            const QList<TrackPointer> randomTracks =
+                    m_pLibrary->trackCollectionManager()->getTracksByIds(randomTrackIds);
+            VERIFY_OR_DEBUG_ASSERT(!randomTracks.isEmpty()) {
+                qWarning() << "Tracks do not exist:"
+                           << randomTrackIds;
+                continue;
+            }
+            for (const auto& pTrack : randomTracks) {
+                if (pTrack->getFileInfo().checkFileExists()) {
+                    pRandomTrack = pTrack;
+                    break;
                 }
+                qWarning() << "Track does not exist:"
+                           << pTrack->getInfo()
+                           << pTrack->getLocation();
             }
         }
         if (pRandomTrack) {
@@ -14,6 +14,10 @@ class BansheePlaylistModel final : public BaseSqlTableModel {
     void selectPlaylist(int playlistId);
 
     TrackPointer getTrack(const QModelIndex& index) const final;
+    /// External tracks are resolved and added one after another
+    TrackPointerList getTracks(const QModelIndexList& indices) const final {
+        return TrackModel::getTracks(indices);
+    }
     TrackId getTrackId(const QModelIndex& index) const final;
     QUrl getTrackUrl(const QModelIndex& index) const final;
 
@@ -21,6 +21,10 @@ class BaseExternalPlaylistModel : public BaseSqlTableModel {
     void setPlaylistById(int playlistId);
 
     TrackPointer getTrack(const QModelIndex& index) const override;
+    /// External tracks are resolved and added one after another
+    TrackPointerList getTracks(const QModelIndexList& indices) const override {
+        return TrackModel::getTracks(indices);
+    }
     TrackId getTrackId(const QModelIndex& index) const override;
     QString getTrackLocation(const QModelIndex& index) const override;
     bool isColumnInternal(int column) override;
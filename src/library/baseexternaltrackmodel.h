@@ -22,6 +22,10 @@ class BaseExternalTrackModel : public BaseSqlTableModel {
     Capabilities getCapabilities() const override;
     TrackId getTrackId(const QModelIndex& index) const override;
     TrackPointer getTrack(const QModelIndex& index) const override;
+    /// External tracks are resolved and added one after another
+    TrackPointerList getTracks(const QModelIndexList& indices) const override {
+        return TrackModel::getTracks(indices);
+    }
     QString getTrackLocation(const QModelIndex& index) const override;
     bool isColumnInternal(int column) override;
     Qt::ItemFlags flags(const QModelIndex& index) const override;
@@ -1,11 +1,14 @@
 #include "library/basesqltablemodel.h"
 
 #include <QUrl>
+#include <QtConcurrentRun>
 #include <QtDebug>
 #include <algorithm>
+#include <optional>
 
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
+#include "library/searchquery.h"
 #include "library/starrating.h"
 #include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
@@ -17,6 +20,8 @@
 #include "util/assert.h"
 #include "util/datetime.h"
 #include "util/db/dbconnection.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
 #include "util/duration.h"
 #include "util/performancetimer.h"
 #include "util/platform.h"
@@ -36,6 +41,42 @@ const QString COLUMNS_SORTING = QStringLiteral("ColumnsSorting");
 
 const QString kModelName = "table:";
 
+const QString kSearchLatencyStatKey = QStringLiteral("BaseSqlTableModel::search");
+
+/// Returns the statement for recreating a temporary view on a different
+/// database connection or an empty string if the table is not temporary.
+/// Returns std::nullopt for temporary tables, which cannot be shared with
+/// other connections.
+std::optional<QString> createTemporaryViewStatement(
+        const QSqlDatabase& database,
+        const QString& tableName) {
+    QSqlQuery query(database);
+    query.prepare(QStringLiteral(
+            "SELECT type,sql FROM sqlite_temp_master "
+            "WHERE name=:name AND type IN ('view','table')"));
+    query.bindValue(":name", tableName);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return std::nullopt;
+    }
+    if (!query.next()) {
+        return QString();
+    }
+    if (query.value(0).toString() != QStringLiteral("view")) {
+        return std::nullopt;
+    }
+    QString statement = query.value(1).toString();
+    // SQLite stores the statement without the TEMPORARY and
+    // IF NOT EXISTS clauses, i.e. it needs to be amended
+    const QString createView = QStringLiteral("CREATE VIEW ");
+    VERIFY_OR_DEBUG_ASSERT(statement.startsWith(createView, Qt::CaseInsensitive)) {
+        return std::nullopt;
+    }
+    return statement.replace(0,
+            createView.size(),
+            QStringLiteral("CREATE TEMPORARY VIEW IF NOT EXISTS "));
+}
+
 } // anonymous namespace
 
 BaseSqlTableModel::BaseSqlTableModel(
@@ -45,10 +86,19 @@ BaseSqlTableModel::BaseSqlTableModel(
         : BaseTrackTableModel(parent, pTrackCollectionManager, settingsNamespace),
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_database(pTrackCollectionManager->internalCollection()->database()),
-          m_bInitialized(false) {
+          m_bInitialized(false),
+          m_selectAsyncPending(false),
+          m_searchLatencyTimer(kSearchLatencyStatKey) {
+    connect(&m_selectFutureWatcher,
+            &QFutureWatcher<SelectResult>::finished,
+            this,
+            &BaseSqlTableModel::slotSelectFinished);
 }
 
 BaseSqlTableModel::~BaseSqlTableModel() {
+    // The worker thread accesses the track source
+    cancelSelectAsync();
+    waitForSelectAsync();
 }
 
 void BaseSqlTableModel::initSortColumnMapping() {
@@ -210,32 +260,69 @@ void BaseSqlTableModel::select() {
     PerformanceTimer time;
     time.start();
 
+    // Supersedes all pending searches
+    cancelSelectAsync();
+
+    const SelectQuery query = prepareSelect();
+    SelectResult result = executeSelect(m_database, query, m_latestSelectId);
+    if (!result.succeeded) {
+        return;
+    }
+    applySelectResult(std::move(result));
+
+    qDebug() << this << "select() returned" << m_rowInfo.size()
+             << "results in" << time.elapsed().debugMillisWithUnit();
+}
+
+BaseSqlTableModel::SelectQuery BaseSqlTableModel::prepareSelect() {
+    SelectQuery query;
+    query.selectId = m_latestSelectId.loadAcquire();
     // Prepare query for id and all columns not in m_trackSource
-    QString queryString = QString("SELECT %1 FROM %2 %3")
-                                  .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
+    query.queryString = QString("SELECT %1 FROM %2 %3")
+                                .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
+    query.idColumn = m_idColumn;
+    query.columnCount = m_tableColumns.size();
+    query.hasPositionColumn = hasPositionColumn();
+    if (m_trackSource) {
+        query.pTrackSource = m_trackSource.data();
+        query.pSearchQuery = m_trackSource->prepareFilterAndSort(
+                m_currentSearch,
+                m_currentSearchFilter);
+        query.isSearchEmpty = m_currentSearch.isEmpty();
+        query.trackSourceOrderBy = m_trackSourceOrderBy;
+        query.sortColumns = m_sortColumns;
+    }
+    return query;
+}
+
+// static
+BaseSqlTableModel::SelectResult BaseSqlTableModel::executeSelect(
+        const QSqlDatabase& database,
+        const SelectQuery& selectQuery,
+        const QAtomicInt& latestSelectId) {
+    SelectResult result;
+    result.selectId = selectQuery.selectId;
+    const auto isSuperseded = [&selectQuery, &latestSelectId]() {
+        return latestSelectId.loadAcquire() != selectQuery.selectId;
+    };
 
     if (sDebug) {
-        qDebug() << this << "select() executing:" << queryString;
+        qDebug() << "select() executing:" << selectQuery.queryString;
     }
 
-    QSqlQuery query(m_database);
+    QSqlQuery query(database);
     // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
     // won't allocate a giant in-memory table that we won't use at all.
     query.setForwardOnly(true);
-    if (!query.prepare(queryString)) {
+    if (!query.prepare(selectQuery.queryString)) {
         LOG_FAILED_QUERY(query);
-        return;
+        return result;
     }
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
-        return;
+        return result;
     }
 
-    // Remove all the rows from the table after(!) the query has been
-    // executed successfully. See issue #6782.
-    // TODO(rryan) we could edit the table in place instead of clearing it?
-    clearRows();
-
     // The size of the result set is not known in advance for a
     // forward-only query, so we cannot reserve memory for rows
     // in advance.
@@ -247,10 +334,10 @@ void BaseSqlTableModel::select() {
         QSqlRecord sqlRecord = query.record();
 
         if (idColumn < 0) {
-            idColumn = sqlRecord.indexOf(m_idColumn);
+            idColumn = sqlRecord.indexOf(selectQuery.idColumn);
         }
 
-        if (posColumn == -1 && hasPositionColumn()) {
+        if (posColumn == -1 && selectQuery.hasPositionColumn) {
             posColumn = sqlRecord.indexOf(PLAYLISTTABLE_POSITION);
         }
 
@@ -261,8 +348,8 @@ void BaseSqlTableModel::select() {
         VERIFY_OR_DEBUG_ASSERT(idColumn != -1) {
             qCritical()
                     << "ID column not available in database query results:"
-                    << m_idColumn;
-            return;
+                    << selectQuery.idColumn;
+            return result;
         }
 
         TrackId trackId(sqlRecord.value(idColumn));
@@ -273,7 +360,7 @@ void BaseSqlTableModel::select() {
         rowInfo.row = rowInfos.size();
 
         rowInfo.columnValues.reserve(sqlRecord.count());
-        for (int i = 0; i < m_tableColumns.size(); ++i) {
+        for (int i = 0; i < selectQuery.columnCount; ++i) {
             rowInfo.columnValues.push_back(sqlRecord.value(i));
         }
         rowInfos.push_back(rowInfo);
@@ -283,14 +370,20 @@ void BaseSqlTableModel::select() {
         qDebug() << "Rows actually received:" << rowInfos.size();
     }
 
-    if (m_trackSource) {
-        m_trackSource->filterAndSort(trackIds,
-                m_currentSearch,
-                m_currentSearchFilter,
-                m_trackSourceOrderBy,
-                m_sortColumns,
-                m_tableColumns.size() - 1, // exclude the 1st column with the id
-                &m_trackSortOrder);
+    if (isSuperseded()) {
+        return result;
+    }
+
+    if (selectQuery.pTrackSource) {
+        const QHash<TrackId, int> trackSortOrder =
+                selectQuery.pTrackSource->filterAndSort(database,
+                        trackIds,
+                        *selectQuery.pSearchQuery,
+                        selectQuery.isSearchEmpty,
+                        selectQuery.trackSourceOrderBy,
+                        selectQuery.sortColumns,
+                        // exclude the 1st column with the id
+                        selectQuery.columnCount - 1);
 
         // Re-sort the track IDs since filterAndSort can change their order or mark
         // them for removal (by setting their row to -1).
@@ -298,12 +391,16 @@ void BaseSqlTableModel::select() {
             // If the sort is not a track column then we will sort only to
             // separate removed tracks (order == -1) from present tracks (order ==
             // 0). Otherwise we sort by the order that filterAndSort returned to us.
-            if (m_trackSourceOrderBy.isEmpty()) {
-                rowInfo.row = m_trackSortOrder.contains(rowInfo.trackId) ? 0 : -1;
+            if (selectQuery.trackSourceOrderBy.isEmpty()) {
+                rowInfo.row = trackSortOrder.contains(rowInfo.trackId) ? 0 : -1;
             } else {
-                rowInfo.row = m_trackSortOrder.value(rowInfo.trackId, -1);
+                rowInfo.row = trackSortOrder.value(rowInfo.trackId, -1);
             }
         }
+
+        if (isSuperseded()) {
+            return result;
+        }
     }
 
     // RowInfo::operator< sorts by the order field, except -1 is placed at the
@@ -331,7 +428,7 @@ void BaseSqlTableModel::select() {
     DEBUG_ASSERT(trackIdToRows.size() <= rowInfos.size());
 
     TrackPos2Row trackPosToRows;
-    if (hasPositionColumn()) {
+    if (selectQuery.hasPositionColumn) {
         // We expect as many positions as we have rows
         trackPosToRows.reserve(rowInfos.size());
         for (int i = 0; i < rowInfos.size(); ++i) {
@@ -341,16 +438,119 @@ void BaseSqlTableModel::select() {
         DEBUG_ASSERT(trackPosToRows.size() == rowInfos.size());
     }
 
+    result.succeeded = true;
+    result.rows = std::move(rowInfos);
+    result.trackIdToRows = std::move(trackIdToRows);
+    result.trackPosToRows = std::move(trackPosToRows);
+    return result;
+}
+
+void BaseSqlTableModel::applySelectResult(SelectResult&& result) {
+    DEBUG_ASSERT(result.succeeded);
+    // Remove all the rows from the table after(!) the query has been
+    // executed successfully. See issue #6782.
+    // TODO(rryan) we could edit the table in place instead of clearing it?
+    clearRows();
+
     // We're done! Issue the update signals and replace the main maps.
     replaceRows(
-            std::move(rowInfos),
-            std::move(trackIdToRows),
-            std::move(trackPosToRows));
+            std::move(result.rows),
+            std::move(result.trackIdToRows),
+            std::move(result.trackPosToRows));
     // Both rowInfo and trackIdToRows (might) have been moved and
     // must not be used afterwards!
+}
 
-    qDebug() << this << "select() returned" << m_rowInfo.size()
-             << "results in" << time.elapsed().debugMillisWithUnit();
+void BaseSqlTableModel::startSelectAsync() {
+    DEBUG_ASSERT(!m_selectFutureWatcher.isRunning());
+    m_selectAsyncPending = false;
+    const mixxx::DbConnectionPoolPtr pDbConnectionPool =
+            m_pTrackCollectionManager->dbConnectionPool();
+    QStringList createViewStatements;
+    for (const auto& tableName : {m_tableName,
+                 m_trackSource ? m_trackSource->tableName() : QString()}) {
+        if (tableName.isEmpty()) {
+            continue;
+        }
+        const auto statement = createTemporaryViewStatement(m_database, tableName);
+        if (!statement) {
+            // Temporary tables, e.g. of BansheePlaylistModel, are only
+            // visible for the connection of this model and are searched
+            // synchronously instead
+            if (sDebug) {
+                qDebug() << this << "Searching synchronously in" << tableName;
+            }
+            select();
+            emit searchFinished();
+            return;
+        }
+        if (!statement->isEmpty()) {
+            createViewStatements.append(*statement);
+        }
+    }
+    SelectQuery query = prepareSelect();
+    query.createViewStatements = std::move(createViewStatements);
+    // The model waits for the worker before the track source
+    // and m_latestSelectId are destroyed
+    const QAtomicInt* pLatestSelectId = &m_latestSelectId;
+    m_selectFutureWatcher.setFuture(QtConcurrent::run(
+            [pDbConnectionPool, query = std::move(query), pLatestSelectId]() {
+                SelectResult result;
+                result.selectId = query.selectId;
+                // The pooler limits the lifetime of the thread-local
+                // connection to this function
+                const mixxx::DbConnectionPooler dbConnectionPooler(pDbConnectionPool);
+                const QSqlDatabase database = mixxx::DbConnectionPooled(pDbConnectionPool);
+                VERIFY_OR_DEBUG_ASSERT(database.isOpen()) {
+                    return result;
+                }
+                for (const auto& statement : query.createViewStatements) {
+                    QSqlQuery createView(database);
+                    if (!createView.exec(statement)) {
+                        LOG_FAILED_QUERY(createView);
+                        return result;
+                    }
+                }
+                return executeSelect(database, query, *pLatestSelectId);
+            }));
+}
+
+void BaseSqlTableModel::cancelSelectAsync() {
+    m_latestSelectId.fetchAndAddOrdered(1);
+    m_selectAsyncPending = false;
+}
+
+void BaseSqlTableModel::waitForSelectAsync() {
+    // Prevent slotSelectFinished() from applying the results
+    // of a canceled select
+    m_selectFutureWatcher.waitForFinished();
+}
+
+void BaseSqlTableModel::slotSelectFinished() {
+    if (m_selectAsyncPending) {
+        // Superseded by a subsequent search while running
+        startSelectAsync();
+        return;
+    }
+    SelectResult result = m_selectFutureWatcher.result();
+    if (result.selectId != m_latestSelectId.loadAcquire()) {
+        // Canceled by a synchronous select()
+        return;
+    }
+    if (!result.succeeded) {
+        // Fall back to a synchronous select, e.g. if the temporary
+        // views could not be recreated for the worker connection
+        qWarning() << this << "Failed to search asynchronously";
+        select();
+        emit searchFinished();
+        return;
+    }
+    applySelectResult(std::move(result));
+
+    const mixxx::Duration latency = m_searchLatencyTimer.elapsed(true);
+    qDebug() << this << "search() returned" << m_rowInfo.size()
+             << "results in" << latency.debugMillisWithUnit();
+    emit searchFinished();
 }
 
 void BaseSqlTableModel::setTable(QString tableName,
@@ -360,6 +560,10 @@ void BaseSqlTableModel::setTable(QString tableName,
     if (sDebug) {
         qDebug() << this << "setTable" << tableName << tableColumns << idColumn;
     }
+    // The worker thread accesses the previous track source
+    cancelSelectAsync();
+    waitForSelectAsync();
+
     m_tableName = std::move(tableName);
     m_idColumn = std::move(idColumn);
     m_tableColumns = std::move(tableColumns);
@@ -431,7 +635,18 @@ void BaseSqlTableModel::search(const QString& searchText, const QString& extraFi
         qDebug() << this << "search" << searchText;
     }
     setSearch(searchText, extraFilter);
-    select();
+    if (!m_bInitialized) {
+        return;
+    }
+    m_searchLatencyTimer.start();
+    // Skips the current search if it has not finished yet
+    m_latestSelectId.fetchAndAddOrdered(1);
+    if (m_selectFutureWatcher.isRunning()) {
+        // Restarted as soon as the current search has finished
+        m_selectAsyncPending = true;
+        return;
+    }
+    startSelectAsync();
 }
 
 void BaseSqlTableModel::setSort(int column, Qt::SortOrder order) {
@@ -776,6 +991,18 @@ TrackPointer BaseSqlTableModel::getTrack(const QModelIndex& index) const {
     return m_pTrackCollectionManager->getTrackById(getTrackId(index));
 }
 
+TrackPointerList BaseSqlTableModel::getTracks(const QModelIndexList& indices) const {
+    QList<TrackId> trackIds;
+    trackIds.reserve(indices.size());
+    for (const auto& index : indices) {
+        const auto trackId = getTrackId(index);
+        if (trackId.isValid()) {
+            trackIds.append(trackId);
+        }
+    }
+    return m_pTrackCollectionManager->getTracksByIds(trackIds);
+}
+
 TrackId BaseSqlTableModel::getTrackId(const QModelIndex& index) const {
     if (index.isValid()) {
         return TrackId(getFieldVariant(index, m_idColumn));
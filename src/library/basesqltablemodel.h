@@ -1,12 +1,16 @@
 #pragma once
 
+#include <QAtomicInt>
+#include <QFutureWatcher>
 #include <QHash>
+#include <memory>
 
 #include "library/basetrackcache.h"
 #include "library/dao/trackdao.h"
 #include "library/basetracktablemodel.h"
 #include "library/columncache.h"
 #include "util/class.h"
+#include "util/timer.h"
 
 class TrackCollectionManager;
 
@@ -45,6 +49,8 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     int fieldIndex(const QString& fieldName) const final;
 
     TrackPointer getTrack(const QModelIndex& index) const override;
+    /// Loads all tracks with a constant number of database queries
+    TrackPointerList getTracks(const QModelIndexList& indices) const override;
     TrackId getTrackId(const QModelIndex& index) const override;
     QString getTrackLocation(const QModelIndex& index) const override;
 
@@ -59,14 +65,23 @@ class BaseSqlTableModel : public BaseTrackTableModel {
         return m_trackPosToRow.value(position);
     }
 
+    /// Searching is done asynchronously on a worker thread. Superseded
+    /// searches are skipped and searchFinished() is emitted after the
+    /// results of the most recent search have been applied. Models that
+    /// are based on temporary tables are searched synchronously.
     void search(const QString& searchText, const QString& extraFilter = QString()) override;
     const QString currentSearch() const override;
 
+    bool isSearchPending() const {
+        return m_selectFutureWatcher.isRunning();
+    }
+
     TrackModel::SortColumnId sortColumnIdFromColumnIndex(int column) const override;
     int columnIndexFromSortColumnId(TrackModel::SortColumnId sortColumn) const override;
 
     void hideTracks(const QModelIndexList& indices) override;
 
+    /// Selects the rows synchronously
     void select() override;
 
     ///////////////////////////////////////////////////////////////////////////
@@ -113,8 +128,12 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     int m_columnIndexBySortColumnId[static_cast<int>(TrackModel::SortColumnId::IdMax)];
     QMap<int, TrackModel::SortColumnId> m_sortColumnIdByColumnIndex;
 
+  signals:
+    void searchFinished();
+
   private slots:
     void tracksChanged(const QSet<TrackId>& trackIds);
+    void slotSelectFinished();
 
   private:
     void setTrackValueForColumn(
@@ -162,6 +181,46 @@ class BaseSqlTableModel : public BaseTrackTableModel {
             TrackId2Rows&& trackIdToRows,
             TrackPos2Row&& trackPosToRows);
 
+    /// A snapshot of all parameters that are needed for
+    /// executing a select() on a different thread
+    struct SelectQuery {
+        int selectId = 0;
+        QString queryString;
+        QString idColumn;
+        int columnCount = 0;
+        bool hasPositionColumn = false;
+        /// Temporary views only exist for the connection that created
+        /// them and need to be recreated for other connections. The
+        /// search query must not refer to the connection of the model.
+        QStringList createViewStatements;
+        const BaseTrackCache* pTrackSource = nullptr;
+        std::shared_ptr<const QueryNode> pSearchQuery;
+        bool isSearchEmpty = true;
+        QString trackSourceOrderBy;
+        QList<SortColumn> sortColumns;
+    };
+
+    struct SelectResult {
+        int selectId = 0;
+        bool succeeded = false;
+        QVector<RowInfo> rows;
+        TrackId2Rows trackIdToRows;
+        TrackPos2Row trackPosToRows;
+    };
+
+    SelectQuery prepareSelect();
+    /// Aborts early and fails if the select has been superseded
+    /// in the meantime, i.e. if the latest id has changed
+    static SelectResult executeSelect(
+            const QSqlDatabase& database,
+            const SelectQuery& query,
+            const QAtomicInt& latestSelectId);
+    void applySelectResult(SelectResult&& result);
+
+    void startSelectAsync();
+    void cancelSelectAsync();
+    void waitForSelectAsync();
+
     QVector<RowInfo> m_rowInfo;
 
     QString m_idColumn;
@@ -169,7 +228,6 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     QStringList m_tableColumns;
     QList<SortColumn> m_sortColumns;
     bool m_bInitialized;
-    QHash<TrackId, int> m_trackSortOrder;
     TrackId2Rows m_trackIdToRows;
     TrackPos2Row m_trackPosToRow;
     QString m_currentSearch;
@@ -177,5 +235,15 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     QVector<QHash<int, QVariant>> m_headerInfo;
     QString m_trackSourceOrderBy;
 
+    QFutureWatcher<SelectResult> m_selectFutureWatcher;
+    // Incremented for every select() that supersedes the previous ones.
+    // Read by the worker thread for skipping superseded selects.
+    QAtomicInt m_latestSelectId;
+    // Another search has been requested while the worker was busy
+    bool m_selectAsyncPending;
+    // Reports the time from search() until the results have been
+    // applied to the StatsManager
+    Timer m_searchLatencyTimer;
+
     DISALLOW_COPY_AND_ASSIGN(BaseSqlTableModel);
 };
@@ -1,5 +1,9 @@
 #include "library/basetrackcache.h"
 
+#include <QMutexLocker>
+#include <algorithm>
+#include <cmath>
+
 #include "library/queryutil.h"
 #include "library/searchquery.h"
 #include "library/searchqueryparser.h"
@@ -14,6 +18,38 @@ namespace {
 
 constexpr bool sDebug = false;
 
+// The columns that are filtered by numeric search queries. All other
+// columns are only stored as texts in the columnar index.
+const ColumnCache::Column kNumericIndexColumns[] = {
+        ColumnCache::COLUMN_LIBRARYTABLE_ID,
+        ColumnCache::COLUMN_LIBRARYTABLE_PLAYED,
+        ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED,
+        ColumnCache::COLUMN_LIBRARYTABLE_RATING,
+        ColumnCache::COLUMN_LIBRARYTABLE_KEY_ID,
+        ColumnCache::COLUMN_LIBRARYTABLE_BPM,
+        ColumnCache::COLUMN_LIBRARYTABLE_BPM_LOCK,
+        ColumnCache::COLUMN_LIBRARYTABLE_DURATION,
+        ColumnCache::COLUMN_LIBRARYTABLE_BITRATE,
+        ColumnCache::COLUMN_LIBRARYTABLE_REPLAYGAIN,
+        ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE,
+        ColumnCache::COLUMN_LIBRARYTABLE_CHANNELS,
+};
+
+ColumnarTrackIndex createColumnarTrackIndex(const ColumnCache& columnCache) {
+    QStringList columnNames;
+    for (int i = 0; i < columnCache.endFieldIndex(); ++i) {
+        columnNames << columnCache.columnNameForFieldIndex(i);
+    }
+    std::vector<bool> numericColumns(columnNames.size(), false);
+    for (const auto column : kNumericIndexColumns) {
+        const int fieldIndex = columnCache.fieldIndex(column);
+        if (fieldIndex >= 0) {
+            numericColumns[fieldIndex] = true;
+        }
+    }
+    return ColumnarTrackIndex(std::move(columnNames), std::move(numericColumns));
+}
+
 }  // namespace
 
 BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
@@ -29,9 +65,13 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
           m_columnCache(std::move(columns)),
           m_pQueryParser(std::make_unique<SearchQueryParser>(
                   pTrackCollection, std::move(searchColumns))),
+          m_index(createColumnarTrackIndex(m_columnCache)),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
           m_database(pTrackCollection->database()) {
+    // The cached tracks are identified by the ids of the library
+    m_pQueryParser->setUseFullTextIndex(
+            pTrackCollection->getTrackDAO().hasFullTextIndex());
 }
 
 BaseTrackCache::~BaseTrackCache() {
@@ -81,8 +121,9 @@ void BaseTrackCache::slotTracksRemoved(const QSet<TrackId>& trackIds) {
     if (sDebug) {
         qDebug() << this << "slotTracksRemoved" << trackIds.size();
     }
+    const QMutexLocker locked(&m_mutex);
     for (const auto& trackId : std::as_const(trackIds)) {
-        m_trackInfo.remove(trackId);
+        m_index.removeRow(trackId);
         m_dirtyTracks.remove(trackId);
     }
 }
@@ -91,6 +132,7 @@ void BaseTrackCache::slotTrackDirty(TrackId trackId) {
     if (sDebug) {
         qDebug() << this << "slotTrackDirty" << trackId;
     }
+    const QMutexLocker locked(&m_mutex);
     m_dirtyTracks.insert(trackId);
 }
 
@@ -98,13 +140,16 @@ void BaseTrackCache::slotTrackClean(TrackId trackId) {
     if (sDebug) {
         qDebug() << this << "slotTrackClean" << trackId;
     }
-    m_dirtyTracks.remove(trackId);
+    {
+        const QMutexLocker locked(&m_mutex);
+        m_dirtyTracks.remove(trackId);
+    }
     // The track might have been reloaded from the database
     updateTrackInIndex(trackId);
 }
 
 bool BaseTrackCache::isCached(TrackId trackId) const {
-    return m_trackInfo.contains(trackId);
+    return m_index.rowOf(trackId) >= 0;
 }
 
 void BaseTrackCache::ensureCached(TrackId trackId) {
@@ -120,7 +165,7 @@ const TrackPointer& BaseTrackCache::getCachedTrack(TrackId trackId) const {
     if (m_recentTrackId != trackId) {
         if (trackId.isValid()) {
             TrackPointer trackPtr =
-                    GlobalTrackCacheLocker().lookupTrackById(trackId);
+                    GlobalTrackCache::lookupTrackById(trackId);
             if (!trackPtr) {
                 resetRecentTrack();
             } else {
@@ -168,13 +213,13 @@ bool BaseTrackCache::updateTrackInIndex(
 
     TrackId trackId = pTrack->getId();
     if (trackId.isValid()) {
-        // m_trackInfo[id] will insert a QVector<QVariant> into the
-        // m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        // preallocate memory for all columns at once
-        record.resize(numColumns);
+        QVector<QVariant> values(numColumns);
         for (int i = 0; i < numColumns; ++i) {
-            record[i] = getTrackValueForColumn(pTrack, i);
+            values[i] = getTrackValueForColumn(pTrack, i);
+        }
+        {
+            const QMutexLocker locked(&m_mutex);
+            m_index.setRow(trackId, values);
         }
         if (m_bIsCaching) {
             replaceRecentTrack(trackId, pTrack);
@@ -209,16 +254,18 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
     int numColumns = columnCount();
     int idColumn = query.record().indexOf(m_idColumn);
 
+    const int locationColumn = fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION);
+    // The record is reused for copying the values of all rows into the index
+    QVector<QVariant> record(numColumns);
+
+    // The query is executed before locking the mutex, but the
+    // results are fetched row by row while holding it
+    const QMutexLocker locked(&m_mutex);
     while (query.next()) {
         TrackId trackId(query.value(idColumn));
 
-        //m_trackInfo[id] will insert a QVector<QVariant> into the
-        //m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        record.resize(numColumns);
-
         for (int i = 0; i < numColumns; ++i) {
-            if (fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION) == i) {
+            if (locationColumn == i) {
                 // Database stores all locations with Qt separators: "/"
                 // Here we want to cache the display string with native separators.
                 QString location = query.value(i).toString();
@@ -227,6 +274,7 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
                 record[i] = query.value(i);
             }
         }
+        m_index.setRow(trackId, record);
     }
 
     qDebug() << this << "updateIndexWithQuery took" << timer.elapsed().debugMillisWithUnit();
@@ -248,7 +296,10 @@ void BaseTrackCache::buildIndex() {
     // TODO(rryan) for very large tables, it probably makes more sense to NOT
     // clear the table, and keep track of what IDs we see, then delete the ones
     // we don't see.
-    m_trackInfo.clear();
+    {
+        const QMutexLocker locked(&m_mutex);
+        m_index.clear();
+    }
     if (m_bIsCaching) {
         resetRecentTrack();
     }
@@ -257,6 +308,7 @@ void BaseTrackCache::buildIndex() {
         qDebug() << "buildIndex failed!";
     }
 
+    const QMutexLocker locked(&m_mutex);
     m_bIndexBuilt = true;
 }
 
@@ -423,24 +475,26 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
     // If the track lookup failed (could happen for track properties we don't
     // keep track of in Track, like playlist position) look up the value in
     // the track info cache.
+    return getTrackInfoValueForColumn(trackId, column);
+}
 
+QVariant BaseTrackCache::getTrackInfoValueForColumn(TrackId trackId, int column) const {
     // TODO(rryan) this code is flawed for columns that contains row-specific
     // metadata. Currently the upper-levels will not delegate row-specific
     // columns to this method, but there should still be a check here I think.
-    auto it = m_trackInfo.constFind(trackId);
-    if (it == m_trackInfo.constEnd()) {
+    const int row = m_index.rowOf(trackId);
+    if (row < 0 || column < 0 || column >= m_index.columnCount()) {
         return QVariant{};
     }
 
-    const QVector<QVariant>& fields = it.value();
     if (column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY)) {
         // The Key value is determined by either the KEY_ID or KEY column
         const auto columnForKeyId = fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY_ID);
         return KeyUtils::keyFromKeyTextAndIdFields(
-                fields.value(column, QVariant{}),
-                fields.value(columnForKeyId, QVariant{}));
+                m_index.value(column, row),
+                columnForKeyId >= 0 ? m_index.value(columnForKeyId, row) : QVariant{});
     }
-    return fields.value(column, QVariant{});
+    return m_index.value(column, row);
 }
 
 void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
@@ -455,75 +509,93 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         return;
     }
 
-    if (!m_bIndexBuilt) {
-        buildIndex();
-    }
-
-    QStringList idStrings;
-    // TODO(rryan) consider making this the data passed in and a separate
-    // QVector for output
-    QSet<TrackId> dirtyTracks;
-    for (const auto& trackId: trackIds) {
-        idStrings << trackId.toString();
-        if (m_dirtyTracks.contains(trackId)) {
-            dirtyTracks.insert(trackId);
-        }
-    }
-
-    QStringList queryFragments;
-    if (!extraFilter.isNull() && extraFilter != "") {
-        queryFragments << QString("(%1)").arg(extraFilter);
-    }
-    if (idStrings.size() > 0) {
-        queryFragments << QString("%1 in (%2)")
-                .arg(m_idColumn, idStrings.join(","));
-    }
-
     const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
+            prepareFilterAndSort(
                     searchQuery,
-                    queryFragments.join(" AND "));
+                    extraFilter);
+
+    *trackToIndex = filterAndSort(m_database,
+            trackIds,
+            *pQuery,
+            searchQuery.isEmpty(),
+            orderByClause,
+            sortColumns,
+            columnOffset);
+}
 
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
+std::unique_ptr<QueryNode> BaseTrackCache::prepareFilterAndSort(
+        const QString& searchQuery,
+        const QString& extraFilter) {
+    if (!m_bIndexBuilt) {
+        buildIndex();
     }
 
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
+    return m_pQueryParser->parseQuery(
+            searchQuery,
+            extraFilter);
+}
 
-    if (sDebug) {
-        qDebug() << this << "select() executing:" << queryString;
+QHash<TrackId, int> BaseTrackCache::filterAndSort(const QSqlDatabase& database,
+        const QSet<TrackId>& trackIds,
+        const QueryNode& query,
+        bool isSearchEmpty,
+        const QString& orderByClause,
+        const QList<SortColumn>& sortColumns,
+        int columnOffset) const {
+    QHash<TrackId, int> trackToIndex;
+    // Skip processing if there are no tracks to filter or sort.
+    if (trackIds.size() == 0) {
+        return trackToIndex;
     }
 
-    QSqlQuery query(m_database);
-    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
-    // won't allocate a giant in-memory table that we won't use at all.
-    query.setForwardOnly(true);
-    query.prepare(queryString);
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    // TODO(rryan) consider making this the data passed in and a separate
+    // QVector for output
+    QSet<TrackId> dirtyTrackIds;
+    if (m_bIsCaching) {
+        const QMutexLocker locked(&m_mutex);
+        for (const auto& trackId : trackIds) {
+            if (m_dirtyTracks.contains(trackId)) {
+                dirtyTrackIds.insert(trackId);
+            }
+        }
     }
-
-    int idColumn = query.record().indexOf(m_idColumn);
-    int rows = query.size();
-
-    if (sDebug) {
-        qDebug() << "Rows returned:" << rows;
+    // The dirty tracks must be looked up before locking the mutex. The
+    // index is modified on the thread of this object while the global
+    // track cache is locked, i.e. the locks are acquired in this order.
+    //
+    // Only get the tracks if they are in the cache. Tracks that are not
+    // cached in memory cannot be dirty. Bypass getCachedTrack() to not
+    // invalidate m_recentTrackId, which is not thread-safe.
+    QHash<TrackId, TrackPointer> dirtyTracks;
+    if (!dirtyTrackIds.isEmpty()) {
+        GlobalTrackCacheLocker cacheLocker;
+        for (const auto& trackId : std::as_const(dirtyTrackIds)) {
+            TrackPointer pTrack = cacheLocker.lookupTrackById(trackId);
+            if (pTrack) {
+                dirtyTracks.insert(trackId, std::move(pTrack));
+            }
+        }
     }
 
-    m_trackOrder.resize(0); // keeps allocated memory
-    trackToIndex->clear();
-    if (rows > 0) {
-        trackToIndex->reserve(rows);
-        m_trackOrder.reserve(rows);
+    QMutexLocker locked(&m_mutex);
+    QVector<TrackId> trackOrder;
+    if (!filterAndSortInIndex(trackIds,
+                query,
+                orderByClause,
+                sortColumns,
+                columnOffset,
+                &trackOrder)) {
+        trackOrder.resize(0);
+        // Don't block modifications of the index while
+        // waiting for the database
+        locked.unlock();
+        filterAndSortInDatabase(database, trackIds, query, orderByClause, &trackOrder);
+        locked.relock();
     }
 
-    while (query.next()) {
-        TrackId trackId(query.value(idColumn));
-        (*trackToIndex)[trackId] = m_trackOrder.size();
-        m_trackOrder.append(trackId);
+    trackToIndex.reserve(trackOrder.size());
+    for (int i = 0; i < trackOrder.size(); ++i) {
+        trackToIndex[trackOrder[i]] = i;
     }
 
     // At this point, the original set of tracks have been divided into two
@@ -535,26 +607,17 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     // membership of tracks in either set, we must then insertion-sort the
     // missing tracks into the resulting index list.
 
-    if (!m_bIsCaching || dirtyTracks.isEmpty()) {
-        return;
-    }
-
-    for (TrackId trackId : std::as_const(dirtyTracks)) {
-        // Only get the track if it is in the cache. Tracks that
-        // are not cached in memory cannot be dirty.
-        // Bypass getCachedTrack() to not invalidate m_recentTrackId
-        TrackPointer pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId);
-        if (!pTrack) {
-            continue;
-        }
+    for (auto it = dirtyTracks.constBegin(); it != dirtyTracks.constEnd(); ++it) {
+        const TrackId& trackId = it.key();
+        const TrackPointer& pTrack = it.value();
 
         // The track should be in the result set if the search is empty or the
         // track matches the search.
-        bool shouldBeInResultSet = searchQuery.isEmpty() ||
-                pQuery->match(pTrack);
+        bool shouldBeInResultSet = isSearchEmpty ||
+                query.match(pTrack);
 
         // If the track is in this result set.
-        bool isInResultSet = trackToIndex->contains(trackId);
+        bool isInResultSet = trackToIndex.contains(trackId);
 
         if (shouldBeInResultSet) {
             // Track should be in result set...
@@ -562,15 +625,15 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
             // Remove the track from the results first (we have to do this or it
             // will sort wrong).
             if (isInResultSet) {
-                int index = (*trackToIndex)[trackId];
-                m_trackOrder.remove(index);
+                int index = trackToIndex[trackId];
+                trackOrder.remove(index);
                 // Don't update trackToIndex, since we do it below.
             }
 
             // Figure out where it is supposed to sort. The table is sorted by
             // the sort column, so we can binary search.
             int insertRow = findSortInsertionPoint(
-                    pTrack, sortColumns, columnOffset, m_trackOrder);
+                    pTrack, sortColumns, columnOffset, trackOrder, dirtyTracks);
 
             if (sDebug) {
                 qDebug() << this
@@ -579,32 +642,256 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
             }
 
             // The track should sort at insertRow
-            m_trackOrder.insert(insertRow, trackId);
+            trackOrder.insert(insertRow, trackId);
 
-            trackToIndex->clear();
+            trackToIndex.clear();
             // Fix the index. TODO(rryan) find a non-stupid way to do this.
-            for (int i = 0; i < m_trackOrder.size(); ++i) {
-                (*trackToIndex)[m_trackOrder[i]] = i;
+            for (int i = 0; i < trackOrder.size(); ++i) {
+                trackToIndex[trackOrder[i]] = i;
             }
         } else if (isInResultSet) {
             // Track should not be in this result set, but it is. We need to
             // remove it.
-            int index = (*trackToIndex)[trackId];
-            m_trackOrder.remove(index);
+            int index = trackToIndex[trackId];
+            trackOrder.remove(index);
 
-            trackToIndex->clear();
+            trackToIndex.clear();
             // Fix the index. TODO(rryan) find a non-stupid way to do this.
-            for (int i = 0; i < m_trackOrder.size(); ++i) {
-                (*trackToIndex)[m_trackOrder[i]] = i;
+            for (int i = 0; i < trackOrder.size(); ++i) {
+                trackToIndex[trackOrder[i]] = i;
+            }
+        }
+    }
+    return trackToIndex;
+}
+
+bool BaseTrackCache::filterAndSortInIndex(const QSet<TrackId>& trackIds,
+        const QueryNode& query,
+        const QString& orderByClause,
+        const QList<SortColumn>& sortColumns,
+        int columnOffset,
+        QVector<TrackId>* pTrackOrder) const {
+    PerformanceTimer timer;
+    timer.start();
+
+    std::vector<SortColumn> indexSortColumns;
+    if (!orderByClause.isEmpty()) {
+        indexSortColumns.reserve(sortColumns.size());
+        for (const auto& sc : sortColumns) {
+            const int column = sc.m_column - columnOffset;
+            if (column <= 0 || column >= columnCount()) {
+                // Sorting by the id or by columns of the table model, e.g.
+                // the random order of the preview column, is done by the
+                // database
+                return false;
+            }
+            indexSortColumns.emplace_back(column, sc.m_order);
+        }
+    }
+
+    std::vector<int> rows;
+    rows.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        const int row = m_index.rowOf(trackId);
+        if (row < 0) {
+            // Not cached (yet)
+            return false;
+        }
+        rows.push_back(row);
+    }
+    // Ascending rows are accessed sequentially in all columns
+    std::sort(rows.begin(), rows.end());
+
+    std::vector<MatchResult> results;
+    if (!query.evaluate(m_index, rows, &results)) {
+        if (sDebug) {
+            qDebug() << this << "filterAndSortInIndex() not supported:" << query.toSql();
+        }
+        return false;
+    }
+    std::size_t matchCount = 0;
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        if (results[i] == MatchResult::True) {
+            rows[matchCount++] = rows[i];
+        }
+    }
+    rows.resize(matchCount);
+
+    if (!indexSortColumns.empty()) {
+        sortRowsInIndex(&rows, indexSortColumns);
+    }
+
+    pTrackOrder->reserve(static_cast<int>(rows.size()));
+    for (const int row : rows) {
+        pTrackOrder->append(m_index.trackIdAt(row));
+    }
+
+    if (sDebug) {
+        qDebug() << this << "filterAndSortInIndex() returned" << pTrackOrder->size()
+                 << "of" << trackIds.size() << "rows in"
+                 << timer.elapsed().debugMillisWithUnit();
+    }
+    return true;
+}
+
+void BaseTrackCache::sortRowsInIndex(std::vector<int>* pRows,
+        const std::vector<SortColumn>& sortColumns) const {
+    const std::size_t rowCount = pRows->size();
+    const std::size_t keyCount = sortColumns.size();
+    const int keyColumn = fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY);
+    const int keyIdColumn = fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY_ID);
+    const KeyUtils::KeyNotation keyNotation = m_columnCache.keyNotation();
+
+    // Numeric sort keys of all rows with the same order as
+    // compareColumnValues(), stored row by row
+    std::vector<double> sortKeys(rowCount * keyCount);
+    for (std::size_t k = 0; k < keyCount; ++k) {
+        const int column = sortColumns[k].m_column;
+        const double sign = sortColumns[k].m_order == Qt::DescendingOrder ? -1.0 : 1.0;
+        // Sort keys that are derived from texts only need
+        // to be computed once for each distinct text
+        std::vector<double> textSortKeys;
+        const std::vector<int>* pTextRanks = nullptr;
+        if (sortsNumerically(column)) {
+            if (!m_index.isNumericColumn(column)) {
+                textSortKeys.assign(m_index.textCount(), std::nan(""));
             }
+        } else if (column == keyColumn) {
+            textSortKeys.assign(m_index.textCount(), std::nan(""));
+        } else {
+            pTextRanks = &m_index.textRanks(column, m_collator);
+        }
+        for (std::size_t i = 0; i < rowCount; ++i) {
+            const int row = (*pRows)[i];
+            double sortKey;
+            if (pTextRanks) {
+                sortKey = (*pTextRanks)[m_index.textId(column, row)];
+            } else if (textSortKeys.empty()) {
+                // Like QVariant::toDouble() for NULL
+                sortKey = m_index.number(column, row);
+                if (std::isnan(sortKey)) {
+                    sortKey = 0.0;
+                }
+            } else {
+                if (column == keyColumn && keyIdColumn >= 0 &&
+                        m_index.isNumericColumn(keyIdColumn)) {
+                    // The key is displayed from the KEY_ID column if
+                    // available, see data()
+                    const double keyId = m_index.number(keyIdColumn, row);
+                    const auto key = std::isnan(keyId)
+                            ? mixxx::track::io::key::INVALID
+                            : KeyUtils::keyFromNumericValue(static_cast<int>(keyId));
+                    if (key != mixxx::track::io::key::INVALID) {
+                        sortKeys[i * keyCount + k] = sign *
+                                KeyUtils::keyToCircleOfFifthsOrder(key, keyNotation);
+                        continue;
+                    }
+                }
+                const quint32 textId = m_index.textId(column, row);
+                sortKey = textSortKeys[textId];
+                if (std::isnan(sortKey)) {
+                    const QString& text = m_index.text(textId);
+                    if (column == keyColumn) {
+                        sortKey = KeyUtils::keyToCircleOfFifthsOrder(
+                                KeyUtils::guessKeyFromText(text), keyNotation);
+                    } else {
+                        sortKey = text.toDouble();
+                    }
+                    textSortKeys[textId] = sortKey;
+                }
+            }
+            sortKeys[i * keyCount + k] = sign * sortKey;
         }
     }
+
+    std::vector<std::size_t> positions(rowCount);
+    for (std::size_t i = 0; i < rowCount; ++i) {
+        positions[i] = i;
+    }
+    std::sort(positions.begin(),
+            positions.end(),
+            [&sortKeys, keyCount, pRows](std::size_t lhs, std::size_t rhs) {
+                for (std::size_t k = 0; k < keyCount; ++k) {
+                    const double lhsKey = sortKeys[lhs * keyCount + k];
+                    const double rhsKey = sortKeys[rhs * keyCount + k];
+                    if (lhsKey != rhsKey) {
+                        return lhsKey < rhsKey;
+                    }
+                }
+                // Keep the order of rows with equal sort keys stable
+                return (*pRows)[lhs] < (*pRows)[rhs];
+            });
+    std::vector<int> sortedRows(rowCount);
+    for (std::size_t i = 0; i < rowCount; ++i) {
+        sortedRows[i] = (*pRows)[positions[i]];
+    }
+    *pRows = std::move(sortedRows);
+}
+
+void BaseTrackCache::filterAndSortInDatabase(const QSqlDatabase& database,
+        const QSet<TrackId>& trackIds,
+        const QueryNode& query,
+        const QString& orderByClause,
+        QVector<TrackId>* pTrackOrder) const {
+    QStringList idStrings;
+    idStrings.reserve(trackIds.size());
+    for (const auto& trackId: trackIds) {
+        idStrings << trackId.toString();
+    }
+
+    QStringList queryFragments;
+    const QString querySql = query.toSql();
+    if (!querySql.isEmpty()) {
+        queryFragments << QString("(%1)").arg(querySql);
+    }
+    if (idStrings.size() > 0) {
+        queryFragments << QString("%1 in (%2)")
+                .arg(m_idColumn, idStrings.join(","));
+    }
+
+    QString filter = queryFragments.join(" AND ");
+    if (!filter.isEmpty()) {
+        filter.prepend("WHERE ");
+    }
+
+    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
+            .arg(m_idColumn, m_tableName, filter, orderByClause);
+
+    if (sDebug) {
+        qDebug() << this << "select() executing:" << queryString;
+    }
+
+    QSqlQuery sqlQuery(database);
+    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
+    // won't allocate a giant in-memory table that we won't use at all.
+    sqlQuery.setForwardOnly(true);
+    sqlQuery.prepare(queryString);
+
+    if (!sqlQuery.exec()) {
+        LOG_FAILED_QUERY(sqlQuery);
+    }
+
+    int idColumn = sqlQuery.record().indexOf(m_idColumn);
+    int rows = sqlQuery.size();
+
+    if (sDebug) {
+        qDebug() << "Rows returned:" << rows;
+    }
+
+    if (rows > 0) {
+        pTrackOrder->reserve(rows);
+    }
+
+    while (sqlQuery.next()) {
+        pTrackOrder->append(TrackId(sqlQuery.value(idColumn)));
+    }
 }
 
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
         const QList<SortColumn>& sortColumns,
         const int columnOffset,
-        const QVector<TrackId>& trackIds) const {
+        const QVector<TrackId>& trackIds,
+        const QHash<TrackId, TrackPointer>& dirtyTracks) const {
     QList<QVariant> trackValues;
     if (sortColumns.isEmpty()) {
         return 0;
@@ -629,18 +916,27 @@ int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
 
         // This should not happen, but it's a recoverable error so we should
         // only log it.
-        if (!m_trackInfo.contains(otherTrackId)) {
+        if (!isCached(otherTrackId)) {
             qDebug() << "WARNING: track" << otherTrackId << "was not in index";
             //updateTrackInIndex(otherTrackId);
         }
 
+        // Only the values of dirty tracks differ from the
+        // values in the index
+        const TrackPointer pOtherTrack = dirtyTracks.value(otherTrackId);
         int compare = 0;
         for (int i = 0; i < sortColumns.count(); i++) {
-            QVariant tableValue =
-                    data(otherTrackId, sortColumns[i].m_column - columnOffset);
+            const int column = sortColumns[i].m_column - columnOffset;
+            QVariant tableValue;
+            if (pOtherTrack) {
+                tableValue = getTrackValueForColumn(pOtherTrack, column);
+            }
+            if (!tableValue.isValid()) {
+                tableValue = getTrackInfoValueForColumn(otherTrackId, column);
+            }
 
             compare = compareColumnValues(
-                    sortColumns[i].m_column - columnOffset,
+                    column,
                     sortColumns[i].m_order,
                     trackValues[i],
                     tableValue);
@@ -670,18 +966,7 @@ int BaseTrackCache::compareColumnValues(int sortColumn,
         const QVariant& val2) const {
     int result = 0;
 
-    if (sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_YEAR) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_DURATION) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_BITRATE) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_BPM) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_REPLAYGAIN) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_CHANNELS) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_RATING) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION)
-    ) {
+    if (sortsNumerically(sortColumn)) {
         // Sort as floats.
         double delta = val1.toDouble() - val2.toDouble();
 
@@ -717,3 +1002,17 @@ int BaseTrackCache::compareColumnValues(int sortColumn,
 
     return result;
 }
+
+bool BaseTrackCache::sortsNumerically(int column) const {
+    return column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_YEAR) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_DURATION) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_BITRATE) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_BPM) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_REPLAYGAIN) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_CHANNELS) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_RATING) ||
+            column == fieldIndex(ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION);
+}
@@ -2,6 +2,7 @@
 
 #include <QHash>
 #include <QList>
+#include <QMutex>
 #include <QObject>
 #include <QSet>
 #include <QSqlDatabase>
@@ -9,13 +10,16 @@
 #include <QStringList>
 #include <QVector>
 #include <memory>
+#include <vector>
 
 #include "library/columncache.h"
+#include "library/columnartrackindex.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/class.h"
 #include "util/string.h"
 
+class QueryNode;
 class SearchQueryParser;
 class TrackCollection;
 
@@ -35,6 +39,10 @@ class SortColumn {
 // waste of memory because all the table-models were caching the same data
 // (track properties). Furthermore, the base SQL tables of these table-models
 // involve complicated joins, which are very slow.
+//
+// Searching and sorting is done in a columnar in-memory index of the cached
+// values whenever possible. Only queries that contain plain SQL expressions
+// or sort by columns that are not cached are delegated to the database.
 class BaseTrackCache : public QObject {
     Q_OBJECT
   public:
@@ -58,6 +66,10 @@ class BaseTrackCache : public QObject {
     // Data access methods
     ////////////////////////////////////////////////////////////////////////////
 
+    const QString& tableName() const {
+        return m_tableName;
+    }
+
     virtual QVariant data(TrackId trackId, int column) const;
     virtual int columnCount() const;
     virtual int fieldIndex(const QString& column) const;
@@ -72,6 +84,24 @@ class BaseTrackCache : public QObject {
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
                                QHash<TrackId, int>* trackToIndex);
+
+    /// Builds the index if needed and parses a search query for the
+    /// thread-safe overload of filterAndSort(). Must be invoked on the
+    /// thread of this object, because both might access the database.
+    std::unique_ptr<QueryNode> prepareFilterAndSort(
+            const QString& query,
+            const QString& extraFilter);
+    /// Thread-safe overload of filterAndSort() for a query that has been
+    /// prepared by prepareFilterAndSort(). Queries that cannot be evaluated
+    /// in memory are executed on the given database connection, which must
+    /// belong to the calling thread.
+    QHash<TrackId, int> filterAndSort(const QSqlDatabase& database,
+            const QSet<TrackId>& trackIds,
+            const QueryNode& query,
+            bool isSearchEmpty,
+            const QString& orderByClause,
+            const QList<SortColumn>& sortColumns,
+            int columnOffset) const;
     virtual bool isCached(TrackId trackId) const;
     virtual void ensureCached(TrackId trackId);
 
@@ -97,15 +127,36 @@ class BaseTrackCache : public QObject {
     bool updateTrackInIndex(const TrackPointer& pTrack);
     void updateTracksInIndex(const QSet<TrackId>& trackIds);
     QVariant getTrackValueForColumn(TrackPointer pTrack, int column) const;
-
+    QVariant getTrackInfoValueForColumn(TrackId trackId, int column) const;
+
+    // Both store the results in pTrackOrder. Must be invoked
+    // while holding m_mutex.
+    bool filterAndSortInIndex(const QSet<TrackId>& trackIds,
+            const QueryNode& query,
+            const QString& orderByClause,
+            const QList<SortColumn>& sortColumns,
+            int columnOffset,
+            QVector<TrackId>* pTrackOrder) const;
+    void filterAndSortInDatabase(const QSqlDatabase& database,
+            const QSet<TrackId>& trackIds,
+            const QueryNode& query,
+            const QString& orderByClause,
+            QVector<TrackId>* pTrackOrder) const;
+    // Sorts rows of m_index like compareColumnValues()
+    void sortRowsInIndex(std::vector<int>* pRows,
+            const std::vector<SortColumn>& sortColumns) const;
+
+    // Must be invoked while holding m_mutex
     int findSortInsertionPoint(TrackPointer pTrack,
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
-                               const QVector<TrackId>& trackIds) const;
+                               const QVector<TrackId>& trackIds,
+                               const QHash<TrackId, TrackPointer>& dirtyTracks) const;
     int compareColumnValues(int sortColumn,
             Qt::SortOrder sortOrder,
             const QVariant& val1,
             const QVariant& val2) const;
+    bool sortsNumerically(int column) const;
 
     const QString m_tableName;
     const QString m_idColumn;
@@ -118,9 +169,15 @@ class BaseTrackCache : public QObject {
 
     const mixxx::StringCollator m_collator;
 
-    // Temporary storage for filterAndSort()
+    // Serializes the thread-safe filterAndSort() with modifications
+    // of m_index and m_dirtyTracks. These members are
+    // only modified on the thread of this object, which doesn't need
+    // to lock the mutex for reading them.
+    mutable QMutex m_mutex;
 
-    QVector<TrackId> m_trackOrder;
+    // The cached values of all tracks. The text ranks are computed
+    // on demand, i.e. sorting also requires to lock m_mutex.
+    mutable ColumnarTrackIndex m_index;
 
     // Remember key and value of the most recent cache lookup to avoid querying
     // the global track cache again and again while populating the columns
@@ -136,7 +193,6 @@ class BaseTrackCache : public QObject {
 
     bool m_bIndexBuilt;
     bool m_bIsCaching;
-    QHash<TrackId, QVector<QVariant>> m_trackInfo;
     QSqlDatabase m_database;
 
     DISALLOW_COPY_AND_ASSIGN(BaseTrackCache);
@@ -0,0 +1,228 @@
+#include "library/columnartrackindex.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "util/db/dbconnection.h"
+
+namespace {
+
+constexpr int kUnranked = -1;
+
+constexpr double kNullNumber = std::numeric_limits<double>::quiet_NaN();
+
+/// The value kind of invalid QVariants, i.e. of empty rows
+constexpr quint8 kInvalidValueKind = 0;
+
+/// Values of these types are restored from their interned text
+/// instead of storing them as QVariant
+bool isRestorableFromText(int typeId) {
+    switch (typeId) {
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+    case QMetaType::QString:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Binary values are not interned, because their text is
+/// neither displayed nor searched
+bool hasText(int typeId) {
+    return typeId != QMetaType::QByteArray;
+}
+
+QVariant nullValueOfType(int typeId) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return QVariant(QMetaType(typeId));
+#else
+    return QVariant(typeId, nullptr);
+#endif
+}
+
+} // anonymous namespace
+
+ColumnarTrackIndex::ColumnarTrackIndex(
+        QStringList columnNames,
+        std::vector<bool> numericColumns)
+        : m_columns(columnNames.size()) {
+    DEBUG_ASSERT(numericColumns.size() == m_columns.size());
+    for (int i = 0; i < columnNames.size(); ++i) {
+        m_columns[i].numeric = i < static_cast<int>(numericColumns.size()) &&
+                numericColumns[i];
+        m_columnIndicesByName.insert(columnNames[i], i);
+    }
+    m_valueKinds.push_back(ValueKind{QMetaType::UnknownType, true});
+    DEBUG_ASSERT(m_valueKinds.size() == kInvalidValueKind + 1u);
+    clear();
+}
+
+void ColumnarTrackIndex::clear() {
+    for (auto& column : m_columns) {
+        column.valueKinds.clear();
+        column.textIds.clear();
+        column.numbers.clear();
+        column.textRanks.clear();
+        column.textRanksValid = false;
+    }
+    m_opaqueValues.clear();
+    m_trackIds.clear();
+    m_rowsByTrackId.clear();
+    m_texts.clear();
+    m_foldedTexts.clear();
+    m_textIdsByText.clear();
+    // Reserve kNullTextId
+    m_texts.emplace_back();
+    m_foldedTexts.emplace_back();
+}
+
+quint32 ColumnarTrackIndex::internText(const QString& text) {
+    const auto it = m_textIdsByText.constFind(text);
+    if (it != m_textIdsByText.constEnd()) {
+        return it.value();
+    }
+    const auto textId = static_cast<quint32>(m_texts.size());
+    QString foldedText = text;
+    mixxx::DbConnection::makeStringLatinLow(&foldedText);
+    m_texts.push_back(text);
+    m_foldedTexts.push_back(std::move(foldedText));
+    m_textIdsByText.insert(text, textId);
+    return textId;
+}
+
+quint8 ColumnarTrackIndex::valueKindOf(const QVariant& value) {
+    const ValueKind valueKind{value.userType(), value.isNull()};
+    const auto it = std::find(m_valueKinds.cbegin(), m_valueKinds.cend(), valueKind);
+    if (it != m_valueKinds.cend()) {
+        return static_cast<quint8>(it - m_valueKinds.cbegin());
+    }
+    // There are only a few different types in the columns of a table
+    VERIFY_OR_DEBUG_ASSERT(m_valueKinds.size() <= std::numeric_limits<quint8>::max()) {
+        return kInvalidValueKind;
+    }
+    m_valueKinds.push_back(valueKind);
+    return static_cast<quint8>(m_valueKinds.size() - 1);
+}
+
+QVariant ColumnarTrackIndex::value(int column, int row) const {
+    const Column& indexColumn = m_columns[column];
+    const ValueKind& valueKind = m_valueKinds[indexColumn.valueKinds[row]];
+    if (valueKind.null) {
+        return nullValueOfType(valueKind.typeId);
+    }
+    if (!isRestorableFromText(valueKind.typeId)) {
+        return m_opaqueValues.value(cellKey(column, row));
+    }
+    const QString& valueText = text(indexColumn.textIds[row]);
+    if (valueKind.typeId == QMetaType::QString) {
+        return valueText;
+    }
+    if (valueKind.typeId == QMetaType::Double && indexColumn.numeric) {
+        return indexColumn.numbers[row];
+    }
+    QVariant value = valueText;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    value.convert(QMetaType(valueKind.typeId));
+#else
+    value.convert(valueKind.typeId);
+#endif
+    return value;
+}
+
+void ColumnarTrackIndex::setRow(TrackId trackId, const QVector<QVariant>& values) {
+    VERIFY_OR_DEBUG_ASSERT(trackId.isValid()) {
+        return;
+    }
+    int row = rowOf(trackId);
+    if (row < 0) {
+        row = rowCount();
+        m_trackIds.push_back(trackId);
+        m_rowsByTrackId.insert(trackId, row);
+        for (auto& column : m_columns) {
+            column.valueKinds.push_back(kInvalidValueKind);
+            column.textIds.push_back(kNullTextId);
+            if (column.numeric) {
+                column.numbers.push_back(kNullNumber);
+            }
+        }
+    }
+    for (int i = 0; i < static_cast<int>(m_columns.size()); ++i) {
+        Column& column = m_columns[i];
+        const QVariant value = values.value(i);
+        const quint8 valueKind = valueKindOf(value);
+        const ValueKind& kind = m_valueKinds[valueKind];
+        if (!kind.null && !isRestorableFromText(kind.typeId)) {
+            m_opaqueValues.insert(cellKey(i, row), value);
+        } else if (!m_opaqueValues.isEmpty()) {
+            m_opaqueValues.remove(cellKey(i, row));
+        }
+        column.valueKinds[row] = valueKind;
+        const quint32 textId = (kind.null || !hasText(kind.typeId))
+                ? kNullTextId
+                : internText(value.toString());
+        column.textIds[row] = textId;
+        if (column.textRanksValid &&
+                (textId >= column.textRanks.size() ||
+                        column.textRanks[textId] == kUnranked)) {
+            column.textRanksValid = false;
+        }
+        if (column.numeric) {
+            bool ok = false;
+            const double number = value.toDouble(&ok);
+            column.numbers[row] = (ok && !value.isNull()) ? number : kNullNumber;
+        }
+    }
+}
+
+void ColumnarTrackIndex::removeRow(TrackId trackId) {
+    const int row = rowOf(trackId);
+    if (row < 0) {
+        return;
+    }
+    m_rowsByTrackId.remove(trackId);
+    m_trackIds[row] = TrackId();
+    for (int i = 0; i < static_cast<int>(m_columns.size()); ++i) {
+        Column& column = m_columns[i];
+        if (!m_opaqueValues.isEmpty()) {
+            m_opaqueValues.remove(cellKey(i, row));
+        }
+        column.valueKinds[row] = kInvalidValueKind;
+        column.textIds[row] = kNullTextId;
+        if (column.numeric) {
+            column.numbers[row] = kNullNumber;
+        }
+    }
+}
+
+const std::vector<int>& ColumnarTrackIndex::textRanks(
+        int column,
+        const mixxx::StringCollator& collator) {
+    Column& indexColumn = m_columns[column];
+    if (indexColumn.textRanksValid) {
+        return indexColumn.textRanks;
+    }
+    std::vector<quint32> textIds = indexColumn.textIds;
+    std::sort(textIds.begin(), textIds.end());
+    textIds.erase(std::unique(textIds.begin(), textIds.end()), textIds.end());
+    std::sort(textIds.begin(),
+            textIds.end(),
+            [this, &collator](quint32 lhs, quint32 rhs) {
+                return collator.compare(m_texts[lhs], m_texts[rhs]) < 0;
+            });
+    indexColumn.textRanks.assign(m_texts.size(), kUnranked);
+    int rank = 0;
+    for (std::size_t i = 0; i < textIds.size(); ++i) {
+        if (i > 0 &&
+                collator.compare(m_texts[textIds[i - 1]], m_texts[textIds[i]]) != 0) {
+            ++rank;
+        }
+        indexColumn.textRanks[textIds[i]] = rank;
+    }
+    indexColumn.textRanksValid = true;
+    return indexColumn.textRanks;
+}
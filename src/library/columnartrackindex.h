@@ -0,0 +1,155 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <vector>
+
+#include "track/trackid.h"
+#include "util/assert.h"
+#include "util/string.h"
+
+/// The compact in-memory storage of the columns of a BaseTrackCache for
+/// displaying, searching, and sorting without querying the database.
+///
+/// Each column is stored as a flat array with one entry per row. Text
+/// values are interned, i.e. each distinct value is only stored and
+/// case-folded once and rows only refer to it by id. Numeric columns
+/// additionally store their values as plain doubles.
+///
+/// The type of each value is recorded in a single byte, such that
+/// value() restores the original QVariant. Only values of types that
+/// can't be restored from their text, e.g. QDateTime and QByteArray,
+/// are stored as QVariant. Binary values like digests are unique for
+/// each track and are not interned as text, i.e. they can't be searched
+/// and are sorted like NULL.
+///
+/// Rows are assigned to tracks when they are inserted and remain stable
+/// until the index is cleared. Removed tracks leave an empty row behind.
+class ColumnarTrackIndex {
+  public:
+    /// The text id of NULL values
+    static constexpr quint32 kNullTextId = 0;
+
+    /// The values of columns that are flagged as numeric are
+    /// also stored as numbers.
+    ColumnarTrackIndex(
+            QStringList columnNames,
+            std::vector<bool> numericColumns);
+
+    void clear();
+
+    /// Inserts or replaces the values of a track. The values are
+    /// ordered like the column names.
+    void setRow(TrackId trackId, const QVector<QVariant>& values);
+    void removeRow(TrackId trackId);
+
+    int columnCount() const {
+        return static_cast<int>(m_columns.size());
+    }
+
+    /// The number of rows, including the empty rows of removed tracks
+    int rowCount() const {
+        return static_cast<int>(m_trackIds.size());
+    }
+
+    /// Returns -1 if the track is not contained in the index
+    int rowOf(TrackId trackId) const {
+        return m_rowsByTrackId.value(trackId, -1);
+    }
+
+    /// Returns an invalid id for the empty rows of removed tracks
+    const TrackId& trackIdAt(int row) const {
+        return m_trackIds[row];
+    }
+
+    /// Returns the value as it has been passed to setRow()
+    QVariant value(int column, int row) const;
+
+    /// Returns -1 if there is no column with this name
+    int columnIndex(const QString& columnName) const {
+        return m_columnIndicesByName.value(columnName, -1);
+    }
+
+    bool isNumericColumn(int column) const {
+        return m_columns[column].numeric;
+    }
+
+    quint32 textId(int column, int row) const {
+        return m_columns[column].textIds[row];
+    }
+
+    /// Returns NaN for NULL and non-numeric values. Only
+    /// available for numeric columns.
+    double number(int column, int row) const {
+        DEBUG_ASSERT(m_columns[column].numeric);
+        return m_columns[column].numbers[row];
+    }
+
+    /// The number of distinct texts in all columns
+    int textCount() const {
+        return static_cast<int>(m_texts.size());
+    }
+
+    const QString& text(quint32 textId) const {
+        return m_texts[textId];
+    }
+
+    /// The text folded like both sides of a LIKE comparison in SQL,
+    /// see DbConnection::makeStringLatinLow()
+    const QString& foldedText(quint32 textId) const {
+        return m_foldedTexts[textId];
+    }
+
+    /// The positions of the texts of a column in collation order,
+    /// indexed by text id. Texts that compare equal have the same
+    /// rank. Texts that are not used in this column are not ranked.
+    ///
+    /// The ranks are computed on demand and reused until new texts
+    /// appear in the column.
+    const std::vector<int>& textRanks(
+            int column,
+            const mixxx::StringCollator& collator);
+
+  private:
+    /// The type of a value and whether it is NULL
+    struct ValueKind {
+        int typeId;
+        bool null;
+
+        bool operator==(const ValueKind& other) const {
+            return typeId == other.typeId && null == other.null;
+        }
+    };
+
+    struct Column {
+        bool numeric = false;
+        std::vector<quint8> valueKinds;
+        std::vector<quint32> textIds;
+        std::vector<double> numbers;
+        std::vector<int> textRanks;
+        bool textRanksValid = false;
+    };
+
+    quint32 internText(const QString& text);
+    quint8 valueKindOf(const QVariant& value);
+
+    static quint64 cellKey(int column, int row) {
+        return (static_cast<quint64>(row) << 32) | static_cast<quint32>(column);
+    }
+
+    std::vector<Column> m_columns;
+    QHash<QString, int> m_columnIndicesByName;
+
+    std::vector<ValueKind> m_valueKinds;
+    QHash<quint64, QVariant> m_opaqueValues;
+
+    std::vector<TrackId> m_trackIds;
+    QHash<TrackId, int> m_rowsByTrackId;
+
+    std::vector<QString> m_texts;
+    std::vector<QString> m_foldedTexts;
+    QHash<QString, quint32> m_textIdsByText;
+};
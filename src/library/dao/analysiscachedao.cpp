@@ -0,0 +1,219 @@
+#include "library/dao/analysiscachedao.h"
+
+#include <QFile>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QVariant>
+
+#include "library/queryutil.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("AnalysisCacheDao");
+
+// Bumped on incompatible changes of the exported table
+constexpr int kExportFormatVersion = 1;
+
+const QString kExportSchema = QStringLiteral("analysis_cache_export");
+
+const QString kColumns = QStringLiteral(
+        "content_hash,"
+        "beats_version,beats_sub_version,beats,"
+        "keys_version,keys_sub_version,keys,"
+        "replaygain,replaygain_peak,"
+        "waveform_version,waveform_description,waveform,"
+        "wavesummary_version,wavesummary_description,wavesummary,"
+        "updated_at");
+
+QVariant nullIfEmpty(const QString& value) {
+    return value.isEmpty() ? QVariant() : QVariant(value);
+}
+
+QVariant nullIfEmpty(const QByteArray& value) {
+    return value.isEmpty() ? QVariant() : QVariant(value);
+}
+
+bool attachDatabase(const QSqlDatabase& database, const QString& filePath) {
+    QSqlQuery query(database);
+    query.prepare(QStringLiteral("ATTACH DATABASE :file_path AS %1").arg(kExportSchema));
+    query.bindValue(":file_path", filePath);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "Failed to attach" << filePath;
+        return false;
+    }
+    return true;
+}
+
+void detachDatabase(const QSqlDatabase& database) {
+    QSqlQuery query(database);
+    if (!query.exec(QStringLiteral("DETACH DATABASE %1").arg(kExportSchema))) {
+        LOG_FAILED_QUERY(query);
+    }
+}
+
+} // anonymous namespace
+
+std::optional<AnalysisCacheDao::Entry> AnalysisCacheDao::findEntry(
+        const QByteArray& contentHash) const {
+    DEBUG_ASSERT(!contentHash.isEmpty());
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "SELECT * FROM analysis_cache WHERE content_hash=:content_hash"));
+    query.bindValue(":content_hash", contentHash);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return std::nullopt;
+    }
+    if (!query.next()) {
+        return std::nullopt;
+    }
+
+    const QSqlRecord record = query.record();
+    Entry entry;
+    entry.beatsVersion = query.value(record.indexOf("beats_version")).toString();
+    entry.beatsSubVersion = query.value(record.indexOf("beats_sub_version")).toString();
+    entry.beats = query.value(record.indexOf("beats")).toByteArray();
+    entry.keysVersion = query.value(record.indexOf("keys_version")).toString();
+    entry.keysSubVersion = query.value(record.indexOf("keys_sub_version")).toString();
+    entry.keys = query.value(record.indexOf("keys")).toByteArray();
+    const QVariant replayGainRatio = query.value(record.indexOf("replaygain"));
+    if (!replayGainRatio.isNull()) {
+        entry.replayGain.setRatio(replayGainRatio.toDouble());
+    }
+    const QVariant replayGainPeak = query.value(record.indexOf("replaygain_peak"));
+    if (!replayGainPeak.isNull()) {
+        entry.replayGain.setPeak(static_cast<CSAMPLE>(replayGainPeak.toDouble()));
+    }
+    entry.waveformVersion = query.value(record.indexOf("waveform_version")).toString();
+    entry.waveformDescription = query.value(record.indexOf("waveform_description")).toString();
+    entry.waveform = query.value(record.indexOf("waveform")).toByteArray();
+    entry.waveSummaryVersion = query.value(record.indexOf("wavesummary_version")).toString();
+    entry.waveSummaryDescription =
+            query.value(record.indexOf("wavesummary_description")).toString();
+    entry.waveSummary = query.value(record.indexOf("wavesummary")).toByteArray();
+    return entry;
+}
+
+bool AnalysisCacheDao::storeEntry(
+        const QByteArray& contentHash, const Entry& entry) const {
+    DEBUG_ASSERT(!contentHash.isEmpty());
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "INSERT INTO analysis_cache (%1) VALUES ("
+            ":content_hash,"
+            ":beats_version,:beats_sub_version,:beats,"
+            ":keys_version,:keys_sub_version,:keys,"
+            ":replaygain,:replaygain_peak,"
+            ":waveform_version,:waveform_description,:waveform,"
+            ":wavesummary_version,:wavesummary_description,:wavesummary,"
+            "CURRENT_TIMESTAMP) "
+            "ON CONFLICT(content_hash) DO UPDATE SET "
+            "beats_version=COALESCE(excluded.beats_version,beats_version),"
+            "beats_sub_version=CASE WHEN excluded.beats IS NULL "
+            "THEN beats_sub_version ELSE excluded.beats_sub_version END,"
+            "beats=COALESCE(excluded.beats,beats),"
+            "keys_version=COALESCE(excluded.keys_version,keys_version),"
+            "keys_sub_version=CASE WHEN excluded.keys IS NULL "
+            "THEN keys_sub_version ELSE excluded.keys_sub_version END,"
+            "keys=COALESCE(excluded.keys,keys),"
+            "replaygain=COALESCE(excluded.replaygain,replaygain),"
+            "replaygain_peak=COALESCE(excluded.replaygain_peak,replaygain_peak),"
+            "waveform_version=COALESCE(excluded.waveform_version,waveform_version),"
+            "waveform_description=COALESCE("
+            "excluded.waveform_description,waveform_description),"
+            "waveform=COALESCE(excluded.waveform,waveform),"
+            "wavesummary_version=COALESCE("
+            "excluded.wavesummary_version,wavesummary_version),"
+            "wavesummary_description=COALESCE("
+            "excluded.wavesummary_description,wavesummary_description),"
+            "wavesummary=COALESCE(excluded.wavesummary,wavesummary),"
+            "updated_at=excluded.updated_at")
+                    .arg(kColumns));
+    query.bindValue(":content_hash", contentHash);
+    query.bindValue(":beats_version", nullIfEmpty(entry.beatsVersion));
+    query.bindValue(":beats_sub_version", nullIfEmpty(entry.beatsSubVersion));
+    query.bindValue(":beats", nullIfEmpty(entry.beats));
+    query.bindValue(":keys_version", nullIfEmpty(entry.keysVersion));
+    query.bindValue(":keys_sub_version", nullIfEmpty(entry.keysSubVersion));
+    query.bindValue(":keys", nullIfEmpty(entry.keys));
+    query.bindValue(":replaygain",
+            entry.replayGain.hasRatio()
+                    ? QVariant(entry.replayGain.getRatio())
+                    : QVariant());
+    query.bindValue(":replaygain_peak",
+            entry.replayGain.hasPeak()
+                    ? QVariant(static_cast<double>(entry.replayGain.getPeak()))
+                    : QVariant());
+    query.bindValue(":waveform_version", nullIfEmpty(entry.waveformVersion));
+    query.bindValue(":waveform_description", nullIfEmpty(entry.waveformDescription));
+    query.bindValue(":waveform", nullIfEmpty(entry.waveform));
+    query.bindValue(":wavesummary_version", nullIfEmpty(entry.waveSummaryVersion));
+    query.bindValue(":wavesummary_description", nullIfEmpty(entry.waveSummaryDescription));
+    query.bindValue(":wavesummary", nullIfEmpty(entry.waveSummary));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return true;
+}
+
+bool AnalysisCacheDao::exportEntries(const QString& filePath) const {
+    if (QFile::exists(filePath) && !QFile::remove(filePath)) {
+        kLogger.warning() << "Failed to replace" << filePath;
+        return false;
+    }
+    if (!attachDatabase(m_database, filePath)) {
+        return false;
+    }
+    QSqlQuery query(m_database);
+    bool success = query.exec(QStringLiteral(
+            "CREATE TABLE %1.analysis_cache AS SELECT %2 FROM main.analysis_cache")
+                                      .arg(kExportSchema, kColumns));
+    if (success) {
+        success = query.exec(QStringLiteral("PRAGMA %1.user_version=%2")
+                                     .arg(kExportSchema,
+                                             QString::number(kExportFormatVersion)));
+    }
+    if (!success) {
+        LOG_FAILED_QUERY(query);
+    }
+    detachDatabase(m_database);
+    return success;
+}
+
+int AnalysisCacheDao::importEntries(const QString& filePath) const {
+    if (!QFile::exists(filePath)) {
+        kLogger.warning() << "File not found" << filePath;
+        return -1;
+    }
+    if (!attachDatabase(m_database, filePath)) {
+        return -1;
+    }
+    int importedCount = -1;
+    QSqlQuery query(m_database);
+    if (query.exec(QStringLiteral("PRAGMA %1.user_version").arg(kExportSchema)) &&
+            query.next()) {
+        const int formatVersion = query.value(0).toInt();
+        if (formatVersion == kExportFormatVersion) {
+            if (query.exec(QStringLiteral(
+                        "INSERT OR IGNORE INTO main.analysis_cache (%1) "
+                        "SELECT %1 FROM %2.analysis_cache")
+                                   .arg(kColumns, kExportSchema))) {
+                importedCount = query.numRowsAffected();
+            } else {
+                LOG_FAILED_QUERY(query);
+            }
+        } else {
+            kLogger.warning()
+                    << "Unsupported format version"
+                    << formatVersion
+                    << "of"
+                    << filePath;
+        }
+    } else {
+        LOG_FAILED_QUERY(query);
+    }
+    detachDatabase(m_database);
+    return importedCount;
+}
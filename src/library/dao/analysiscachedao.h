@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <optional>
+
+#include "library/dao/dao.h"
+#include "track/replaygain.h"
+
+/// Stores analysis results by the content hash of the decoded audio,
+/// independent of the file location and the track id in the library.
+class AnalysisCacheDao : public DAO {
+  public:
+    struct Entry {
+        QString beatsVersion;
+        QString beatsSubVersion;
+        QByteArray beats;
+        QString keysVersion;
+        QString keysSubVersion;
+        QByteArray keys;
+        mixxx::ReplayGain replayGain;
+        QString waveformVersion;
+        QString waveformDescription;
+        QByteArray waveform;
+        QString waveSummaryVersion;
+        QString waveSummaryDescription;
+        QByteArray waveSummary;
+    };
+
+    ~AnalysisCacheDao() override = default;
+
+    std::optional<Entry> findEntry(const QByteArray& contentHash) const;
+
+    /// Inserts or updates the entry. Empty results in the given entry
+    /// don't replace results that have been stored before.
+    bool storeEntry(const QByteArray& contentHash, const Entry& entry) const;
+
+    /// Writes all entries into a new SQLite database file that can be
+    /// imported into the library of another installation.
+    bool exportEntries(const QString& filePath) const;
+
+    /// Adds the entries from a file written by exportEntries(). Entries
+    /// that are already present are kept. Returns the number of imported
+    /// entries or -1 on failure.
+    int importEntries(const QString& filePath) const;
+};
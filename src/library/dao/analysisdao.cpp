@@ -17,6 +17,23 @@ const QString AnalysisDao::s_analysisTableName = "track_analysis";
 // CPU time so I think we should stick with the default. rryan 4/3/2012
 constexpr int kCompressionLevel = -1;
 
+// Data that is mapped into memory is compressed block by block and each
+// block is verified when it is decoded. Only the header is covered by the
+// checksum, otherwise all of it would need to be read.
+constexpr qint64 kMappableChecksumSize = 4096;
+
+namespace {
+
+int checksumOf(const QByteArray& data) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return qChecksum(data);
+#else
+    return qChecksum(data.constData(), data.length());
+#endif
+}
+
+} // anonymous namespace
+
 AnalysisDao::AnalysisDao(UserSettingsPointer pConfig)
         : m_pConfig(pConfig) {
     QDir storagePath = getAnalysisStoragePath();
@@ -84,15 +101,18 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
         int checksum = query->value(dataChecksumColumn).toInt();
         QString dataPath = analysisPath.absoluteFilePath(
             QString::number(info.analysisId));
+        const QByteArray mappableHeader = loadDataFromFile(dataPath, kMappableChecksumSize);
+        if (Waveform::isFlatByteArray(mappableHeader)) {
+            if (checksum != checksumOf(mappableHeader)) {
+                qDebug() << "WARNING: Corrupt analysis header loaded from" << dataPath;
+                continue;
+            }
+            info.mappableDataPath = dataPath;
+            analyses.append(info);
+            continue;
+        }
         const QByteArray compressedData = loadDataFromFile(dataPath);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        const int file_checksum = qChecksum(
-                compressedData);
-#else
-        const int file_checksum = qChecksum(
-                compressedData.constData(),
-                compressedData.length());
-#endif
+        const int file_checksum = checksumOf(compressedData);
         if (checksum != file_checksum) {
             qDebug() << "WARNING: Corrupt analysis loaded from" << dataPath
                      << "length" << compressedData.length();
@@ -120,15 +140,14 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
     PerformanceTimer time;
     time.start();
 
-    const QByteArray compressedData = qCompress(info->data, kCompressionLevel);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    const int checksum = qChecksum(
-            compressedData);
-#else
-    const int checksum = qChecksum(
-            compressedData.constData(),
-            compressedData.length());
-#endif
+    // The flat layout is already compressed block by block
+    const bool mappable = Waveform::isFlatByteArray(info->data);
+    const QByteArray compressedData = mappable
+            ? info->data
+            : qCompress(info->data, kCompressionLevel);
+    const int checksum = mappable
+            ? checksumOf(compressedData.left(kMappableChecksumSize))
+            : checksumOf(compressedData);
     QSqlQuery query(m_database);
     if (info->analysisId == -1) {
         query.prepare(QString(
@@ -262,7 +281,7 @@ QDir AnalysisDao::getAnalysisStoragePath() const {
     return dir.absolutePath().append("/");
 }
 
-QByteArray AnalysisDao::loadDataFromFile(const QString& filename) const {
+QByteArray AnalysisDao::loadDataFromFile(const QString& filename, qint64 maxSize) const {
     QFile file(filename);
     if (!file.exists()) {
         return QByteArray();
@@ -270,12 +289,21 @@ QByteArray AnalysisDao::loadDataFromFile(const QString& filename) const {
     if (!file.open(QIODevice::ReadOnly)) {
         return QByteArray();
     }
+    if (maxSize >= 0) {
+        return file.read(maxSize);
+    }
     return file.readAll();
 }
 
 bool AnalysisDao::deleteFile(const QString& fileName) const {
     QFile file(fileName);
-    return file.remove();
+    // Fails on Windows while the file is mapped by a loaded waveform
+    if (!file.remove() && file.exists()) {
+        qDebug() << "WARNING: Couldn't delete analysis data file" << fileName
+                 << file.errorString();
+        return false;
+    }
+    return true;
 }
 
 bool AnalysisDao::saveDataToFile(const QString& fileName, const QByteArray& data) const {
@@ -340,7 +368,8 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVEFORM;
     analysis.description = pWaveform->getDescription();
     analysis.version = pWaveform->getVersion();
-    analysis.data = pWaveform->toByteArray();
+    // Mapped into memory when loaded, see WaveformFactory
+    analysis.data = pWaveform->toFlatByteArray();
     bool success = saveAnalysis(&analysis);
     if (success) {
         pWaveform->setSaveState(Waveform::SaveState::Saved);
@@ -30,6 +30,10 @@ class AnalysisDao : public DAO {
         QString description;
         QString version;
         QByteArray data;
+        // Only set if the data is stored in a layout that is mapped into
+        // memory instead of being loaded, e.g. Waveform::toFlatByteArray().
+        // The data is empty in this case.
+        QString mappableDataPath;
     };
 
     explicit AnalysisDao(UserSettingsPointer pConfig);
@@ -59,7 +63,7 @@ class AnalysisDao : public DAO {
 
   private:
     QDir getAnalysisStoragePath() const;
-    QByteArray loadDataFromFile(const QString& fileName) const;
+    QByteArray loadDataFromFile(const QString& fileName, qint64 maxSize = -1) const;
     bool saveDataToFile(const QString& fileName, const QByteArray& data) const;
     bool deleteFile(const QString& filename) const;
     QList<AnalysisInfo> loadAnalysesFromQuery(TrackId trackId, QSqlQuery* query);
@@ -72,6 +72,28 @@ CuePointer cueFromRow(const QSqlRecord& row) {
     return pCue;
 }
 
+/// Appends a cue to the cues of a track. Hot cues with the same
+/// number that have been appended before are dropped.
+void appendCue(
+        QList<CuePointer>* pCues,
+        QMap<int, CuePointer>* pHotCuesByNumber,
+        const CuePointer& pCue) {
+    int hotCueNumber = pCue->getHotCue();
+    if (hotCueNumber != Cue::kNoHotCue) {
+        const auto pDuplicateCue = pHotCuesByNumber->take(hotCueNumber);
+        if (pDuplicateCue) {
+            kLogger.warning()
+                    << "Dropping hot cue"
+                    << pDuplicateCue->getId()
+                    << "with duplicate number"
+                    << hotCueNumber;
+            pCues->removeOne(pDuplicateCue);
+        }
+        pHotCuesByNumber->insert(hotCueNumber, pCue);
+    }
+    pCues->push_back(pCue);
+}
+
 } // namespace
 
 QList<CuePointer> CueDAO::getCuesForTrack(TrackId trackId) const {
@@ -98,24 +120,50 @@ QList<CuePointer> CueDAO::getCuesForTrack(TrackId trackId) const {
         if (!pCue) {
             continue;
         }
-        int hotCueNumber = pCue->getHotCue();
-        if (hotCueNumber != Cue::kNoHotCue) {
-            const auto pDuplicateCue = hotCuesByNumber.take(hotCueNumber);
-            if (pDuplicateCue) {
-                kLogger.warning()
-                        << "Dropping hot cue"
-                        << pDuplicateCue->getId()
-                        << "with duplicate number"
-                        << hotCueNumber;
-                cues.removeOne(pDuplicateCue);
-            }
-            hotCuesByNumber.insert(hotCueNumber, pCue);
-        }
-        cues.push_back(pCue);
+        appendCue(&cues, &hotCuesByNumber, pCue);
     }
     return cues;
 }
 
+QHash<TrackId, QList<CuePointer>> CueDAO::getCuesForTracks(
+        const QList<TrackId>& trackIds) const {
+    QHash<TrackId, QList<CuePointer>> cuesByTrackId;
+    if (trackIds.isEmpty()) {
+        return cuesByTrackId;
+    }
+    QStringList trackIdList;
+    trackIdList.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        trackIdList.append(trackId.toString());
+    }
+    FwdSqlQuery query(
+            m_database,
+            QStringLiteral("SELECT * FROM " CUE_TABLE " WHERE track_id IN (%1)")
+                    .arg(trackIdList.join(QChar(','))));
+    DEBUG_ASSERT(
+            query.isPrepared() &&
+            !query.hasError());
+    if (!query.execPrepared()) {
+        kLogger.warning()
+                << "Failed to load cues of"
+                << trackIds.size()
+                << "tracks";
+        DEBUG_ASSERT(!"failed query");
+        return cuesByTrackId;
+    }
+    QHash<TrackId, QMap<int, CuePointer>> hotCuesByTrackId;
+    while (query.next()) {
+        const QSqlRecord record = query.record();
+        CuePointer pCue = cueFromRow(record);
+        if (!pCue) {
+            continue;
+        }
+        const TrackId trackId(record.value(record.indexOf("track_id")));
+        appendCue(&cuesByTrackId[trackId], &hotCuesByTrackId[trackId], pCue);
+    }
+    return cuesByTrackId;
+}
+
 bool CueDAO::deleteCuesForTrack(TrackId trackId) const {
     qDebug() << "CueDAO::deleteCuesForTrack" << QThread::currentThread() << m_database.connectionName();
     QSqlQuery query(m_database);
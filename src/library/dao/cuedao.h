@@ -1,5 +1,8 @@
 #pragma once
 
+#include <QHash>
+#include <QList>
+
 #include "library/dao/dao.h"
 #include "track/cue.h"
 #include "track/trackid.h"
@@ -13,6 +16,10 @@ class CueDAO : public DAO {
     ~CueDAO() override = default;
 
     QList<CuePointer> getCuesForTrack(TrackId trackId) const;
+    /// Loads the cues of multiple tracks with a single query. Tracks
+    /// without cues are omitted.
+    QHash<TrackId, QList<CuePointer>> getCuesForTracks(
+            const QList<TrackId>& trackIds) const;
 
     void saveTrackCues(TrackId trackId, const QList<CuePointer>& cueList) const;
     bool deleteCuesForTrack(TrackId trackId) const;
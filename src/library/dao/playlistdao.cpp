@@ -170,6 +170,33 @@ QList<TrackId> PlaylistDAO::getTrackIdsInPlaylistOrder(const int playlistId) con
     return trackIds;
 }
 
+QList<TrackId> PlaylistDAO::getRecentlyAddedTrackIds(
+        HiddenType hidden, int maxCount) const {
+    QList<TrackId> trackIds;
+    if (maxCount <= 0) {
+        return trackIds;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "SELECT track_id FROM PlaylistTracks "
+            "WHERE playlist_id IN (SELECT id FROM Playlists WHERE hidden=:hidden) "
+            "GROUP BY track_id "
+            "ORDER BY MAX(pl_datetime_added) DESC "
+            "LIMIT :count"));
+    query.bindValue(":hidden", static_cast<int>(hidden));
+    query.bindValue(":count", maxCount);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return trackIds;
+    }
+
+    while (query.next()) {
+        trackIds.append(TrackId(query.value(0)));
+    }
+    return trackIds;
+}
+
 int PlaylistDAO::getPlaylistIdFromName(const QString& name) const {
     //qDebug() << "PlaylistDAO::getPlaylistIdFromName" << QThread::currentThread() << m_database.connectionName();
 
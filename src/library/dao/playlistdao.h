@@ -76,6 +76,10 @@ class PlaylistDAO : public QObject, public virtual DAO {
     int getPlaylistId(const int index) const;
     QList<TrackId> getTrackIds(const int playlistId) const;
     QList<TrackId> getTrackIdsInPlaylistOrder(const int playlistId) const;
+    // Get the tracks that have been added most recently to any playlist
+    // with the HiddenType hidden, e.g. the played history, ordered from
+    // the most recently added track.
+    QList<TrackId> getRecentlyAddedTrackIds(HiddenType hidden, int maxCount) const;
     // Returns true if the playlist with playlistId is hidden
     bool isHidden(const int playlistId) const;
     // Returns the HiddenType of playlistId
@@ -28,6 +28,7 @@
 #include "track/track.h"
 #include "util/assert.h"
 #include "util/datetime.h"
+#include "util/db/dbconnection.h"
 #include "util/db/fwdsqlquery.h"
 #include "util/db/sqlite.h"
 #include "util/db/sqlstringformatter.h"
@@ -100,7 +101,8 @@ TrackDAO::TrackDAO(CueDAO& cueDao,
           m_pConfig(pConfig),
           m_trackLocationIdColumn(UndefinedRecordIndex),
           m_queryLibraryIdColumn(UndefinedRecordIndex),
-          m_queryLibraryMixxxDeletedColumn(UndefinedRecordIndex) {
+          m_queryLibraryMixxxDeletedColumn(UndefinedRecordIndex),
+          m_hasFullTextIndex(false) {
     connect(&m_playlistDao,
             &PlaylistDAO::tracksRemovedFromPlayedHistory,
             this,
@@ -121,6 +123,11 @@ TrackDAO::~TrackDAO() {
     addTracksFinish(true);
 }
 
+void TrackDAO::initialize(const QSqlDatabase& database) {
+    DAO::initialize(database);
+    m_hasFullTextIndex = detectFullTextIndex();
+}
+
 void TrackDAO::finish() {
     kLogger.debug() << "finish()";
 
@@ -551,6 +558,12 @@ void TrackDAO::addTracksFinish(bool rollback) {
             m_pTransaction->commit();
         }
     }
+    if (m_hasFullTextIndex && !m_tracksAddedSet.isEmpty()) {
+        SqlTransaction transaction(m_database);
+        if (updateFullTextIndex()) {
+            transaction.commit();
+        }
+    }
     m_pQueryTrackLocationInsert.reset();
     m_pQueryTrackLocationSelect.reset();
     m_pQueryLibraryInsert.reset();
@@ -868,7 +881,8 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
 
 TrackPointer TrackDAO::addTracksAddFile(
         const QString& filePath,
-        bool unremove) {
+        bool unremove,
+        const SoundSourceProxy::ImportedTrackMetadataAndCoverImage* pImported) {
     const auto fileAccess = mixxx::FileAccess(mixxx::FileInfo(filePath));
     // Check that track is a supported extension.
     // TODO(uklotzde): The following check can be skipped if
@@ -936,7 +950,8 @@ TrackPointer TrackDAO::addTracksAddFile(
     // from the file.
     SoundSourceProxy(pTrack).updateTrackFromSource(
             SoundSourceProxy::UpdateTrackFromSourceMode::Once,
-            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig),
+            pImported);
     if (!pTrack->checkSourceSynchronized()) {
         kLogger.warning() << "addTracksAddFile:"
                           << "Failed to parse track metadata from file"
@@ -1368,6 +1383,83 @@ struct ColumnPopulator {
     TrackPopulatorFn populator;
 };
 
+constexpr ColumnPopulator kTrackColumns[] = {
+        // Location must be first and is populated manually!
+        {"track_locations.location", nullptr},
+        {"artist", setTrackArtist},
+        {"title", setTrackTitle},
+        {"album", setTrackAlbum},
+        {"album_artist", setTrackAlbumArtist},
+        {"year", setTrackYear},
+        {"genre", setTrackGenre},
+        {"composer", setTrackComposer},
+        {"grouping", setTrackGrouping},
+        {"tracknumber", setTrackNumber},
+        {"tracktotal", setTrackTotal},
+        {"filetype", setTrackFiletype},
+        {"rating", setTrackRating},
+        {"color", setTrackColor},
+        {"comment", setTrackComment},
+        {"url", setTrackUrl},
+        {"cuepoint", setTrackCuePoint},
+        {"replaygain", setTrackReplayGainRatio},
+        {"replaygain_peak", setTrackReplayGainPeak},
+        {"timesplayed", setTrackTimesPlayed},
+        {"last_played_at", setTrackLastPlayedAt},
+        {"played", setTrackPlayed},
+        {"datetime_added", setTrackDateAdded},
+        {"header_parsed", setTrackHeaderParsed},
+        {"source_synchronized_ms", setTrackSourceSynchronizedAt},
+
+        // Audio properties are set together at once. Do not change the
+        // ordering of these columns or put other columns in between them!
+        {"channels", setTrackAudioProperties},
+        {"samplerate", nullptr},
+        {"bitrate", nullptr},
+        {"duration", nullptr},
+
+        // Beat detection columns are handled by setTrackBeats. Do not change
+        // the ordering of these columns or put other columns in between them!
+        {"bpm", setTrackBeats},
+        {"beats_version", nullptr},
+        {"beats_sub_version", nullptr},
+        {"beats", nullptr},
+        {"bpm_lock", nullptr},
+
+        // Key detection columns are handled by setTrackKey. Do not change the
+        // ordering of these columns or put other columns in between them!
+        {"key", setTrackKey},
+        {"keys_version", nullptr},
+        {"keys_sub_version", nullptr},
+        {"keys", nullptr},
+
+        // Cover art columns are handled by setTrackCoverInfo. Do not change the
+        // ordering of these columns or put other columns in between them!
+        {"coverart_source", setTrackCoverInfo},
+        {"coverart_type", nullptr},
+        {"coverart_location", nullptr},
+        {"coverart_color", nullptr},
+        {"coverart_digest", nullptr},
+        {"coverart_hash", nullptr},
+};
+constexpr int kTrackColumnsCount = static_cast<int>(std::size(kTrackColumns));
+
+QString trackColumnsSql() {
+    QString columnsStr;
+    int columnsSize = 0;
+    for (int i = 0; i < kTrackColumnsCount; ++i) {
+        columnsSize += static_cast<int>(qstrlen(kTrackColumns[i].name)) + 1;
+    }
+    columnsStr.reserve(columnsSize);
+    for (int i = 0; i < kTrackColumnsCount; ++i) {
+        if (i > 0) {
+            columnsStr.append(QChar(','));
+        }
+        columnsStr.append(kTrackColumns[i].name);
+    }
+    return columnsStr;
+}
+
 }  // namespace
 
 TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
@@ -1375,73 +1467,13 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
         return nullptr;
     }
 
-    // The GlobalTrackCache is only locked while executing the following line.
-    TrackPointer pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId);
+    // The GlobalTrackCache is only locked while executing the following
+    // line if the track is not in use.
+    TrackPointer pTrack = GlobalTrackCache::lookupTrackById(trackId);
     if (pTrack) {
         return pTrack;
     }
 
-    constexpr ColumnPopulator columns[] = {
-            // Location must be first and is populated manually!
-            {"track_locations.location", nullptr},
-            {"artist", setTrackArtist},
-            {"title", setTrackTitle},
-            {"album", setTrackAlbum},
-            {"album_artist", setTrackAlbumArtist},
-            {"year", setTrackYear},
-            {"genre", setTrackGenre},
-            {"composer", setTrackComposer},
-            {"grouping", setTrackGrouping},
-            {"tracknumber", setTrackNumber},
-            {"tracktotal", setTrackTotal},
-            {"filetype", setTrackFiletype},
-            {"rating", setTrackRating},
-            {"color", setTrackColor},
-            {"comment", setTrackComment},
-            {"url", setTrackUrl},
-            {"cuepoint", setTrackCuePoint},
-            {"replaygain", setTrackReplayGainRatio},
-            {"replaygain_peak", setTrackReplayGainPeak},
-            {"timesplayed", setTrackTimesPlayed},
-            {"last_played_at", setTrackLastPlayedAt},
-            {"played", setTrackPlayed},
-            {"datetime_added", setTrackDateAdded},
-            {"header_parsed", setTrackHeaderParsed},
-            {"source_synchronized_ms", setTrackSourceSynchronizedAt},
-
-            // Audio properties are set together at once. Do not change the
-            // ordering of these columns or put other columns in between them!
-            {"channels", setTrackAudioProperties},
-            {"samplerate", nullptr},
-            {"bitrate", nullptr},
-            {"duration", nullptr},
-
-            // Beat detection columns are handled by setTrackBeats. Do not change
-            // the ordering of these columns or put other columns in between them!
-            {"bpm", setTrackBeats},
-            {"beats_version", nullptr},
-            {"beats_sub_version", nullptr},
-            {"beats", nullptr},
-            {"bpm_lock", nullptr},
-
-            // Key detection columns are handled by setTrackKey. Do not change the
-            // ordering of these columns or put other columns in between them!
-            {"key", setTrackKey},
-            {"keys_version", nullptr},
-            {"keys_sub_version", nullptr},
-            {"keys", nullptr},
-
-            // Cover art columns are handled by setTrackCoverInfo. Do not change the
-            // ordering of these columns or put other columns in between them!
-            {"coverart_source", setTrackCoverInfo},
-            {"coverart_type", nullptr},
-            {"coverart_location", nullptr},
-            {"coverart_color", nullptr},
-            {"coverart_digest", nullptr},
-            {"coverart_hash", nullptr},
-    };
-    constexpr int columnsCount = static_cast<int>(std::size(columns));
-
     // Accessing the database is a time consuming operation that should not
     // be executed with a lock on the GlobalTrackCache. The GlobalTrackCache
     // will be locked again after the query has been executed (see below)
@@ -1450,25 +1482,12 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
 
     QSqlRecord queryRecord;
     {
-        QString columnsStr;
-        int columnsSize = 0;
-        for (int i = 0; i < columnsCount; ++i) {
-            columnsSize += static_cast<int>(qstrlen(columns[i].name)) + 1;
-        }
-        columnsStr.reserve(columnsSize);
-        for (int i = 0; i < columnsCount; ++i) {
-            if (i > 0) {
-                columnsStr.append(QChar(','));
-            }
-            columnsStr.append(columns[i].name);
-        }
-
         QSqlQuery query(m_database);
         query.prepare(QString(
                 "SELECT %1 FROM Library "
                 "INNER JOIN track_locations ON library.location = track_locations.id "
                 "WHERE library.id = %2")
-                              .arg(columnsStr, trackId.toString()));
+                              .arg(trackColumnsSql(), trackId.toString()));
         if (!query.exec()) {
             LOG_FAILED_QUERY(query)
                     << QString("getTrack(%1)").arg(trackId.toString());
@@ -1485,6 +1504,97 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
         DEBUG_ASSERT(!query.next());
     }
 
+    return loadTrackFromRecord(
+            trackId,
+            queryRecord,
+            m_cueDao.getCuesForTrack(trackId));
+}
+
+QList<TrackPointer> TrackDAO::getTracksByIds(
+        const QList<TrackId>& trackIds) const {
+    QList<TrackPointer> tracks;
+    tracks.reserve(trackIds.size());
+    QSet<TrackId> missingTrackIds;
+    {
+        // Lock the GlobalTrackCache only once for all tracks
+        GlobalTrackCacheLocker cacheLocker;
+        for (const auto& trackId : trackIds) {
+            TrackPointer pTrack;
+            if (trackId.isValid()) {
+                pTrack = cacheLocker.lookupTrackById(trackId);
+                if (!pTrack) {
+                    missingTrackIds.insert(trackId);
+                }
+            }
+            tracks.append(pTrack);
+        }
+    }
+
+    if (!missingTrackIds.isEmpty()) {
+        ScopedTimer t(QStringLiteral("TrackDAO::getTracksByIds"));
+
+        // All tracks and all of their cues are loaded with a single
+        // query each. The GlobalTrackCache is not locked meanwhile,
+        // see getTrackById().
+        QVector<QSqlRecord> queryRecords;
+        queryRecords.reserve(missingTrackIds.size());
+        {
+            QSqlQuery query(m_database);
+            query.setForwardOnly(true);
+            query.prepare(QString(
+                    "SELECT %1,library.id FROM Library "
+                    "INNER JOIN track_locations ON library.location = track_locations.id "
+                    "WHERE library.id IN (%2)")
+                                  .arg(trackColumnsSql(),
+                                          joinTrackIdList(missingTrackIds)));
+            if (!query.exec()) {
+                LOG_FAILED_QUERY(query)
+                        << "getTracksByIds:"
+                        << missingTrackIds.size()
+                        << "tracks";
+                DEBUG_ASSERT(!"Failed query");
+            }
+            while (query.next()) {
+                queryRecords.append(query.record());
+            }
+        }
+        QList<TrackId> missingTrackIdList;
+        missingTrackIdList.reserve(missingTrackIds.size());
+        for (const auto& trackId : std::as_const(missingTrackIds)) {
+            missingTrackIdList.append(trackId);
+        }
+        const QHash<TrackId, QList<CuePointer>> cuesByTrackId =
+                m_cueDao.getCuesForTracks(missingTrackIdList);
+
+        // The records are only populated after the query has been
+        // finished, because populating a track might access the
+        // database and its file.
+        QHash<TrackId, TrackPointer> loadedTracks;
+        loadedTracks.reserve(queryRecords.size());
+        for (const auto& queryRecord : std::as_const(queryRecords)) {
+            const auto trackId = TrackId(queryRecord.value(kTrackColumnsCount));
+            loadedTracks.insert(trackId,
+                    loadTrackFromRecord(
+                            trackId,
+                            queryRecord,
+                            cuesByTrackId.value(trackId)));
+        }
+        for (int i = 0; i < tracks.size(); ++i) {
+            if (!tracks[i]) {
+                tracks[i] = loadedTracks.value(trackIds[i]);
+            }
+        }
+    }
+
+    tracks.removeAll(TrackPointer());
+    return tracks;
+}
+
+TrackPointer TrackDAO::loadTrackFromRecord(
+        TrackId trackId,
+        const QSqlRecord& queryRecord,
+        const QList<CuePointer>& cues) const {
+    TrackPointer pTrack;
     { // Locking scope of cacheResolver
         // Location is the first column.
         DEBUG_ASSERT(queryRecord.count() > 0);
@@ -1553,13 +1663,15 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
 
     // For every column run its populator to fill the track in with the data.
     {
+        // Additional columns are ignored
         int recordCount = queryRecord.count();
-        if (recordCount != columnsCount) {
-            recordCount = math_min(recordCount, columnsCount);
+        if (recordCount < kTrackColumnsCount) {
             DEBUG_ASSERT(!"Failed query");
+        } else {
+            recordCount = kTrackColumnsCount;
         }
         for (int i = 0; i < recordCount; ++i) {
-            TrackPopulatorFn populator = columns[i].populator;
+            TrackPopulatorFn populator = kTrackColumns[i].populator;
             if (populator) {
                 (*populator)(queryRecord, i, pTrack.get());
             }
@@ -1567,7 +1679,7 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
     }
 
     // Populate track cues from the cues table.
-    pTrack->setCuePoints(m_cueDao.getCuesForTrack(trackId));
+    pTrack->setCuePoints(cues);
     pTrack->markClean();
 
     // Synchronize the track's metadata with the corresponding source
@@ -1613,6 +1725,16 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
         }
     }
 
+    relayTrackSignals(pTrack);
+
+    return pTrack;
+}
+
+void TrackDAO::relayTrackSignals(const TrackPointer& pTrack) const {
+    DEBUG_ASSERT(pTrack);
+    const TrackId trackId = pTrack->getId();
+    DEBUG_ASSERT(trackId.isValid());
+
     // Listen to signals from Track objects and forward them to
     // receivers. TrackDAO works as a relay for selected track signals
     // that allows receivers to use permanent connections with
@@ -1642,16 +1764,14 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
             });
 
     // BaseTrackCache cares about track trackDirty/trackClean notifications
-    // from TrackDAO that are triggered by the track itself. But the preceding
-    // track modifications above have been sent before the TrackDAO has been
+    // from TrackDAO that are triggered by the track itself. But preceding
+    // track modifications have been sent before the TrackDAO has been
     // connected to the track's signals and need to be replayed manually.
     if (pTrack->isDirty()) {
         emit mixxx::thisAsNonConst(this)->trackDirty(trackId);
     } else {
         emit mixxx::thisAsNonConst(this)->trackClean(trackId);
     }
-
-    return pTrack;
 }
 
 TrackPointer TrackDAO::getTrackByRef(
@@ -1659,7 +1779,7 @@ TrackPointer TrackDAO::getTrackByRef(
     if (!trackRef.isValid()) {
         return nullptr;
     }
-    const auto pTrack = GlobalTrackCacheLocker().lookupTrackByRef(trackRef);
+    const auto pTrack = GlobalTrackCache::lookupTrackByRef(trackRef);
     if (pTrack) {
         return pTrack;
     }
@@ -1767,6 +1887,11 @@ bool TrackDAO::updateTrack(const Track& track) const {
             track.getWaveformSummary());
     m_cueDao.saveTrackCues(
             trackId, track.getCuePoints());
+    if (m_hasFullTextIndex) {
+        // Failures are tolerated, because pending tracks are still
+        // searched without the index
+        updateFullTextIndex();
+    }
     transaction.commit();
 
     // kLogger.debug() << "Update track in database took: " <<
@@ -1774,6 +1899,112 @@ bool TrackDAO::updateTrack(const Track& track) const {
     return true;
 }
 
+bool TrackDAO::detectFullTextIndex() const {
+    // The index and the triggers that enqueue modified tracks in
+    // LIBRARYFTS_PENDING_TABLE are created by an optional schema
+    // migration that is skipped if SQLite doesn't provide FTS5 and
+    // its trigram tokenizer (SQLite >= 3.34). The trigram tokenizer
+    // matches arbitrary substrings of 3 or more characters like
+    // LIKE '%...%' does.
+    if (!m_database.tables().contains(LIBRARYFTS_TABLE)) {
+        return false;
+    }
+    // Fails if the database has been migrated by a different build
+    QSqlQuery query(m_database);
+    if (!query.exec(QStringLiteral(
+                "SELECT rowid FROM " LIBRARYFTS_TABLE " LIMIT 1"))) {
+        kLogger.info()
+                << "Full-text search is not supported:"
+                << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+void TrackDAO::buildFullTextIndex() const {
+    if (!m_hasFullTextIndex) {
+        return;
+    }
+    PerformanceTimer time;
+    time.start();
+    SqlTransaction transaction(m_database);
+    if (!updateFullTextIndex() || !transaction.commit()) {
+        return;
+    }
+    kLogger.debug()
+            << "Updating the full-text index took"
+            << time.elapsed().formatMillisWithUnit();
+}
+
+bool TrackDAO::updateFullTextIndex() const {
+    const QStringList& columns = mixxx::trackschema::fullTextColumns();
+    QStringList qualifiedColumns;
+    QStringList placeholders;
+    for (const auto& column : columns) {
+        qualifiedColumns.append(mixxx::trackschema::tableForColumn(column) +
+                QLatin1Char('.') + column);
+        placeholders.append(QStringLiteral("?"));
+    }
+
+    QSqlQuery pendingQuery(m_database);
+    pendingQuery.setForwardOnly(true);
+    // Tracks that have been removed from the library have no
+    // values and are only removed from the index
+    if (!pendingQuery.exec(QStringLiteral(
+                "SELECT " LIBRARYFTS_PENDING_TABLE ".id," LIBRARY_TABLE ".id,%1 "
+                "FROM " LIBRARYFTS_PENDING_TABLE " "
+                "LEFT JOIN " LIBRARY_TABLE " ON " LIBRARY_TABLE
+                ".id=" LIBRARYFTS_PENDING_TABLE ".id "
+                "LEFT JOIN " TRACKLOCATIONS_TABLE " ON " TRACKLOCATIONS_TABLE
+                ".id=" LIBRARY_TABLE ".location")
+                        .arg(qualifiedColumns.join(QChar(','))))) {
+        LOG_FAILED_QUERY(pendingQuery);
+        return false;
+    }
+    QSqlQuery deleteQuery(m_database);
+    deleteQuery.prepare(QStringLiteral(
+            "DELETE FROM " LIBRARYFTS_TABLE " WHERE rowid=?"));
+    QSqlQuery insertQuery(m_database);
+    insertQuery.prepare(QStringLiteral(
+            "INSERT INTO " LIBRARYFTS_TABLE " (rowid,%1) VALUES (?,%2)")
+                                .arg(columns.join(QChar(',')),
+                                        placeholders.join(QChar(','))));
+    QSqlQuery dequeueQuery(m_database);
+    dequeueQuery.prepare(QStringLiteral(
+            "DELETE FROM " LIBRARYFTS_PENDING_TABLE " WHERE id=?"));
+    while (pendingQuery.next()) {
+        const QVariant id = pendingQuery.value(0);
+        deleteQuery.bindValue(0, id);
+        if (!deleteQuery.exec()) {
+            LOG_FAILED_QUERY(deleteQuery);
+            return false;
+        }
+        if (!pendingQuery.isNull(1)) {
+            insertQuery.bindValue(0, id);
+            for (int i = 0; i < columns.size(); ++i) {
+                QVariant value = pendingQuery.value(2 + i);
+                if (!value.isNull()) {
+                    // Fold the texts like DbConnection does for LIKE
+                    QString text = value.toString();
+                    mixxx::DbConnection::makeStringLatinLow(&text);
+                    value = text;
+                }
+                insertQuery.bindValue(1 + i, value);
+            }
+            if (!insertQuery.exec()) {
+                LOG_FAILED_QUERY(insertQuery);
+                return false;
+            }
+        }
+        dequeueQuery.bindValue(0, id);
+        if (!dequeueQuery.exec()) {
+            LOG_FAILED_QUERY(dequeueQuery);
+            return false;
+        }
+    }
+    return true;
+}
+
 // Make sure that `directory` in in track_locations table is indeed a
 // directory path. This works around / removes residues of a bug where tracks
 // are falsely marked missing because `directory` == `location`.
@@ -2311,7 +2542,7 @@ TrackPointer TrackDAO::getOrAddTrack(
     VERIFY_OR_DEBUG_ASSERT(trackRef.hasLocation()) {
         return {};
     }
-    TrackPointer pTrack = GlobalTrackCacheLocker().lookupTrackByRef(trackRef);
+    TrackPointer pTrack = GlobalTrackCache::lookupTrackByRef(trackRef);
     if (!pTrack) {
         // track not cached
         const TrackId trackId = getTrackIdByLocation(trackRef.getLocation());
@@ -9,9 +9,12 @@
 #include "library/dao/dao.h"
 #include "library/relocatedtrack.h"
 #include "preferences/usersettings.h"
+#include "sources/soundsourceproxy.h"
 #include "track/globaltrackcache.h"
 #include "util/class.h"
 
+class CuePointer;
+class QSqlRecord;
 class SqlTransaction;
 class PlaylistDAO;
 class AnalysisDao;
@@ -45,8 +48,17 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
             UserSettingsPointer pConfig);
     ~TrackDAO() override;
 
+    void initialize(const QSqlDatabase& database) override;
+
     void finish();
 
+    /// Returns true if the library is indexed for full-text search
+    /// in LIBRARYFTS_TABLE. This requires the FTS5 extension of SQLite
+    /// and its trigram tokenizer.
+    bool hasFullTextIndex() const {
+        return m_hasFullTextIndex;
+    }
+
     QList<TrackId> resolveTrackIds(
             const QList<QUrl>& urls,
             ResolveTrackIdFlags flags = ResolveTrackIdFlag::ResolveOnly);
@@ -78,6 +90,17 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     // Only used by friend class TrackCollection, but public for testing!
     bool saveTrack(Track* pTrack) const;
 
+    /// Indexes the pending tracks in a transaction, i.e. all tracks
+    /// after the index has been created and the tracks that have been
+    /// modified by other versions of Mixxx. Invoked once on startup.
+    void buildFullTextIndex() const;
+
+    /// Re-indexes the tracks that have been added, modified or removed
+    /// since the last update. Must be invoked within a transaction.
+    ///
+    /// Only used internally, but public for testing!
+    bool updateFullTextIndex() const;
+
     /// Update the play counter properties according to the corresponding
     /// aggregated properties obtained from the played history.
     bool updatePlayCounterFromPlayedHistory(
@@ -108,6 +131,12 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
         return getTrackByRef(TrackRef::fromUrl(url));
     }
 
+    /// Forwards the signals of a track that has been loaded by a
+    /// different TrackDAO instance, e.g. on a worker thread, through
+    /// this instance. Tracks that are loaded by this instance are
+    /// connected implicitly.
+    void relayTrackSignals(const TrackPointer& pTrack) const;
+
   signals:
     // Forwarded from Track object
     void trackDirty(TrackId trackId);
@@ -134,6 +163,7 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
   private:
     friend class LibraryScanner;
     friend class TrackCollection;
+    friend class TrackCollectionManager;
     friend class TrackAnalysisScheduler;
 
     QList<TrackId> resolveTrackIds(
@@ -144,6 +174,19 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
             const QString& location) const;
     TrackPointer getTrackById(
             TrackId trackId) const;
+    /// Loads multiple tracks with a constant number of queries. Tracks
+    /// that are cached in memory are not loaded from the database.
+    ///
+    /// The tracks are returned in the order of the given ids. Tracks
+    /// that don't exist or could not be loaded are omitted.
+    QList<TrackPointer> getTracksByIds(
+            const QList<TrackId>& trackIds) const;
+    /// Populates a track from a record with the columns of the library
+    /// and adds it to the GlobalTrackCache.
+    TrackPointer loadTrackFromRecord(
+            TrackId trackId,
+            const QSqlRecord& queryRecord,
+            const QList<CuePointer>& cues) const;
 
     // Loads a track from the database (by id if available, otherwise by location)
     // or adds it if not found in case the location is known. The (optional) out
@@ -158,13 +201,20 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     TrackId addTracksAddTrack(
             const TrackPointer& pTrack,
             bool unremove);
+    /// Metadata and cover image that have already been imported from
+    /// the file, e.g. by a library scanner task, might be passed in
+    /// pImported to avoid parsing the file again.
     TrackPointer addTracksAddFile(
             const QString& filePath,
-            bool unremove);
+            bool unremove,
+            const SoundSourceProxy::ImportedTrackMetadataAndCoverImage* pImported =
+                    nullptr);
     void addTracksFinish(bool rollback = false);
 
     bool updateTrack(const Track& track) const;
 
+    bool detectFullTextIndex() const;
+
     void hideAllTracks(const QDir& rootDir) const;
 
     bool hideTracks(
@@ -216,6 +266,8 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     int m_queryLibraryIdColumn;
     int m_queryLibraryMixxxDeletedColumn;
 
+    bool m_hasFullTextIndex;
+
     QSet<TrackId> m_tracksAddedSet;
 
     DISALLOW_COPY_AND_ASSIGN(TrackDAO);
@@ -9,5 +9,20 @@ QString tableForColumn(const QString& columnName) {
     // This doesn't detect unknown columns, but that's not really important here.
     return QStringLiteral(LIBRARY_TABLE);
 }
+
+const QStringList& fullTextColumns() {
+    static const QStringList kColumns = {
+            LIBRARYTABLE_ARTIST,
+            LIBRARYTABLE_TITLE,
+            LIBRARYTABLE_ALBUM,
+            LIBRARYTABLE_ALBUMARTIST,
+            LIBRARYTABLE_GENRE,
+            LIBRARYTABLE_COMPOSER,
+            LIBRARYTABLE_GROUPING,
+            LIBRARYTABLE_COMMENT,
+            TRACKLOCATIONSTABLE_LOCATION,
+    };
+    return kColumns;
+}
 } // namespace trackschema
 } // namespace mixxx
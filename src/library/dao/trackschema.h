@@ -1,10 +1,14 @@
 #pragma once
 
 #include <QString>
+#include <QStringList>
 
 #define LIBRARY_TABLE "library"
 #define TRACKLOCATIONS_TABLE "track_locations"
 
+#define LIBRARYFTS_TABLE "library_fts"
+#define LIBRARYFTS_PENDING_TABLE "library_fts_pending"
+
 #define PLAYLIST_TABLE "Playlists"
 #define PLAYLIST_TRACKS_TABLE "PlaylistTracks"
 
@@ -82,5 +86,9 @@ namespace mixxx {
 namespace trackschema {
 // TableForColumn returns the name of the table that contains the named column.
 QString tableForColumn(const QString& columnName);
+
+/// The text columns of the library that are covered by the full-text
+/// index, see TrackDAO::updateFullTextIndex()
+const QStringList& fullTextColumns();
 } // namespace trackschema
 } // namespace mixxx
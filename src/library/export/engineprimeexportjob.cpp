@@ -9,6 +9,7 @@
 
 #include "library/export/engineprimeexportrequest.h"
 #include "library/trackcollection.h"
+#include "library/trackcollectioniterator.h"
 #include "library/trackcollectionmanager.h"
 #include "library/trackset/crate/crate.h"
 #include "moc_engineprimeexportjob.cpp"
@@ -535,12 +536,20 @@ void EnginePrimeExportJob::loadIds(const QSet<CrateId>& crateIds, const QSet<int
     }
 }
 
-void EnginePrimeExportJob::loadTrack(const TrackRef& trackRef) {
+void EnginePrimeExportJob::loadNextTrack() {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(m_pTrackCollectionManager);
+    DEBUG_ASSERT(m_pTrackIterator);
 
-    // Load the track.
-    qDebug() << "Loading track" << trackRef << "...";
-    m_pLastLoadedTrack = m_pTrackCollectionManager->getTrackByRef(trackRef);
+    // Load the next track. The iterator loads the tracks in batches
+    // instead of querying the database for each track individually.
+    const auto nextTrack = m_pTrackIterator->nextItem();
+    if (!nextTrack) {
+        m_pLastLoadedTrack.reset();
+        m_pLastLoadedWaveform.reset();
+        return;
+    }
+    m_pLastLoadedTrack = *nextTrack;
+    qDebug() << "Loaded track" << m_pLastLoadedTrack->getId();
 
     // Load high-resolution waveform from analysis info.
     auto& analysisDao = m_pTrackCollectionManager->internalCollection()->getAnalysisDAO();
@@ -638,22 +647,32 @@ void EnginePrimeExportJob::run() {
     // djinterop::track, so we wrap it in std::optional and ensure it is always set.
     QHash<TrackId, std::optional<djinterop::track>> mixxxToExtTrackMap;
 
+    TrackIdList trackIds;
+    trackIds.reserve(m_trackRefs.size());
     for (const auto& trackRef : std::as_const(m_trackRefs)) {
+        trackIds.append(trackRef.getId());
+    }
+    m_pTrackIterator = std::make_unique<TrackByIdCollectionIterator>(
+            m_pTrackCollectionManager, trackIds);
+
+    while (true) {
         // Load each track.
         // Note that loading must happen on the same thread as the track collection
         // manager, which is not the same as this method's worker thread.
         QMetaObject::invokeMethod(
                 this,
-                "loadTrack",
-                Qt::BlockingQueuedConnection,
-                Q_ARG(TrackRef, trackRef));
+                "loadNextTrack",
+                Qt::BlockingQueuedConnection);
 
         if (m_cancellationRequested.loadAcquire() != 0) {
             qInfo() << "Cancelling export";
             return;
         }
 
-        DEBUG_ASSERT(m_pLastLoadedTrack != nullptr);
+        if (!m_pLastLoadedTrack) {
+            // All tracks have been exported
+            break;
+        }
 
         qInfo() << "Exporting track" << m_pLastLoadedTrack->getId().toString()
                 << "at" << m_pLastLoadedTrack->getFileInfo().location() << "...";
@@ -682,6 +701,7 @@ void EnginePrimeExportJob::run() {
         ++currProgress;
         emit jobProgress(currProgress);
     }
+    m_pTrackIterator.reset();
 
     // If the database type supports it, ensure that there is a special
     // top-level crate representing the root of all Mixxx-exported items.
@@ -19,6 +19,7 @@ class Waveform;
 namespace mixxx {
 
 struct EnginePrimeExportRequest;
+class TrackByIdCollectionIterator;
 
 /// The Engine DJ export job performs the work of exporting the Mixxx
 /// library to an external Engine DJ (also known as "Engine Library")
@@ -59,12 +60,13 @@ class EnginePrimeExportJob : public QThread {
     // thread of the application, which will be different to the worker thread
     // used by an instance of this class.
     void loadIds(const QSet<CrateId>& crateIds, const QSet<int>& playlistIds);
-    void loadTrack(const TrackRef& trackRef);
+    void loadNextTrack();
     void loadCrate(const CrateId& crateId);
     void loadPlaylist(int playlistId, const QString& playlistName);
 
   private:
     QList<TrackRef> m_trackRefs;
+    std::unique_ptr<TrackByIdCollectionIterator> m_pTrackIterator;
     QList<CrateId> m_crateIds;
     QList<QPair<int, QString>> m_playlistIdsAndNames;
 
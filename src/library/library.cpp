@@ -5,6 +5,7 @@
 #include <QMessageBox>
 
 #include "control/controlobject.h"
+#include "control/pollingcontrolproxy.h"
 #include "controllers/keyboard/keyboardeventfilter.h"
 #include "library/analysis/analysisfeature.h"
 #include "library/autodj/autodjfeature.h"
@@ -282,7 +283,10 @@ namespace {
 class TrackAnalysisSchedulerEnvironmentImpl final : public TrackAnalysisSchedulerEnvironment {
   public:
     explicit TrackAnalysisSchedulerEnvironmentImpl(const Library* pLibrary)
-            : m_pLibrary(pLibrary) {
+            : m_pLibrary(pLibrary),
+              m_audioLatencyUsage(QStringLiteral("[App]"),
+                      QStringLiteral("audio_latency_usage"),
+                      ControlFlag::AllowMissingOrInvalid) {
         DEBUG_ASSERT(m_pLibrary);
     }
     ~TrackAnalysisSchedulerEnvironmentImpl() final = default;
@@ -291,9 +295,17 @@ class TrackAnalysisSchedulerEnvironmentImpl final : public TrackAnalysisSchedule
         return m_pLibrary->trackCollectionManager()->getTrackById(trackId);
     }
 
+    std::optional<double> audioLatencyUsage() const final {
+        if (!m_audioLatencyUsage.valid()) {
+            return std::nullopt;
+        }
+        return m_audioLatencyUsage.get();
+    }
+
   private:
     // TODO: Use std::shared_ptr or std::weak_ptr instead of a plain pointer?
     const Library* const m_pLibrary;
+    const PollingControlProxy m_audioLatencyUsage;
 };
 } // namespace
 
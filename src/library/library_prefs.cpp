@@ -109,3 +109,33 @@ const ConfigKey mixxx::library::prefs::kTagFetcherApplyCoverConfigKey =
         ConfigKey{
                 mixxx::library::prefs::kConfigGroup,
                 QStringLiteral("TagFetcherApplyCover")};
+
+const ConfigKey mixxx::library::prefs::kAnalysisCacheEnabledConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("AnalysisCacheEnabled")};
+
+const ConfigKey mixxx::library::prefs::kIncrementalRescanEnabledConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("IncrementalRescanEnabled")};
+
+const ConfigKey mixxx::library::prefs::kDatabaseTuningEnabledConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("DatabaseTuningEnabled")};
+
+const ConfigKey mixxx::library::prefs::kDatabaseCacheSizeMiBConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("DatabaseCacheSizeMiB")};
+
+const ConfigKey mixxx::library::prefs::kDatabaseMmapSizeMiBConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("DatabaseMmapSizeMiB")};
+
+const ConfigKey mixxx::library::prefs::kRetainedTrackCountConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("RetainedTrackCount")};
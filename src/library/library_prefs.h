@@ -56,6 +56,30 @@ extern const ConfigKey kTagFetcherApplyTagsConfigKey;
 
 extern const ConfigKey kTagFetcherApplyCoverConfigKey;
 
+extern const ConfigKey kAnalysisCacheEnabledConfigKey;
+
+const bool kAnalysisCacheEnabledDefault = true;
+
+extern const ConfigKey kIncrementalRescanEnabledConfigKey;
+
+const bool kIncrementalRescanEnabledDefault = false;
+
+extern const ConfigKey kDatabaseTuningEnabledConfigKey;
+
+const bool kDatabaseTuningEnabledDefault = true;
+
+extern const ConfigKey kDatabaseCacheSizeMiBConfigKey;
+
+const int kDatabaseCacheSizeMiBDefault = 64;
+
+extern const ConfigKey kDatabaseMmapSizeMiBConfigKey;
+
+const int kDatabaseMmapSizeMiBDefault = 256;
+
+extern const ConfigKey kRetainedTrackCountConfigKey;
+
+const int kRetainedTrackCountDefault = 64;
+
 } // namespace prefs
 
 } // namespace library
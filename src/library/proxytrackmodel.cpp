@@ -57,6 +57,18 @@ TrackPointer ProxyTrackModel::getTrack(const QModelIndex& index) const {
     return m_pTrackModel ? m_pTrackModel->getTrack(indexSource) : TrackPointer();
 }
 
+TrackPointerList ProxyTrackModel::getTracks(const QModelIndexList& indices) const {
+    if (!m_pTrackModel) {
+        return {};
+    }
+    QModelIndexList indicesSource;
+    indicesSource.reserve(indices.size());
+    for (const auto& index : indices) {
+        indicesSource.append(mapToSource(index));
+    }
+    return m_pTrackModel->getTracks(indicesSource);
+}
+
 TrackPointer ProxyTrackModel::getTrackByRef(const TrackRef& trackRef) const {
     return m_pTrackModel ? m_pTrackModel->getTrackByRef(trackRef) : TrackPointer();
 }
@@ -25,6 +25,7 @@ class ProxyTrackModel : public QSortFilterProxyModel, public TrackModel {
     // Inherited from TrackModel
     Capabilities getCapabilities() const final;
     TrackPointer getTrack(const QModelIndex& index) const final;
+    TrackPointerList getTracks(const QModelIndexList& indices) const final;
     TrackPointer getTrackByRef(const TrackRef& trackRef) const final;
     QUrl getTrackUrl(const QModelIndex& index) const final;
     QString getTrackLocation(const QModelIndex& index) const final;
@@ -3,6 +3,15 @@
 #include "moc_importfilestask.cpp"
 #include "util/timer.h"
 
+namespace {
+
+// The number of parsed tracks that are handed over to the scanner
+// thread at once. The total number of parsed tracks that are waiting
+// to be added is limited by ScannerGlobal.
+constexpr int kMaxNewTracksPerBatch = 32;
+
+} // anonymous namespace
+
 ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
         const ScannerGlobalPointer scannerGlobal,
         const QString& dirPath,
@@ -22,6 +31,9 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
 
 void ImportFilesTask::run() {
     ScopedTimer timer(QStringLiteral("ImportFilesTask::run"));
+    // New tracks are parsed here in parallel and then added to
+    // the library by the scanner thread in batches.
+    QList<ImportedTrackFile> newTracks;
     for (const QFileInfo& fileInfo: m_filesToImport) {
         // If a flag was raised telling us to cancel the library scan then stop.
         if (m_scannerGlobal->shouldCancel()) {
@@ -49,9 +61,34 @@ void ImportFilesTask::run() {
             }
             qDebug() << "Importing track" << trackLocation;
 
-            emit addNewTrack(trackLocation);
+            if (!m_scannerGlobal->tryAcquireNewTrack()) {
+                // Hand over the current batch before waiting. Otherwise
+                // tasks that wait for each other's pending tracks might
+                // block forever.
+                if (!newTracks.isEmpty()) {
+                    emit addNewTracks(newTracks);
+                    newTracks.clear();
+                }
+                if (!m_scannerGlobal->acquireNewTrack()) {
+                    setSuccess(false);
+                    return;
+                }
+            }
+
+            newTracks.append(ImportedTrackFile{trackLocation,
+                    SoundSourceProxy::importNewTrackMetadataAndCoverImageFromFile(
+                            mixxx::FileAccess(mixxx::FileInfo(fileInfo), m_pToken),
+                            m_scannerGlobal->syncTrackMetadataParams()
+                                    .resetMissingTagMetadataOnImport)});
+            if (newTracks.size() >= kMaxNewTracksPerBatch) {
+                emit addNewTracks(newTracks);
+                newTracks.clear();
+            }
         }
     }
+    if (!newTracks.isEmpty()) {
+        emit addNewTracks(newTracks);
+    }
     // Insert or update the hash in the database.
     emit directoryHashedAndScanned(m_dirPath, !m_prevHashExists, m_newHash);
     setSuccess(true);
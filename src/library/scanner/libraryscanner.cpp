@@ -2,8 +2,10 @@
 
 #include "library/coverartutils.h"
 #include "library/library_decl.h"
+#include "library/library_prefs.h"
 #include "library/queryutil.h"
 #include "library/scanner/libraryscannerdlg.h"
+#include "library/scanner/librarywatcher.h"
 #include "library/scanner/recursivescandirectorytask.h"
 #include "library/scanner/scannertask.h"
 #include "library/scanner/scannerutil.h"
@@ -14,14 +16,17 @@
 #include "util/db/dbconnectionpooler.h"
 #include "util/db/fwdsqlquery.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/performancetimer.h"
 #include "util/timer.h"
 #include "util/trace.h"
 
 namespace {
 
+// Hashing directories and parsing files is distributed among
+// multiple threads. More threads would compete for disk I/O.
 // TODO(rryan) make configurable
-constexpr int kScannerThreadPoolSize = 1;
+constexpr int kMaxScannerThreadPoolSize = 4;
 
 mixxx::Logger kLogger("LibraryScanner");
 
@@ -99,6 +104,7 @@ LibraryScanner::LibraryScanner(
         mixxx::DbConnectionPoolPtr pDbConnectionPool,
         const UserSettingsPointer& pConfig)
         : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_pConfig(pConfig),
           m_analysisDao(pConfig),
           m_trackDao(m_cueDao, m_playlistDao, m_analysisDao, m_libraryHashDao, pConfig),
           m_stateSema(1), // only one transaction is possible at a time
@@ -112,7 +118,8 @@ LibraryScanner::LibraryScanner(
     const int instanceId = s_instanceCounter.fetchAndAddAcquire(1) + 1;
     setObjectName(QString("LibraryScanner %1").arg(instanceId));
 
-    m_pool.setMaxThreadCount(kScannerThreadPoolSize);
+    m_pool.setMaxThreadCount(math_clamp(
+            QThread::idealThreadCount(), 1, kMaxScannerThreadPoolSize));
 
     // Listen to signals from our public methods (invoked by other threads) and
     // connect them to our slots to run the command on the scanner thread.
@@ -178,6 +185,9 @@ void LibraryScanner::run() {
         kLogger.debug() << "Event loop starting";
         exec();
         kLogger.debug() << "Event loop stopped";
+
+        // The watcher must be destroyed by the thread that created it
+        m_pWatcher.reset();
     }
     kLogger.debug() << "Exiting thread";
 }
@@ -211,9 +221,15 @@ void LibraryScanner::slotStartScan() {
     QStringList directoryBlacklist = ScannerUtil::getDirectoryBlacklist();
     m_numRelocatedTracks = 0;
 
+    m_scanStartedAt = QDateTime::currentDateTimeUtc();
     m_scannerGlobal = ScannerGlobalPointer(
-            new ScannerGlobal(trackLocations, directoryHashes, extensionFilter,
-                              coverExtensionFilter, directoryBlacklist));
+            new ScannerGlobal(trackLocations,
+                    directoryHashes,
+                    extensionFilter,
+                    coverExtensionFilter,
+                    directoryBlacklist,
+                    SyncTrackMetadataParams::readFromUserSettings(*m_pConfig),
+                    takeUnmodifiedDirectories()));
 
     m_scannerGlobal->startTimer();
 
@@ -311,6 +327,36 @@ void LibraryScanner::slotFinishHashedScan() {
     pWatcher->taskDone();
 }
 
+QHash<QString, QStringList> LibraryScanner::takeUnmodifiedDirectories() {
+    if (!m_pConfig->getValue(
+                mixxx::library::prefs::kIncrementalRescanEnabledConfigKey,
+                mixxx::library::prefs::kIncrementalRescanEnabledDefault)) {
+        m_pWatcher.reset();
+        return {};
+    }
+    if (!m_pWatcher) {
+        // Modifications are only recorded after the first complete scan
+        m_pWatcher = std::make_unique<LibraryWatcher>();
+        return {};
+    }
+    if (!m_pWatcher->isComplete()) {
+        kLogger.info()
+                << "Rescanning all directories, because"
+                << "not all of them have been watched";
+        return {};
+    }
+    const int numModifiedDirs = m_pWatcher->modifiedDirectories().size();
+    QHash<QString, QStringList> unmodifiedDirectories =
+            m_pWatcher->takeUnmodifiedDirectories();
+    kLogger.info()
+            << "Rescanning"
+            << numModifiedDirs
+            << "modified directories, skipping"
+            << unmodifiedDirectories.size()
+            << "unmodified directories";
+    return unmodifiedDirectories;
+}
+
 // Quick hack: return number of relocated tracks
 void LibraryScanner::cleanUpScan() {
     // At the end of a scan, mark all tracks and directories that weren't
@@ -422,6 +468,14 @@ void LibraryScanner::slotFinishUnhashedScan() {
         cleanUpScan();
     }
 
+    if (m_pWatcher && !m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
+        // Otherwise the watcher remains incomplete and the next
+        // scan needs to read all directories again.
+        m_pWatcher->watchDirectories(
+                m_scannerGlobal->scannedDirectories(),
+                m_scanStartedAt);
+    }
+
     if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
         const auto dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
         updateQueryPlannerStatisticsForDatabase(dbConnection);
@@ -568,9 +622,9 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             this,
             &LibraryScanner::slotTrackExists);
     connect(pTask,
-            &ScannerTask::addNewTrack,
+            &ScannerTask::addNewTracks,
             this,
-            &LibraryScanner::slotAddNewTrack);
+            &LibraryScanner::slotAddNewTracks);
 
     // Progress signals.
     // Pass directly to the main thread
@@ -623,32 +677,41 @@ void LibraryScanner::slotTrackExists(const QString& trackPath) {
     }
 }
 
-// triggered by ScannerTask::addNewTrack / in ImportFilesTask::run()
-void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
-    //kLogger.debug() << "slotAddNewTrack" << trackPath;
-    ScopedTimer timer(QStringLiteral("LibraryScanner::addNewTrack"));
-    // For statistics tracking and to detect moved tracks
-    TrackPointer pTrack = m_trackDao.addTracksAddFile(
-            trackPath,
-            false);
-    if (!pTrack) {
-        // This happens only when there is an issue with the database which
-        // has been logged already. No need for yet another warning here.
-        return;
-    }
+// triggered by ScannerTask::addNewTracks / in ImportFilesTask::run()
+void LibraryScanner::slotAddNewTracks(const QList<ImportedTrackFile>& newTracks) {
+    //kLogger.debug() << "slotAddNewTracks" << newTracks.size();
+    ScopedTimer timer(QStringLiteral("LibraryScanner::addNewTracks"));
+    for (const auto& newTrack : newTracks) {
+        // All tracks are inserted within the transaction of the whole scan
+        // and their metadata has already been parsed by the worker task.
+        TrackPointer pTrack = m_trackDao.addTracksAddFile(
+                newTrack.location,
+                false,
+                &newTrack.imported);
+        if (!pTrack) {
+            // This happens only when there is an issue with the database which
+            // has been logged already. No need for yet another warning here.
+            continue;
+        }
 
-    DEBUG_ASSERT(!pTrack->isDirty());
-    // The track's actual location might differ from the
-    // given trackPath
-    const QString trackLocation = pTrack->getLocation();
-    // Acknowledge successful track addition
+        DEBUG_ASSERT(!pTrack->isDirty());
+        // The track's actual location might differ from the
+        // given location
+        const QString trackLocation = pTrack->getLocation();
+        // Acknowledge successful track addition for statistics
+        // tracking and to detect moved tracks
+        if (m_scannerGlobal) {
+            m_scannerGlobal->trackAdded(trackLocation);
+        }
+        // Signal the main instance of TrackDAO, that there is
+        // a new track in the database.
+        emit trackAdded(pTrack);
+        emit progressLoading(trackLocation);
+    }
+    // Let the waiting tasks parse more tracks
     if (m_scannerGlobal) {
-        m_scannerGlobal->trackAdded(trackLocation);
+        m_scannerGlobal->releaseNewTracks(static_cast<int>(newTracks.size()));
     }
-    // Signal the main instance of TrackDAO, that there is
-    // a new track in the database.
-    emit trackAdded(pTrack);
-    emit progressLoading(trackLocation);
 }
 
 bool LibraryScanner::changeScannerState(ScannerState newState) {
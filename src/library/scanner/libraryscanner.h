@@ -2,11 +2,13 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <QDateTime>
 #include <QList>
 #include <QScopedPointer>
 #include <QSemaphore>
 #include <QThread>
 #include <QThreadPool>
+#include <memory>
 
 #include "library/dao/analysisdao.h"
 #include "library/dao/cuedao.h"
@@ -15,11 +17,12 @@
 #include "library/dao/playlistdao.h"
 #include "library/dao/trackdao.h"
 #include "library/scanner/scannerglobal.h"
+#include "library/scanner/scannertask.h"
 #include "track/track_decl.h"
 #include "util/db/dbconnectionpool.h"
 
-class ScannerTask;
 class LibraryScannerDlg;
+class LibraryWatcher;
 class QString;
 struct LibraryScanResultSummary;
 
@@ -74,7 +77,7 @@ class LibraryScanner : public QThread {
                                    bool newDirectory, mixxx::cache_key_t hash);
     void slotDirectoryUnchanged(const QString& directoryPath);
     void slotTrackExists(const QString& trackPath);
-    void slotAddNewTrack(const QString& trackPath);
+    void slotAddNewTracks(const QList<ImportedTrackFile>& newTracks);
 
   private:
     enum ScannerState {
@@ -100,7 +103,12 @@ class LibraryScanner : public QThread {
 
     void cleanUpScan();
 
+    // Returns the directories that don't need to be rescanned if an
+    // incremental scan is possible and an empty hash otherwise.
+    QHash<QString, QStringList> takeUnmodifiedDirectories();
+
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const UserSettingsPointer m_pConfig;
 
     // The pool of threads used for worker tasks.
     QThreadPool m_pool;
@@ -128,6 +136,11 @@ class LibraryScanner : public QThread {
     int m_numRelocatedTracks;
 
     QList<mixxx::FileInfo> m_libraryRootDirs;
+
+    // Records modified directories between scans if incremental
+    // rescans are enabled. Only accessed by the scanner thread.
+    std::unique_ptr<LibraryWatcher> m_pWatcher;
+    QDateTime m_scanStartedAt;
     QScopedPointer<LibraryScannerDlg> m_pProgressDlg;
 
     bool m_manualScan;
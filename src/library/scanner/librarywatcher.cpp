@@ -0,0 +1,128 @@
+#include "library/scanner/librarywatcher.h"
+
+#include <QFileInfo>
+
+#include "moc_librarywatcher.cpp"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("LibraryWatcher");
+
+// Accounts for the coarse resolution of modification times
+// on some file systems, e.g. 2 seconds on FAT.
+constexpr qint64 kModificationTimeToleranceSecs = 2;
+
+} // anonymous namespace
+
+LibraryWatcher::LibraryWatcher(QObject* parent)
+        : QObject(parent),
+          m_complete(false) {
+    connect(&m_watcher,
+            &QFileSystemWatcher::directoryChanged,
+            this,
+            &LibraryWatcher::slotDirectoryChanged);
+}
+
+bool LibraryWatcher::watchDirectories(
+        const QHash<QString, QStringList>& subdirectoriesByDirectory,
+        const QDateTime& scanStartedAt) {
+    PerformanceTimer timer;
+    timer.start();
+
+    const QStringList watchedDirectoryList = m_watcher.directories();
+    const QSet<QString> watchedDirectories(
+            watchedDirectoryList.cbegin(), watchedDirectoryList.cend());
+    QStringList removedDirectories;
+    for (const auto& directory : watchedDirectories) {
+        if (!subdirectoriesByDirectory.contains(directory)) {
+            removedDirectories.append(directory);
+            m_modifiedDirectories.remove(directory);
+        }
+    }
+    if (!removedDirectories.isEmpty()) {
+        m_watcher.removePaths(removedDirectories);
+    }
+
+    QStringList addedDirectories;
+    for (auto it = subdirectoriesByDirectory.constBegin();
+            it != subdirectoriesByDirectory.constEnd();
+            ++it) {
+        if (!watchedDirectories.contains(it.key())) {
+            addedDirectories.append(it.key());
+        }
+    }
+    const QStringList failedDirectories = m_watcher.addPaths(addedDirectories);
+    for (const auto& directory : failedDirectories) {
+        // Directories that have been deleted in the meantime are
+        // detected as a modification of their parent directory.
+        if (QFileInfo::exists(directory)) {
+            kLogger.warning()
+                    << "Failed to watch"
+                    << failedDirectories.size()
+                    << "of"
+                    << subdirectoriesByDirectory.size()
+                    << "directories, e.g."
+                    << directory;
+            reset();
+            return false;
+        }
+    }
+
+    // Modifications of directories that happened after they have been
+    // read by the scan but before they have been watched would be missed
+    const QDateTime modifiedSince =
+            scanStartedAt.addSecs(-kModificationTimeToleranceSecs);
+    for (const auto& directory : std::as_const(addedDirectories)) {
+        const QDateTime lastModified = QFileInfo(directory).lastModified();
+        if (!lastModified.isValid() || lastModified >= modifiedSince) {
+            m_modifiedDirectories.insert(directory);
+        }
+    }
+
+    m_subdirectoriesByDirectory = subdirectoriesByDirectory;
+    m_complete = true;
+    kLogger.info()
+            << "Watching"
+            << m_subdirectoriesByDirectory.size()
+            << "directories:"
+            << m_modifiedDirectories.size()
+            << "modified,"
+            << addedDirectories.size()
+            << "added,"
+            << removedDirectories.size()
+            << "removed,"
+            << timer.elapsed().debugMillisWithUnit();
+    return true;
+}
+
+void LibraryWatcher::reset() {
+    const QStringList directories = m_watcher.directories();
+    if (!directories.isEmpty()) {
+        m_watcher.removePaths(directories);
+    }
+    m_subdirectoriesByDirectory.clear();
+    m_modifiedDirectories.clear();
+    m_complete = false;
+}
+
+QHash<QString, QStringList> LibraryWatcher::takeUnmodifiedDirectories() {
+    if (!m_complete) {
+        return {};
+    }
+    QHash<QString, QStringList> unmodifiedDirectories = m_subdirectoriesByDirectory;
+    for (const auto& directory : std::as_const(m_modifiedDirectories)) {
+        unmodifiedDirectories.remove(directory);
+    }
+    m_modifiedDirectories.clear();
+    m_complete = false;
+    return unmodifiedDirectories;
+}
+
+void LibraryWatcher::slotDirectoryChanged(const QString& path) {
+    if (kLogger.traceEnabled()) {
+        kLogger.trace() << "Directory modified" << path;
+    }
+    m_modifiedDirectories.insert(path);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QDateTime>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+/// Records modifications of the directories in the library while Mixxx
+/// is running to restrict subsequent rescans to modified directories.
+///
+/// The directory tree is learned from a complete scan. Only the contents
+/// of directories are watched, i.e. added, removed, and renamed entries,
+/// which is the same information that is captured by the directory hashes
+/// of LibraryHashDAO. Unmodified directories don't need to be read from
+/// disk again.
+///
+/// Not thread-safe, the watcher must be used and destroyed by the thread
+/// that has created it.
+class LibraryWatcher : public QObject {
+    Q_OBJECT
+  public:
+    explicit LibraryWatcher(QObject* parent = nullptr);
+    ~LibraryWatcher() override = default;
+
+    /// Returns true if all directories of the last scan are watched.
+    bool isComplete() const {
+        return m_complete;
+    }
+
+    /// Replaces the watched directories with those of a complete scan,
+    /// each with the paths of its subdirectories. Directories that have
+    /// been modified since the scan started are considered as modified.
+    ///
+    /// Returns false if not all directories could be watched, e.g. when
+    /// exceeding the limits of the operating system. The watcher is
+    /// incomplete and subsequent scans need to be complete in this case.
+    bool watchDirectories(
+            const QHash<QString, QStringList>& subdirectoriesByDirectory,
+            const QDateTime& scanStartedAt);
+
+    /// Stops watching all directories and discards all modifications.
+    void reset();
+
+    /// The watched directories that have not been modified since the
+    /// last scan, each with the paths of its subdirectories.
+    ///
+    /// The recorded modifications are cleared. They are supposed to be
+    /// handled by the scan that is about to start. The watcher remains
+    /// incomplete until this scan has finished, see watchDirectories().
+    QHash<QString, QStringList> takeUnmodifiedDirectories();
+
+    const QSet<QString>& modifiedDirectories() const {
+        return m_modifiedDirectories;
+    }
+
+  private slots:
+    void slotDirectoryChanged(const QString& path);
+
+  private:
+    QFileSystemWatcher m_watcher;
+    QHash<QString, QStringList> m_subdirectoriesByDirectory;
+    QSet<QString> m_modifiedDirectories;
+    bool m_complete;
+};
@@ -30,6 +30,29 @@ void RecursiveScanDirectoryTask::run() {
     //qDebug() << "Burn CPU";
     //for (int i = 0;i < 1000000000; i++) asm("nop");
 
+    const QString dirLocation = m_dirAccess.info().location();
+
+    // Directories that have not been modified since the last scan
+    // don't need to be read from disk again.
+    QStringList subdirLocations;
+    if (m_scannerGlobal->directoryUnmodified(dirLocation, &subdirLocations)) {
+        emit directoryUnchanged(dirLocation);
+        m_scannerGlobal->addScannedDirectory(dirLocation, subdirLocations);
+        for (const QString& subdirLocation : std::as_const(subdirLocations)) {
+            const auto subdirInfo = mixxx::FileInfo(subdirLocation);
+            if (!m_scannerGlobal->testAndMarkDirectoryScanned(subdirInfo.toQDir())) {
+                m_pScanner->queueTask(
+                        new RecursiveScanDirectoryTask(
+                                m_pScanner,
+                                m_scannerGlobal,
+                                mixxx::FileAccess(subdirInfo, m_dirAccess.token()),
+                                m_scanUnhashed));
+            }
+        }
+        setSuccess(true);
+        return;
+    }
+
     // Note, we save on filesystem operations (and random work) by initializing
     // a QDirIterator with a QDir instead of a QString -- but it inherits its
     // Filter from the QDir so we have to set it first. If the QDir has not done
@@ -84,7 +107,10 @@ void RecursiveScanDirectoryTask::run() {
     // Calculate a hash of the directory's file list.
     const mixxx::cache_key_t newHash = mixxx::cacheKeyFromMessageDigest(hasher.result());
 
-    QString dirLocation = m_dirAccess.info().location();
+    for (const mixxx::FileInfo& dirInfo : dirsToScan) {
+        subdirLocations.append(dirInfo.location());
+    }
+    m_scannerGlobal->addScannedDirectory(dirLocation, subdirLocations);
 
     // Try to retrieve a hash from the last time that directory was scanned.
     const mixxx::cache_key_t prevHash = m_scannerGlobal->directoryHashInDatabase(dirLocation);
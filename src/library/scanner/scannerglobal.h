@@ -4,10 +4,12 @@
 #include <QHash>
 #include <QMutex>
 #include <QRegularExpression>
+#include <QSemaphore>
 #include <QSet>
 #include <QSharedPointer>
 #include <QStringList>
 
+#include "track/track_decl.h"
 #include "util/cache.h"
 #include "util/compatibility/qmutex.h"
 #include "util/fileaccess.h"
@@ -20,15 +22,20 @@ class ScannerGlobal {
             const QHash<QString, mixxx::cache_key_t>& directoryHashes,
             const QRegularExpression& supportedExtensionsMatcher,
             const QRegularExpression& supportedCoverExtensionsMatcher,
-            const QStringList& directoriesBlacklist)
+            const QStringList& directoriesBlacklist,
+            const SyncTrackMetadataParams& syncParams,
+            const QHash<QString, QStringList>& unmodifiedDirectories)
             : m_trackLocations(trackLocations),
               m_directoryHashes(directoryHashes),
               m_supportedExtensionsMatcher(supportedExtensionsMatcher),
               m_supportedCoverExtensionsMatcher(supportedCoverExtensionsMatcher),
               m_directoriesBlacklist(directoriesBlacklist),
+              m_syncParams(syncParams),
+              m_unmodifiedDirectories(unmodifiedDirectories),
               // Unless marked un-clean, we assume it will finish cleanly.
               m_scanFinishedCleanly(true),
               m_shouldCancel(false),
+              m_pendingNewTracks(kMaxPendingNewTracks),
               m_numScannedDirectories(0),
               m_numRelocatedTracks(0) {
     }
@@ -95,10 +102,68 @@ class ScannerGlobal {
         return match.hasMatch();
     }
 
+    // The settings for importing metadata of new tracks in worker tasks
+    const SyncTrackMetadataParams& syncTrackMetadataParams() const {
+        return m_syncParams;
+    }
+
+    // Returns true if the directory has not been modified since the last
+    // scan and stores the paths of its subdirectories, see LibraryWatcher.
+    bool directoryUnmodified(const QString& directoryPath,
+            QStringList* pSubdirectoryPaths) const {
+        // no need for locking here, because it is never modified
+        const auto it = m_unmodifiedDirectories.constFind(directoryPath);
+        if (it == m_unmodifiedDirectories.constEnd()) {
+            return false;
+        }
+        *pSubdirectoryPaths = it.value();
+        return true;
+    }
+
+    bool isIncrementalScan() const {
+        return !m_unmodifiedDirectories.isEmpty();
+    }
+
+    // Records the subdirectories of all directories that have been
+    // visited by the scan, either read from disk or unmodified.
+    void addScannedDirectory(const QString& directoryPath,
+            const QStringList& subdirectoryPaths) {
+        const auto locker = lockMutex(&m_subdirectoriesByDirectoryMutex);
+        m_subdirectoriesByDirectory.insert(directoryPath, subdirectoryPaths);
+    }
+
+    const QHash<QString, QStringList>& scannedDirectories() const {
+        // no need for locking here, because it is only used
+        // when only one using thread is around.
+        return m_subdirectoriesByDirectory;
+    }
+
     bool shouldCancel() const {
         return m_shouldCancel;
     }
 
+    // Reserves memory for the parsed metadata and cover image of a new
+    // track until it has been added to the library by the scanner thread,
+    // see releaseNewTracks(). Returns false if the limit has been reached.
+    bool tryAcquireNewTrack() {
+        return m_pendingNewTracks.tryAcquire();
+    }
+
+    // Blocks until a new track can be acquired. Returns false if the scan
+    // has been cancelled while waiting.
+    bool acquireNewTrack() {
+        while (!m_pendingNewTracks.tryAcquire(1, kAcquireNewTrackTimeoutMillis)) {
+            if (m_shouldCancel) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void releaseNewTracks(int count) {
+        m_pendingNewTracks.release(count);
+    }
+
     volatile const bool* shouldCancelPointer() const {
         return &m_shouldCancel;
     }
@@ -162,6 +227,12 @@ class ScannerGlobal {
     }
 
   private:
+    // Limits the number of parsed tracks and cover images that are
+    // kept in memory until they have been added to the library
+    static constexpr int kMaxPendingNewTracks = 128;
+    // Interval for checking if the scan has been cancelled while waiting
+    static constexpr int kAcquireNewTrackTimeoutMillis = 100;
+
     TaskWatcher m_watcher;
 
     QSet<QString> m_trackLocations;
@@ -190,6 +261,13 @@ class ScannerGlobal {
     // this has never been investigated.
     QStringList m_directoriesBlacklist;
 
+    const SyncTrackMetadataParams m_syncParams;
+
+    const QHash<QString, QStringList> m_unmodifiedDirectories;
+
+    mutable QMutex m_subdirectoriesByDirectoryMutex;
+    QHash<QString, QStringList> m_subdirectoriesByDirectory;
+
     // The list of directories verified by the scan.
     QStringList m_verifiedDirectories;
 
@@ -202,6 +280,8 @@ class ScannerGlobal {
     volatile bool m_scanFinishedCleanly;
     volatile bool m_shouldCancel;
 
+    QSemaphore m_pendingNewTracks;
+
     // Stats tracking.
     PerformanceTimer m_timer;
     int m_numScannedDirectories;
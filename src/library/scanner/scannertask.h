@@ -1,12 +1,23 @@
 #pragma once
 
+#include <QList>
 #include <QObject>
 #include <QRunnable>
 
 #include "library/scanner/scannerglobal.h"
+#include "sources/soundsourceproxy.h"
 
 class LibraryScanner;
 
+/// A new file that has already been parsed by a worker task
+/// and is about to be added to the library.
+struct ImportedTrackFile {
+    QString location;
+    SoundSourceProxy::ImportedTrackMetadataAndCoverImage imported;
+};
+
+Q_DECLARE_METATYPE(ImportedTrackFile);
+
 class ScannerTask : public QObject, public QRunnable {
     Q_OBJECT
   public:
@@ -23,7 +34,7 @@ class ScannerTask : public QObject, public QRunnable {
                                    bool newDirectory, mixxx::cache_key_t hash);
     void directoryUnchanged(const QString& directoryPath);
     void trackExists(const QString& filePath);
-    void addNewTrack(const QString& filePath);
+    void addNewTracks(const QList<ImportedTrackFile>& newTracks);
 
     // Feedback to GUI
     void progressLoading(const QString& fileName);
@@ -1,7 +1,11 @@
 #include "library/searchquery.h"
 
 #include <QRegularExpression>
+#include <QStringMatcher>
+#include <algorithm>
+#include <cmath>
 
+#include "library/columnartrackindex.h"
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
 #include "library/trackset/crate/crateschema.h"
@@ -102,8 +106,152 @@ QString concatSqlClauses(
     }
 }
 
+inline MatchResult toMatchResult(bool matches) {
+    return matches ? MatchResult::True : MatchResult::False;
+}
+
+// Three-valued logic of SQL: FALSE AND NULL is FALSE
+inline MatchResult matchAnd(MatchResult lhs, MatchResult rhs) {
+    if (lhs == MatchResult::False || rhs == MatchResult::False) {
+        return MatchResult::False;
+    }
+    if (lhs == MatchResult::Null || rhs == MatchResult::Null) {
+        return MatchResult::Null;
+    }
+    return MatchResult::True;
+}
+
+// Three-valued logic of SQL: TRUE OR NULL is TRUE
+inline MatchResult matchOr(MatchResult lhs, MatchResult rhs) {
+    if (lhs == MatchResult::True || rhs == MatchResult::True) {
+        return MatchResult::True;
+    }
+    if (lhs == MatchResult::Null || rhs == MatchResult::Null) {
+        return MatchResult::Null;
+    }
+    return MatchResult::False;
+}
+
+// Three-valued logic of SQL: NOT NULL is NULL
+inline MatchResult matchNot(MatchResult result) {
+    switch (result) {
+    case MatchResult::False:
+        return MatchResult::True;
+    case MatchResult::True:
+        return MatchResult::False;
+    case MatchResult::Null:
+        return MatchResult::Null;
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return MatchResult::Null;
+}
+
+// Resolves the columns of the index that are referenced by a node.
+// Returns false if any of them is missing or (optionally) not numeric.
+bool indexColumns(const ColumnarTrackIndex& index,
+        const QStringList& sqlColumns,
+        bool numeric,
+        std::vector<int>* pColumns) {
+    pColumns->clear();
+    pColumns->reserve(sqlColumns.size());
+    for (const auto& sqlColumn : sqlColumns) {
+        const int column = index.columnIndex(sqlColumn);
+        if (column < 0 || (numeric && !index.isNumericColumn(column))) {
+            return false;
+        }
+        pColumns->push_back(column);
+    }
+    return true;
+}
+
+enum class NumericOperator {
+    Equal,
+    Less,
+    Greater,
+    LessOrEqual,
+    GreaterOrEqual,
+};
+
+NumericOperator numericOperator(const QString& op) {
+    if (op == QLatin1String("<")) {
+        return NumericOperator::Less;
+    } else if (op == QLatin1String(">")) {
+        return NumericOperator::Greater;
+    } else if (op == QLatin1String("<=")) {
+        return NumericOperator::LessOrEqual;
+    } else if (op == QLatin1String(">=")) {
+        return NumericOperator::GreaterOrEqual;
+    }
+    DEBUG_ASSERT(op == QLatin1String("="));
+    return NumericOperator::Equal;
+}
+
+// The result of a numeric comparison in SQL, i.e. NULL if the
+// value is NULL (NaN)
+MatchResult compareNumber(NumericOperator op, double value, double argument) {
+    if (std::isnan(value)) {
+        return MatchResult::Null;
+    }
+    switch (op) {
+    case NumericOperator::Equal:
+        return toMatchResult(value == argument);
+    case NumericOperator::Less:
+        return toMatchResult(value < argument);
+    case NumericOperator::Greater:
+        return toMatchResult(value > argument);
+    case NumericOperator::LessOrEqual:
+        return toMatchResult(value <= argument);
+    case NumericOperator::GreaterOrEqual:
+        return toMatchResult(value >= argument);
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return MatchResult::Null;
+}
+
+// The result of "value BETWEEN lower AND upper" in SQL
+inline MatchResult matchRange(double value, double lower, double upper) {
+    if (std::isnan(value)) {
+        return MatchResult::Null;
+    }
+    return toMatchResult(value >= lower && value <= upper);
+}
+
+// The result of "value >= lower AND value < upper" in SQL
+inline MatchResult matchRangeUpperExclusive(double value, double lower, double upper) {
+    if (std::isnan(value)) {
+        return MatchResult::Null;
+    }
+    return toMatchResult(value >= lower && value < upper);
+}
+
+// The integer value of "CAST(substr(year,1,4) AS INTEGER)" in SQL:
+// The longest prefix that is an integer number or 0.
+double castYearToInteger(const QString& year) {
+    const QString prefix = year.left(4).trimmed();
+    int end = 0;
+    if (end < prefix.size() &&
+            (prefix[end] == QChar('-') || prefix[end] == QChar('+'))) {
+        ++end;
+    }
+    while (end < prefix.size() && prefix[end].isDigit()) {
+        ++end;
+    }
+    bool ok = false;
+    const int value = prefix.left(end).toInt(&ok);
+    return ok ? value : 0;
+}
+
 } // namespace
 
+bool QueryNode::evaluate(const ColumnarTrackIndex& index,
+        const std::vector<int>& rows,
+        std::vector<MatchResult>* pResults) const {
+    Q_UNUSED(index);
+    Q_UNUSED(rows);
+    Q_UNUSED(pResults);
+    return false;
+}
+
 bool AndNode::match(const TrackPointer& pTrack) const {
     for (const auto& pNode : m_nodes) {
         if (!pNode->match(pTrack)) {
@@ -127,6 +275,45 @@ QString AndNode::toSql() const {
     return concatSqlClauses(queryFragments, "AND");
 }
 
+bool AndNode::evaluate(const ColumnarTrackIndex& index,
+        const std::vector<int>& rows,
+        std::vector<MatchResult>* pResults) const {
+    pResults->assign(rows.size(), MatchResult::True);
+    // Subsequent nodes only need to evaluate the rows that
+    // might still match
+    std::vector<int> pendingRows = rows;
+    std::vector<std::size_t> pendingPositions(rows.size());
+    for (std::size_t i = 0; i < pendingPositions.size(); ++i) {
+        pendingPositions[i] = i;
+    }
+    std::vector<MatchResult> nodeResults;
+    for (const auto& pNode : m_nodes) {
+        if (pendingRows.empty()) {
+            break;
+        }
+        if (pNode->toSql().isEmpty()) {
+            // Omitted from the query, see toSql()
+            continue;
+        }
+        if (!pNode->evaluate(index, pendingRows, &nodeResults)) {
+            return false;
+        }
+        std::size_t pendingCount = 0;
+        for (std::size_t i = 0; i < pendingRows.size(); ++i) {
+            MatchResult& result = (*pResults)[pendingPositions[i]];
+            result = matchAnd(result, nodeResults[i]);
+            if (result != MatchResult::False) {
+                pendingRows[pendingCount] = pendingRows[i];
+                pendingPositions[pendingCount] = pendingPositions[i];
+                ++pendingCount;
+            }
+        }
+        pendingRows.resize(pendingCount);
+        pendingPositions.resize(pendingCount);
+    }
+    return true;
+}
+
 bool OrNode::match(const TrackPointer& pTrack) const {
     for (const auto& pNode : m_nodes) {
         if (pNode->match(pTrack)) {
@@ -151,6 +338,55 @@ QString OrNode::toSql() const {
     return concatSqlClauses(queryFragments, "OR");
 }
 
+bool OrNode::evaluate(const ColumnarTrackIndex& index,
+        const std::vector<int>& rows,
+        std::vector<MatchResult>* pResults) const {
+    if (m_nodes.empty()) {
+        // Consistent with the generated SQL query
+        pResults->assign(rows.size(), MatchResult::False);
+        return true;
+    }
+    if (toSql().isEmpty()) {
+        // Omitted from the query, i.e. everything matches
+        pResults->assign(rows.size(), MatchResult::True);
+        return true;
+    }
+    pResults->assign(rows.size(), MatchResult::False);
+    // Subsequent nodes only need to evaluate the rows that
+    // do not match yet
+    std::vector<int> pendingRows = rows;
+    std::vector<std::size_t> pendingPositions(rows.size());
+    for (std::size_t i = 0; i < pendingPositions.size(); ++i) {
+        pendingPositions[i] = i;
+    }
+    std::vector<MatchResult> nodeResults;
+    for (const auto& pNode : m_nodes) {
+        if (pendingRows.empty()) {
+            break;
+        }
+        if (pNode->toSql().isEmpty()) {
+            // Omitted from the query, see toSql()
+            continue;
+        }
+        if (!pNode->evaluate(index, pendingRows, &nodeResults)) {
+            return false;
+        }
+        std::size_t pendingCount = 0;
+        for (std::size_t i = 0; i < pendingRows.size(); ++i) {
+            MatchResult& result = (*pResults)[pendingPositions[i]];
+            result = matchOr(result, nodeResults[i]);
+            if (result != MatchResult::True) {
+                pendingRows[pendingCount] = pendingRows[i];
+                pendingPositions[pendingCount] = pendingPositions[i];
+                ++pendingCount;
+            }
+        }
+        pendingRows.resize(pendingCount);
+        pendingPositions.resize(pendingCount);
+    }
+    return true;
+}
+
 bool NotNode::match(const TrackPointer& pTrack) const {
     return !m_pNode->match(pTrack);
 }
@@ -167,15 +403,83 @@ QString NotNode::toSql() const {
     }
 }
 
+bool NotNode::evaluate(const ColumnarTrackIndex& index,
+        const std::vector<int>& rows,
+        std::vector<MatchResult>* pResults) const {
+    if (m_pNode->toSql().isEmpty()) {
+        // Omitted from the query, i.e. everything matches
+        pResults->assign(rows.size(), MatchResult::True);
+        return true;
+    }
+    if (!m_pNode->evaluate(index, rows, pResults)) {
+        return false;
+    }
+    for (auto& result : *pResults) {
+        result = matchNot(result);
+    }
+    return true;
+}
+
 TextFilterNode::TextFilterNode(const QSqlDatabase& database,
         const QStringList& sqlColumns,
         const QString& argument,
-        const StringMatch matchMode)
-        : m_database(database),
-          m_sqlColumns(sqlColumns),
+        const StringMatch matchMode,
+        bool useFullTextIndex)
+        : m_sqlColumns(sqlColumns),
           m_argument(argument),
           m_matchMode(matchMode) {
     mixxx::DbConnection::makeStringLatinLow(&m_argument);
+    QString likeArgument = m_argument;
+    if (likeArgument.size() > 0) {
+        if (likeArgument[likeArgument.size() - 1].isSpace()) {
+            // LIKE eats a trailing space. This can be avoided by adding a '_'
+            // as a delimiter that matches any following character.
+            likeArgument.append('_');
+        }
+    }
+    // Escaped now, because the SQL might be generated on a different
+    // thread that must not use this database connection
+    FieldEscaper escaper(database);
+    // Using a switch-case without default case to get a compile-time -Wswitch warning
+    switch (m_matchMode) {
+    case StringMatch::Contains:
+        m_escapedLikeArgument = escaper.escapeString(
+                kSqlLikeMatchAll + likeArgument + kSqlLikeMatchAll);
+        break;
+    case StringMatch::Equals:
+        m_escapedLikeArgument = escaper.escapeString(likeArgument);
+        break;
+    }
+    if (!canUseFullTextIndex(useFullTextIndex)) {
+        return;
+    }
+    for (const auto& sqlColumn : m_sqlColumns) {
+        if (mixxx::trackschema::fullTextColumns().contains(sqlColumn)) {
+            m_fullTextColumns << sqlColumn;
+        }
+    }
+    if (m_fullTextColumns.isEmpty()) {
+        return;
+    }
+    // The index contains the folded texts, i.e. a phrase query
+    // finds the same substrings as LIKE
+    QString phrase = m_argument;
+    phrase.replace(QChar('"'), QStringLiteral("\"\""));
+    m_escapedFullTextQuery = escaper.escapeString(
+            QStringLiteral("{%1} : \"%2\"")
+                    .arg(m_fullTextColumns.join(QChar(' ')), phrase));
+}
+
+bool TextFilterNode::canUseFullTextIndex(bool useFullTextIndex) const {
+    // The trigram tokenizer only finds substrings with 3 or more
+    // characters. Wildcards and the trailing space that is followed
+    // by a wildcard are only interpreted by LIKE.
+    return useFullTextIndex &&
+            m_matchMode == StringMatch::Contains &&
+            m_argument.toUcs4().size() >= 3 &&
+            !m_argument[m_argument.size() - 1].isSpace() &&
+            !m_argument.contains(kSqlLikeMatchAll) &&
+            !m_argument.contains(kSqlLikeMatchOne);
 }
 
 bool TextFilterNode::match(const TrackPointer& pTrack) const {
@@ -201,33 +505,94 @@ bool TextFilterNode::match(const TrackPointer& pTrack) const {
 }
 
 QString TextFilterNode::toSql() const {
-    FieldEscaper escaper(m_database);
-    QString argument = m_argument;
-    if (argument.size() > 0) {
-        if (argument[argument.size() - 1].isSpace()) {
-            // LIKE eats a trailing space. This can be avoided by adding a '_'
-            // as a delimiter that matches any following character.
-            argument.append('_');
-        }
-    }
-    QString escapedArgument;
-    // Using a switch-case without default case to get a compile-time -Wswitch warning
-    switch (m_matchMode) {
-    case StringMatch::Contains:
-        escapedArgument = escaper.escapeString(
-                kSqlLikeMatchAll + argument + kSqlLikeMatchAll);
-        break;
-    case StringMatch::Equals:
-        escapedArgument = escaper.escapeString(argument);
-        break;
-    }
     QStringList searchClauses;
+    QStringList fullTextClauses;
     for (const auto& sqlColumn : m_sqlColumns) {
-        searchClauses << QString("%1 LIKE %2").arg(sqlColumn, escapedArgument);
+        const QString clause = QString("%1 LIKE %2").arg(sqlColumn, m_escapedLikeArgument);
+        if (m_fullTextColumns.contains(sqlColumn)) {
+            fullTextClauses << clause;
+        } else {
+            searchClauses << clause;
+        }
+    }
+    if (!fullTextClauses.isEmpty()) {
+        // Tracks that have been modified since the index has been updated
+        // are still scanned with LIKE. NULL values make the result NULL
+        // like for LIKE.
+        QStringList nullClauses;
+        for (const auto& sqlColumn : m_fullTextColumns) {
+            nullClauses << QString("%1 IS NULL").arg(sqlColumn);
+        }
+        searchClauses << QStringLiteral(
+                "CASE WHEN %1 IN (SELECT id FROM " LIBRARYFTS_PENDING_TABLE
+                ") THEN (%2) "
+                "WHEN %1 IN (SELECT rowid FROM " LIBRARYFTS_TABLE
+                " WHERE " LIBRARYFTS_TABLE " MATCH %3) THEN 1 "
+                "WHEN %4 THEN NULL ELSE 0 END")
+                                 .arg(LIBRARYTABLE_ID,
+                                         concatSqlClauses(fullTextClauses, "OR"),
+                                         m_escapedFullTextQuery,
+                                         nullClauses.join(QStringLiteral(" OR ")));
     }
     return concatSqlClauses(searchClauses, "OR");
 }
 
+bool TextFilterNode::evaluate(const ColumnarTrackIndex& index,
+        const std::vector<int>& rows,
+        std::vector<MatchResult>* pResults) const {
+    if (m_argument.contains(kSqlLikeMatchAll) ||
+            m_argument.contains(kSqlLikeMatchOne)) {
+        // Wildcards that are typed by the user are only
+        // interpreted by LIKE in SQL
+        return false;
+    }
+    std::vector<int> columns;
+    if (!indexColumns(index, m_sqlColumns, false, &columns)) {
+        return false;
+    }
+    // LIKE eats a trailing space, which is followed by a
+    // wildcard in the generated SQL query
+    const bool trailingWildcard =
+            !m_argument.isEmpty() && m_argument[m_argument.size() - 1].isSpace();
+    const QStringMatcher matcher(m_argument);
+    const auto matchesText = [this, trailingWildcard, &matcher](const QString& text) {
+        const int minLength = m_argument.size() + (trailingWildcard ? 1 : 0);
+        switch (m_matchMode) {
+        case StringMatch::Contains: {
+            // Subsequent occurrences are even closer to the end
+            const int pos = matcher.indexIn(text);
+            return pos >= 0 && pos + minLength <= text.size();
+        }
+        case StringMatch::Equals:
+            return text.size() == minLength && text.startsWith(m_argument);
+        }
+        return false;
+    };
+
+    // Each distinct text only needs to be matched once
+    std::vector<qint8> textMatches(index.textCount(), -1);
+    pResults->assign(rows.size(), MatchResult::False);
+    for (const int column : columns) {
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            MatchResult& result = (*pResults)[i];
+            if (result == MatchResult::True) {
+                continue;
+            }
+            const quint32 textId = index.textId(column, rows[i]);
+            if (textId == ColumnarTrackIndex::kNullTextId) {
+                result = matchOr(result, MatchResult::Null);
+                continue;
+            }
+            qint8& textMatch = textMatches[textId];
+            if (textMatch < 0) {
+                textMatch = matchesText(index.foldedText(textId)) ? 1 : 0;
+            }
+            result = matchOr(result, toMatchResult(textMatch > 0));
+        }
+    }
+    return true;
+}
+
 bool NullOrEmptyTextFilterNode::match(const TrackPointer& pTrack) const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -248,26 +613,55 @@ QString NullOrEmptyTextFilterNode::toSql() const {
     return QString();
 }
 
+bool NullOrEmptyTextFilterNode::evaluate(const ColumnarTrackIndex& index,
+        const std::vector<int>& rows,
+        std::vector<MatchResult>* pResults) const {
+    if (m_sqlColumns.isEmpty()) {
+        pResults->assign(rows.size(), MatchResult::True);
+        return true;
+    }
+    // only use the major column
+    const int column = index.columnIndex(m_sqlColumns.first());
+    if (column < 0) {
+        return false;
+    }
+    pResults->resize(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const quint32 textId = index.textId(column, rows[i]);
+        (*pResults)[i] = toMatchResult(textId == ColumnarTrackIndex::kNullTextId ||
+                index.text(textId).isEmpty());
+    }
+    return true;
+}
+
 CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
         const QString& crateNameLike)
         : m_pCrateStorage(pCrateStorage),
-          m_crateNameLike(crateNameLike),
-          m_matchInitialized(false) {
+          m_crateNameLike(crateNameLike) {
+    // Resolved immediately, because parsed queries might be evaluated
+    // on a different thread than the database connection belongs to
+    CrateTrackSelectResult crateTracks(
+            m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
+    while (crateTracks.next()) {
+        m_matchingTrackIds.push_back(crateTracks.trackId());
+    }
 }
 
 bool CrateFilterNode::match(const TrackPointer& pTrack) const {
-    if (!m_matchInitialized) {
-        CrateTrackSelectResult crateTracks(
-                m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
-
-        while (crateTracks.next()) {
-            m_matchingTrackIds.push_back(crateTracks.trackId());
-        }
+    const auto& trackIds = m_matchingTrackIds;
+    return std::binary_search(trackIds.begin(), trackIds.end(), pTrack->getId());
+}
 
-        m_matchInitialized = true;
+bool CrateFilterNode::evaluate(const ColumnarTrackIndex& index,
+        const std::vector<int>& rows,
+        std::vector<MatchResult>* pResults) const {
+    const auto& trackIds = m_matchingTrackIds;
+    pResults->resize(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        (*pResults)[i] = toMatchResult(std::binary_search(
+                trackIds.begin(), trackIds.end(), index.trackIdAt(rows[i])));
     }
-
-    return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+    return true;
 }
 
 QString CrateFilterNode::toSql() const {
@@ -277,23 +671,30 @@ QString CrateFilterNode::toSql() const {
 }
 
 NoCrateFilterNode::NoCrateFilterNode(const CrateStorage* pCrateStorage)
-        : m_pCrateStorage(pCrateStorage),
-          m_matchInitialized(false) {
+        : m_pCrateStorage(pCrateStorage) {
+    // Resolved immediately, see CrateFilterNode
+    TrackSelectResult tracks(
+            m_pCrateStorage->selectAllTracksSorted());
+    while (tracks.next()) {
+        m_matchingTrackIds.push_back(tracks.trackId());
+    }
 }
 
 bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
-    if (!m_matchInitialized) {
-        TrackSelectResult tracks(
-                m_pCrateStorage->selectAllTracksSorted());
-
-        while (tracks.next()) {
-            m_matchingTrackIds.push_back(tracks.trackId());
-        }
+    const auto& trackIds = m_matchingTrackIds;
+    return !std::binary_search(trackIds.begin(), trackIds.end(), pTrack->getId());
+}
 
-        m_matchInitialized = true;
+bool NoCrateFilterNode::evaluate(const ColumnarTrackIndex& index,
+        const std::vector<int>& rows,
+        std::vector<MatchResult>* pResults) const {
+    const auto& trackIds = m_matchingTrackIds;
+    pResults->resize(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        (*pResults)[i] = toMatchResult(!std::binary_search(
+                trackIds.begin(), trackIds.end(), index.trackIdAt(rows[i])));
     }
-
-    return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+    return true;
 }
 
 QString NoCrateFilterNode::toSql() const {
@@ -417,6 +818,42 @@ QString NumericFilterNode::toSql() const {
     return QString();
 }
 
+bool NumericFilterNode::evaluate(const ColumnarTrackIndex& index,
+        const std::vector<int>& rows,
+        std::vector<MatchResult>* pResults) const {
+    if (m_sqlColumns.isEmpty() ||
+            (!m_bNullQuery && !m_bOperatorQuery && !m_bRangeQuery)) {
+        // Omitted from the query, see toSql()
+        pResults->assign(rows.size(), MatchResult::True);
+        return true;
+    }
+    std::vector<int> columns;
+    if (!indexColumns(index, m_sqlColumns, true, &columns)) {
+        return false;
+    }
+    if (m_bNullQuery) {
+        // only use the major column
+        pResults->resize(rows.size());
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            (*pResults)[i] = toMatchResult(
+                    std::isnan(index.number(columns.front(), rows[i])));
+        }
+        return true;
+    }
+    const NumericOperator op = numericOperator(m_operator);
+    pResults->assign(rows.size(), MatchResult::False);
+    for (const int column : columns) {
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            const double value = index.number(column, rows[i]);
+            (*pResults)[i] = matchOr((*pResults)[i],
+                    m_bOperatorQuery
+                            ? compareNumber(op, value, m_dOperatorArgument)
+                            : matchRange(value, m_dRangeLow, m_dRangeHigh));
+        }
+    }
+    return true;
+}
+
 NullNumericFilterNode::NullNumericFilterNode(const QStringList& sqlColumns)
         : m_sqlColumns(sqlColumns) {
 }
@@ -440,6 +877,25 @@ QString NullNumericFilterNode::toSql() const {
     return QString();
 }
 
+bool NullNumericFilterNode::evaluate(const ColumnarTrackIndex& index,
+        const std::vector<int>& rows,
+        std::vector<MatchResult>* pResults) const {
+    if (m_sqlColumns.isEmpty()) {
+        pResults->assign(rows.size(), MatchResult::True);
+        return true;
+    }
+    // only use the major column
+    const int column = index.columnIndex(m_sqlColumns.first());
+    if (column < 0 || !index.isNumericColumn(column)) {
+        return false;
+    }
+    pResults->resize(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        (*pResults)[i] = toMatchResult(std::isnan(index.number(column, rows[i])));
+    }
+    return true;
+}
+
 DurationFilterNode::DurationFilterNode(
         const QStringList& sqlColumns, const QString& argument)
         : NumericFilterNode(sqlColumns) {
@@ -775,6 +1231,73 @@ QString BpmFilterNode::toSql() const {
     }
 }
 
+bool BpmFilterNode::evaluate(const ColumnarTrackIndex& index,
+        const std::vector<int>& rows,
+        std::vector<MatchResult>* pResults) const {
+    pResults->resize(rows.size());
+    if (m_matchMode == MatchMode::Locked) {
+        const int column = index.columnIndex(LIBRARYTABLE_BPM_LOCK);
+        if (column < 0 || !index.isNumericColumn(column)) {
+            return false;
+        }
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            (*pResults)[i] = toMatchResult(index.number(column, rows[i]) == 1.0);
+        }
+        return true;
+    }
+
+    const int column = index.columnIndex(LIBRARYTABLE_BPM);
+    if (column < 0 || !index.isNumericColumn(column)) {
+        return false;
+    }
+    const NumericOperator op = numericOperator(m_operator);
+    // The results must be consistent with toSql() and not with match()!
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const double value = index.number(column, rows[i]);
+        MatchResult result;
+        switch (m_matchMode) {
+        case MatchMode::Null: {
+            result = toMatchResult(value == 0.0);
+            break;
+        }
+        case MatchMode::Explicit: {
+            result = matchRangeUpperExclusive(value, m_rangeLower, m_rangeUpper);
+            break;
+        }
+        case MatchMode::ExplicitStrict:
+        case MatchMode::Fuzzy:
+        case MatchMode::Range: {
+            result = matchRange(value, m_rangeLower, m_rangeUpper);
+            break;
+        }
+        case MatchMode::HalveDouble: {
+            result = matchOr(
+                    matchOr(matchRangeUpperExclusive(value, m_rangeLower, m_rangeUpper),
+                            matchRangeUpperExclusive(
+                                    value, m_bpmHalfLower, m_bpmHalfUpper)),
+                    matchRangeUpperExclusive(
+                            value, m_bpmDoubleLower, m_bpmDoubleUpper));
+            break;
+        }
+        case MatchMode::HalveDoubleStrict: {
+            result = matchOr(
+                    matchOr(matchRange(value, m_rangeLower, m_rangeUpper),
+                            matchRange(value, m_bpmHalfLower, m_bpmHalfUpper)),
+                    matchRange(value, m_bpmDoubleLower, m_bpmDoubleUpper));
+            break;
+        }
+        case MatchMode::Operator: {
+            result = compareNumber(op, value, m_bpm);
+            break;
+        }
+        default: // MatchMode::Invalid
+            result = toMatchResult(std::isnan(value));
+        }
+        (*pResults)[i] = result;
+    }
+    return true;
+}
+
 KeyFilterNode::KeyFilterNode(mixxx::track::io::key::ChromaticKey key,
         bool fuzzy) {
     if (fuzzy) {
@@ -796,6 +1319,24 @@ QString KeyFilterNode::toSql() const {
     return concatSqlClauses(searchClauses, "OR");
 }
 
+bool KeyFilterNode::evaluate(const ColumnarTrackIndex& index,
+        const std::vector<int>& rows,
+        std::vector<MatchResult>* pResults) const {
+    const int column = index.columnIndex(LIBRARYTABLE_KEY_ID);
+    if (column < 0 || !index.isNumericColumn(column)) {
+        return false;
+    }
+    pResults->resize(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const double value = index.number(column, rows[i]);
+        // key_id IS NULL never matches
+        (*pResults)[i] = toMatchResult(!std::isnan(value) &&
+                m_matchKeys.contains(static_cast<mixxx::track::io::key::ChromaticKey>(
+                        static_cast<int>(value))));
+    }
+    return true;
+}
+
 YearFilterNode::YearFilterNode(
         const QStringList& sqlColumns, const QString& argument)
         : NumericFilterNode(sqlColumns, argument) {
@@ -821,3 +1362,43 @@ QString YearFilterNode::toSql() const {
 
     return QString();
 }
+
+bool YearFilterNode::evaluate(const ColumnarTrackIndex& index,
+        const std::vector<int>& rows,
+        std::vector<MatchResult>* pResults) const {
+    if (!m_bNullQuery && !m_bOperatorQuery && !m_bRangeQuery) {
+        // Omitted from the query, see toSql()
+        pResults->assign(rows.size(), MatchResult::True);
+        return true;
+    }
+    const int column = index.columnIndex(LIBRARYTABLE_YEAR);
+    if (column < 0) {
+        return false;
+    }
+    pResults->resize(rows.size());
+    if (m_bNullQuery) {
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            (*pResults)[i] = toMatchResult(
+                    index.textId(column, rows[i]) == ColumnarTrackIndex::kNullTextId);
+        }
+        return true;
+    }
+    const NumericOperator op = numericOperator(m_operator);
+    // Each distinct text only needs to be converted once
+    std::vector<double> years(index.textCount(), std::nan(""));
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const quint32 textId = index.textId(column, rows[i]);
+        if (textId == ColumnarTrackIndex::kNullTextId) {
+            (*pResults)[i] = MatchResult::Null;
+            continue;
+        }
+        double& year = years[textId];
+        if (std::isnan(year)) {
+            year = castYearToInteger(index.text(textId));
+        }
+        (*pResults)[i] = m_bOperatorQuery
+                ? compareNumber(op, year, m_dOperatorArgument)
+                : matchRange(year, m_dRangeLow, m_dRangeHigh);
+    }
+    return true;
+}
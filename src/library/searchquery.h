@@ -13,6 +13,7 @@
 #include "track/track_decl.h"
 #include "util/assert.h"
 
+class ColumnarTrackIndex;
 class CrateStorage;
 class TrackId;
 
@@ -23,6 +24,15 @@ enum class StringMatch {
     Equals,
 };
 
+/// The result of a search predicate for a single row, following the
+/// three-valued logic of SQL: A comparison with NULL is neither true
+/// nor false, and neither is its negation.
+enum class MatchResult : quint8 {
+    False,
+    True,
+    Null,
+};
+
 class QueryNode {
   public:
     QueryNode(const QueryNode&) = delete; // prevent copying
@@ -31,6 +41,16 @@ class QueryNode {
     virtual bool match(const TrackPointer& pTrack) const = 0;
     virtual QString toSql() const = 0;
 
+    /// Evaluates the node for the given rows of an in-memory index
+    /// with the same results as the query returned by toSql(). The
+    /// results are stored at the positions of the corresponding rows.
+    ///
+    /// Returns false if the node can only be evaluated by the database,
+    /// e.g. a plain SQL expression. The results are undefined then.
+    virtual bool evaluate(const ColumnarTrackIndex& index,
+            const std::vector<int>& rows,
+            std::vector<MatchResult>* pResults) const;
+
   protected:
     QueryNode() = default;
 };
@@ -53,12 +73,18 @@ class OrNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const ColumnarTrackIndex& index,
+            const std::vector<int>& rows,
+            std::vector<MatchResult>* pResults) const override;
 };
 
 class AndNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const ColumnarTrackIndex& index,
+            const std::vector<int>& rows,
+            std::vector<MatchResult>* pResults) const override;
 };
 
 class NotNode : public QueryNode {
@@ -70,6 +96,9 @@ class NotNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const ColumnarTrackIndex& index,
+            const std::vector<int>& rows,
+            std::vector<MatchResult>* pResults) const override;
 
   private:
     std::unique_ptr<QueryNode> m_pNode;
@@ -77,34 +106,46 @@ class NotNode : public QueryNode {
 
 class TextFilterNode : public QueryNode {
   public:
+    /// If useFullTextIndex is true the generated SQL looks up the
+    /// columns of the library that are covered by the full-text index
+    /// in this index instead of scanning them with LIKE, if possible.
     TextFilterNode(const QSqlDatabase& database,
             const QStringList& sqlColumns,
             const QString& argument,
-            const StringMatch matchMode = StringMatch::Contains);
+            const StringMatch matchMode = StringMatch::Contains,
+            bool useFullTextIndex = false);
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const ColumnarTrackIndex& index,
+            const std::vector<int>& rows,
+            std::vector<MatchResult>* pResults) const override;
 
   private:
-    QSqlDatabase m_database;
+    bool canUseFullTextIndex(bool useFullTextIndex) const;
+
     QStringList m_sqlColumns;
     QString m_argument;
     StringMatch m_matchMode;
+    QString m_escapedLikeArgument;
+    // The searched columns that are looked up in the full-text index
+    QStringList m_fullTextColumns;
+    QString m_escapedFullTextQuery;
 };
 
 class NullOrEmptyTextFilterNode : public QueryNode {
   public:
-    NullOrEmptyTextFilterNode(const QSqlDatabase& database,
-            const QStringList& sqlColumns)
-            : m_database(database),
-              m_sqlColumns(sqlColumns) {
+    explicit NullOrEmptyTextFilterNode(const QStringList& sqlColumns)
+            : m_sqlColumns(sqlColumns) {
     }
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const ColumnarTrackIndex& index,
+            const std::vector<int>& rows,
+            std::vector<MatchResult>* pResults) const override;
 
   private:
-    QSqlDatabase m_database;
     QStringList m_sqlColumns;
 };
 
@@ -115,12 +156,15 @@ class CrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const ColumnarTrackIndex& index,
+            const std::vector<int>& rows,
+            std::vector<MatchResult>* pResults) const override;
 
   private:
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
-    mutable bool m_matchInitialized;
-    mutable std::vector<TrackId> m_matchingTrackIds;
+    // Sorted by id
+    std::vector<TrackId> m_matchingTrackIds;
 };
 
 class NoCrateFilterNode : public QueryNode {
@@ -129,12 +173,15 @@ class NoCrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const ColumnarTrackIndex& index,
+            const std::vector<int>& rows,
+            std::vector<MatchResult>* pResults) const override;
 
   private:
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
-    mutable bool m_matchInitialized;
-    mutable std::vector<TrackId> m_matchingTrackIds;
+    // Sorted by id
+    std::vector<TrackId> m_matchingTrackIds;
 };
 
 class NumericFilterNode : public QueryNode {
@@ -143,6 +190,9 @@ class NumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const ColumnarTrackIndex& index,
+            const std::vector<int>& rows,
+            std::vector<MatchResult>* pResults) const override;
 
   protected:
     // Single argument constructor for that does not call init()
@@ -172,6 +222,9 @@ class NullNumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const ColumnarTrackIndex& index,
+            const std::vector<int>& rows,
+            std::vector<MatchResult>* pResults) const override;
 
     QStringList m_sqlColumns;
 };
@@ -214,6 +267,9 @@ class BpmFilterNode : public QueryNode {
     }
 
     QString toSql() const override;
+    bool evaluate(const ColumnarTrackIndex& index,
+            const std::vector<int>& rows,
+            std::vector<MatchResult>* pResults) const override;
 
   private:
     bool match(const TrackPointer& pTrack) const override;
@@ -239,6 +295,9 @@ class KeyFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const ColumnarTrackIndex& index,
+            const std::vector<int>& rows,
+            std::vector<MatchResult>* pResults) const override;
 
   private:
     QList<mixxx::track::io::key::ChromaticKey> m_matchKeys;
@@ -272,6 +331,9 @@ class YearFilterNode : public NumericFilterNode {
   public:
     YearFilterNode(const QStringList& sqlColumns, const QString& argument);
     QString toSql() const override;
+    bool evaluate(const ColumnarTrackIndex& index,
+            const std::vector<int>& rows,
+            std::vector<MatchResult>* pResults) const override;
 };
 
 #endif /* SEARCHQUERY_H */
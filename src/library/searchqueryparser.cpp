@@ -69,7 +69,8 @@ const QRegularExpression kSplitOnOrOperatorRegexp = QRegularExpression(
 
 SearchQueryParser::SearchQueryParser(TrackCollection* pTrackCollection, QStringList searchColumns)
         : m_pTrackCollection(pTrackCollection),
-          m_searchCrates(false) {
+          m_searchCrates(false),
+          m_useFullTextIndex(false) {
     setSearchColumns(std::move(searchColumns));
 
     m_textFilters << "artist"
@@ -194,7 +195,7 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                     qDebug() << pNode->toSql();
                 } else {
                     pNode = std::make_unique<NullOrEmptyTextFilterNode>(
-                          m_pTrackCollection->database(), m_fieldToSqlColumns[field]);
+                            m_fieldToSqlColumns[field]);
                     qDebug() << pNode->toSql();
                 }
             } else if (!argument.isEmpty()) {
@@ -206,7 +207,8 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                             m_pTrackCollection->database(),
                             m_fieldToSqlColumns[field],
                             argument,
-                            matchMode);
+                            matchMode,
+                            m_useFullTextIndex);
                 }
             }
         } else if (numericFilterMatch.hasMatch()) {
@@ -236,7 +238,7 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                     if (key == mixxx::track::io::key::INVALID) {
                         if (argument == kMissingFieldSearchTerm) {
                             pNode = std::make_unique<NullOrEmptyTextFilterNode>(
-                                    m_pTrackCollection->database(), m_fieldToSqlColumns[field]);
+                                    m_fieldToSqlColumns[field]);
                         } else {
                             pNode = std::make_unique<TextFilterNode>(
                                     m_pTrackCollection->database(), m_fieldToSqlColumns[field], argument);
@@ -281,11 +283,19 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                     gNode->addNode(std::make_unique<CrateFilterNode>(
                                     &m_pTrackCollection->crates(), argument));
                     gNode->addNode(std::make_unique<TextFilterNode>(
-                            m_pTrackCollection->database(), m_queryColumns, argument));
+                            m_pTrackCollection->database(),
+                            m_queryColumns,
+                            argument,
+                            StringMatch::Contains,
+                            m_useFullTextIndex));
                     pNode = std::move(gNode);
                 } else {
                     pNode = std::make_unique<TextFilterNode>(
-                            m_pTrackCollection->database(), m_queryColumns, argument);
+                            m_pTrackCollection->database(),
+                            m_queryColumns,
+                            argument,
+                            StringMatch::Contains,
+                            m_useFullTextIndex);
                 }
             }
         }
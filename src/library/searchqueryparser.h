@@ -17,6 +17,13 @@ class SearchQueryParser {
 
     void setSearchColumns(QStringList searchColumns);
 
+    /// Look up text in the full-text index of the library, see
+    /// TrackDAO::hasFullTextIndex(). Only applicable if the searched
+    /// table is identified by the ids of the library.
+    void setUseFullTextIndex(bool useFullTextIndex) {
+        m_useFullTextIndex = useFullTextIndex;
+    }
+
     std::unique_ptr<QueryNode> parseQuery(
             const QString& query,
             const QString& extraFilter) const;
@@ -45,6 +52,7 @@ class SearchQueryParser {
     TrackCollection* m_pTrackCollection;
     QStringList m_queryColumns;
     bool m_searchCrates;
+    bool m_useFullTextIndex;
     QStringList m_textFilters;
     QStringList m_numericFilters;
     QStringList m_specialFilters;
@@ -72,6 +72,9 @@ void TrackCollection::connectDatabase(const QSqlDatabase& database) {
     DEBUG_ASSERT(database.isOpen());
     m_database = database;
     m_trackDao.initialize(database);
+    // Only once for the internal collection and not by the TrackDAOs
+    // of other threads that compete for the write lock
+    m_trackDao.buildFullTextIndex();
     m_playlistDao.initialize(database);
     m_cueDao.initialize(database);
     m_directoryDao.initialize(database);
@@ -561,6 +564,13 @@ TrackPointer TrackCollection::getTrackById(
     return m_trackDao.getTrackById(trackId);
 }
 
+QList<TrackPointer> TrackCollection::getTracksByIds(
+        const QList<TrackId>& trackIds) const {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    return m_trackDao.getTracksByIds(trackIds);
+}
+
 TrackPointer TrackCollection::getTrackByRef(
         const TrackRef& trackRef) const {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
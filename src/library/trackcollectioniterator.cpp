@@ -4,18 +4,30 @@
 
 namespace mixxx {
 
+namespace {
+
+constexpr int kPrefetchTrackCount = 100;
+
+} // anonymous namespace
+
 std::optional<TrackPointer> TrackByIdCollectionIterator::nextItem() {
-    const auto nextTrackId =
-            m_trackIdListIter.nextItem();
-    if (!nextTrackId) {
-        return std::nullopt;
-    }
-    const auto trackPtr =
-            m_pTrackCollectionManager->getTrackById(*nextTrackId);
-    if (!trackPtr) {
-        return std::nullopt;
+    while (m_prefetchedTracks.isEmpty()) {
+        TrackIdList trackIds;
+        while (trackIds.size() < kPrefetchTrackCount) {
+            const auto nextTrackId =
+                    m_trackIdListIter.nextItem();
+            if (!nextTrackId) {
+                break;
+            }
+            trackIds.append(*nextTrackId);
+        }
+        if (trackIds.isEmpty()) {
+            return std::nullopt;
+        }
+        m_prefetchedTracks =
+                m_pTrackCollectionManager->getTracksByIds(trackIds);
     }
-    return std::make_optional(trackPtr);
+    return std::make_optional(m_prefetchedTracks.takeFirst());
 }
 
 } // namespace mixxx
@@ -25,10 +25,15 @@ class TrackByIdCollectionIterator final
 
     void reset() override {
         m_trackIdListIter.reset();
+        m_prefetchedTracks.clear();
     }
 
     std::optional<int> estimateItemsRemaining() override {
-        return m_trackIdListIter.estimateItemsRemaining();
+        const auto idsRemaining = m_trackIdListIter.estimateItemsRemaining();
+        if (!idsRemaining) {
+            return std::nullopt;
+        }
+        return std::make_optional(*idsRemaining + m_prefetchedTracks.size());
     }
 
     std::optional<TrackPointer> nextItem() override;
@@ -36,6 +41,9 @@ class TrackByIdCollectionIterator final
   private:
     const TrackCollectionManager* const m_pTrackCollectionManager;
     TrackIdListIterator m_trackIdListIter;
+    // The tracks are loaded in chunks for reducing the number
+    // of database queries
+    QList<TrackPointer> m_prefetchedTracks;
 };
 
 } // namespace mixxx
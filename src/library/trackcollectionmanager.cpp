@@ -1,7 +1,13 @@
 #include "library/trackcollectionmanager.h"
 
+#include <QtConcurrentRun>
 #include <utility>
 
+#include "library/dao/analysisdao.h"
+#include "library/dao/cuedao.h"
+#include "library/dao/libraryhashdao.h"
+#include "library/dao/playlistdao.h"
+#include "library/dao/trackschema.h"
 #include "library/externaltrackcollection.h"
 #include "library/library_decl.h"
 #include "library/library_prefs.h"
@@ -12,6 +18,7 @@
 #include "track/track.h"
 #include "util/assert.h"
 #include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
 #include "util/logger.h"
 
 namespace {
@@ -33,6 +40,62 @@ parented_ptr<TrackCollection> createInternalTrackCollection(
     return make_parented<TrackCollection>(parent, pConfig);
 }
 
+/// Loads the next tracks of the Auto DJ queue and the most recently
+/// played tracks on a worker thread with a separate database connection.
+///
+/// Returns only the tracks that have been loaded by this function and
+/// not those that have already been cached.
+QList<TrackPointer> loadRecentTracks(
+        const mixxx::DbConnectionPoolPtr& pDbConnectionPool,
+        const UserSettingsPointer& pConfig,
+        int maxTrackCount) {
+    const mixxx::DbConnectionPooler dbConnectionPooler(pDbConnectionPool);
+    const QSqlDatabase dbConnection = mixxx::DbConnectionPooled(pDbConnectionPool);
+    if (!dbConnection.isOpen()) {
+        kLogger.warning()
+                << "Failed to open database connection for prefetching tracks";
+        return {};
+    }
+
+    CueDAO cueDao;
+    PlaylistDAO playlistDao;
+    AnalysisDao analysisDao(pConfig);
+    LibraryHashDAO libraryHashDao;
+    TrackDAO trackDao(cueDao, playlistDao, analysisDao, libraryHashDao, pConfig);
+    libraryHashDao.initialize(dbConnection);
+    cueDao.initialize(dbConnection);
+    trackDao.initialize(dbConnection);
+    playlistDao.initialize(dbConnection);
+    analysisDao.initialize(dbConnection);
+
+    // Split evenly between the upcoming and the recently played tracks
+    QList<TrackId> trackIds;
+    const int autoDjPlaylistId = playlistDao.getPlaylistIdFromName(AUTODJ_TABLE);
+    if (autoDjPlaylistId >= 0) {
+        trackIds = playlistDao.getTrackIdsInPlaylistOrder(autoDjPlaylistId)
+                           .mid(0, maxTrackCount / 2);
+    }
+    const QList<TrackId> playedTrackIds = playlistDao.getRecentlyAddedTrackIds(
+            PlaylistDAO::PLHT_SET_LOG, maxTrackCount - trackIds.size());
+    for (const auto& trackId : playedTrackIds) {
+        if (!trackIds.contains(trackId)) {
+            trackIds.append(trackId);
+        }
+    }
+
+    QList<TrackPointer> loadedTracks;
+    const QList<TrackPointer> tracks = trackDao.getTracksByIds(trackIds);
+    for (const auto& pTrack : tracks) {
+        // Only the tracks that have been loaded by this TrackDAO are
+        // connected to it. Their signals need to be relayed by the
+        // TrackDAO of the internal collection instead.
+        if (pTrack->disconnect(&trackDao)) {
+            loadedTracks.append(pTrack);
+        }
+    }
+    return loadedTracks;
+}
+
 } // anonymous namespace
 
 TrackCollectionManager::TrackCollectionManager(
@@ -42,6 +105,7 @@ TrackCollectionManager::TrackCollectionManager(
         deleteTrackFn_t /*only-needed-for-testing*/ deleteTrackForTestingFn)
     : QObject(parent),
       m_pConfig(pConfig),
+      m_pDbConnectionPool(pDbConnectionPool),
       m_pInternalCollection(createInternalTrackCollection(this, pConfig, deleteTrackForTestingFn)) {
     const QSqlDatabase dbConnection = mixxx::DbConnectionPooled(pDbConnectionPool);
 
@@ -132,6 +196,17 @@ TrackCollectionManager::TrackCollectionManager(
         kLogger.info() << "Starting library scanner thread";
         m_pScanner->start();
     }
+
+    // Tests expect that tracks are evicted when releasing the last reference
+    if (!deleteTrackForTestingFn) {
+        const int retainedTrackCount = pConfig->getValue(
+                mixxx::library::prefs::kRetainedTrackCountConfigKey,
+                mixxx::library::prefs::kRetainedTrackCountDefault);
+        if (retainedTrackCount > 0) {
+            GlobalTrackCacheLocker().setRetainedTrackCapacity(retainedTrackCount);
+            prefetchRecentTracks(retainedTrackCount);
+        }
+    }
 }
 
 TrackCollectionManager::~TrackCollectionManager() {
@@ -147,6 +222,10 @@ TrackCollectionManager::~TrackCollectionManager() {
         m_pScanner.reset();
     }
 
+    // Release the prefetched tracks before deactivating the cache
+    m_prefetchFutureWatcher.waitForFinished();
+    m_prefetchFutureWatcher.setFuture(QFuture<QList<TrackPointer>>());
+
     const auto pWeakTrackSource = m_pInternalCollection->disconnectTrackSource();
     VERIFY_OR_DEBUG_ASSERT(pWeakTrackSource.isNull()) {
         kLogger.warning() << "BaseTrackCache is still in use";
@@ -204,6 +283,36 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
 
 // Export metadata and save the track in both the internal database
 // and external libraries.
+void TrackCollectionManager::prefetchRecentTracks(int maxTrackCount) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    DEBUG_ASSERT(!m_prefetchFutureWatcher.isRunning());
+    connect(&m_prefetchFutureWatcher,
+            &QFutureWatcher<QList<TrackPointer>>::finished,
+            this,
+            &TrackCollectionManager::afterRecentTracksPrefetched);
+    m_prefetchFutureWatcher.setFuture(QtConcurrent::run(
+            loadRecentTracks,
+            m_pDbConnectionPool,
+            m_pConfig,
+            maxTrackCount));
+}
+
+void TrackCollectionManager::afterRecentTracksPrefetched() {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    const QList<TrackPointer> tracks = m_prefetchFutureWatcher.result();
+    m_prefetchFutureWatcher.setFuture(QFuture<QList<TrackPointer>>());
+    for (const auto& pTrack : tracks) {
+        m_pInternalCollection->getTrackDAO().relayTrackSignals(pTrack);
+    }
+    kLogger.info()
+            << "Prefetched"
+            << tracks.size()
+            << "tracks";
+    // The tracks are retained by the GlobalTrackCache after
+    // releasing the last reference. Only their metadata is loaded,
+    // waveforms are loaded when the tracks are loaded into a deck.
+}
+
 void TrackCollectionManager::saveEvictedTrack(Track* pTrack) noexcept {
     saveTrack(pTrack, TrackMetadataExportMode::Immediate);
 }
@@ -587,6 +696,12 @@ TrackPointer TrackCollectionManager::getTrackById(
             trackId);
 }
 
+QList<TrackPointer> TrackCollectionManager::getTracksByIds(
+        const QList<TrackId>& trackIds) const {
+    return internalCollection()->getTracksByIds(
+            trackIds);
+}
+
 TrackPointer TrackCollectionManager::getTrackByRef(
         const TrackRef& trackRef) const {
     return internalCollection()->getTrackByRef(
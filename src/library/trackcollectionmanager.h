@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QDir>
+#include <QFutureWatcher>
 #include <QList>
 #include <QSet>
 #include <memory>
@@ -43,6 +44,12 @@ class TrackCollectionManager: public QObject,
         return m_pInternalCollection;
     }
 
+    /// For accessing the internal collection on other threads
+    /// with a separate database connection
+    const mixxx::DbConnectionPoolPtr& dbConnectionPool() const {
+        return m_pDbConnectionPool;
+    }
+
     const QList<ExternalTrackCollection*>& externalCollections() const {
         DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
         return m_externalCollections;
@@ -50,6 +57,9 @@ class TrackCollectionManager: public QObject,
 
     TrackPointer getTrackById(
             TrackId trackId) const;
+    /// Loads multiple tracks at once, see TrackDAO::getTracksByIds()
+    QList<TrackPointer> getTracksByIds(
+            const QList<TrackId>& trackIds) const;
     TrackPointer getTrackByRef(
             const TrackRef& trackRef) const;
     QList<TrackId> resolveTrackIdsFromUrls(
@@ -109,6 +119,11 @@ class TrackCollectionManager: public QObject,
     void afterTracksUpdated(const QSet<TrackId>& updatedTrackIds) const;
     void afterTracksRelocated(const QList<RelocatedTrack>& relocatedTracks) const;
 
+    /// Loads the tracks that are likely to be needed soon after startup
+    /// in the background and keeps them in the GlobalTrackCache.
+    void prefetchRecentTracks(int maxTrackCount);
+    void afterRecentTracksPrefetched();
+
     // Callback for GlobalTrackCache
     void saveEvictedTrack(Track* pTrack) noexcept override;
 
@@ -126,10 +141,14 @@ class TrackCollectionManager: public QObject,
 
     const UserSettingsPointer m_pConfig;
 
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+
     const parented_ptr<TrackCollection> m_pInternalCollection;
 
     QList<ExternalTrackCollection*> m_externalCollections;
 
     // TODO: Extract and decouple LibraryScanner from TrackCollectionManager
     std::unique_ptr<LibraryScanner> m_pScanner;
+
+    QFutureWatcher<QList<TrackPointer>> m_prefetchFutureWatcher;
 };
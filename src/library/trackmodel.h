@@ -107,6 +107,23 @@ class TrackModel {
     virtual TrackPointer getTrack(const QModelIndex& index) const = 0;
     virtual TrackPointer getTrackByRef(const TrackRef& trackRef) const = 0;
 
+    /// Returns the tracks at the given QModelIndexes in the same order.
+    /// Tracks that could not be loaded are skipped.
+    ///
+    /// Models should override this function if they are able to load
+    /// multiple tracks more efficiently than one after another.
+    virtual TrackPointerList getTracks(const QModelIndexList& indices) const {
+        TrackPointerList tracks;
+        tracks.reserve(indices.size());
+        for (const auto& index : indices) {
+            auto pTrack = getTrack(index);
+            if (pTrack) {
+                tracks.append(std::move(pTrack));
+            }
+        }
+        return tracks;
+    }
+
     /// Get the URL of the track at the given QModelIndex.
     ///
     /// This function should be used in favor of getTrackId() to allow
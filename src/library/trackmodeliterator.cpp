@@ -4,6 +4,12 @@
 
 namespace mixxx {
 
+namespace {
+
+constexpr int kPrefetchTrackCount = 100;
+
+} // anonymous namespace
+
 std::optional<TrackId> TrackIdModelIterator::nextItem() {
     const auto nextModelIndex =
             m_modelIndexListIter.nextItem();
@@ -19,17 +25,22 @@ std::optional<TrackId> TrackIdModelIterator::nextItem() {
 }
 
 std::optional<TrackPointer> TrackPointerModelIterator::nextItem() {
-    const auto nextModelIndex =
-            m_modelIndexListIter.nextItem();
-    if (!nextModelIndex) {
-        return std::nullopt;
-    }
-    const auto trackPtr =
-            m_pTrackModel->getTrack(*nextModelIndex);
-    if (!trackPtr) {
-        return std::nullopt;
+    while (m_prefetchedTracks.isEmpty()) {
+        QModelIndexList indices;
+        while (indices.size() < kPrefetchTrackCount) {
+            const auto nextModelIndex =
+                    m_modelIndexListIter.nextItem();
+            if (!nextModelIndex) {
+                break;
+            }
+            indices.append(*nextModelIndex);
+        }
+        if (indices.isEmpty()) {
+            return std::nullopt;
+        }
+        m_prefetchedTracks = m_pTrackModel->getTracks(indices);
     }
-    return std::make_optional(trackPtr);
+    return std::make_optional(m_prefetchedTracks.takeFirst());
 }
 
 } // namespace mixxx
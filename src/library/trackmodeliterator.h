@@ -56,10 +56,15 @@ class TrackPointerModelIterator final
 
     void reset() override {
         m_modelIndexListIter.reset();
+        m_prefetchedTracks.clear();
     }
 
     std::optional<int> estimateItemsRemaining() override {
-        return m_modelIndexListIter.estimateItemsRemaining();
+        const auto indicesRemaining = m_modelIndexListIter.estimateItemsRemaining();
+        if (!indicesRemaining) {
+            return std::nullopt;
+        }
+        return std::make_optional(*indicesRemaining + m_prefetchedTracks.size());
     }
 
     std::optional<TrackPointer> nextItem() override;
@@ -67,6 +72,8 @@ class TrackPointerModelIterator final
   private:
     const TrackModel* const m_pTrackModel;
     ListItemIterator<QModelIndex> m_modelIndexListIter;
+    // The tracks are loaded in chunks, see TrackModel::getTracks()
+    TrackPointerList m_prefetchedTracks;
 };
 
 } // namespace mixxx
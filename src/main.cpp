@@ -16,6 +16,7 @@
 #include "controllers/controllermanager.h"
 #include "coreservices.h"
 #include "errordialoghandler.h"
+#include "library/analysis/headlessanalysis.h"
 #include "mixxxapplication.h"
 #ifdef MIXXX_USE_QML
 #include "mixer/playermanager.h"
@@ -118,6 +119,13 @@ int runMixxx(MixxxApplication* pApp, const CmdlineArgs& args) {
     return exitCode;
 }
 
+int runHeadlessAnalysis(const CmdlineArgs& args) {
+    CmdlineArgs::Instance().parseForUserFeedback();
+
+    HeadlessAnalysis analysis(args);
+    return analysis.run();
+}
+
 void adjustScaleFactor(CmdlineArgs* pArgs) {
     if (qEnvironmentVariableIsSet(kScaleFactorEnvVar)) {
         bool ok;
@@ -233,6 +241,11 @@ int main(int argc, char * argv[]) {
 
     adjustScaleFactor(&args);
 
+    if (args.getHeadless() && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        // The analysis doesn't need a display, e.g. on a build server
+        qputenv("QT_QPA_PLATFORM", QByteArrayLiteral("offscreen"));
+    }
+
     MixxxApplication app(argc, argv);
 
 #if defined(Q_OS_WIN)
@@ -290,7 +303,9 @@ int main(int argc, char * argv[]) {
     // When the last window is closed, terminate the Qt event loop.
     QObject::connect(&app, &MixxxApplication::lastWindowClosed, &app, &MixxxApplication::quit);
 
-    int exitCode = runMixxx(&app, args);
+    int exitCode = args.getHeadless()
+            ? runHeadlessAnalysis(args)
+            : runMixxx(&app, args);
 
     qDebug() << "Mixxx shutdown complete with code" << exitCode;
 
@@ -183,9 +183,12 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
             &Library::slotLoadLocationToPlayer);
 
     DEBUG_ASSERT(!m_pTrackAnalysisScheduler);
+    // Only a few tracks are loaded at a time, so run the analyzers
+    // concurrently to get the waveform and beats as early as possible.
     m_pTrackAnalysisScheduler = pLibrary->createTrackAnalysisScheduler(
             kNumberOfAnalyzerThreads,
-            AnalyzerModeFlags::WithWaveform);
+            static_cast<AnalyzerModeFlags>(
+                    AnalyzerModeFlags::WithWaveform | AnalyzerModeFlags::Pipelined));
 
     connect(m_pTrackAnalysisScheduler.get(), &TrackAnalysisScheduler::trackProgress,
             this, &PlayerManager::onTrackAnalysisProgress);
@@ -193,9 +196,9 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
             this, &PlayerManager::onTrackAnalysisFinished);
 
     // Connect the player to the analyzer queue so that loaded tracks are
-    // analyzed.
+    // analyzed. Tracks in decks are analyzed first.
     foreach(Deck* pDeck, m_decks) {
-        connect(pDeck, &BaseTrackPlayer::newTrackLoaded, this, &PlayerManager::slotAnalyzeTrack);
+        connect(pDeck, &BaseTrackPlayer::newTrackLoaded, this, &PlayerManager::slotAnalyzeDeckTrack);
     }
 
     // Connect the player to the analyzer queue so that loaded tracks are
@@ -429,7 +432,7 @@ void PlayerManager::addDeckInner() {
         connect(pDeck,
                 &BaseTrackPlayer::newTrackLoaded,
                 this,
-                &PlayerManager::slotAnalyzeTrack);
+                &PlayerManager::slotAnalyzeDeckTrack);
     }
 
     m_players[handleGroup.handle()] = pDeck;
@@ -821,11 +824,25 @@ void PlayerManager::slotLoadTrackIntoNextAvailableSampler(TrackPointer pTrack) {
 }
 
 void PlayerManager::slotAnalyzeTrack(TrackPointer track) {
+    analyzeTrack(track, TrackAnalysisScheduler::Priority::Normal);
+}
+
+void PlayerManager::slotAnalyzeDeckTrack(TrackPointer track) {
+    // The DJ is about to play this track, it takes precedence over
+    // tracks in samplers and preview decks that are still queued or
+    // analyzed. The batch analysis of the library is not scheduled here,
+    // it is suspended by trackAnalyzerProgress() anyway.
+    analyzeTrack(track, TrackAnalysisScheduler::Priority::High);
+}
+
+void PlayerManager::analyzeTrack(
+        const TrackPointer& track,
+        TrackAnalysisScheduler::Priority priority) {
     VERIFY_OR_DEBUG_ASSERT(track) {
         return;
     }
     if (m_pTrackAnalysisScheduler) {
-        if (m_pTrackAnalysisScheduler->scheduleTrack(track->getId())) {
+        if (m_pTrackAnalysisScheduler->scheduleTrack(track->getId(), priority)) {
             m_pTrackAnalysisScheduler->resume();
         }
         // The first progress signal will suspend a running batch analysis
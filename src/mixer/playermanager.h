@@ -232,6 +232,7 @@ class PlayerManager : public QObject, public PlayerManagerInterface {
 
   private slots:
     void slotAnalyzeTrack(TrackPointer track);
+    void slotAnalyzeDeckTrack(TrackPointer track);
 
     void onTrackAnalysisProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
     void onTrackAnalysisFinished();
@@ -280,6 +281,10 @@ class PlayerManager : public QObject, public PlayerManagerInterface {
     // creates a new auxiliary.
     void addAuxiliaryInner();
 
+    void analyzeTrack(
+            const TrackPointer& track,
+            TrackAnalysisScheduler::Priority priority);
+
     // Used to protect access to PlayerManager state across threads.
     mutable QT_RECURSIVE_MUTEX m_mutex;
 
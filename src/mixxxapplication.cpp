@@ -9,6 +9,7 @@
 #include "audio/types.h"
 #include "control/controlproxy.h"
 #include "library/relocatedtrack.h"
+#include "library/scanner/scannertask.h"
 #include "library/trackset/crate/crateid.h"
 #include "moc_mixxxapplication.cpp"
 #include "soundio/soundmanagerutil.h"
@@ -140,6 +141,8 @@ void MixxxApplication::registerMetaTypes() {
     // Library Scanner
     qRegisterMetaType<RelocatedTrack>();
     qRegisterMetaType<QList<RelocatedTrack>>();
+    qRegisterMetaType<ImportedTrackFile>();
+    qRegisterMetaType<QList<ImportedTrackFile>>();
 
     // Various custom data types
     qRegisterMetaType<mixxx::ReplayGain>("mixxx::ReplayGain");
@@ -250,11 +250,24 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
             m_signalInfo.setSampleRate(sampleRate);
         }
 
+        // Decoders that read multiple independent streams, e.g. the
+        // stems of a stem file, may decode them concurrently on additional
+        // threads. Only worthwhile when reading large chunks in a batch
+        // like the analysis does.
+        bool concurrentStreamDecoding() const {
+            return m_concurrentStreamDecoding;
+        }
+
+        void setConcurrentStreamDecoding(bool concurrentStreamDecoding) {
+            m_concurrentStreamDecoding = concurrentStreamDecoding;
+        }
+
       private:
         audio::SignalInfo m_signalInfo;
 #ifdef __STEM__
         mixxx::StemChannelSelection m_stemMask;
 #endif
+        bool m_concurrentStreamDecoding = false;
     };
 
     // Opens the AudioSource for reading audio data.
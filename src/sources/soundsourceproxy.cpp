@@ -4,6 +4,7 @@
 #include <QMimeType>
 #include <QRegularExpression>
 #include <QStandardPaths>
+#include <tuple>
 
 #include "sources/audiosourcetrackproxy.h"
 
@@ -607,6 +608,21 @@ SoundSourceProxy::importTrackMetadataAndCoverImage(
             resetMissingTagMetadata);
 }
 
+//static
+SoundSourceProxy::ImportedTrackMetadataAndCoverImage
+SoundSourceProxy::importNewTrackMetadataAndCoverImageFromFile(
+        const mixxx::FileAccess& trackFileAccess,
+        bool resetMissingTagMetadata) {
+    ImportedTrackMetadataAndCoverImage imported;
+    std::tie(imported.importResult, imported.sourceSynchronizedAt) =
+            importTrackMetadataAndCoverImageFromFile(
+                    trackFileAccess,
+                    &imported.trackMetadata,
+                    &imported.coverImage,
+                    resetMissingTagMetadata);
+    return imported;
+}
+
 namespace {
 
 inline bool shouldUpdateTrackMetadataFromSource(
@@ -636,7 +652,8 @@ inline bool shouldImportSeratoTagsFromSource(
 
 SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromSource(
         UpdateTrackFromSourceMode mode,
-        const SyncTrackMetadataParams& syncParams) {
+        const SyncTrackMetadataParams& syncParams,
+        const ImportedTrackMetadataAndCoverImage* pImported) {
     DEBUG_ASSERT(m_pTrack);
 
     if (getUrl().isEmpty()) {
@@ -715,11 +732,26 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
 
     // Parse the tags stored in the audio file and the date and time when the
     // file has been last modified to detect future changes of the tags.
-    auto [metadataImportResult, sourceSynchronizedAt] =
-            importTrackMetadataAndCoverImage(
-                    &trackMetadata,
-                    pCoverImg,
-                    syncParams.resetMissingTagMetadataOnImport);
+    mixxx::MetadataSource::ImportResult metadataImportResult;
+    QDateTime sourceSynchronizedAt;
+    if (pImported &&
+            sourceSyncStatus == mixxx::TrackRecord::SourceSyncStatus::Void &&
+            pCoverImg) {
+        // The file has already been parsed without any defaults, which
+        // are not available for new tracks anyway.
+        metadataImportResult = pImported->importResult;
+        sourceSynchronizedAt = pImported->sourceSynchronizedAt;
+        if (metadataImportResult == mixxx::MetadataSource::ImportResult::Succeeded) {
+            trackMetadata = pImported->trackMetadata;
+            *pCoverImg = pImported->coverImage;
+        }
+    } else {
+        std::tie(metadataImportResult, sourceSynchronizedAt) =
+                importTrackMetadataAndCoverImage(
+                        &trackMetadata,
+                        pCoverImg,
+                        syncParams.resetMissingTagMetadataOnImport);
+    }
     VERIFY_OR_DEBUG_ASSERT(!sourceSynchronizedAt.isValid() ||
             sourceSynchronizedAt.timeSpec() == Qt::UTC) {
         qWarning() << "Converting source synchronization time to UTC:" << sourceSynchronizedAt;
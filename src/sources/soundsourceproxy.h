@@ -153,6 +153,27 @@ class SoundSourceProxy {
         ExtraMetadataImportedAndMerged,
     };
 
+    /// Track metadata and cover image of a file that have been imported
+    /// in advance, e.g. concurrently by a worker thread. The metadata
+    /// has been imported without any defaults, i.e. it is only suitable
+    /// for initializing new tracks.
+    struct ImportedTrackMetadataAndCoverImage {
+        mixxx::MetadataSource::ImportResult importResult =
+                mixxx::MetadataSource::ImportResult::Unavailable;
+        QDateTime sourceSynchronizedAt;
+        mixxx::TrackMetadata trackMetadata;
+        QImage coverImage;
+    };
+
+    /// Imports the track metadata and cover image of a file for
+    /// initializing a new track later by updateTrackFromSource().
+    ///
+    /// This function is thread-safe and can be invoked from any thread,
+    /// see importTrackMetadataAndCoverImageFromFile().
+    static ImportedTrackMetadataAndCoverImage importNewTrackMetadataAndCoverImageFromFile(
+            const mixxx::FileAccess& trackFileAccess,
+            bool resetMissingTagMetadata);
+
     /// Updates file type, metadata, and cover image of the track object
     /// from the source file according to the given mode.
     ///
@@ -174,10 +195,16 @@ class SoundSourceProxy {
     /// properly. The application log will contain warning messages for a detailed
     /// analysis in case unexpected behavior has been reported.
     ///
+    /// Metadata and cover image that have already been imported from the
+    /// file might be passed in pImported to avoid parsing the file again.
+    /// They are only used when initializing a new track for the first time
+    /// and ignored otherwise.
+    ///
     /// Returns true if the track has been modified and false otherwise.
     UpdateTrackFromSourceResult updateTrackFromSource(
             UpdateTrackFromSourceMode mode,
-            const SyncTrackMetadataParams& syncParams);
+            const SyncTrackMetadataParams& syncParams,
+            const ImportedTrackMetadataAndCoverImage* pImported = nullptr);
 
     /// Opening the audio source through the proxy will update the
     /// audio properties of the corresponding track object. Returns
@@ -1,5 +1,8 @@
 #include "sources/soundsourcestem.h"
 
+#include <QThread>
+#include <QWaitCondition>
+
 #include "sources/readaheadframebuffer.h"
 
 extern "C" {
@@ -12,6 +15,7 @@ extern "C" {
 } // extern "C"
 
 #include "util/assert.h"
+#include "util/compatibility/qmutex.h"
 #include "util/logger.h"
 #include "util/sample.h"
 
@@ -300,10 +304,89 @@ SoundSource::OpenResult SoundSourceSingleSTEM::tryOpen(
     return OpenResult::Succeeded;
 }
 
+/// Decodes a single stream of a stem file on its own thread. Each stream
+/// has its own FFmpeg context, so they can be decoded independently.
+class SoundSourceSTEM::StreamDecoder final : public QThread {
+  public:
+    StreamDecoder(SoundSourceSingleSTEM* pStream, SampleBuffer* pBuffer)
+            : m_pStream(pStream),
+              m_pBuffer(pBuffer),
+              m_sampleLength(0),
+              m_pending(false),
+              m_quit(false) {
+        setObjectName(QStringLiteral("SoundSourceSTEM"));
+    }
+
+    ~StreamDecoder() override {
+        {
+            const auto locker = lockMutex(&m_mutex);
+            m_quit = true;
+            m_condition.wakeAll();
+        }
+        wait();
+    }
+
+    // Starts decoding the frames into the buffer, which must not be
+    // accessed until awaitDecoded() returns
+    void decode(IndexRange frameIndexRange, SINT sampleLength) {
+        const auto locker = lockMutex(&m_mutex);
+        DEBUG_ASSERT(!m_pending);
+        DEBUG_ASSERT(sampleLength <= m_pBuffer->size());
+        m_frameIndexRange = frameIndexRange;
+        m_sampleLength = sampleLength;
+        m_pending = true;
+        m_condition.wakeAll();
+    }
+
+    void awaitDecoded() {
+        auto locker = lockMutex(&m_mutex);
+        while (m_pending) {
+            m_condition.wait(&m_mutex);
+        }
+    }
+
+  protected:
+    void run() override {
+        auto locker = lockMutex(&m_mutex);
+        while (true) {
+            while (!m_pending && !m_quit) {
+                m_condition.wait(&m_mutex);
+            }
+            if (m_quit) {
+                return;
+            }
+            const IndexRange frameIndexRange = m_frameIndexRange;
+            const SINT sampleLength = m_sampleLength;
+            locker.unlock();
+            m_pStream->readSampleFrames(WritableSampleFrames(
+                    frameIndexRange,
+                    SampleBuffer::WritableSlice(m_pBuffer->data(), sampleLength)));
+            locker.relock();
+            m_pending = false;
+            m_condition.wakeAll();
+        }
+    }
+
+  private:
+    SoundSourceSingleSTEM* const m_pStream;
+    SampleBuffer* const m_pBuffer;
+
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    IndexRange m_frameIndexRange;
+    SINT m_sampleLength;
+    bool m_pending;
+    bool m_quit;
+};
+
 SoundSourceSTEM::SoundSourceSTEM(const QUrl& url)
         : SoundSource(url) {
 }
 
+SoundSourceSTEM::~SoundSourceSTEM() {
+    close();
+}
+
 SoundSource::OpenResult SoundSourceSTEM::tryOpen(
         OpenMode /*mode*/,
         const OpenParams& params) {
@@ -439,10 +522,26 @@ SoundSource::OpenResult SoundSourceSTEM::tryOpen(
     initBitrateOnce(m_pStereoStreams.front()->getBitrate());
     initFrameIndexRangeOnce(m_pStereoStreams.front()->frameIndexRange());
 
+    if (params.concurrentStreamDecoding() && m_pStereoStreams.size() > 1) {
+        // The buffers must not be moved after the decoders have been
+        // created and are only resized while the decoders are idle
+        m_streamBuffers.resize(m_pStereoStreams.size());
+        for (std::size_t streamIdx = 1; streamIdx < m_pStereoStreams.size(); streamIdx++) {
+            m_streamDecoders.push_back(std::make_unique<StreamDecoder>(
+                    m_pStereoStreams[streamIdx].get(),
+                    &m_streamBuffers[streamIdx]));
+            // Inherits the priority of the calling thread
+            m_streamDecoders.back()->start();
+        }
+    }
+
     return OpenResult::Succeeded;
 }
 
 void SoundSourceSTEM::close() {
+    // Stop decoding before the streams are closed
+    m_streamDecoders.clear();
+    m_streamBuffers.clear();
     for (auto& stream : m_pStereoStreams) {
         stream->close();
     }
@@ -466,7 +565,7 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
     // The same buffer is reused between requests tp prevent reallocation, but
     // it will be reallocated if a larger chunk is requested and will keep the
     // new maximum size
-    if (stemSampleLength > m_buffer.size()) {
+    if (m_streamDecoders.empty() && stemSampleLength > m_buffer.size()) {
         m_buffer = SampleBuffer(stemSampleLength);
     }
 
@@ -489,13 +588,40 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
         return read;
     }
 
-    for (std::size_t streamIdx = 0; streamIdx < stemCount; streamIdx++) {
-        WritableSampleFrames currentStemFrame = WritableSampleFrames(
+    const bool concurrent = !m_streamDecoders.empty();
+    if (concurrent) {
+        DEBUG_ASSERT(m_streamBuffers.size() == stemCount);
+        for (auto& streamBuffer : m_streamBuffers) {
+            if (stemSampleLength > streamBuffer.size()) {
+                streamBuffer = SampleBuffer(stemSampleLength);
+            }
+        }
+        for (auto& pStreamDecoder : m_streamDecoders) {
+            pStreamDecoder->decode(globalSampleFrames.frameIndexRange(), stemSampleLength);
+        }
+        m_pStereoStreams[0]->readSampleFrames(WritableSampleFrames(
                 globalSampleFrames.frameIndexRange(),
                 SampleBuffer::WritableSlice(
-                        m_buffer.data(),
-                        stemSampleLength));
-        m_pStereoStreams[streamIdx]->readSampleFrames(currentStemFrame);
+                        m_streamBuffers[0].data(),
+                        stemSampleLength)));
+        for (auto& pStreamDecoder : m_streamDecoders) {
+            pStreamDecoder->awaitDecoded();
+        }
+    }
+
+    for (std::size_t streamIdx = 0; streamIdx < stemCount; streamIdx++) {
+        const CSAMPLE* pStemBuffer;
+        if (concurrent) {
+            pStemBuffer = m_streamBuffers[streamIdx].data();
+        } else {
+            WritableSampleFrames currentStemFrame = WritableSampleFrames(
+                    globalSampleFrames.frameIndexRange(),
+                    SampleBuffer::WritableSlice(
+                            m_buffer.data(),
+                            stemSampleLength));
+            m_pStereoStreams[streamIdx]->readSampleFrames(currentStemFrame);
+            pStemBuffer = m_buffer.data();
+        }
 
         // TODO(XXX): currently, stem samples are interleaved and packed
         // next to each other as such:
@@ -505,14 +631,14 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
         if (m_requestedChannelCount != mixxx::audio::ChannelCount::stereo()) {
             // Change the sample layout to interleave all channels together
             for (SINT i = 0; i < stemSampleLength / 2; i++) {
-                pBuffer[2 * stemCount * i + 2 * streamIdx] = m_buffer[2 * i];
-                pBuffer[2 * stemCount * i + 2 * streamIdx + 1] = m_buffer[2 * i + 1];
+                pBuffer[2 * stemCount * i + 2 * streamIdx] = pStemBuffer[2 * i];
+                pBuffer[2 * stemCount * i + 2 * streamIdx + 1] = pStemBuffer[2 * i + 1];
             }
         } else {
             // Change the sample layout to mix all channels together
             for (SINT i = 0; i < stemSampleLength / 2; i++) {
-                pBuffer[2 * i] += m_buffer[2 * i];
-                pBuffer[2 * i + 1] += m_buffer[2 * i + 1];
+                pBuffer[2 * i] += pStemBuffer[2 * i];
+                pBuffer[2 * i + 1] += pStemBuffer[2 * i + 1];
             }
         }
     }
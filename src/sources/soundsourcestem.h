@@ -29,14 +29,24 @@ class SoundSourceSingleSTEM : public SoundSourceFFmpeg {
 class SoundSourceSTEM : public SoundSource {
   public:
     explicit SoundSourceSTEM(const QUrl& url);
+    ~SoundSourceSTEM() override;
 
     void close() override;
 
   private:
+    class StreamDecoder;
+
     // Contains each stem source, or the main mix if opened in stereo mode
     std::vector<std::unique_ptr<SoundSourceSingleSTEM>> m_pStereoStreams;
     SampleBuffer m_buffer;
 
+    // Only used if the streams are decoded concurrently, see
+    // OpenParams::concurrentStreamDecoding(). Each stream is decoded into
+    // its own buffer. The first stream is decoded by the reading thread,
+    // all other streams by a StreamDecoder thread.
+    std::vector<SampleBuffer> m_streamBuffers;
+    std::vector<std::unique_ptr<StreamDecoder>> m_streamDecoders;
+
     mixxx::audio::ChannelCount m_requestedChannelCount;
 
   protected:
@@ -1,7 +1,13 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
 #include <QDir>
+#include <QFile>
 #include <QtDebug>
+#include <QtEndian>
+#include <cstring>
+#include <memory>
+#include <random>
 #include <vector>
 
 #include "analyzer/analyzertrack.h"
@@ -9,6 +15,7 @@
 #include "library/dao/analysisdao.h"
 #include "test/mixxxtest.h"
 #include "track/track.h"
+#include "util/math.h"
 
 namespace {
 
@@ -130,4 +137,283 @@ TEST_F(AnalyzerWaveformTest, canary) {
     EXPECT_DOUBLE_EQ(pWaveformSummary->getAudioVisualRatio(), 1.0);
 }
 
+std::vector<CSAMPLE> makeNoise(SINT numSamples) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<CSAMPLE> dis(-1.0f, 1.0f);
+    std::vector<CSAMPLE> samples(numSamples);
+    for (auto& sample : samples) {
+        sample = dis(gen);
+    }
+    return samples;
+}
+
+TrackPointer analyzeInChunks(UserSettingsPointer pConfig,
+        const std::vector<CSAMPLE>& samples,
+        mixxx::audio::SampleRate sampleRate,
+        SINT framesPerChunk) {
+    const SINT frameLength = static_cast<SINT>(samples.size()) / kChannelCount;
+    TrackPointer pTrack = Track::newTemporary();
+    pTrack->setAudioProperties(
+            mixxx::audio::ChannelCount(kChannelCount),
+            sampleRate,
+            mixxx::audio::Bitrate(),
+            mixxx::Duration::fromSeconds(frameLength / sampleRate.toDouble()));
+    AnalyzerWaveform analyzer(pConfig, QSqlDatabase());
+    analyzer.initialize(AnalyzerTrack(pTrack),
+            sampleRate,
+            mixxx::audio::ChannelCount(kChannelCount),
+            frameLength);
+    for (SINT frame = 0; frame < frameLength; frame += framesPerChunk) {
+        const SINT chunkFrames = math_min(framesPerChunk, frameLength - frame);
+        analyzer.processSamples(&samples[frame * kChannelCount], chunkFrames * kChannelCount);
+    }
+    analyzer.storeResults(pTrack);
+    analyzer.cleanup();
+    return pTrack;
+}
+
+// The strides are processed at once for each chunk. Processing the
+// frames one by one must still give exactly the same results, also if
+// the stride length is fractional.
+TEST_F(AnalyzerWaveformTest, chunkSizeIndependence) {
+    // 48 kHz results in a fractional stride length
+    const auto sampleRate = mixxx::audio::SampleRate(48000);
+    const std::vector<CSAMPLE> samples = makeNoise(sampleRate * 2 * kChannelCount);
+
+    const TrackPointer pFrameByFrame = analyzeInChunks(config(), samples, sampleRate, 1);
+    const TrackPointer pChunked = analyzeInChunks(config(), samples, sampleRate, 4096);
+
+    ASSERT_NE(pFrameByFrame->getWaveform(), nullptr);
+    ASSERT_NE(pChunked->getWaveform(), nullptr);
+    EXPECT_EQ(pFrameByFrame->getWaveform()->toByteArray(),
+            pChunked->getWaveform()->toByteArray());
+    ASSERT_NE(pFrameByFrame->getWaveformSummary(), nullptr);
+    ASSERT_NE(pChunked->getWaveformSummary(), nullptr);
+    EXPECT_EQ(pFrameByFrame->getWaveformSummary()->toByteArray(),
+            pChunked->getWaveformSummary()->toByteArray());
+}
+
+// Each level of the mip-map pyramid holds the maxima of adjacent visual
+// frames of the previous level and is restored from the flat layout.
+TEST_F(AnalyzerWaveformTest, mipMapLevels) {
+    const auto sampleRate = mixxx::audio::SampleRate(44100);
+    const std::vector<CSAMPLE> samples = makeNoise(sampleRate * 10 * kChannelCount);
+
+    const TrackPointer pTrack = analyzeInChunks(config(), samples, sampleRate, 4096);
+    const ConstWaveformPointer pWaveform = pTrack->getWaveform();
+    ASSERT_NE(pWaveform, nullptr);
+    // 4411 visual frames are reduced down to 276 visual frames
+    ASSERT_EQ(5, pWaveform->getLevelCount());
+
+    for (int level = 1; level < pWaveform->getLevelCount(); ++level) {
+        const WaveformData* pPrevious = pWaveform->getLevelData(level - 1);
+        const int previousFrames = pWaveform->getLevelDataSize(level - 1) / 2;
+        const WaveformData* pData = pWaveform->getLevelData(level);
+        const int frames = pWaveform->getLevelDataSize(level) / 2;
+        EXPECT_EQ((previousFrames + 1) / 2, frames);
+        for (int frame = 0; frame < frames; ++frame) {
+            for (int chn = 0; chn < kChannelCount; ++chn) {
+                const WaveformData& a = pPrevious[frame * 4 + chn];
+                const WaveformData& b = frame * 2 + 1 < previousFrames
+                        ? pPrevious[frame * 4 + 2 + chn]
+                        : a;
+                const WaveformData& reduced = pData[frame * 2 + chn];
+                EXPECT_EQ(math_max(a.filtered.all, b.filtered.all), reduced.filtered.all);
+                EXPECT_EQ(math_max(a.filtered.low, b.filtered.low), reduced.filtered.low);
+                EXPECT_EQ(math_max(a.filtered.mid, b.filtered.mid), reduced.filtered.mid);
+                EXPECT_EQ(math_max(a.filtered.high, b.filtered.high), reduced.filtered.high);
+            }
+        }
+    }
+
+    EXPECT_EQ(0, pWaveform->getLevelForVisualFramesPerPixel(0.5));
+    EXPECT_EQ(1, pWaveform->getLevelForVisualFramesPerPixel(3.0));
+    EXPECT_EQ(4, pWaveform->getLevelForVisualFramesPerPixel(100.0));
+
+    // The protobuf layout only stores level 0
+    EXPECT_EQ(1, Waveform(pWaveform->toByteArray()).getLevelCount());
+
+    const Waveform restored(pWaveform->toFlatByteArray());
+    ASSERT_EQ(pWaveform->getLevelCount(), restored.getLevelCount());
+    for (int level = 1; level < restored.getLevelCount(); ++level) {
+        const int dataSize = pWaveform->getLevelDataSize(level);
+        ASSERT_EQ(dataSize, restored.getLevelDataSize(level));
+        for (int i = 0; i < dataSize; ++i) {
+            EXPECT_EQ(pWaveform->getLevelData(level)[i].filtered.all,
+                    restored.getLevelData(level)[i].filtered.all);
+            EXPECT_EQ(pWaveform->getLevelData(level)[i].filtered.high,
+                    restored.getLevelData(level)[i].filtered.high);
+        }
+    }
+
+    // The summary is small enough to be rendered directly
+    EXPECT_EQ(1, pTrack->getWaveformSummary()->getLevelCount());
+}
+
+// The flat layout is compressed and stores all levels
+TEST_F(AnalyzerWaveformTest, flatByteArray) {
+    const auto sampleRate = mixxx::audio::SampleRate(44100);
+    const std::vector<CSAMPLE> samples = makeNoise(sampleRate * 10 * kChannelCount);
+
+    const TrackPointer pTrack = analyzeInChunks(config(), samples, sampleRate, 4096);
+    const ConstWaveformPointer pWaveform = pTrack->getWaveform();
+    ASSERT_NE(pWaveform, nullptr);
+    ASSERT_FALSE(pWaveform->hasStem());
+    const QByteArray flatData = pWaveform->toFlatByteArray();
+    EXPECT_TRUE(Waveform::isFlatByteArray(flatData));
+    EXPECT_FALSE(Waveform::isFlatByteArray(pWaveform->toByteArray()));
+    // Smaller than the uncompressed data
+    EXPECT_LT(static_cast<std::size_t>(flatData.size()),
+            pWaveform->getDataSize() * sizeof(WaveformData));
+
+    const Waveform restored(flatData);
+    EXPECT_EQ(Waveform::SaveState::Saved, restored.saveState());
+    EXPECT_EQ(pWaveform->getDataSize(), restored.getDataSize());
+    EXPECT_EQ(pWaveform->getDataSize(), restored.getCompletion());
+    EXPECT_DOUBLE_EQ(pWaveform->getAudioVisualRatio(), restored.getAudioVisualRatio());
+    EXPECT_EQ(pWaveform->getTextureStride(), restored.getTextureStride());
+    EXPECT_FALSE(restored.hasStem());
+    ASSERT_EQ(pWaveform->getLevelCount(), restored.getLevelCount());
+    for (int level = 0; level < restored.getLevelCount(); ++level) {
+        const int dataSize = pWaveform->getLevelDataSize(level);
+        ASSERT_EQ(dataSize, restored.getLevelDataSize(level));
+        EXPECT_EQ(0,
+                std::memcmp(pWaveform->getLevelData(level),
+                        restored.getLevelData(level),
+                        dataSize * sizeof(WaveformData)));
+    }
+
+    // Truncated data is rejected
+    const Waveform truncated(flatData.left(flatData.size() / 2));
+    EXPECT_EQ(0, truncated.getDataSize());
+    EXPECT_EQ(Waveform::SaveState::NotSaved, truncated.saveState());
+
+    // Only the corrupt block of the last level is discarded when decoded
+    QByteArray corruptData = flatData;
+    corruptData[corruptData.size() - 1] = static_cast<char>(corruptData.back() ^ 0x01);
+    const Waveform corrupt(corruptData);
+    ASSERT_EQ(pWaveform->getDataSize(), corrupt.getDataSize());
+    EXPECT_EQ(0,
+            std::memcmp(pWaveform->data(),
+                    corrupt.data(),
+                    pWaveform->getDataSize() * sizeof(WaveformData)));
+    const int lastLevel = corrupt.getLevelCount() - 1;
+    const WaveformData* pCorrupt = corrupt.getLevelData(lastLevel);
+    for (int i = 0; i < corrupt.getLevelDataSize(lastLevel); ++i) {
+        EXPECT_EQ(0, pCorrupt[i].filtered.all);
+    }
+}
+
+// The blocks of a mapped file are decoded independently on first access
+TEST_F(AnalyzerWaveformTest, mapFlatFile) {
+    Waveform waveform(44100, 44100 * 60, 441, -1, 0);
+    const int dataSize = waveform.getDataSize();
+    WaveformData* pData = waveform.data();
+    for (int i = 0; i < dataSize; ++i) {
+        pData[i].filtered.all = static_cast<unsigned char>(i % 251 + 1);
+        pData[i].filtered.low = static_cast<unsigned char>(i % 7);
+    }
+    waveform.setCompletion(dataSize);
+    // The levels are stored even if they have not been built yet
+    ASSERT_EQ(1, waveform.getLevelCount());
+    QByteArray flatData = waveform.toFlatByteArray();
+
+    // Corrupt the first block of level 0. The block table follows the
+    // header of 48 bytes and the level table.
+    const quint32 levelCount = qFromLittleEndian<quint32>(flatData.constData() + 16);
+    const quint64 firstBlockOffset = qFromLittleEndian<quint64>(
+            flatData.constData() + 48 + levelCount * 8);
+    flatData[static_cast<int>(firstBlockOffset) + 8] =
+            static_cast<char>(flatData[static_cast<int>(firstBlockOffset) + 8] ^ 0x01);
+
+    const QString fileName = getTestDir().filePath(QStringLiteral("mapFlatFile"));
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    ASSERT_EQ(flatData.size(), file.write(flatData));
+    file.close();
+
+    const std::unique_ptr<Waveform> pMapped(Waveform::mapFlatFile(fileName));
+    EXPECT_EQ(Waveform::SaveState::Saved, pMapped->saveState());
+    ASSERT_EQ(dataSize, pMapped->getDataSize());
+    EXPECT_EQ(dataSize, pMapped->getCompletion());
+    EXPECT_EQ(waveform.getTextureStride(), pMapped->getTextureStride());
+    EXPECT_EQ(static_cast<int>(levelCount), pMapped->getLevelCount());
+    EXPECT_LT(1, pMapped->getLevelCount());
+
+    // The last element is in another block than the corrupt one
+    EXPECT_EQ(waveform.getAll(dataSize - 1), pMapped->getAll(dataSize - 1));
+    EXPECT_EQ(waveform.getLow(dataSize - 1), pMapped->getLow(dataSize - 1));
+    EXPECT_EQ(0, pMapped->getAll(0));
+
+    waveform.updateLevels();
+    ASSERT_EQ(waveform.getLevelCount(), pMapped->getLevelCount());
+    for (int level = 1; level < pMapped->getLevelCount(); ++level) {
+        const int levelDataSize = waveform.getLevelDataSize(level);
+        ASSERT_EQ(levelDataSize, pMapped->getLevelDataSize(level));
+        // Decodes the last element only
+        EXPECT_EQ(waveform.getLevelData(level)[levelDataSize - 1].filtered.all,
+                pMapped->getLevelData(level, levelDataSize - 1, levelDataSize)[levelDataSize - 1]
+                        .filtered.all);
+        EXPECT_EQ(0,
+                std::memcmp(waveform.getLevelData(level),
+                        pMapped->getLevelData(level),
+                        levelDataSize * sizeof(WaveformData)));
+    }
+
+    // Stored again as is
+    EXPECT_EQ(flatData, pMapped->toFlatByteArray());
+
+    const std::unique_ptr<Waveform> pMissing(Waveform::mapFlatFile(fileName + ".missing"));
+    EXPECT_EQ(0, pMissing->getDataSize());
+    EXPECT_EQ(Waveform::SaveState::NotSaved, pMissing->saveState());
+}
+
+TEST_F(AnalyzerWaveformTest, flatByteArrayWithStems) {
+    constexpr int kStemCount = 2;
+    Waveform waveform(44100, 44100 * 10, 441, -1, kStemCount);
+    ASSERT_TRUE(waveform.hasStem());
+    const int dataSize = waveform.getDataSize();
+    WaveformData* pData = waveform.data();
+    for (int i = 0; i < dataSize; ++i) {
+        pData[i].filtered.low = static_cast<unsigned char>(i % 7);
+        pData[i].filtered.mid = static_cast<unsigned char>(i % 13);
+        pData[i].filtered.high = static_cast<unsigned char>(i % 31);
+        pData[i].filtered.all = static_cast<unsigned char>(i % 251);
+        for (int stemIdx = 0; stemIdx < kStemCount; ++stemIdx) {
+            pData[i].stems[stemIdx] = static_cast<unsigned char>((i + stemIdx) % 127);
+        }
+    }
+    waveform.setCompletion(dataSize);
+
+    const QByteArray flatData = waveform.toFlatByteArray();
+    const Waveform restored(flatData);
+    ASSERT_EQ(dataSize, restored.getDataSize());
+    EXPECT_TRUE(restored.hasStem());
+    EXPECT_EQ(0,
+            std::memcmp(waveform.data(),
+                    restored.data(),
+                    dataSize * sizeof(WaveformData)));
+
+    // The stem planes are omitted without stems
+    Waveform withoutStems(44100, 44100 * 10, 441, -1, 0);
+    std::memcpy(withoutStems.data(), pData, dataSize * sizeof(WaveformData));
+    for (int i = 0; i < dataSize; ++i) {
+        std::memset(withoutStems.data()[i].stems, 0, sizeof(WaveformData::stems));
+    }
+    EXPECT_LT(withoutStems.toFlatByteArray().size(), flatData.size());
+}
+
+static void BM_AnalyzerWaveform(benchmark::State& state) {
+    const auto sampleRate = mixxx::audio::SampleRate(44100);
+    const SINT framesPerChunk = state.range(0);
+    // One minute of audio
+    const std::vector<CSAMPLE> samples = makeNoise(sampleRate * 60 * kChannelCount);
+    const UserSettingsPointer pConfig(new UserSettings(QString()));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(analyzeInChunks(pConfig, samples, sampleRate, framesPerChunk));
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size() / kChannelCount);
+}
+BENCHMARK(BM_AnalyzerWaveform)->Arg(256)->Arg(4096)->Unit(benchmark::kMillisecond);
+
 } // namespace
@@ -0,0 +1,133 @@
+#include "library/dao/analysiscachedao.h"
+
+#include <gtest/gtest.h>
+
+#include <QSqlQuery>
+
+#include "analyzer/analysiscache.h"
+#include "test/librarytest.h"
+#include "track/track.h"
+
+namespace {
+
+const QByteArray kContentHash = QByteArrayLiteral("0123456789abcdefghij");
+
+class AnalysisCacheDaoTest : public LibraryTest {
+  protected:
+    AnalysisCacheDaoTest() {
+        m_dao.initialize(dbConnection());
+    }
+
+    void deleteAllEntries() {
+        QSqlQuery query(dbConnection());
+        ASSERT_TRUE(query.exec("DELETE FROM analysis_cache"));
+    }
+
+    AnalysisCacheDao m_dao;
+};
+
+TEST_F(AnalysisCacheDaoTest, StoreAndFind) {
+    EXPECT_FALSE(m_dao.findEntry(kContentHash).has_value());
+
+    AnalysisCacheDao::Entry entry;
+    entry.beatsVersion = QStringLiteral("BeatMap-1.0");
+    entry.beatsSubVersion = QStringLiteral("sub");
+    entry.beats = QByteArrayLiteral("beats");
+    entry.replayGain.setRatio(0.5);
+    ASSERT_TRUE(m_dao.storeEntry(kContentHash, entry));
+
+    const auto found = m_dao.findEntry(kContentHash);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(entry.beatsVersion, found->beatsVersion);
+    EXPECT_EQ(entry.beatsSubVersion, found->beatsSubVersion);
+    EXPECT_EQ(entry.beats, found->beats);
+    EXPECT_TRUE(found->keys.isEmpty());
+    EXPECT_DOUBLE_EQ(0.5, found->replayGain.getRatio());
+    EXPECT_FALSE(found->replayGain.hasPeak());
+}
+
+TEST_F(AnalysisCacheDaoTest, EmptyResultsDontReplaceStoredResults) {
+    AnalysisCacheDao::Entry beatsEntry;
+    beatsEntry.beatsVersion = QStringLiteral("BeatMap-1.0");
+    beatsEntry.beatsSubVersion = QStringLiteral("sub");
+    beatsEntry.beats = QByteArrayLiteral("beats");
+    ASSERT_TRUE(m_dao.storeEntry(kContentHash, beatsEntry));
+
+    AnalysisCacheDao::Entry keysEntry;
+    keysEntry.keysVersion = QStringLiteral("KeyMap-1.0");
+    keysEntry.keysSubVersion = QStringLiteral("sub");
+    keysEntry.keys = QByteArrayLiteral("keys");
+    ASSERT_TRUE(m_dao.storeEntry(kContentHash, keysEntry));
+
+    const auto found = m_dao.findEntry(kContentHash);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(beatsEntry.beats, found->beats);
+    EXPECT_EQ(beatsEntry.beatsSubVersion, found->beatsSubVersion);
+    EXPECT_EQ(keysEntry.keys, found->keys);
+}
+
+TEST_F(AnalysisCacheDaoTest, ExportAndImport) {
+    AnalysisCacheDao::Entry entry;
+    entry.waveformVersion = QStringLiteral("Waveform-6.0");
+    entry.waveformDescription = QStringLiteral("description");
+    entry.waveform = QByteArrayLiteral("waveform");
+    entry.waveSummaryVersion = QStringLiteral("WaveformSummary-6.0");
+    entry.waveSummary = QByteArrayLiteral("summary");
+    ASSERT_TRUE(m_dao.storeEntry(kContentHash, entry));
+
+    const QString filePath = getTestDataDir().filePath("analysis_cache.sqlite");
+    ASSERT_TRUE(m_dao.exportEntries(filePath));
+
+    deleteAllEntries();
+    EXPECT_FALSE(m_dao.findEntry(kContentHash).has_value());
+
+    EXPECT_EQ(1, m_dao.importEntries(filePath));
+    const auto found = m_dao.findEntry(kContentHash);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(entry.waveformVersion, found->waveformVersion);
+    EXPECT_EQ(entry.waveformDescription, found->waveformDescription);
+    EXPECT_EQ(entry.waveform, found->waveform);
+    EXPECT_EQ(entry.waveSummary, found->waveSummary);
+
+    // Existing entries are kept
+    EXPECT_EQ(0, m_dao.importEntries(filePath));
+
+    EXPECT_EQ(-1, m_dao.importEntries(getTestDataDir().filePath("missing.sqlite")));
+}
+
+TEST_F(AnalysisCacheDaoTest, EditedBeatsAreNotCached) {
+    const AnalysisCache cache(config(), dbConnection(), false);
+    TrackPointer pTrack(Track::newTemporary());
+    pTrack->setAudioProperties(
+            mixxx::audio::ChannelCount(2),
+            mixxx::audio::SampleRate(44100),
+            mixxx::audio::Bitrate(),
+            mixxx::Duration::fromSeconds(180));
+    const auto pAnalyzedBeats = mixxx::Beats::fromConstTempo(pTrack->getSampleRate(),
+            mixxx::audio::kStartFramePos,
+            mixxx::Bpm(120),
+            QStringLiteral("sub"));
+    ASSERT_TRUE(pTrack->trySetBeats(pAnalyzedBeats));
+
+    // Existing beats that have not been replaced by the analysis
+    cache.storeResults(kContentHash, pTrack, pAnalyzedBeats);
+    auto found = m_dao.findEntry(kContentHash);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_TRUE(found->beats.isEmpty());
+
+    // Locked beats
+    ASSERT_TRUE(pTrack->trySetAndLockBeats(pAnalyzedBeats->tryTranslate(1000).value()));
+    cache.storeResults(kContentHash, pTrack, pAnalyzedBeats);
+    found = m_dao.findEntry(kContentHash);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_TRUE(found->beats.isEmpty());
+
+    // Beats of the analysis
+    pTrack->setBpmLocked(false);
+    cache.storeResults(kContentHash, pTrack, nullptr);
+    found = m_dao.findEntry(kContentHash);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_FALSE(found->beats.isEmpty());
+}
+
+} // namespace
@@ -0,0 +1,80 @@
+#include "analyzer/analyzerinput.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+constexpr mixxx::audio::ChannelCount kStemChannelCount = mixxx::audio::ChannelCount::stem();
+
+TEST(AnalyzerInputTest, StereoIsPassedThrough) {
+    AnalyzerInput input;
+    input.initialize(mixxx::audio::ChannelCount::stereo(), AnalyzerInputFormat::Mono);
+
+    const std::vector<CSAMPLE> samples = {0.5f, 0.25f, -1.0f, 0.0f};
+    AnalyzerInputChunk chunk;
+    input.process(samples.data(), samples.size(), &chunk);
+
+    EXPECT_EQ(samples.data(), chunk.data(AnalyzerInputFormat::Interleaved));
+    EXPECT_EQ(samples.data(), chunk.data(AnalyzerInputFormat::Stereo));
+    ASSERT_EQ(2, chunk.sampleCount(AnalyzerInputFormat::Mono));
+    EXPECT_FLOAT_EQ(0.375f, chunk.data(AnalyzerInputFormat::Mono)[0]);
+    EXPECT_FLOAT_EQ(-0.5f, chunk.data(AnalyzerInputFormat::Mono)[1]);
+}
+
+TEST(AnalyzerInputTest, StemsAreMixedToStereo) {
+    // A single frame with the stems 1, 2, 3, 4 on the left
+    // and 10, 20, 30, 40 on the right channel
+    const std::vector<CSAMPLE> samples = {1, 10, 2, 20, 3, 30, 4, 40};
+
+    AnalyzerInput input;
+    input.initialize(kStemChannelCount, AnalyzerInputFormat::Mono);
+    AnalyzerInputChunk chunk;
+    input.process(samples.data(), samples.size(), &chunk);
+    ASSERT_EQ(2, chunk.sampleCount(AnalyzerInputFormat::Stereo));
+    EXPECT_FLOAT_EQ(10.0f, chunk.data(AnalyzerInputFormat::Stereo)[0]);
+    EXPECT_FLOAT_EQ(100.0f, chunk.data(AnalyzerInputFormat::Stereo)[1]);
+    ASSERT_EQ(1, chunk.sampleCount(AnalyzerInputFormat::Mono));
+    EXPECT_FLOAT_EQ(55.0f, chunk.data(AnalyzerInputFormat::Mono)[0]);
+
+    // Without the drums in the first stem
+    input.initialize(kStemChannelCount, AnalyzerInputFormat::Stereo, 0x1);
+    input.process(samples.data(), samples.size(), &chunk);
+    ASSERT_EQ(2, chunk.sampleCount(AnalyzerInputFormat::Stereo));
+    EXPECT_FLOAT_EQ(9.0f, chunk.data(AnalyzerInputFormat::Stereo)[0]);
+    EXPECT_FLOAT_EQ(90.0f, chunk.data(AnalyzerInputFormat::Stereo)[1]);
+}
+
+TEST(AnalyzerInputTest, DecimationContinuesAcrossChunks) {
+    AnalyzerInput input;
+    input.initialize(mixxx::audio::ChannelCount::stereo(),
+            AnalyzerInputFormat::MonoDecimated);
+    AnalyzerInputChunk chunk;
+
+    // A DC signal that is not aligned to the decimation factor
+    const SINT framesPerChunk = mixxx::kAnalysisDecimationFactor * 100 + 3;
+    const std::vector<CSAMPLE> samples(framesPerChunk * 2, 0.5f);
+    SINT totalDecimatedCount = 0;
+    for (int i = 0; i < 8; ++i) {
+        input.process(samples.data(), samples.size(), &chunk);
+        totalDecimatedCount += chunk.sampleCount(AnalyzerInputFormat::MonoDecimated);
+    }
+    EXPECT_EQ(framesPerChunk * 8 / mixxx::kAnalysisDecimationFactor, totalDecimatedCount);
+
+    // The anti-aliasing filter lets DC pass after settling
+    const SINT count = chunk.sampleCount(AnalyzerInputFormat::MonoDecimated);
+    ASSERT_GT(count, 0);
+    EXPECT_NEAR(0.5, chunk.data(AnalyzerInputFormat::MonoDecimated)[count - 1], 0.01);
+
+    EXPECT_EQ(framesPerChunk,
+            AnalyzerInput::frameCount(AnalyzerInputFormat::Stereo,
+                    framesPerChunk * 2,
+                    mixxx::audio::ChannelCount::stereo()));
+    EXPECT_EQ(100 * mixxx::kAnalysisDecimationFactor,
+            AnalyzerInput::frameCount(AnalyzerInputFormat::MonoDecimated,
+                    100,
+                    mixxx::audio::ChannelCount::stereo()));
+}
+
+} // namespace
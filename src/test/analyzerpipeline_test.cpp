@@ -0,0 +1,139 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <vector>
+
+#include "analyzer/analyzertrack.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+
+namespace {
+
+constexpr SINT kSamplesPerChunk = 64;
+constexpr int kChunkCount = 3;
+
+/// Records the first sample of each chunk, optionally taking its time
+class RecordingAnalyzer : public Analyzer {
+  public:
+    RecordingAnalyzer(std::vector<CSAMPLE>* pReceived, unsigned long sleepMillis)
+            : m_pReceived(pReceived),
+              m_sleepMillis(sleepMillis) {
+    }
+
+    bool initialize(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            mixxx::audio::ChannelCount channelCount,
+            SINT frameLength) override {
+        Q_UNUSED(track);
+        Q_UNUSED(sampleRate);
+        Q_UNUSED(channelCount);
+        Q_UNUSED(frameLength);
+        return true;
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        EXPECT_EQ(kSamplesPerChunk, count);
+        // Detect chunks that are overwritten while being processed
+        const CSAMPLE first = pIn[0];
+        if (m_sleepMillis > 0) {
+            QThread::msleep(m_sleepMillis);
+        }
+        EXPECT_EQ(first, pIn[count - 1]);
+        m_pReceived->push_back(first);
+        return true;
+    }
+
+    void storeResults(TrackPointer pTrack) override {
+        Q_UNUSED(pTrack);
+    }
+
+    void cleanup() override {
+    }
+
+  private:
+    std::vector<CSAMPLE>* m_pReceived;
+    const unsigned long m_sleepMillis;
+};
+
+class AnalyzerPipelineTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        const AnalyzerTrack track(Track::newTemporary());
+        m_analyzers.push_back(AnalyzerWithState(
+                std::make_unique<RecordingAnalyzer>(&m_fastReceived, 0)));
+        m_analyzers.push_back(AnalyzerWithState(
+                std::make_unique<RecordingAnalyzer>(&m_slowReceived, 10)));
+        for (auto& analyzer : m_analyzers) {
+            analyzer.initialize(track,
+                    mixxx::audio::SampleRate(44100),
+                    mixxx::audio::ChannelCount::stereo(),
+                    0);
+        }
+        m_input.initialize(mixxx::audio::ChannelCount::stereo(),
+                AnalyzerInputFormat::Interleaved);
+    }
+
+    void TearDown() override {
+        for (auto& analyzer : m_analyzers) {
+            analyzer.cancel();
+        }
+    }
+
+    void publish(AnalyzerPipeline* pPipeline, CSAMPLE value) {
+        mixxx::SampleBuffer& buffer = pPipeline->acquireChunk();
+        buffer.fill(value);
+        pPipeline->publishChunk(buffer.data(), kSamplesPerChunk, kSamplesPerChunk / 2);
+    }
+
+    std::vector<CSAMPLE> m_fastReceived;
+    std::vector<CSAMPLE> m_slowReceived;
+    std::vector<AnalyzerWithState> m_analyzers;
+    AnalyzerInput m_input;
+};
+
+TEST_F(AnalyzerPipelineTest, AllAnalyzersReceiveAllChunksInOrder) {
+    AnalyzerPipeline pipeline(&m_analyzers, &m_input, kChunkCount, kSamplesPerChunk);
+    std::vector<CSAMPLE> published;
+    for (int i = 0; i < 20; ++i) {
+        publish(&pipeline, static_cast<CSAMPLE>(i));
+        published.push_back(static_cast<CSAMPLE>(i));
+    }
+    pipeline.drain();
+
+    EXPECT_EQ(published, m_fastReceived);
+    EXPECT_EQ(published, m_slowReceived);
+    EXPECT_EQ(20 * kSamplesPerChunk / 2, pipeline.processedFrameCount());
+}
+
+TEST_F(AnalyzerPipelineTest, ProcessedFramesLagBehindPublishedFrames) {
+    AnalyzerPipeline pipeline(&m_analyzers, &m_input, kChunkCount, kSamplesPerChunk);
+    for (int i = 0; i < kChunkCount; ++i) {
+        publish(&pipeline, static_cast<CSAMPLE>(i));
+    }
+    // The slow analyzer takes 10 ms for each chunk
+    EXPECT_LT(pipeline.processedFrameCount(), kChunkCount * kSamplesPerChunk / 2);
+    pipeline.drain();
+    EXPECT_EQ(kChunkCount * kSamplesPerChunk / 2, pipeline.processedFrameCount());
+}
+
+TEST_F(AnalyzerPipelineTest, CancelSkipsPendingChunks) {
+    AnalyzerPipeline pipeline(&m_analyzers, &m_input, kChunkCount, kSamplesPerChunk);
+    for (int i = 0; i < 10; ++i) {
+        publish(&pipeline, static_cast<CSAMPLE>(i));
+    }
+    pipeline.cancel();
+    // The slow analyzer can't have kept up
+    EXPECT_LT(m_slowReceived.size(), 10u);
+
+    // Chunks published after cancelling are processed again
+    m_fastReceived.clear();
+    m_slowReceived.clear();
+    publish(&pipeline, 42);
+    pipeline.drain();
+    EXPECT_EQ(std::vector<CSAMPLE>{42}, m_fastReceived);
+    EXPECT_EQ(std::vector<CSAMPLE>{42}, m_slowReceived);
+}
+
+} // namespace
@@ -0,0 +1,175 @@
+#include "library/basesqltablemodel.h"
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSqlQuery>
+#include <memory>
+
+#include "library/basetrackcache.h"
+#include "library/dao/trackschema.h"
+#include "library/librarytablemodel.h"
+#include "test/librarytest.h"
+#include "track/track.h"
+
+class BaseSqlTableModelTest : public LibraryTest {
+  protected:
+    void SetUp() override {
+        m_trackIds.append(addTrack(QStringLiteral("cover-test.flac"),
+                QStringLiteral("Alpha Song")));
+        m_trackIds.append(addTrack(QStringLiteral("cover-test.ogg"),
+                QStringLiteral("Beta Song")));
+        m_trackIds.append(addTrack(QStringLiteral("cover-test.wav"),
+                QStringLiteral("Gamma Song")));
+        for (const auto& trackId : std::as_const(m_trackIds)) {
+            ASSERT_TRUE(trackId.isValid());
+        }
+
+        // Same as the track source of MixxxLibraryFeature with fewer columns
+        const QStringList columns = {
+                LIBRARYTABLE_ID,
+                LIBRARYTABLE_ARTIST,
+                LIBRARYTABLE_TITLE,
+                LIBRARYTABLE_ALBUM,
+                LIBRARYTABLE_KEY_ID,
+                TRACKLOCATIONSTABLE_LOCATION,
+                TRACKLOCATIONSTABLE_FSDELETED,
+                LIBRARYTABLE_MIXXXDELETED};
+        QStringList qualifiedTableColumns;
+        for (const auto& col : columns) {
+            qualifiedTableColumns.append(mixxx::trackschema::tableForColumn(col) +
+                    QLatin1Char('.') + col);
+        }
+        const QString tableName = QStringLiteral("library_cache_view");
+        QSqlQuery query(internalCollection()->database());
+        ASSERT_TRUE(query.exec(
+                QStringLiteral(
+                        "CREATE TEMPORARY VIEW IF NOT EXISTS %1 AS "
+                        "SELECT %2 FROM library "
+                        "INNER JOIN track_locations ON library.location = "
+                        "track_locations.id")
+                        .arg(tableName, qualifiedTableColumns.join(","))));
+
+        m_pTrackSource = QSharedPointer<BaseTrackCache>::create(
+                internalCollection(),
+                tableName,
+                LIBRARYTABLE_ID,
+                columns,
+                QStringList{LIBRARYTABLE_ARTIST, LIBRARYTABLE_TITLE},
+                true);
+        internalCollection()->connectTrackSource(m_pTrackSource);
+
+        m_pModel = std::make_unique<LibraryTableModel>(nullptr,
+                trackCollectionManager(),
+                "mixxx.db.model.library");
+        QObject::connect(m_pModel.get(),
+                &BaseSqlTableModel::searchFinished,
+                [this]() {
+                    ++m_searchFinishedCount;
+                });
+    }
+
+    void TearDown() override {
+        // The track source must be released before the
+        // track collection manager is destroyed
+        m_pModel.reset();
+        m_pTrackSource.reset();
+    }
+
+    TrackId addTrack(const QString& fileName, const QString& title) const {
+        const auto pTrack = getOrAddTrackByLocation(
+                getTestDir().filePath(QStringLiteral("id3-test-data/") + fileName));
+        if (!pTrack) {
+            return TrackId();
+        }
+        pTrack->setTitle(title);
+        trackCollectionManager()->saveTrack(pTrack);
+        return pTrack->getId();
+    }
+
+    bool waitForSearchFinished() {
+        const int searchFinishedCount = m_searchFinishedCount;
+        QElapsedTimer timer;
+        timer.start();
+        while (m_searchFinishedCount == searchFinishedCount &&
+                timer.elapsed() < 10000) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+        }
+        return m_searchFinishedCount > searchFinishedCount;
+    }
+
+    QList<TrackId> resultTrackIds() const {
+        QList<TrackId> trackIds;
+        for (int row = 0; row < m_pModel->rowCount(); ++row) {
+            trackIds.append(m_pModel->getTrackId(m_pModel->index(row, 0)));
+        }
+        return trackIds;
+    }
+
+    QList<TrackId> m_trackIds;
+    QSharedPointer<BaseTrackCache> m_pTrackSource;
+    std::unique_ptr<LibraryTableModel> m_pModel;
+    int m_searchFinishedCount = 0;
+};
+
+TEST_F(BaseSqlTableModelTest, SearchAsync) {
+    m_pModel->search(QStringLiteral("Beta"));
+    ASSERT_TRUE(waitForSearchFinished());
+    EXPECT_EQ(1, m_searchFinishedCount);
+    EXPECT_EQ(QList<TrackId>{m_trackIds.at(1)}, resultTrackIds());
+
+    // The temporary views of the worker connection are reused
+    m_pModel->search(QStringLiteral("Song"));
+    ASSERT_TRUE(waitForSearchFinished());
+    EXPECT_EQ(2, m_searchFinishedCount);
+    EXPECT_EQ(3, m_pModel->rowCount());
+}
+
+TEST_F(BaseSqlTableModelTest, SearchSupersedesPendingSearch) {
+    m_pModel->search(QStringLiteral("Alpha"));
+    m_pModel->search(QStringLiteral("Beta"));
+    m_pModel->search(QStringLiteral("Gamma"));
+    ASSERT_TRUE(waitForSearchFinished());
+
+    // Only the results of the most recent search are applied
+    QCoreApplication::processEvents();
+    EXPECT_FALSE(m_pModel->isSearchPending());
+    EXPECT_EQ(1, m_searchFinishedCount);
+    EXPECT_EQ(QList<TrackId>{m_trackIds.at(2)}, resultTrackIds());
+    EXPECT_EQ(QStringLiteral("Gamma"), m_pModel->currentSearch());
+}
+
+TEST_F(BaseSqlTableModelTest, SearchAsyncKeepsSortOrder) {
+    const int titleColumn = m_pModel->fieldIndex(LIBRARYTABLE_TITLE);
+    ASSERT_LE(0, titleColumn);
+
+    m_pModel->setSort(titleColumn, Qt::DescendingOrder);
+    m_pModel->search(QStringLiteral("Song"));
+    ASSERT_TRUE(waitForSearchFinished());
+    EXPECT_EQ((QList<TrackId>{m_trackIds.at(2), m_trackIds.at(1), m_trackIds.at(0)}),
+            resultTrackIds());
+
+    m_pModel->setSort(titleColumn, Qt::AscendingOrder);
+    m_pModel->search(QStringLiteral("Song"));
+    ASSERT_TRUE(waitForSearchFinished());
+    EXPECT_EQ((QList<TrackId>{m_trackIds.at(0), m_trackIds.at(1), m_trackIds.at(2)}),
+            resultTrackIds());
+}
+
+TEST_F(BaseSqlTableModelTest, GetTracks) {
+    m_pModel->search(QStringLiteral("Song"));
+    ASSERT_TRUE(waitForSearchFinished());
+    ASSERT_EQ(3, m_pModel->rowCount());
+
+    const QModelIndexList indices = {
+            m_pModel->index(2, 0),
+            QModelIndex(),
+            m_pModel->index(0, 0),
+    };
+    const TrackPointerList tracks = m_pModel->getTracks(indices);
+    // Invalid indices are skipped and the order is preserved
+    ASSERT_EQ(2, tracks.size());
+    EXPECT_EQ(m_pModel->getTrackId(indices.at(0)), tracks.at(0)->getId());
+    EXPECT_EQ(m_pModel->getTrackId(indices.at(2)), tracks.at(1)->getId());
+}
@@ -0,0 +1,278 @@
+#include "library/columnartrackindex.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <cmath>
+#include <random>
+
+#include "library/searchquery.h"
+#include "library/searchqueryparser.h"
+#include "test/librarytest.h"
+
+namespace {
+
+const QStringList kColumns = {
+        QStringLiteral("id"),
+        QStringLiteral("artist"),
+        QStringLiteral("album_artist"),
+        QStringLiteral("title"),
+        QStringLiteral("year"),
+        QStringLiteral("bpm"),
+        QStringLiteral("bpm_lock"),
+        QStringLiteral("key_id"),
+        QStringLiteral("timesplayed"),
+};
+
+const std::vector<bool> kNumericColumns = {
+        true,
+        false,
+        false,
+        false,
+        false,
+        true,
+        true,
+        true,
+        true,
+};
+
+QVariant nullValueOfType(QMetaType::Type type) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return QVariant(QMetaType(type));
+#else
+    return QVariant(static_cast<QVariant::Type>(type));
+#endif
+}
+
+class ColumnarTrackIndexTest : public LibraryTest {
+  protected:
+    ColumnarTrackIndexTest()
+            : m_parser(internalCollection(), {"artist", "title"}),
+              m_index(kColumns, kNumericColumns) {
+        m_index.setRow(TrackId(QVariant(1)),
+                {1,
+                        QStringLiteral("Foo Fighters"),
+                        QVariant(),
+                        QStringLiteral("Everlong"),
+                        QStringLiteral("1997-05-20"),
+                        158.0,
+                        0,
+                        1,
+                        3});
+        m_index.setRow(TrackId(QVariant(2)),
+                {2,
+                        QVariant(),
+                        QVariant(),
+                        QStringLiteral("Ëverything"),
+                        QVariant(),
+                        QVariant(),
+                        1,
+                        QVariant(),
+                        0});
+        m_index.setRow(TrackId(QVariant(3)),
+                {3,
+                        QStringLiteral("Bar"),
+                        QVariant(),
+                        QStringLiteral("foo bar"),
+                        QStringLiteral("2005"),
+                        79.0,
+                        0,
+                        2,
+                        QVariant()});
+    }
+
+    std::vector<int> allRows() const {
+        std::vector<int> rows;
+        for (int row = 0; row < m_index.rowCount(); ++row) {
+            if (m_index.trackIdAt(row).isValid()) {
+                rows.push_back(row);
+            }
+        }
+        return rows;
+    }
+
+    std::vector<int> search(const QString& query) const {
+        const auto pQuery = m_parser.parseQuery(query, QString());
+        const std::vector<int> rows = allRows();
+        std::vector<MatchResult> results;
+        EXPECT_TRUE(pQuery->evaluate(m_index, rows, &results)) << query.toStdString();
+        std::vector<int> matchingRows;
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            if (results[i] == MatchResult::True) {
+                matchingRows.push_back(rows[i]);
+            }
+        }
+        return matchingRows;
+    }
+
+    SearchQueryParser m_parser;
+    ColumnarTrackIndex m_index;
+};
+
+TEST_F(ColumnarTrackIndexTest, InternedTexts) {
+    EXPECT_EQ(0, m_index.rowOf(TrackId(QVariant(1))));
+    EXPECT_EQ(-1, m_index.rowOf(TrackId(QVariant(4))));
+
+    const int artist = m_index.columnIndex("artist");
+    ASSERT_LE(0, artist);
+    EXPECT_EQ(-1, m_index.columnIndex("album"));
+    EXPECT_EQ(ColumnarTrackIndex::kNullTextId, m_index.textId(artist, 1));
+    EXPECT_EQ(QStringLiteral("Foo Fighters"), m_index.text(m_index.textId(artist, 0)));
+    EXPECT_EQ(QStringLiteral("foo fighters"), m_index.foldedText(m_index.textId(artist, 0)));
+
+    // Equal texts share the same id, also in different columns
+    m_index.setRow(TrackId(QVariant(4)),
+            {4, QStringLiteral("Bar"), QVariant(), QStringLiteral("Bar"), QVariant(), 0.0, 0, 0, 0});
+    const int title = m_index.columnIndex("title");
+    EXPECT_EQ(m_index.textId(artist, 2), m_index.textId(artist, 3));
+    EXPECT_EQ(m_index.textId(artist, 3), m_index.textId(title, 3));
+
+    const int bpm = m_index.columnIndex("bpm");
+    ASSERT_TRUE(m_index.isNumericColumn(bpm));
+    EXPECT_EQ(158.0, m_index.number(bpm, 0));
+    EXPECT_TRUE(std::isnan(m_index.number(bpm, 1)));
+}
+
+TEST_F(ColumnarTrackIndexTest, RemoveRow) {
+    m_index.removeRow(TrackId(QVariant(2)));
+    EXPECT_EQ(-1, m_index.rowOf(TrackId(QVariant(2))));
+    EXPECT_FALSE(m_index.trackIdAt(1).isValid());
+    // Rows remain stable
+    EXPECT_EQ(2, m_index.rowOf(TrackId(QVariant(3))));
+    EXPECT_EQ(std::vector<int>({0, 2}), search("foo"));
+}
+
+TEST_F(ColumnarTrackIndexTest, Values) {
+    const QDateTime dateTime = QDateTime::currentDateTimeUtc();
+    const QVector<QVariant> values = {4,
+            QStringLiteral("Bar"),
+            nullValueOfType(QMetaType::QString),
+            dateTime,
+            QStringLiteral("2005"),
+            79.25,
+            true,
+            nullValueOfType(QMetaType::Int),
+            Q_INT64_C(1234567890123)};
+    m_index.setRow(TrackId(QVariant(4)), values);
+    const int row = m_index.rowOf(TrackId(QVariant(4)));
+    for (int column = 0; column < m_index.columnCount(); ++column) {
+        // Values and their types are restored, including NULL values
+        const QVariant value = m_index.value(column, row);
+        EXPECT_EQ(values[column].userType(), value.userType()) << column;
+        EXPECT_EQ(values[column].isNull(), value.isNull()) << column;
+        EXPECT_EQ(values[column], value) << column;
+    }
+    EXPECT_EQ(dateTime, m_index.value(m_index.columnIndex("title"), row).toDateTime());
+
+    // Binary values are stored once and not interned as text
+    const QByteArray digest = QByteArrayLiteral("\x01\x02\x03");
+    const int textCount = m_index.textCount();
+    m_index.setRow(TrackId(QVariant(4)),
+            {4, QStringLiteral("Bar"), digest, QStringLiteral("Bar"), QVariant(), 0.0, 0, 0, 0});
+    const int albumArtist = m_index.columnIndex("album_artist");
+    EXPECT_EQ(ColumnarTrackIndex::kNullTextId, m_index.textId(albumArtist, row));
+    EXPECT_EQ(textCount, m_index.textCount());
+    EXPECT_EQ(QVariant(digest), m_index.value(albumArtist, row));
+
+    // Replaced and removed values
+    m_index.setRow(TrackId(QVariant(4)),
+            {4, QStringLiteral("Bar"), QVariant(), QStringLiteral("Bar"), QVariant(), 0.0, 0, 0, 0});
+    EXPECT_EQ(QVariant(QStringLiteral("Bar")),
+            m_index.value(m_index.columnIndex("title"), row));
+    m_index.removeRow(TrackId(QVariant(4)));
+    EXPECT_FALSE(m_index.value(m_index.columnIndex("title"), row).isValid());
+}
+
+TEST_F(ColumnarTrackIndexTest, TextRanks) {
+    m_index.setRow(TrackId(QVariant(4)),
+            {4, QStringLiteral("bar"), QVariant(), QStringLiteral("Abba"), QVariant(), 0.0, 0, 0, 0});
+    const int artist = m_index.columnIndex("artist");
+    const mixxx::StringCollator collator;
+    const std::vector<int>& ranks = m_index.textRanks(artist, collator);
+    const int nullRank = ranks[m_index.textId(artist, 1)];
+    const int barRank = ranks[m_index.textId(artist, 2)];
+    const int fooRank = ranks[m_index.textId(artist, 0)];
+    EXPECT_LT(nullRank, barRank);
+    EXPECT_LT(barRank, fooRank);
+    // Case-insensitive
+    EXPECT_EQ(barRank, ranks[m_index.textId(artist, 3)]);
+}
+
+TEST_F(ColumnarTrackIndexTest, TextFilter) {
+    EXPECT_EQ(std::vector<int>({0, 2}), search("foo"));
+    EXPECT_EQ(std::vector<int>({0}), search("foo everlong"));
+    EXPECT_EQ(std::vector<int>({0, 1}), search("everlong | everything"));
+    // Case and diacritics are folded like by LIKE
+    EXPECT_EQ(std::vector<int>({1}), search("EVERYTHING"));
+    EXPECT_EQ(std::vector<int>({2}), search("artist:=bar"));
+    EXPECT_EQ(std::vector<int>(), search("artist:=ba"));
+    EXPECT_EQ(std::vector<int>({1}), search("artist:\"\""));
+}
+
+TEST_F(ColumnarTrackIndexTest, NullValuesAreNeitherTrueNorFalse) {
+    // Row 1 has no artist, which is NULL in SQL. The title does not
+    // match, i.e. the term is NULL and so is its negation.
+    EXPECT_EQ(std::vector<int>(), search("-foo"));
+    EXPECT_EQ(std::vector<int>({0}), search("-bar"));
+}
+
+TEST_F(ColumnarTrackIndexTest, NumericFilter) {
+    EXPECT_EQ(std::vector<int>({0}), search("played:>1"));
+    EXPECT_EQ(std::vector<int>({0, 1}), search("played:0-5"));
+    EXPECT_EQ(std::vector<int>({2}), search("year:>2000"));
+    EXPECT_EQ(std::vector<int>({0}), search("year:1997"));
+    EXPECT_EQ(std::vector<int>({1}), search("year:\"\""));
+    // Also finds the half BPM
+    EXPECT_EQ(std::vector<int>({0, 2}), search("bpm:158"));
+    EXPECT_EQ(std::vector<int>({2}), search("bpm:<100"));
+    EXPECT_EQ(std::vector<int>({1}), search("bpm:locked"));
+    EXPECT_EQ(std::vector<int>({0}), search("key:C"));
+}
+
+TEST_F(ColumnarTrackIndexTest, SqlIsNotSupported) {
+    const auto pQuery = m_parser.parseQuery("foo", "mixxx_deleted=0");
+    std::vector<MatchResult> results;
+    EXPECT_FALSE(pQuery->evaluate(m_index, allRows(), &results));
+}
+
+void BM_ColumnarTrackIndexSearch(benchmark::State& state) {
+    const int rowCount = static_cast<int>(state.range(0));
+    ColumnarTrackIndex index(kColumns, kNumericColumns);
+    std::mt19937 gen; // explicitly don't seed for reproducibility
+    std::uniform_int_distribution<> dis(0, rowCount / 10);
+    for (int i = 1; i <= rowCount; ++i) {
+        index.setRow(TrackId(QVariant(i)),
+                {i,
+                        QStringLiteral("Artist %1").arg(dis(gen)),
+                        QVariant(),
+                        QStringLiteral("Title %1 of the track").arg(i),
+                        QStringLiteral("2000"),
+                        120.0,
+                        0,
+                        1,
+                        0});
+    }
+    std::vector<int> rows(rowCount);
+    for (int i = 0; i < rowCount; ++i) {
+        rows[i] = i;
+    }
+
+    AndNode query;
+    const QStringList sqlColumns = {QStringLiteral("artist"), QStringLiteral("title")};
+    query.addNode(std::make_unique<TextFilterNode>(
+            QSqlDatabase(), sqlColumns, QStringLiteral("artist 12")));
+    query.addNode(std::make_unique<TextFilterNode>(
+            QSqlDatabase(), sqlColumns, QStringLiteral("track")));
+    std::vector<MatchResult> results;
+    for (auto _ : state) {
+        query.evaluate(index, rows, &results);
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * rowCount);
+}
+
+BENCHMARK(BM_ColumnarTrackIndexSearch)->Arg(10000)->Arg(100000);
+
+} // namespace
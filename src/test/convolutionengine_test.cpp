@@ -0,0 +1,131 @@
+#include "effects/backends/builtin/convolutionengine.h"
+
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <cmath>
+#include <vector>
+
+#include "test/mixxxtest.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+class ConvolutionEngineTest : public MixxxTest {
+  protected:
+    static std::vector<double> decayingImpulse(SINT frames) {
+        std::vector<double> impulse(frames);
+        for (SINT i = 0; i < frames; ++i) {
+            // Deterministic, decaying and not too regular
+            impulse[i] = std::exp(-i / 2000.0) * (((i * 7919) % 13) - 6) / 6.0;
+        }
+        return impulse;
+    }
+
+    /// The tests don't run in real time. Waiting for the tail block after
+    /// each buffer ensures that the worker never misses its deadline.
+    static void waitForTailBlock(const mixxx::ConvolutionEngine& engine) {
+        QElapsedTimer timer;
+        timer.start();
+        while (engine.isTailBlockPending() && timer.elapsed() < 10000) {
+            QThread::yieldCurrentThread();
+        }
+        ASSERT_FALSE(engine.isTailBlockPending());
+    }
+};
+
+TEST_F(ConvolutionEngineTest, MatchesDirectConvolution) {
+    constexpr SINT kFramesPerBuffer = 256;
+    const auto partitioning =
+            mixxx::ConvolutionPartitioning::forFramesPerBuffer(kFramesPerBuffer);
+    ASSERT_TRUE(partitioning.isValid());
+
+    // Long enough to cover the head and multiple tail partitions
+    const SINT impulseFrames = partitioning.headLengthFrames() +
+            2 * partitioning.tailBlockFrames() + 123;
+    const std::vector<double> leftImpulse = decayingImpulse(impulseFrames);
+    std::vector<double> rightImpulse(leftImpulse.rbegin(), leftImpulse.rend());
+    const auto pImpulse = std::make_shared<const mixxx::ConvolutionImpulse>(
+            partitioning,
+            std::make_unique<mixxx::ConvolutionKernel>(
+                    leftImpulse.data(), impulseFrames, partitioning),
+            std::make_unique<mixxx::ConvolutionKernel>(
+                    rightImpulse.data(), impulseFrames, partitioning));
+
+    mixxx::ConvolutionEngine engine(pImpulse);
+    const auto pWorker = mixxx::ConvolutionWorker::acquire();
+
+    // A few clicks in the input
+    const SINT latencyFrames = engine.latencyFrames();
+    const SINT totalFrames = (impulseFrames + 2000 + latencyFrames + kFramesPerBuffer) /
+            kFramesPerBuffer * kFramesPerBuffer;
+    std::vector<double> input(totalFrames);
+    input[0] = 0.5;
+    input[37] = -0.25;
+    input[1500] = 0.75;
+
+    mixxx::SampleBuffer inputBuffer(totalFrames * 2);
+    mixxx::SampleBuffer outputBuffer(totalFrames * 2);
+    for (SINT i = 0; i < totalFrames; ++i) {
+        inputBuffer[2 * i] = static_cast<CSAMPLE>(input[i]);
+        inputBuffer[2 * i + 1] = static_cast<CSAMPLE>(input[i]);
+    }
+    for (SINT frame = 0; frame < totalFrames; frame += kFramesPerBuffer) {
+        engine.process(pWorker.get(),
+                inputBuffer.data(2 * frame),
+                outputBuffer.data(2 * frame),
+                kFramesPerBuffer);
+        waitForTailBlock(engine);
+    }
+
+    for (SINT i = latencyFrames; i < totalFrames; ++i) {
+        const SINT n = i - latencyFrames;
+        double expectedLeft = 0;
+        double expectedRight = 0;
+        for (SINT m = math_max<SINT>(0, n - impulseFrames + 1); m <= n; ++m) {
+            expectedLeft += input[m] * leftImpulse[n - m];
+            expectedRight += input[m] * rightImpulse[n - m];
+        }
+        ASSERT_NEAR(expectedLeft, outputBuffer[2 * i], 1e-4) << "frame " << n;
+        ASSERT_NEAR(expectedRight, outputBuffer[2 * i + 1], 1e-4) << "frame " << n;
+    }
+}
+
+TEST_F(ConvolutionEngineTest, ClearDropsBufferedSignal) {
+    constexpr SINT kFramesPerBuffer = 512;
+    const auto partitioning =
+            mixxx::ConvolutionPartitioning::forFramesPerBuffer(kFramesPerBuffer);
+    const SINT impulseFrames = 3 * partitioning.headLengthFrames();
+    const std::vector<double> impulse = decayingImpulse(impulseFrames);
+    const auto pImpulse = std::make_shared<const mixxx::ConvolutionImpulse>(
+            partitioning,
+            std::make_unique<mixxx::ConvolutionKernel>(
+                    impulse.data(), impulseFrames, partitioning),
+            std::make_unique<mixxx::ConvolutionKernel>(
+                    impulse.data(), impulseFrames, partitioning));
+
+    mixxx::ConvolutionEngine engine(pImpulse);
+    const auto pWorker = mixxx::ConvolutionWorker::acquire();
+
+    mixxx::SampleBuffer buffer(kFramesPerBuffer * 2);
+    buffer.fill(0.5f);
+    for (int i = 0; i < 8; ++i) {
+        engine.process(pWorker.get(), buffer.data(), buffer.data(), kFramesPerBuffer);
+        buffer.fill(0.5f);
+        waitForTailBlock(engine);
+    }
+
+    engine.clear();
+    for (SINT frame = 0; frame < impulseFrames + kFramesPerBuffer; frame += kFramesPerBuffer) {
+        buffer.fill(0.0f);
+        engine.process(pWorker.get(), buffer.data(), buffer.data(), kFramesPerBuffer);
+        for (SINT i = 0; i < buffer.size(); ++i) {
+            ASSERT_EQ(0.0f, buffer[i]) << "frame " << frame + i / 2;
+        }
+        waitForTailBlock(engine);
+    }
+}
+
+} // namespace
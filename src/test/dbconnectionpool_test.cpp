@@ -1,8 +1,14 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
 #include "library/dao/settingsdao.h"
+#include "library/library_prefs.h"
 #include "test/mixxxdbtest.h"
 #include "util/db/dbconnectionpooler.h"
+#include "util/db/sqltransaction.h"
 
 class DbConnectionPoolTest : public MixxxTest {};
 
@@ -20,3 +26,141 @@ TEST_F(DbConnectionPoolTest, MoveSemantics) {
     EXPECT_TRUE(p1.isPooling());
     EXPECT_FALSE(p2.isPooling());
 }
+
+TEST_F(DbConnectionPoolTest, ConnectionProfile) {
+    const auto journalMode = [this]() {
+        const MixxxDb mixxxDb(config());
+        const mixxx::DbConnectionPooler pooler(mixxxDb.connectionPool());
+        const QSqlDatabase database =
+                mixxx::DbConnectionPooled(mixxxDb.connectionPool());
+        QSqlQuery query(database);
+        EXPECT_TRUE(query.exec(QStringLiteral("PRAGMA journal_mode")));
+        EXPECT_TRUE(query.next());
+        return query.value(0).toString().toLower();
+    };
+
+    EXPECT_QSTRING_EQ(QStringLiteral("wal"), journalMode());
+
+    // The journal mode is reverted when disabling the tuning
+    config()->setValue(
+            mixxx::library::prefs::kDatabaseTuningEnabledConfigKey, false);
+    EXPECT_QSTRING_EQ(QStringLiteral("delete"), journalMode());
+}
+
+namespace {
+
+// Measures the latency of database operations with (argument 1) and
+// without (argument 0) the tuned connection profile. The database is
+// stored in a file, because most settings don't apply to in-memory
+// databases.
+class DbConnectionProfileBenchmark {
+  public:
+    explicit DbConnectionProfileBenchmark(bool tuned)
+            : m_pConfig(new UserSettings(m_testDataDir.filePath("test.cfg"))) {
+        m_pConfig->setValue(
+                mixxx::library::prefs::kDatabaseTuningEnabledConfigKey, tuned);
+        m_pMixxxDb = std::make_unique<MixxxDb>(m_pConfig);
+        m_pPooler = std::make_unique<mixxx::DbConnectionPooler>(
+                m_pMixxxDb->connectionPool());
+        m_database = mixxx::DbConnectionPooled(m_pMixxxDb->connectionPool());
+        m_initialized = MixxxDb::initDatabaseSchema(m_database);
+        m_insertLocation = QSqlQuery(m_database);
+        m_insertLocation.prepare(QStringLiteral(
+                "INSERT INTO track_locations "
+                "(location,filename,directory,fs_deleted,needs_verification) "
+                "VALUES (:location,:filename,'/music',0,0)"));
+        m_insertTrack = QSqlQuery(m_database);
+        m_insertTrack.prepare(QStringLiteral(
+                "INSERT INTO library (artist,title,album,location) "
+                "VALUES (:artist,:title,'Album',:location)"));
+    }
+
+    bool isInitialized() const {
+        return m_initialized;
+    }
+
+    const QSqlDatabase& database() const {
+        return m_database;
+    }
+
+    bool addTrack(int i) {
+        const QString fileName = QStringLiteral("%1.mp3").arg(i);
+        m_insertLocation.bindValue(":location", QStringLiteral("/music/") + fileName);
+        m_insertLocation.bindValue(":filename", fileName);
+        if (!m_insertLocation.exec()) {
+            return false;
+        }
+        m_insertTrack.bindValue(":artist", QStringLiteral("Artist %1").arg(i % 1000));
+        m_insertTrack.bindValue(":title", QStringLiteral("Title %1").arg(i));
+        m_insertTrack.bindValue(":location", m_insertLocation.lastInsertId());
+        return m_insertTrack.exec();
+    }
+
+  private:
+    const QTemporaryDir m_testDataDir;
+    const UserSettingsPointer m_pConfig;
+    std::unique_ptr<MixxxDb> m_pMixxxDb;
+    std::unique_ptr<mixxx::DbConnectionPooler> m_pPooler;
+    QSqlDatabase m_database;
+    bool m_initialized;
+    QSqlQuery m_insertLocation;
+    QSqlQuery m_insertTrack;
+};
+
+void BM_DbConnectionProfileScan(benchmark::State& state) {
+    DbConnectionProfileBenchmark db(state.range(0) != 0);
+    if (!db.isInitialized()) {
+        state.SkipWithError("Failed to initialize the database");
+        return;
+    }
+    int i = 0;
+    for (auto _ : state) {
+        // Every track is saved in a separate transaction
+        SqlTransaction transaction(db.database());
+        if (!db.addTrack(i++) || !transaction.commit()) {
+            state.SkipWithError("Failed to add track");
+            return;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_DbConnectionProfileScan)->ArgName("tuned")->Arg(0)->Arg(1);
+
+void BM_DbConnectionProfileSearch(benchmark::State& state) {
+    DbConnectionProfileBenchmark db(state.range(0) != 0);
+    if (!db.isInitialized()) {
+        state.SkipWithError("Failed to initialize the database");
+        return;
+    }
+    constexpr int kTrackCount = 10000;
+    {
+        SqlTransaction transaction(db.database());
+        for (int i = 0; i < kTrackCount; ++i) {
+            if (!db.addTrack(i)) {
+                state.SkipWithError("Failed to add track");
+                return;
+            }
+        }
+        transaction.commit();
+    }
+    QSqlQuery query(db.database());
+    query.setForwardOnly(true);
+    for (auto _ : state) {
+        query.exec(QStringLiteral(
+                "SELECT library.id FROM library "
+                "INNER JOIN track_locations ON library.location=track_locations.id "
+                "WHERE artist LIKE '%12%' OR title LIKE '%12%' "
+                "ORDER BY artist"));
+        int rowCount = 0;
+        while (query.next()) {
+            ++rowCount;
+        }
+        benchmark::DoNotOptimize(rowCount);
+    }
+    state.SetItemsProcessed(state.iterations() * kTrackCount);
+}
+
+BENCHMARK(BM_DbConnectionProfileSearch)->ArgName("tuned")->Arg(0)->Arg(1);
+
+} // namespace
@@ -0,0 +1,115 @@
+#include "engine/effects/engineeffect.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "effects/backends/builtin/bitcrushereffect.h"
+#include "effects/backends/effectsbackendmanager.h"
+#include "engine/channelhandle.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "test/mixxxtest.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr SINT kFramesPerBuffer = 64;
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+
+const QString kGroup = QStringLiteral("[Channel1]");
+
+class EngineEffectTest : public MixxxTest {
+  protected:
+    EngineEffectTest()
+            : m_channel(m_channelHandleFactory.getOrCreateHandle(kGroup), kGroup) {
+    }
+
+    void SetUp() override {
+        m_pBackendManager = EffectsBackendManagerPointer(
+                new EffectsBackendManager(config()));
+        const QSet<ChannelHandleAndGroup> channels = {m_channel};
+
+        const EffectManifestPointer pManifest = m_pBackendManager->getManifest(
+                BitCrusherEffect::getId(), EffectBackendType::BuiltIn);
+        ASSERT_TRUE(pManifest);
+        ASSERT_FALSE(pManifest->parameters().isEmpty());
+        m_pEffect = std::make_unique<EngineEffect>(
+                pManifest, m_pBackendManager, channels, channels, channels);
+
+        m_pParameter = m_pEffect->getParameter(0);
+        ASSERT_TRUE(m_pParameter);
+        const auto& pManifestParameter = pManifest->parameters().first();
+        m_defaultValue = pManifestParameter->getDefault();
+        m_publishedValue = pManifestParameter->getMinimum();
+        ASSERT_NE(m_defaultValue, m_publishedValue);
+    }
+
+    void setEnabled(bool enabled) {
+        auto [requestPipe, responsePipe] =
+                makeTwoWayMessagePipe<EffectsRequest*, EffectsResponse>(1, 1);
+        EffectsRequest request;
+        request.type = EffectsRequest::SET_EFFECT_PARAMETERS;
+        request.pTargetEffect = m_pEffect.get();
+        request.SetEffectParameters.enabled = enabled;
+        ASSERT_TRUE(m_pEffect->processEffectsRequest(request, &responsePipe));
+    }
+
+    bool process() {
+        mixxx::SampleBuffer input(kFramesPerBuffer * mixxx::kEngineChannelOutputCount);
+        mixxx::SampleBuffer output(kFramesPerBuffer * mixxx::kEngineChannelOutputCount);
+        input.fill(0.5f);
+        return m_pEffect->process(m_channel.handle(),
+                m_channel.handle(),
+                input.data(),
+                output.data(),
+                input.size(),
+                kSampleRate,
+                EffectEnableState::Enabled,
+                GroupFeatureState());
+    }
+
+    ChannelHandleFactory m_channelHandleFactory;
+    ChannelHandleAndGroup m_channel;
+    EffectsBackendManagerPointer m_pBackendManager;
+    std::unique_ptr<EngineEffect> m_pEffect;
+    EngineEffectParameterPointer m_pParameter;
+    double m_defaultValue;
+    double m_publishedValue;
+};
+
+TEST_F(EngineEffectTest, PublishedValueIsAppliedOnNextProcess) {
+    setEnabled(true);
+    ASSERT_TRUE(process());
+    EXPECT_EQ(m_defaultValue, m_pParameter->value());
+
+    m_pParameter->publishValue(m_publishedValue);
+    // The engine side value doesn't change between two calls to process()
+    EXPECT_EQ(m_defaultValue, m_pParameter->value());
+
+    ASSERT_TRUE(process());
+    EXPECT_EQ(m_publishedValue, m_pParameter->value());
+}
+
+TEST_F(EngineEffectTest, PublishedValueIsNotAppliedWhileDisabled) {
+    m_pParameter->publishValue(m_publishedValue);
+    EXPECT_FALSE(process());
+    EXPECT_EQ(m_defaultValue, m_pParameter->value());
+
+    // Picked up as soon as the effect is enabled
+    setEnabled(true);
+    ASSERT_TRUE(process());
+    EXPECT_EQ(m_publishedValue, m_pParameter->value());
+
+    // The last call while disabling still picks up new values
+    m_pParameter->publishValue(m_defaultValue);
+    setEnabled(false);
+    ASSERT_TRUE(process());
+    EXPECT_EQ(m_defaultValue, m_pParameter->value());
+
+    m_pParameter->publishValue(m_publishedValue);
+    EXPECT_FALSE(process());
+    EXPECT_EQ(m_defaultValue, m_pParameter->value());
+}
+
+} // namespace
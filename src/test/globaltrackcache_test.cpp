@@ -1,5 +1,8 @@
 #include "track/globaltrackcache.h"
 
+#include <benchmark/benchmark.h>
+
+#include <QSemaphore>
 #include <QThread>
 #include <QtDebug>
 #include <atomic>
@@ -231,3 +234,185 @@ TEST_F(GlobalTrackCacheTest, evictWhileMoving) {
 
     EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
 }
+
+TEST_F(GlobalTrackCacheTest, retainRecentlyUsedTracks) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+    GlobalTrackCacheLocker().setRetainedTrackCapacity(1);
+
+    const auto resolveTrack = [this](const QString& testFile, TrackId trackId) {
+        auto resolver = GlobalTrackCacheResolver(
+                mixxx::FileAccess(mixxx::FileInfo(getTestDir().filePath(testFile))));
+        TrackPointer pTrack = resolver.getTrack();
+        resolver.initTrackIdAndUnlockCache(trackId);
+        return pTrack;
+    };
+
+    const TrackId trackId1(QVariant(1));
+    const TrackId trackId2(QVariant(2));
+
+    TrackPointer pTrack = resolveTrack(kTestFile, trackId1);
+    ASSERT_TRUE(static_cast<bool>(pTrack));
+    const Track* pPlainTrack1 = pTrack.get();
+
+    // Unmodified tracks are retained after releasing the last reference
+    pTrack.reset();
+    EXPECT_EQ(1u, GlobalTrackCacheLocker().getRetainedTrackCount());
+    pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId1);
+    EXPECT_EQ(pPlainTrack1, pTrack.get());
+    EXPECT_EQ(0u, GlobalTrackCacheLocker().getRetainedTrackCount());
+    pTrack.reset();
+    EXPECT_EQ(1u, GlobalTrackCacheLocker().getRetainedTrackCount());
+
+    // The least recently used track is evicted when exceeding the capacity
+    pTrack = resolveTrack(kTestFile2, trackId2);
+    ASSERT_TRUE(static_cast<bool>(pTrack));
+    pTrack.reset();
+    EXPECT_EQ(1u, GlobalTrackCacheLocker().getRetainedTrackCount());
+    pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId1);
+    EXPECT_FALSE(static_cast<bool>(pTrack));
+
+    // Modified tracks are saved and evicted
+    pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId2);
+    ASSERT_TRUE(static_cast<bool>(pTrack));
+    pTrack->setTitle(QStringLiteral("Title"));
+    ASSERT_TRUE(pTrack->isDirty());
+    pTrack.reset();
+    EXPECT_EQ(0u, GlobalTrackCacheLocker().getRetainedTrackCount());
+    EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    // Disabling the retention tier releases all retained tracks
+    pTrack = resolveTrack(kTestFile, trackId1);
+    pTrack.reset();
+    EXPECT_FALSE(GlobalTrackCacheLocker().isEmpty());
+    GlobalTrackCacheLocker().setRetainedTrackCapacity(0);
+    EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
+}
+
+TEST_F(GlobalTrackCacheTest, retainedTracksDropWaveforms) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+    GlobalTrackCacheLocker().setRetainedTrackCapacity(1);
+
+    const TrackId trackId(QVariant(1));
+    TrackPointer pTrack;
+    {
+        auto resolver = GlobalTrackCacheResolver(
+                mixxx::FileAccess(mixxx::FileInfo(getTestDir().filePath(kTestFile))));
+        pTrack = resolver.getTrack();
+        resolver.initTrackIdAndUnlockCache(trackId);
+    }
+    ASSERT_TRUE(static_cast<bool>(pTrack));
+
+    // Not analyzed yet, nothing needs to be saved
+    pTrack->setWaveform(ConstWaveformPointer(new Waveform()));
+    pTrack->setWaveformSummary(ConstWaveformPointer(new Waveform()));
+    pTrack.reset();
+    EXPECT_EQ(1u, GlobalTrackCacheLocker().getRetainedTrackCount());
+    pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId);
+    ASSERT_TRUE(static_cast<bool>(pTrack));
+    EXPECT_TRUE(pTrack->getWaveform().isNull());
+    EXPECT_TRUE(pTrack->getWaveformSummary().isNull());
+
+    // Tracks with unsaved waveforms are not retained
+    pTrack->setWaveform(ConstWaveformPointer(new Waveform(44100, 44100, 441, -1, 0)));
+    pTrack.reset();
+    EXPECT_EQ(0u, GlobalTrackCacheLocker().getRetainedTrackCount());
+    EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    GlobalTrackCacheLocker().setRetainedTrackCapacity(0);
+}
+
+TEST_F(GlobalTrackCacheTest, lookupWithoutLocking) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    const TrackId trackId(QVariant(1));
+    TrackPointer pTrack;
+    {
+        auto resolver = GlobalTrackCacheResolver(
+                mixxx::FileAccess(mixxx::FileInfo(getTestDir().filePath(kTestFile))));
+        pTrack = resolver.getTrack();
+        resolver.initTrackIdAndUnlockCache(trackId);
+    }
+    ASSERT_TRUE(static_cast<bool>(pTrack));
+    const auto trackRef = TrackRef::fromFileInfo(pTrack->getFileInfo());
+
+    // Tracks that are in use are found while the cache is locked
+    // by another thread
+    QSemaphore locked;
+    QSemaphore unlock;
+    std::unique_ptr<QThread> pLockingThread(QThread::create([&locked, &unlock] {
+        GlobalTrackCacheLocker cacheLocker;
+        locked.release();
+        unlock.acquire();
+    }));
+    pLockingThread->start();
+    locked.acquire();
+    EXPECT_EQ(pTrack, GlobalTrackCache::lookupTrackById(trackId));
+    EXPECT_EQ(pTrack, GlobalTrackCache::lookupTrackByRef(trackRef));
+    EXPECT_FALSE(static_cast<bool>(
+            GlobalTrackCache::lookupTrackById(TrackId(QVariant(2)))));
+    unlock.release();
+    pLockingThread->wait();
+
+    pTrack.reset();
+    EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
+    EXPECT_FALSE(static_cast<bool>(GlobalTrackCache::lookupTrackById(trackId)));
+    EXPECT_FALSE(static_cast<bool>(GlobalTrackCache::lookupTrackByRef(trackRef)));
+}
+
+namespace {
+
+class NoopTrackCacheSaver : public virtual GlobalTrackCacheSaver {
+  private:
+    void saveEvictedTrack(Track* /*pTrack*/) noexcept override {
+    }
+};
+
+NoopTrackCacheSaver s_benchmarkTrackCacheSaver;
+
+QList<TrackPointer> s_benchmarkTracks;
+
+// Measures the throughput of concurrent lookups of tracks that are in use
+// with (argument 1) and without (argument 0) the sharded index, i.e. while
+// locking the whole cache for each lookup.
+void BM_GlobalTrackCacheLookupContention(benchmark::State& state) {
+    constexpr int kTrackCount = 1000;
+    if (state.thread_index() == 0) {
+        GlobalTrackCache::createInstance(&s_benchmarkTrackCacheSaver, deleteTrack);
+        for (int i = 1; i <= kTrackCount; ++i) {
+            // The files don't exist and the tracks are only indexed by id
+            s_benchmarkTracks.append(
+                    GlobalTrackCacheResolver(
+                            mixxx::FileAccess(mixxx::FileInfo(
+                                    QStringLiteral("/nonexistent/%1.mp3").arg(i))),
+                            TrackId(QVariant(i)))
+                            .getTrack());
+        }
+    }
+    const bool sharded = state.range(0) != 0;
+    int i = state.thread_index() * 97;
+    for (auto _ : state) {
+        const TrackId trackId(QVariant(1 + i % kTrackCount));
+        TrackPointer pTrack;
+        if (sharded) {
+            pTrack = GlobalTrackCache::lookupTrackById(trackId);
+        } else {
+            pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId);
+        }
+        benchmark::DoNotOptimize(pTrack);
+        i += 7;
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        s_benchmarkTracks.clear();
+        GlobalTrackCache::destroyInstance();
+    }
+}
+
+BENCHMARK(BM_GlobalTrackCacheLookupContention)
+        ->ArgName("sharded")
+        ->Arg(0)
+        ->Arg(1)
+        ->ThreadRange(1, 8)
+        ->UseRealTime();
+
+} // anonymous namespace
@@ -0,0 +1,86 @@
+#include "library/scanner/librarywatcher.h"
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "test/mixxxtest.h"
+
+class LibraryWatcherTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_rootPath = QDir(m_tempDir.path()).absolutePath();
+        m_subdirPath = m_rootPath + QStringLiteral("/subdir");
+        ASSERT_TRUE(QDir().mkpath(m_subdirPath));
+        m_scannedDirectories.insert(m_rootPath, {m_subdirPath});
+        m_scannedDirectories.insert(m_subdirPath, {});
+    }
+
+    // A scan that started in the future has not missed any modifications
+    static QDateTime scanStartedAfterModifications() {
+        return QDateTime::currentDateTimeUtc().addSecs(60);
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_rootPath;
+    QString m_subdirPath;
+    QHash<QString, QStringList> m_scannedDirectories;
+};
+
+TEST_F(LibraryWatcherTest, IncompleteBeforeFirstScan) {
+    LibraryWatcher watcher;
+    EXPECT_FALSE(watcher.isComplete());
+    EXPECT_TRUE(watcher.takeUnmodifiedDirectories().isEmpty());
+}
+
+TEST_F(LibraryWatcherTest, UnmodifiedDirectories) {
+    LibraryWatcher watcher;
+    ASSERT_TRUE(watcher.watchDirectories(
+            m_scannedDirectories, scanStartedAfterModifications()));
+    EXPECT_TRUE(watcher.isComplete());
+    EXPECT_TRUE(watcher.modifiedDirectories().isEmpty());
+    EXPECT_EQ(m_scannedDirectories, watcher.takeUnmodifiedDirectories());
+
+    // Incomplete until the next scan has finished
+    EXPECT_FALSE(watcher.isComplete());
+    EXPECT_TRUE(watcher.takeUnmodifiedDirectories().isEmpty());
+}
+
+TEST_F(LibraryWatcherTest, ModifiedWhileScanning) {
+    LibraryWatcher watcher;
+    // The directories have been created after the scan started
+    ASSERT_TRUE(watcher.watchDirectories(
+            m_scannedDirectories,
+            QDateTime::currentDateTimeUtc().addSecs(-60)));
+    EXPECT_TRUE(watcher.isComplete());
+    EXPECT_EQ(2, watcher.modifiedDirectories().size());
+    EXPECT_TRUE(watcher.takeUnmodifiedDirectories().isEmpty());
+}
+
+TEST_F(LibraryWatcherTest, RecordModifications) {
+    LibraryWatcher watcher;
+    ASSERT_TRUE(watcher.watchDirectories(
+            m_scannedDirectories, scanStartedAfterModifications()));
+
+    QFile file(m_subdirPath + QStringLiteral("/track.mp3"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    QElapsedTimer timer;
+    timer.start();
+    while (watcher.modifiedDirectories().isEmpty() && timer.elapsed() < 5000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+    }
+    EXPECT_TRUE(watcher.modifiedDirectories().contains(m_subdirPath));
+    EXPECT_FALSE(watcher.modifiedDirectories().contains(m_rootPath));
+
+    const auto unmodifiedDirectories = watcher.takeUnmodifiedDirectories();
+    EXPECT_EQ(1, unmodifiedDirectories.size());
+    EXPECT_TRUE(unmodifiedDirectories.contains(m_rootPath));
+    EXPECT_TRUE(watcher.modifiedDirectories().isEmpty());
+}
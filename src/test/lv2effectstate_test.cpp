@@ -0,0 +1,185 @@
+#include "effects/backends/lv2/lv2effectstate.h"
+
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <vector>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr SINT kFramesPerBuffer = 64;
+
+/// Doubles the input instead of running an LV2 plugin. Runs can be held
+/// back to make the LV2EffectThread miss its deadline.
+class StubLV2EffectState final : public LV2EffectState {
+  public:
+    StubLV2EffectState(const mixxx::EngineParameters& engineParameters,
+            bool processInThread)
+            : LV2EffectState(engineParameters),
+              m_holdRuns(false),
+              m_active(false) {
+        initControlValues(std::vector<float>());
+        if (processInThread) {
+            startProcessThread();
+        }
+    }
+
+    ~StubLV2EffectState() override {
+        releaseRuns();
+        stopProcessThread();
+    }
+
+    void holdRuns() {
+        m_holdRuns.store(true);
+    }
+
+    void releaseRuns() {
+        m_holdRuns.store(false);
+        m_runsReleased.release(kFramesPerBuffer);
+    }
+
+    bool isActive() const {
+        return m_active.load();
+    }
+
+  protected:
+    void setPluginActive(bool active) override {
+        m_active.store(active);
+    }
+
+    void runPlugin(Buffers* pBuffers, SINT framesPerBuffer) override {
+        if (m_holdRuns.load()) {
+            m_runsReleased.acquire();
+        }
+        for (SINT i = 0; i < framesPerBuffer; ++i) {
+            pBuffers->outputL[i] = 2 * pBuffers->inputL[i];
+            pBuffers->outputR[i] = 2 * pBuffers->inputR[i];
+        }
+    }
+
+  private:
+    std::atomic<bool> m_holdRuns;
+    QSemaphore m_runsReleased;
+    std::atomic<bool> m_active;
+};
+
+class LV2EffectStateTest : public MixxxTest {
+  protected:
+    LV2EffectStateTest()
+            : m_engineParameters(mixxx::audio::SampleRate(44100), kFramesPerBuffer),
+              m_output(kFramesPerBuffer * mixxx::kEngineChannelOutputCount) {
+    }
+
+    /// Processes a buffer in which all samples have the given value
+    void process(StubLV2EffectState* pState,
+            CSAMPLE value,
+            EffectEnableState enableState = EffectEnableState::Enabled) {
+        const std::vector<CSAMPLE> input(
+                kFramesPerBuffer * mixxx::kEngineChannelOutputCount, value);
+        pState->process(QList<EngineEffectParameterPointer>(),
+                input.data(),
+                m_output.data(),
+                kFramesPerBuffer,
+                enableState);
+    }
+
+    void waitUntilProcessed(const StubLV2EffectState& state) {
+        QElapsedTimer timer;
+        timer.start();
+        while (state.hasQueuedBlocks() && timer.elapsed() < 10000) {
+            QThread::msleep(1);
+        }
+        ASSERT_FALSE(state.hasQueuedBlocks());
+    }
+
+    void expectOutput(CSAMPLE value) {
+        for (const auto sample : m_output) {
+            ASSERT_EQ(value, sample);
+        }
+    }
+
+    const mixxx::EngineParameters m_engineParameters;
+    std::vector<CSAMPLE> m_output;
+};
+
+TEST_F(LV2EffectStateTest, ProcessInCallback) {
+    StubLV2EffectState state(m_engineParameters, false);
+    EXPECT_EQ(0, state.getGroupDelayFrames(kFramesPerBuffer));
+
+    process(&state, 1, EffectEnableState::Enabling);
+    EXPECT_TRUE(state.isActive());
+    expectOutput(2);
+
+    process(&state, 3, EffectEnableState::Disabling);
+    EXPECT_FALSE(state.isActive());
+    expectOutput(6);
+}
+
+TEST_F(LV2EffectStateTest, ProcessInThreadDelaysOneBuffer) {
+    StubLV2EffectState state(m_engineParameters, true);
+    EXPECT_EQ(kFramesPerBuffer, state.getGroupDelayFrames(kFramesPerBuffer));
+
+    process(&state, 1, EffectEnableState::Enabling);
+    expectOutput(0);
+    waitUntilProcessed(state);
+    EXPECT_TRUE(state.isActive());
+
+    process(&state, 2);
+    expectOutput(2);
+    waitUntilProcessed(state);
+
+    process(&state, 3);
+    expectOutput(4);
+    waitUntilProcessed(state);
+
+    // The last output is returned while the plugin is deactivated
+    process(&state, 4, EffectEnableState::Disabling);
+    expectOutput(6);
+    waitUntilProcessed(state);
+    EXPECT_FALSE(state.isActive());
+
+    // The output from before the effect was disabled is not replayed
+    process(&state, 5, EffectEnableState::Enabling);
+    expectOutput(0);
+    waitUntilProcessed(state);
+    process(&state, 6);
+    expectOutput(10);
+}
+
+TEST_F(LV2EffectStateTest, ProcessInThreadMissesDeadline) {
+    StubLV2EffectState state(m_engineParameters, true);
+
+    process(&state, 1, EffectEnableState::Enabling);
+    waitUntilProcessed(state);
+    process(&state, 2);
+    expectOutput(2);
+    waitUntilProcessed(state);
+
+    state.holdRuns();
+    process(&state, 3);
+    expectOutput(4);
+    // The thread is still busy with the previous buffer, whose output is
+    // replaced with silence. This buffer is queued in the other block.
+    process(&state, 4);
+    expectOutput(0);
+    // Both blocks are in use, so this buffer is dropped
+    process(&state, 5);
+    expectOutput(0);
+
+    state.releaseRuns();
+    waitUntilProcessed(state);
+    // The output of the dropped buffer is silent as well
+    process(&state, 6);
+    expectOutput(0);
+    waitUntilProcessed(state);
+    // Back in phase with a latency of one buffer
+    process(&state, 7);
+    expectOutput(12);
+}
+
+} // namespace
@@ -303,6 +303,46 @@ TEST_F(SampleUtilTest, sumAbsPerChannel) {
     }
 }
 
+TEST_F(SampleUtilTest, meterPerChannel) {
+    for (int i = 0; i < evenBuffers.size(); ++i) {
+        int j = evenBuffers[i];
+        CSAMPLE* buffer = buffers[j];
+        int size = sizes[j];
+        FillBuffer(buffer, 0.5f, size);
+        SampleUtil::applyAlternatingGain(buffer, -1.0, 2.0, size);
+        CSAMPLE fAbsL = 0, fAbsR = 0;
+        CSAMPLE fSquaredL = 0, fSquaredR = 0;
+        CSAMPLE fPeakL = 0, fPeakR = 0;
+        SampleUtil::CLIP_STATUS clipped = SampleUtil::meterPerChannel(&fAbsL,
+                &fAbsR,
+                &fSquaredL,
+                &fSquaredR,
+                &fPeakL,
+                &fPeakR,
+                buffer,
+                size);
+        EXPECT_FLOAT_EQ(fAbsL, size / 2 * 0.5f);
+        EXPECT_FLOAT_EQ(fAbsR, size / 2 * 1.0f);
+        EXPECT_FLOAT_EQ(fSquaredL, size / 2 * 0.25f);
+        EXPECT_FLOAT_EQ(fSquaredR, size / 2 * 1.0f);
+        EXPECT_FLOAT_EQ(fPeakL, 0.5f);
+        EXPECT_FLOAT_EQ(fPeakR, 1.0f);
+        EXPECT_EQ(SampleUtil::NO_CLIPPING, clipped);
+
+        buffer[size - 1] = 1.5f;
+        clipped = SampleUtil::meterPerChannel(&fAbsL,
+                &fAbsR,
+                &fSquaredL,
+                &fSquaredR,
+                &fPeakL,
+                &fPeakR,
+                buffer,
+                size);
+        EXPECT_FLOAT_EQ(fPeakR, 1.5f);
+        EXPECT_EQ(SampleUtil::CLIP_STATUS(SampleUtil::CLIPPING_RIGHT), clipped);
+    }
+}
+
 TEST_F(SampleUtilTest, interleaveBuffer) {
     for (int i = 0; i < buffers.size(); ++i) {
         CSAMPLE* buffer = buffers[i];
@@ -1,14 +1,17 @@
 #include <gtest/gtest.h>
 
 #include <QDir>
+#include <QSqlQuery>
 #include <QtDebug>
 
+#include "library/dao/trackschema.h"
 #include "library/searchquery.h"
 #include "library/searchqueryparser.h"
 #include "library/trackset/crate/crate.h"
 #include "test/librarytest.h"
 #include "track/track.h"
 #include "util/assert.h"
+#include "util/db/sqltransaction.h"
 
 TrackPointer newTestTrack() {
     TrackPointer pTrack(Track::newTemporary());
@@ -922,6 +925,64 @@ TEST_F(SearchQueryParserTest, ShortCrateFilter) {
     EXPECT_TRUE(pQuery->match(pTrackC));
 }
 
+TEST_F(SearchQueryParserTest, FullTextIndex) {
+    TrackDAO& trackDao = internalCollection()->getTrackDAO();
+    if (!trackDao.hasFullTextIndex()) {
+        GTEST_SKIP() << "Full-text search is not supported by SQLite";
+    }
+    m_parser.setSearchColumns({"artist", "title"});
+    m_parser.setUseFullTextIndex(true);
+
+    const TrackId trackAId = addTrackToCollection(getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-jpg.mp3")));
+    const TrackId trackBId = addTrackToCollection(getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-png.mp3")));
+    ASSERT_TRUE(trackAId.isValid());
+    ASSERT_TRUE(trackBId.isValid());
+
+    // Modifying the library bypasses the index until it is updated
+    QSqlQuery query(dbConnection());
+    ASSERT_TRUE(query.exec(QString::fromUtf8(
+            "UPDATE library SET artist='\xC3\x8Bverything Now', title='foo' WHERE id=%1")
+                                   .arg(trackAId.toString())));
+    ASSERT_TRUE(query.exec(QStringLiteral(
+            "UPDATE library SET artist=NULL, title='Never' WHERE id=%1")
+                                   .arg(trackBId.toString())));
+
+    const auto search = [this](const QString& searchQuery) {
+        const auto pQuery = m_parser.parseQuery(searchQuery, QString());
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec(QStringLiteral(
+                "SELECT id FROM library WHERE %1 ORDER BY id")
+                                       .arg(pQuery->toSql())));
+        QList<TrackId> trackIds;
+        while (query.next()) {
+            trackIds.append(TrackId(query.value(0)));
+        }
+        return trackIds;
+    };
+    const auto checkSearch = [&]() {
+        // Diacritics and case are folded like for LIKE
+        EXPECT_EQ(QList<TrackId>{trackAId}, search("EVERYTHING"));
+        EXPECT_EQ(QList<TrackId>({trackAId, trackBId}), search("ver"));
+        // NULL values make the negation NULL like for LIKE
+        EXPECT_EQ(QList<TrackId>(), search("-foo"));
+        EXPECT_EQ(QList<TrackId>{trackAId}, search("-never"));
+    };
+
+    checkSearch();
+    {
+        SqlTransaction transaction(dbConnection());
+        ASSERT_TRUE(trackDao.updateFullTextIndex());
+        transaction.commit();
+    }
+    checkSearch();
+
+    EXPECT_TRUE(m_parser.parseQuery("ver", QString())->toSql().contains(LIBRARYFTS_TABLE));
+    // Too short for the trigram tokenizer
+    EXPECT_FALSE(m_parser.parseQuery("ve", QString())->toSql().contains(LIBRARYFTS_TABLE));
+}
+
 TEST_F(SearchQueryParserTest, CrateFilterEmpty) {
     // Empty should match everything
     auto pQuery(m_parser.parseQuery(QString("crate: "), QString()));
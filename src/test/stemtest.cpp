@@ -152,4 +152,42 @@ TEST_F(StemTest, OpenStem) {
             sourceStem.getSignalInfo());
 }
 
+// Decoding the stems concurrently must not change the decoded samples
+TEST_F(StemTest, ReadStemConcurrently) {
+    SoundSourceSTEM sourceSerial(QUrl::fromLocalFile(getTestDir().filePath("stems/test.stem.mp4")));
+    SoundSourceSTEM sourceConcurrent(
+            QUrl::fromLocalFile(getTestDir().filePath("stems/test.stem.mp4")));
+
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(mixxx::audio::ChannelCount(8));
+    ASSERT_EQ(sourceSerial.open(AudioSource::OpenMode::Strict, config),
+            AudioSource::OpenResult::Succeeded);
+    config.setConcurrentStreamDecoding(true);
+    ASSERT_EQ(sourceConcurrent.open(AudioSource::OpenMode::Strict, config),
+            AudioSource::OpenResult::Succeeded);
+
+    // Read multiple chunks of different size, including a seek back
+    const QList<IndexRange> frameIndexRanges = {
+            IndexRange::between(0, 512),
+            IndexRange::between(512, 4608),
+            IndexRange::between(1024, 1536),
+    };
+    for (const auto& frameIndexRange : frameIndexRanges) {
+        SampleBuffer buffer1(frameIndexRange.length() * 8);
+        SampleBuffer buffer2(frameIndexRange.length() * 8);
+        ASSERT_EQ(sourceSerial.readSampleFrames(WritableSampleFrames(frameIndexRange,
+                                                        SampleBuffer::WritableSlice(buffer1)))
+                          .readableLength(),
+                buffer1.size());
+        ASSERT_EQ(sourceConcurrent.readSampleFrames(WritableSampleFrames(frameIndexRange,
+                                                            SampleBuffer::WritableSlice(buffer2)))
+                          .readableLength(),
+                buffer2.size());
+        EXPECT_EQ(0,
+                std::memcmp(buffer1.data(),
+                        buffer2.data(),
+                        buffer1.size() * sizeof(CSAMPLE)));
+    }
+}
+
 } // namespace
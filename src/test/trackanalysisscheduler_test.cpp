@@ -0,0 +1,152 @@
+#include "analyzer/trackanalysisscheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <algorithm>
+
+#include "test/librarytest.h"
+#include "track/track.h"
+
+namespace {
+
+class TrackAnalysisSchedulerEnvironmentImpl final : public TrackAnalysisSchedulerEnvironment {
+  public:
+    explicit TrackAnalysisSchedulerEnvironmentImpl(
+            const TrackCollectionManager* pTrackCollectionManager)
+            : m_pTrackCollectionManager(pTrackCollectionManager) {
+    }
+
+    TrackPointer loadTrackById(TrackId trackId) const final {
+        return m_pTrackCollectionManager->getTrackById(trackId);
+    }
+
+  private:
+    const TrackCollectionManager* const m_pTrackCollectionManager;
+};
+
+} // anonymous namespace
+
+class TrackAnalysisSchedulerTest : public LibraryTest {
+  protected:
+    TrackAnalysisScheduler::Pointer createScheduler(
+            int numWorkerThreads,
+            AnalyzerModeFlags modeFlags = AnalyzerModeFlags::None) {
+        auto pScheduler = TrackAnalysisScheduler::createInstance(
+                std::make_unique<TrackAnalysisSchedulerEnvironmentImpl>(
+                        trackCollectionManager()),
+                numWorkerThreads,
+                dbConnectionPooler(),
+                config(),
+                modeFlags);
+        QObject::connect(pScheduler.get(),
+                &TrackAnalysisScheduler::trackProgress,
+                [this](TrackId trackId, AnalyzerProgress analyzerProgress) {
+                    // Failures are reported as kAnalyzerProgressUnknown
+                    if (analyzerProgress == kAnalyzerProgressDone ||
+                            analyzerProgress == kAnalyzerProgressUnknown) {
+                        m_finishedTrackIds.append(trackId);
+                    }
+                });
+        QObject::connect(pScheduler.get(),
+                &TrackAnalysisScheduler::finished,
+                [this]() {
+                    m_finished = true;
+                });
+        return pScheduler;
+    }
+
+    TrackId addTrack(const QString& fileName) const {
+        const auto pTrack = getOrAddTrackByLocation(
+                getTestDir().filePath(QStringLiteral("id3-test-data/") + fileName));
+        return pTrack ? pTrack->getId() : TrackId();
+    }
+
+    bool waitUntilFinished() {
+        QElapsedTimer timer;
+        timer.start();
+        while (!m_finished && timer.elapsed() < 10000) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+        }
+        return m_finished;
+    }
+
+    QList<TrackId> m_finishedTrackIds;
+    bool m_finished = false;
+};
+
+TEST_F(TrackAnalysisSchedulerTest, HighPriorityOvertakesQueuedTracks) {
+    const TrackId normalTrackId1 = addTrack(QStringLiteral("cover-test.flac"));
+    const TrackId normalTrackId2 = addTrack(QStringLiteral("cover-test.ogg"));
+    const TrackId normalTrackId3 = addTrack(QStringLiteral("cover-test.wav"));
+    const TrackId deckTrackId = addTrack(QStringLiteral("cover-test-png.mp3"));
+    ASSERT_TRUE(normalTrackId1.isValid());
+    ASSERT_TRUE(normalTrackId2.isValid());
+    ASSERT_TRUE(normalTrackId3.isValid());
+    ASSERT_TRUE(deckTrackId.isValid());
+
+    // A single worker for the batch of queued tracks
+    auto pScheduler = createScheduler(1);
+    ASSERT_TRUE(pScheduler->scheduleTrack(normalTrackId1));
+    ASSERT_TRUE(pScheduler->scheduleTrack(normalTrackId2));
+    ASSERT_TRUE(pScheduler->scheduleTrack(normalTrackId3));
+    // Loaded into a deck after the batch has been queued
+    ASSERT_TRUE(pScheduler->scheduleTrack(
+            deckTrackId, TrackAnalysisScheduler::Priority::High));
+    pScheduler->resume();
+
+    ASSERT_TRUE(waitUntilFinished());
+    ASSERT_EQ(4, m_finishedTrackIds.size());
+    EXPECT_EQ(deckTrackId, m_finishedTrackIds.first());
+    // The batch keeps its order
+    EXPECT_EQ(normalTrackId1, m_finishedTrackIds.at(1));
+    EXPECT_EQ(normalTrackId2, m_finishedTrackIds.at(2));
+    EXPECT_EQ(normalTrackId3, m_finishedTrackIds.at(3));
+}
+
+TEST_F(TrackAnalysisSchedulerTest, LowerMaxActiveWorkersWhileBusy) {
+    const QList<TrackId> trackIds = {
+            addTrack(QStringLiteral("cover-test.flac")),
+            addTrack(QStringLiteral("cover-test.ogg")),
+            addTrack(QStringLiteral("cover-test.wav")),
+            addTrack(QStringLiteral("cover-test-png.mp3")),
+    };
+    auto pScheduler = createScheduler(2);
+    for (const auto& trackId : trackIds) {
+        ASSERT_TRUE(trackId.isValid());
+        ASSERT_TRUE(pScheduler->scheduleTrack(trackId));
+    }
+    pScheduler->resume();
+
+    // Wait until both workers are busy
+    QElapsedTimer timer;
+    timer.start();
+    while (pScheduler->busyWorkersCount() < 2 && !m_finished &&
+            timer.elapsed() < 10000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+    }
+    ASSERT_EQ(2, pScheduler->busyWorkersCount());
+
+    const auto preemptedWorkersCount = [&pScheduler]() {
+        return std::count_if(pScheduler->m_workers.begin(),
+                pScheduler->m_workers.end(),
+                [](const TrackAnalysisScheduler::Worker& worker) {
+                    return worker.isPreempted();
+                });
+    };
+
+    // The running worker beyond the limit is suspended
+    pScheduler->setMaxActiveWorkers(1);
+    EXPECT_EQ(1, preemptedWorkersCount());
+
+    // ...and resumed when raising the limit again
+    pScheduler->setMaxActiveWorkers(2);
+    EXPECT_EQ(0, preemptedWorkersCount());
+
+    pScheduler->setMaxActiveWorkers(1);
+    EXPECT_EQ(1, preemptedWorkersCount());
+    ASSERT_TRUE(waitUntilFinished());
+    EXPECT_EQ(0, preemptedWorkersCount());
+    EXPECT_EQ(trackIds.size(), m_finishedTrackIds.size());
+}
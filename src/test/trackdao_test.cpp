@@ -1,8 +1,13 @@
+#include <benchmark/benchmark.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
+#include "sources/soundsourceproxy.h"
 #include "test/librarytest.h"
 #include "track/track.h"
+#include "util/db/sqltransaction.h"
 
 using ::testing::UnorderedElementsAre;
 
@@ -56,3 +61,137 @@ TEST_F(TrackDAOTest, detectMovedTracks) {
     QSet<QString> trackLocations = trackDAO.getAllTrackLocations();
     EXPECT_THAT(trackLocations, UnorderedElementsAre(newFile.location(), otherFile.location()));
 }
+
+TEST_F(TrackDAOTest, addTracksAddFileImported) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+    const QString location = getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-jpg.mp3"));
+
+    // Parsed in advance like by the library scanner tasks
+    const auto imported = SoundSourceProxy::importNewTrackMetadataAndCoverImageFromFile(
+            mixxx::FileAccess(mixxx::FileInfo(location)), false);
+    ASSERT_EQ(mixxx::MetadataSource::ImportResult::Succeeded, imported.importResult);
+    ASSERT_FALSE(imported.coverImage.isNull());
+
+    trackDAO.addTracksPrepare();
+    const TrackPointer pTrack = trackDAO.addTracksAddFile(location, false, &imported);
+    trackDAO.addTracksFinish();
+    ASSERT_NE(nullptr, pTrack);
+    EXPECT_TRUE(pTrack->getId().isValid());
+    EXPECT_TRUE(pTrack->checkSourceSynchronized());
+    EXPECT_EQ(QStringLiteral("test22kMono"), pTrack->getTitle());
+    EXPECT_EQ(CoverInfo::METADATA, pTrack->getCoverInfo().type);
+}
+
+TEST_F(TrackDAOTest, getTracksByIds) {
+    QList<TrackId> trackIds;
+    for (int i = 0; i < 3; ++i) {
+        mixxx::FileInfo fileInfo(QDir(QDir::tempPath()),
+                QStringLiteral("track%1.mp3").arg(i));
+        TrackPointer pTrack = Track::newTemporary(mixxx::FileAccess(fileInfo));
+        pTrack->setTitle(QStringLiteral("Title %1").arg(i));
+        trackIds.append(internalCollection()->addTrack(pTrack, false));
+        ASSERT_TRUE(trackIds.last().isValid());
+    }
+
+    // Keep the second track in the cache
+    const TrackPointer pCachedTrack =
+            trackCollectionManager()->getTrackById(trackIds[1]);
+    ASSERT_NE(nullptr, pCachedTrack);
+
+    // Missing tracks are skipped and the order is preserved
+    QList<TrackId> requestedTrackIds = trackIds;
+    requestedTrackIds.insert(1, TrackId(QVariant(12345)));
+    std::reverse(requestedTrackIds.begin(), requestedTrackIds.end());
+    const QList<TrackPointer> tracks =
+            trackCollectionManager()->getTracksByIds(requestedTrackIds);
+    ASSERT_EQ(3, tracks.size());
+    EXPECT_EQ(trackIds[2], tracks[0]->getId());
+    EXPECT_EQ(QStringLiteral("Title 2"), tracks[0]->getTitle());
+    EXPECT_EQ(pCachedTrack, tracks[1]);
+    EXPECT_EQ(trackIds[0], tracks[2]->getId());
+    EXPECT_EQ(QStringLiteral("Title 0"), tracks[2]->getTitle());
+
+    EXPECT_TRUE(trackCollectionManager()->getTracksByIds({}).isEmpty());
+}
+
+namespace {
+
+class TrackDAOBenchmark : public LibraryTest {
+  public:
+    bool addTracks(int trackCount) {
+        SqlTransaction transaction(dbConnection());
+        QSqlQuery insertLocation(dbConnection());
+        insertLocation.prepare(QStringLiteral(
+                "INSERT INTO track_locations "
+                "(location,filename,directory,fs_deleted,needs_verification) "
+                "VALUES (:location,:filename,'/music',0,0)"));
+        QSqlQuery insertTrack(dbConnection());
+        insertTrack.prepare(QStringLiteral(
+                "INSERT INTO library (artist,title,location) "
+                "VALUES (:artist,:title,:location)"));
+        for (int i = 0; i < trackCount; ++i) {
+            const QString fileName = QStringLiteral("%1.mp3").arg(i);
+            insertLocation.bindValue(":location", QStringLiteral("/music/") + fileName);
+            insertLocation.bindValue(":filename", fileName);
+            if (!insertLocation.exec()) {
+                return false;
+            }
+            insertTrack.bindValue(":artist", QStringLiteral("Artist %1").arg(i % 1000));
+            insertTrack.bindValue(":title", QStringLiteral("Title %1").arg(i));
+            insertTrack.bindValue(":location", insertLocation.lastInsertId());
+            if (!insertTrack.exec()) {
+                return false;
+            }
+            m_trackIds.append(TrackId(insertTrack.lastInsertId()));
+        }
+        return transaction.commit();
+    }
+
+    const QList<TrackId>& trackIds() const {
+        return m_trackIds;
+    }
+
+    TrackCollectionManager* manager() const {
+        return trackCollectionManager();
+    }
+
+  private:
+    void TestBody() override {
+    }
+
+    QList<TrackId> m_trackIds;
+};
+
+// Compares loading the tracks one by one (argument 0) with
+// loading them at once (argument 1)
+void BM_TrackDAOLoadTracks(benchmark::State& state) {
+    constexpr int kTrackCount = 10000;
+    TrackDAOBenchmark library;
+    if (!library.addTracks(kTrackCount)) {
+        state.SkipWithError("Failed to add tracks");
+        return;
+    }
+    const bool batch = state.range(0) != 0;
+    for (auto _ : state) {
+        QList<TrackPointer> tracks;
+        if (batch) {
+            tracks = library.manager()->getTracksByIds(library.trackIds());
+        } else {
+            tracks.reserve(library.trackIds().size());
+            for (const auto& trackId : library.trackIds()) {
+                tracks.append(library.manager()->getTrackById(trackId));
+            }
+        }
+        benchmark::DoNotOptimize(tracks.size());
+    }
+    state.SetItemsProcessed(state.iterations() * kTrackCount);
+}
+
+BENCHMARK(BM_TrackDAOLoadTracks)
+        ->ArgName("batch")
+        ->Arg(0)
+        ->Arg(1)
+        ->Unit(benchmark::kMillisecond);
+
+} // namespace
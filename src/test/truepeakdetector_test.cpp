@@ -0,0 +1,74 @@
+#include "util/truepeakdetector.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "util/math.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+class TruePeakDetectorTest : public testing::Test {
+  protected:
+    /// Fills the buffer with a sine of the given frequency in cycles per
+    /// frame on both channels
+    static void fillSine(mixxx::SampleBuffer* pBuffer,
+            double cyclesPerFrame,
+            double phase,
+            CSAMPLE amplitude) {
+        for (SINT i = 0; i < pBuffer->size() / 2; ++i) {
+            const auto value = static_cast<CSAMPLE>(
+                    amplitude * std::sin(2 * M_PI * cyclesPerFrame * i + phase));
+            (*pBuffer)[2 * i] = value;
+            (*pBuffer)[2 * i + 1] = value;
+        }
+    }
+};
+
+TEST_F(TruePeakDetectorTest, Silence) {
+    TruePeakDetector detector;
+    mixxx::SampleBuffer buffer(1024);
+    buffer.fill(CSAMPLE_ZERO);
+
+    CSAMPLE peakL = 1;
+    CSAMPLE peakR = 1;
+    detector.process(&peakL, &peakR, buffer.data(), buffer.size());
+    EXPECT_EQ(CSAMPLE_ZERO, peakL);
+    EXPECT_EQ(CSAMPLE_ZERO, peakR);
+}
+
+TEST_F(TruePeakDetectorTest, PeakBetweenSamples) {
+    // A sine at a quarter of the sample rate, sampled at 45 degrees, never
+    // hits its peak. The samples are all at amplitude / sqrt(2).
+    TruePeakDetector detector;
+    mixxx::SampleBuffer buffer(2 * 1000);
+    fillSine(&buffer, 0.25, M_PI / 4, 0.9f);
+
+    CSAMPLE peakL;
+    CSAMPLE peakR;
+    // The first buffer warms up the filter history
+    detector.process(&peakL, &peakR, buffer.data(), buffer.size());
+    detector.process(&peakL, &peakR, buffer.data(), buffer.size());
+
+    const CSAMPLE samplePeak = SampleUtil::maxAbsAmplitude(buffer.data(), buffer.size());
+    EXPECT_NEAR(0.9f / std::sqrt(2.0f), samplePeak, 1e-4);
+    EXPECT_GT(peakL, samplePeak);
+    EXPECT_NEAR(0.9f, peakL, 0.05);
+    EXPECT_EQ(peakL, peakR);
+}
+
+TEST_F(TruePeakDetectorTest, LowFrequencyMatchesSamplePeak) {
+    TruePeakDetector detector;
+    mixxx::SampleBuffer buffer(2 * 4410);
+    fillSine(&buffer, 100.0 / 44100, 0, 0.5f);
+
+    CSAMPLE peakL;
+    CSAMPLE peakR;
+    detector.process(&peakL, &peakR, buffer.data(), buffer.size());
+    EXPECT_NEAR(0.5f, peakL, 0.01);
+    EXPECT_NEAR(0.5f, peakR, 0.01);
+}
+
+} // namespace
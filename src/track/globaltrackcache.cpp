@@ -1,6 +1,7 @@
 #include "track/globaltrackcache.h"
 
 #include <QCoreApplication>
+#include <QSignalBlocker>
 
 #include "moc_globaltrackcache.cpp"
 #include "track/track.h"
@@ -63,6 +64,16 @@ class EvictAndSaveFunctor {
     GlobalTrackCacheEntryPointer m_cacheEntryPtr;
 };
 
+inline GlobalTrackCacheEntry* cacheEntryOf(const TrackPointer& savingPtr) {
+    EvictAndSaveFunctor* pDel = std::get_deleter<EvictAndSaveFunctor>(savingPtr);
+    DEBUG_ASSERT(pDel);
+    return pDel->getCacheEntryPointer().get();
+}
+
+bool isWaveformDisposable(const ConstWaveformPointer& pWaveform) {
+    return !pWaveform || pWaveform->saveState() != Waveform::SaveState::SavePending;
+}
+
 } // anonymous namespace
 
 GlobalTrackCacheLocker::GlobalTrackCacheLocker()
@@ -105,6 +116,9 @@ void GlobalTrackCacheLocker::unlockCache() {
                     << "/ #tracksByCanonicalLocation ="
                     << m_pInstance->m_tracksByCanonicalLocation.size();
         }
+        // Released after unlocking the cache, see m_releasedTracks
+        std::vector<TrackPointer> releasedTracks;
+        releasedTracks.swap(m_pInstance->m_releasedTracks);
         m_pInstance->m_mutex.unlock();
         if (traceLogEnabled()) {
             kLogger.trace() << "Cache is unlocked";
@@ -129,6 +143,17 @@ void GlobalTrackCacheLocker::deactivateCache() const {
     m_pInstance->deactivate();
 }
 
+void GlobalTrackCacheLocker::setRetainedTrackCapacity(std::size_t capacity) const {
+    DEBUG_ASSERT(m_pInstance);
+    m_pInstance->m_retainedTrackCapacity = capacity;
+    m_pInstance->trimRetainedTracks(capacity);
+}
+
+std::size_t GlobalTrackCacheLocker::getRetainedTrackCount() const {
+    DEBUG_ASSERT(m_pInstance);
+    return m_pInstance->m_retainedTracks.size();
+}
+
 bool GlobalTrackCacheLocker::isEmpty() const {
     DEBUG_ASSERT(m_pInstance);
     return m_pInstance->isEmpty();
@@ -299,12 +324,61 @@ void GlobalTrackCache::evictAndSaveCachedTrack(GlobalTrackCacheEntryPointer cach
     }
 }
 
+//static
+TrackPointer GlobalTrackCache::lookupTrackById(
+        const TrackId& trackId) {
+    DEBUG_ASSERT(s_pInstance);
+    const auto entryPtr = s_pInstance->m_tracksById.findShared(trackId);
+    if (!entryPtr) {
+        // Cache miss
+        return {};
+    }
+    TrackPointer trackPtr = s_pInstance->reviveShared(*entryPtr);
+    if (trackPtr) {
+        return trackPtr;
+    }
+    return GlobalTrackCacheLocker().lookupTrackById(trackId);
+}
+
+//static
+TrackPointer GlobalTrackCache::lookupTrackByRef(
+        const TrackRef& trackRef) {
+    DEBUG_ASSERT(s_pInstance);
+    if (trackRef.hasId()) {
+        const auto entryPtr = s_pInstance->m_tracksById.findShared(trackRef.getId());
+        if (entryPtr) {
+            TrackPointer trackPtr = s_pInstance->reviveShared(*entryPtr);
+            if (trackPtr) {
+                return trackPtr;
+            }
+            return GlobalTrackCacheLocker().lookupTrackByRef(trackRef);
+        }
+    }
+    if (trackRef.hasCanonicalLocation()) {
+        const auto entryPtr = s_pInstance->m_tracksByCanonicalLocation.findShared(
+                trackRef.getCanonicalLocation());
+        if (entryPtr) {
+            TrackPointer trackPtr = s_pInstance->reviveShared(*entryPtr);
+            if (trackPtr &&
+                    trackRef.getLocation() == createTrackRef(*trackPtr).getLocation()) {
+                return trackPtr;
+            }
+            return GlobalTrackCacheLocker().lookupTrackByRef(trackRef);
+        }
+    }
+    // Cache miss
+    return {};
+}
+
 GlobalTrackCache::GlobalTrackCache(
         GlobalTrackCacheSaver* pSaver,
         deleteTrackFn_t deleteTrackFn)
         : m_pSaver(pSaver),
           m_deleteTrackFn(deleteTrackFn),
-          m_tracksById(kUnorderedCollectionMinCapacity, DbId::hash_fun) {
+          m_incompleteTrackPlainPtr(nullptr),
+          m_tracksById(kUnorderedCollectionMinCapacity),
+          m_tracksByCanonicalLocation(kUnorderedCollectionMinCapacity),
+          m_retainedTrackCapacity(0) {
     DEBUG_ASSERT(m_pSaver);
     qRegisterMetaType<GlobalTrackCacheEntryPointer>("GlobalTrackCacheEntryPointer");
 }
@@ -319,13 +393,17 @@ void GlobalTrackCache::relocateTracks(
         kLogger.debug()
                 << "Relocating tracks";
     }
-    TracksByCanonicalLocation relocatedTracksByCanonicalLocation;
-    for (auto&&
-            i = m_tracksByCanonicalLocation.begin();
-            i != m_tracksByCanonicalLocation.end();
-            ++i) {
-        const QString oldCanonicalLocation = i->first;
-        Track* plainPtr = i->second->getPlainPtr();
+    // The index is modified after all entries have been visited
+    std::vector<std::pair<QString, GlobalTrackCacheEntryPointer>> cachedTracks;
+    cachedTracks.reserve(m_tracksByCanonicalLocation.size());
+    m_tracksByCanonicalLocation.forEach(
+            [&cachedTracks](const QString& canonicalLocation,
+                    const GlobalTrackCacheEntryPointer& entryPtr) {
+                cachedTracks.emplace_back(canonicalLocation, entryPtr);
+            });
+    std::vector<std::pair<QString, GlobalTrackCacheEntryPointer>> relocatedTracks;
+    for (const auto& [oldCanonicalLocation, entryPtr] : cachedTracks) {
+        Track* plainPtr = entryPtr->getPlainPtr();
         const mixxx::FileInfo fileInfo = plainPtr->getFileInfo();
         TrackRef trackRef = TrackRef::fromFileInfo(fileInfo, plainPtr->getId());
         if (!trackRef.hasCanonicalLocation() && trackRef.hasId() && pRelocator) {
@@ -343,12 +421,12 @@ void GlobalTrackCache::relocateTracks(
                     << "Failed to relocate track"
                     << oldCanonicalLocation
                     << trackRef;
+            m_tracksByCanonicalLocation.erase(oldCanonicalLocation);
             continue;
         }
         QString newCanonicalLocation = trackRef.getCanonicalLocation();
         if (oldCanonicalLocation == newCanonicalLocation) {
-            // Copy the entry unmodified into the new map
-            relocatedTracksByCanonicalLocation.insert(*i);
+            // Keep the entry unmodified
             continue;
         }
         if (debugLogEnabled()) {
@@ -357,11 +435,14 @@ void GlobalTrackCache::relocateTracks(
                     << "from" << oldCanonicalLocation
                     << "to" << newCanonicalLocation;
         }
-        relocatedTracksByCanonicalLocation.insert(std::make_pair(
-                std::move(newCanonicalLocation),
-                i->second));
+        m_tracksByCanonicalLocation.erase(oldCanonicalLocation);
+        relocatedTracks.emplace_back(std::move(newCanonicalLocation), entryPtr);
+    }
+    // Relocated tracks might take over the canonical location of
+    // another relocated track and are only inserted afterwards
+    for (auto& [newCanonicalLocation, entryPtr] : relocatedTracks) {
+        m_tracksByCanonicalLocation.insert(newCanonicalLocation, std::move(entryPtr));
     }
-    m_tracksByCanonicalLocation = std::move(relocatedTracksByCanonicalLocation);
 }
 
 void GlobalTrackCache::saveEvictedTrack(Track* pEvictedTrack) const {
@@ -380,6 +461,11 @@ void GlobalTrackCache::saveEvictedTrack(Track* pEvictedTrack) const {
 void GlobalTrackCache::deactivate() {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
 
+    // The retained tracks are evicted together with all other
+    // tracks and deleted after their references have been released.
+    m_retainedTrackCapacity = 0;
+    trimRetainedTracks(0);
+
     if (isEmpty()) {
         return;
     }
@@ -397,19 +483,30 @@ void GlobalTrackCache::deactivate() {
             << m_tracksByCanonicalLocation.size()
             << "tracks from cache";
 
-    while (!m_tracksById.empty()) {
-        auto i = m_tracksById.begin();
-        Track* plainPtr= i->second->getPlainPtr();
-        saveEvictedTrack(plainPtr);
+    std::vector<std::pair<TrackId, GlobalTrackCacheEntryPointer>> tracksById;
+    m_tracksById.forEach(
+            [&tracksById](const TrackId& trackId,
+                    const GlobalTrackCacheEntryPointer& entryPtr) {
+                tracksById.emplace_back(trackId, entryPtr);
+            });
+    for (const auto& [trackId, entryPtr] : tracksById) {
+        Track* plainPtr = entryPtr->getPlainPtr();
+        // Make the track invisible for lookups without locking
+        // the cache before saving it
         m_tracksByCanonicalLocation.erase(plainPtr->getFileInfo().canonicalLocation());
-        m_tracksById.erase(i);
+        m_tracksById.erase(trackId);
+        saveEvictedTrack(plainPtr);
     }
 
-    while (!m_tracksByCanonicalLocation.empty()) {
-        auto i = m_tracksByCanonicalLocation.begin();
-        Track* plainPtr= i->second->getPlainPtr();
-        saveEvictedTrack(plainPtr);
-        m_tracksByCanonicalLocation.erase(i);
+    std::vector<std::pair<QString, GlobalTrackCacheEntryPointer>> tracksByCanonicalLocation;
+    m_tracksByCanonicalLocation.forEach(
+            [&tracksByCanonicalLocation](const QString& canonicalLocation,
+                    const GlobalTrackCacheEntryPointer& entryPtr) {
+                tracksByCanonicalLocation.emplace_back(canonicalLocation, entryPtr);
+            });
+    for (const auto& [canonicalLocation, entryPtr] : tracksByCanonicalLocation) {
+        m_tracksByCanonicalLocation.erase(canonicalLocation);
+        saveEvictedTrack(entryPtr->getPlainPtr());
     }
 
     // Verify that all cached tracks have been evicted
@@ -443,16 +540,16 @@ TrackPointer GlobalTrackCache::lookupById(
     }
 
     TrackPointer trackPtr;
-    const auto trackById(m_tracksById.find(trackId));
-    if (m_tracksById.end() != trackById) {
+    auto entryPtr = m_tracksById.find(trackId);
+    if (entryPtr) {
         // Cache hit
         if (traceLogEnabled()) {
             kLogger.trace()
                     << "Cache hit for"
                     << trackId
-                    << trackById->second->getPlainPtr();
+                    << entryPtr->getPlainPtr();
         }
-        trackPtr = revive(trackById->second);
+        trackPtr = revive(std::move(entryPtr));
         DEBUG_ASSERT(trackPtr);
     } else {
         // Cache miss
@@ -503,17 +600,16 @@ TrackPointer GlobalTrackCache::lookupByCanonicalLocation(
     }
 
     TrackPointer trackPtr;
-    const auto trackByCanonicalLocation(
-            m_tracksByCanonicalLocation.find(canonicalLocation));
-    if (m_tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
+    auto entryPtr = m_tracksByCanonicalLocation.find(canonicalLocation);
+    if (entryPtr) {
         // Cache hit
         if (traceLogEnabled()) {
             kLogger.trace()
                     << "Cache hit for"
                     << canonicalLocation
-                    << trackByCanonicalLocation->second->getPlainPtr();
+                    << entryPtr->getPlainPtr();
         }
-        trackPtr = revive(trackByCanonicalLocation->second);
+        trackPtr = revive(std::move(entryPtr));
         DEBUG_ASSERT(trackPtr);
     } else {
         // Cache miss
@@ -528,9 +624,11 @@ TrackPointer GlobalTrackCache::lookupByCanonicalLocation(
 
 QSet<TrackId> GlobalTrackCache::getCachedTrackIds() const {
     QSet<TrackId> trackIds;
-    for (const auto& entry : m_tracksById) {
-        trackIds << entry.first;
-    }
+    m_tracksById.forEach(
+            [&trackIds](const TrackId& trackId,
+                    const GlobalTrackCacheEntryPointer& /*entryPtr*/) {
+                trackIds << trackId;
+            });
     return trackIds;
 }
 
@@ -545,6 +643,10 @@ TrackPointer GlobalTrackCache::revive(
                     << entryPtr->getPlainPtr();
         }
         DEBUG_ASSERT(!savingPtr->signalsBlocked());
+        // The track is in use again and will be retained
+        // after the new references have been released.
+        entryPtr->setRetainable(true);
+        unretain(entryPtr->getPlainPtr());
         return savingPtr;
     }
 
@@ -563,10 +665,32 @@ TrackPointer GlobalTrackCache::revive(
     savingPtr = TrackPointer(entryPtr->getPlainPtr(),
             EvictAndSaveFunctor(entryPtr));
     entryPtr->init(savingPtr);
+    entryPtr->setRetainable(true);
     DEBUG_ASSERT(!savingPtr->signalsBlocked());
     return savingPtr;
 }
 
+TrackPointer GlobalTrackCache::reviveShared(
+        GlobalTrackCacheEntry& entry) const {
+    TrackPointer savingPtr = entry.lock();
+    if (!savingPtr) {
+        // Zombie tracks can only be revived while the cache is locked
+        return {};
+    }
+    if (entry.isRetained() ||
+            savingPtr.get() == m_incompleteTrackPlainPtr.load()) {
+        // Retained tracks need to be taken out of the retention tier
+        // and incomplete tracks need to be awaited while the cache is
+        // locked. The reference is released before locking the cache.
+        return {};
+    }
+    if (!entry.isRetainable()) {
+        // See revive()
+        entry.setRetainable(true);
+    }
+    return savingPtr;
+}
+
 void GlobalTrackCache::resolve(
         GlobalTrackCacheResolver* /*in/out*/ pCacheResolver,
         mixxx::FileAccess /*in*/ fileAccess,
@@ -647,6 +771,20 @@ void GlobalTrackCache::resolve(
                 << trackRef;
         return;
     }
+    if (m_incompleteTrack) {
+        // Check if someone else is currently busy loading track metadata
+        // in the background, and wait until they are done.
+        //
+        // See GlobalTrackCache::lookupById for more information on how
+        // the locking is implemented.
+        do {
+            m_isTrackCompleted.wait(&m_mutex);
+        } while (m_incompleteTrack);
+        // The lock has been released while waiting and the track
+        // might have been added by another thread in the meantime
+        resolve(pCacheResolver, std::move(fileAccess), std::move(trackId));
+        return;
+    }
     if (debugLogEnabled()) {
         kLogger.debug()
                 << "Cache miss - allocating track"
@@ -672,23 +810,6 @@ void GlobalTrackCache::resolve(
                 << deletingPtr.get();
     }
 
-    if (trackRef.hasId()) {
-        // Insert item by id
-        DEBUG_ASSERT(m_tracksById.find(
-                trackRef.getId()) == m_tracksById.end());
-        m_tracksById.insert(std::make_pair(
-                trackRef.getId(),
-                cacheEntryPtr));
-    }
-    if (trackRef.hasCanonicalLocation()) {
-        // Insert item by track location
-        DEBUG_ASSERT(m_tracksByCanonicalLocation.find(
-                trackRef.getCanonicalLocation()) == m_tracksByCanonicalLocation.end());
-        m_tracksByCanonicalLocation.insert(std::make_pair(
-                trackRef.getCanonicalLocation(),
-                cacheEntryPtr));
-    }
-
     // Track objects live together with the cache on the main thread
     // and will be deleted later within the event loop. But this
     // function might be called from any thread, even from worker
@@ -696,17 +817,26 @@ void GlobalTrackCache::resolve(
     // created object to the main thread.
     savingPtr->moveToThread(QCoreApplication::instance()->thread());
 
-    // Check if someone else is currently busy loading track metadata
-    // in the background, and wait until they are done.
-    //
-    // See GlobalTrackCache::lookupById for more information on how
-    // the locking is implemented.
-    while (m_incompleteTrack) {
-        // Wait for completion.
-        m_isTrackCompleted.wait(&m_mutex);
-        // now the track should be empty
+    // The track must be marked as incomplete before it is published
+    // for lookups without locking the cache, see reviveShared()
+    setIncompleteTrack(savingPtr);
+
+    if (trackRef.hasId()) {
+        // Insert item by id
+        const bool inserted = m_tracksById.insert(
+                trackRef.getId(),
+                cacheEntryPtr);
+        Q_UNUSED(inserted); // only used in DEBUG_ASSERT
+        DEBUG_ASSERT(inserted);
+    }
+    if (trackRef.hasCanonicalLocation()) {
+        // Insert item by track location
+        const bool inserted = m_tracksByCanonicalLocation.insert(
+                trackRef.getCanonicalLocation(),
+                cacheEntryPtr);
+        Q_UNUSED(inserted); // only used in DEBUG_ASSERT
+        DEBUG_ASSERT(inserted);
     }
-    m_incompleteTrack = savingPtr;
 
     pCacheResolver->initLookupResult(
             GlobalTrackCacheLookupResult::Miss,
@@ -757,7 +887,7 @@ void GlobalTrackCache::resolveTemporary(
         m_isTrackCompleted.wait(&m_mutex);
         // now the track should be empty
     }
-    m_incompleteTrack = pTrack;
+    setIncompleteTrack(pTrack);
     pCacheResolver->initLookupResult(
             GlobalTrackCacheLookupResult::Miss,
             std::move(pTrack),
@@ -780,32 +910,43 @@ TrackRef GlobalTrackCache::initTrackId(
     DEBUG_ASSERT(strongPtr == m_incompleteTrack);
     discardIncompleteTrack();
 
-    // Insert item by id
-    DEBUG_ASSERT(m_tracksById.find(trackId) == m_tracksById.end());
-    m_tracksById.insert(std::make_pair(
-            trackId,
-            pDel->getCacheEntryPointer()));
-
+    // The id must be initialized before the track is published
+    // for lookups by id without locking the cache
     strongPtr->initId(trackId);
     DEBUG_ASSERT(createTrackRef(*strongPtr) == trackRefWithId);
-    DEBUG_ASSERT(m_tracksById.find(trackId) != m_tracksById.end());
+
+    // Insert item by id
+    const bool inserted = m_tracksById.insert(
+            trackId,
+            pDel->getCacheEntryPointer());
+    Q_UNUSED(inserted); // only used in DEBUG_ASSERT
+    DEBUG_ASSERT(inserted);
+    DEBUG_ASSERT(m_tracksById.find(trackId));
 
     return trackRefWithId;
 }
 
+void GlobalTrackCache::setIncompleteTrack(TrackPointer incompleteTrack) {
+    DEBUG_ASSERT(!m_incompleteTrack);
+    m_incompleteTrackPlainPtr.store(incompleteTrack.get());
+    m_incompleteTrack = std::move(incompleteTrack);
+}
+
 void GlobalTrackCache::discardIncompleteTrack() {
     m_incompleteTrack = nullptr;
+    m_incompleteTrackPlainPtr.store(nullptr);
     m_isTrackCompleted.wakeAll();
 }
 
 void GlobalTrackCache::purgeTrackId(TrackId trackId) {
     DEBUG_ASSERT(trackId.isValid());
 
-    const auto trackById(m_tracksById.find(trackId));
-    if (m_tracksById.end() != trackById) {
-        Track* track = trackById->second->getPlainPtr();
+    const auto entryPtr = m_tracksById.find(trackId);
+    if (entryPtr) {
+        Track* track = entryPtr->getPlainPtr();
+        unretain(track);
+        m_tracksById.erase(trackId);
         track->resetId();
-        m_tracksById.erase(trackById);
     }
 }
 
@@ -830,6 +971,15 @@ void GlobalTrackCache::slotEvictAndSave(
         return;
     }
 
+    if (tryRetain(cacheEntryPtr)) {
+        if (traceLogEnabled()) {
+            kLogger.trace()
+                    << "Retaining track"
+                    << cacheEntryPtr->getPlainPtr();
+        }
+        return;
+    }
+
     if (!tryEvict(cacheEntryPtr->getPlainPtr())) {
         // A second deleter has already evicted the track from cache after our
         // reference count drops to zero and before acquiring the lock at the
@@ -872,10 +1022,10 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
                 << plainPtr;
     }
     if (trackRef.hasId()) {
-        const auto trackById = m_tracksById.find(trackRef.getId());
-        if (trackById != m_tracksById.end()) {
-            if (trackById->second->getPlainPtr() == plainPtr) {
-                m_tracksById.erase(trackById);
+        const auto entryPtr = m_tracksById.find(trackRef.getId());
+        if (entryPtr) {
+            if (entryPtr->getPlainPtr() == plainPtr) {
+                m_tracksById.erase(trackRef.getId());
                 evicted = true;
             } else {
                 notEvicted = true;
@@ -883,12 +1033,12 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
         }
     }
     if (trackRef.hasCanonicalLocation()) {
-        const auto trackByCanonicalLocation(
-                m_tracksByCanonicalLocation.find(trackRef.getCanonicalLocation()));
-        if (m_tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
-            if (trackByCanonicalLocation->second->getPlainPtr() == plainPtr) {
+        const auto entryPtr = m_tracksByCanonicalLocation.find(
+                trackRef.getCanonicalLocation());
+        if (entryPtr) {
+            if (entryPtr->getPlainPtr() == plainPtr) {
                 m_tracksByCanonicalLocation.erase(
-                        trackByCanonicalLocation);
+                        trackRef.getCanonicalLocation());
                 evicted = true;
             } else {
                 notEvicted = true;
@@ -902,15 +1052,83 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
 }
 
 bool GlobalTrackCache::isCached(Track* plainPtr) const {
-    for (auto&& entry: m_tracksById) {
-        if (entry.second->getPlainPtr() == plainPtr) {
-            return true;
-        }
+    bool cached = false;
+    const auto isCachedEntry =
+            [plainPtr, &cached](const auto& /*key*/,
+                    const GlobalTrackCacheEntryPointer& entryPtr) {
+                if (entryPtr->getPlainPtr() == plainPtr) {
+                    cached = true;
+                }
+            };
+    m_tracksById.forEach(isCachedEntry);
+    m_tracksByCanonicalLocation.forEach(isCachedEntry);
+    return cached;
+}
+
+bool GlobalTrackCache::tryRetain(
+        const GlobalTrackCacheEntryPointer& cacheEntryPtr) {
+    DEBUG_ASSERT(cacheEntryPtr->expired());
+    if (m_retainedTrackCapacity == 0 || !m_pSaver ||
+            !cacheEntryPtr->isRetainable()) {
+        return false;
     }
-    for (auto&& entry: m_tracksByCanonicalLocation) {
-        if (entry.second->getPlainPtr() == plainPtr) {
-              return true;
-        }
+    // Only library tracks that could still be found by their id
+    // are retained. Modified tracks need to be saved.
+    Track* plainPtr = cacheEntryPtr->getPlainPtr();
+    const TrackId trackId = plainPtr->getId();
+    if (!trackId.isValid()) {
+        return false;
+    }
+    if (m_tracksById.find(trackId) != cacheEntryPtr || plainPtr->isDirty()) {
+        return false;
+    }
+    // The waveforms are by far the largest part of a track in memory.
+    // They are dropped and reloaded from the database when the track is
+    // loaded into a deck again, see AnalyzerWaveform. Unsaved waveforms
+    // would get lost.
+    if (!isWaveformDisposable(plainPtr->getWaveform()) ||
+            !isWaveformDisposable(plainPtr->getWaveformSummary())) {
+        return false;
+    }
+    {
+        // Nobody is interested in the track while it is retained
+        const QSignalBlocker signalBlocker(plainPtr);
+        plainPtr->setWaveform(ConstWaveformPointer());
+        plainPtr->setWaveformSummary(ConstWaveformPointer());
+    }
+    DEBUG_ASSERT(m_retainedTrackIndex.find(plainPtr) == m_retainedTrackIndex.end());
+    // Mark the track before reviving it to prevent that lookups
+    // without locking the cache return it, see reviveShared()
+    cacheEntryPtr->setRetained(true);
+    m_retainedTrackIndex.emplace(plainPtr,
+            m_retainedTracks.insert(
+                    m_retainedTracks.end(),
+                    revive(cacheEntryPtr)));
+    trimRetainedTracks(m_retainedTrackCapacity);
+    return true;
+}
+
+void GlobalTrackCache::unretain(Track* plainPtr) {
+    const auto i = m_retainedTrackIndex.find(plainPtr);
+    if (i == m_retainedTrackIndex.end()) {
+        return;
+    }
+    cacheEntryOf(*i->second)->setRetained(false);
+    m_releasedTracks.push_back(std::move(*i->second));
+    m_retainedTracks.erase(i->second);
+    m_retainedTrackIndex.erase(i);
+}
+
+void GlobalTrackCache::trimRetainedTracks(std::size_t capacity) {
+    while (m_retainedTracks.size() > capacity) {
+        TrackPointer savingPtr = std::move(m_retainedTracks.front());
+        m_retainedTracks.pop_front();
+        m_retainedTrackIndex.erase(savingPtr.get());
+        // Evict the least recently used track when releasing
+        // the last reference instead of retaining it again
+        GlobalTrackCacheEntry* pEntry = cacheEntryOf(savingPtr);
+        pEntry->setRetained(false);
+        pEntry->setRetainable(false);
+        m_releasedTracks.push_back(std::move(savingPtr));
     }
-    return false;
 }
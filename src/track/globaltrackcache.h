@@ -1,8 +1,13 @@
 #pragma once
 
+#include <QHash>
 #include <QWaitCondition>
-#include <map>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <list>
 #include <unordered_map>
+#include <vector>
 
 #include "track/track_decl.h"
 #include "track/trackref.h"
@@ -55,12 +60,17 @@ class GlobalTrackCacheEntry final {
 
     explicit GlobalTrackCacheEntry(
             std::unique_ptr<Track, TrackDeleter> deletingPtr)
-        : m_deletingPtr(std::move(deletingPtr)) {
+        : m_deletingPtr(std::move(deletingPtr)),
+          m_retained(false),
+          m_retainable(true) {
     }
     GlobalTrackCacheEntry(const GlobalTrackCacheEntry& other) = delete;
-    GlobalTrackCacheEntry(GlobalTrackCacheEntry&&) = default;
+    GlobalTrackCacheEntry(GlobalTrackCacheEntry&&) = delete;
 
+    // The weak pointer is accessed concurrently by lookups that
+    // don't lock the cache, see GlobalTrackCache::lookupTrackById().
     void init(TrackWeakPointer savingWeakPtr) {
+        const auto locked = lockMutex(&m_mutex);
         // Uninitialized or expired
         DEBUG_ASSERT(!m_savingWeakPtr.lock());
         m_savingWeakPtr = std::move(savingWeakPtr);
@@ -71,19 +81,135 @@ class GlobalTrackCacheEntry final {
     }
 
     TrackPointer lock() const {
+        const auto locked = lockMutex(&m_mutex);
         return m_savingWeakPtr.lock();
     }
     bool expired() const {
+        const auto locked = lockMutex(&m_mutex);
         return m_savingWeakPtr.expired();
     }
 
+    /// Tracks in the retention tier are kept alive by the cache.
+    bool isRetained() const {
+        return m_retained.load();
+    }
+    void setRetained(bool retained) {
+        m_retained.store(retained);
+    }
+
+    /// Tracks that have been dropped from the retention tier are
+    /// evicted when their last reference is released.
+    bool isRetainable() const {
+        return m_retainable.load();
+    }
+    void setRetainable(bool retainable) {
+        m_retainable.store(retainable);
+    }
+
   private:
     std::unique_ptr<Track, TrackDeleter> m_deletingPtr;
+    mutable QMutex m_mutex;
     TrackWeakPointer m_savingWeakPtr;
+    std::atomic<bool> m_retained;
+    std::atomic<bool> m_retainable;
 };
 
 typedef std::shared_ptr<GlobalTrackCacheEntry> GlobalTrackCacheEntryPointer;
 
+/// An index of cached tracks that is split into shards by the hash
+/// of the key. Each shard is guarded by a separate mutex.
+///
+/// All modifications require that the cache is locked and additionally
+/// lock the affected shard. Reading while the cache is locked doesn't
+/// need to lock any shards. Only lookups without locking the cache need
+/// to lock the shard of the key, see findShared().
+template<typename Key, typename Hash>
+class GlobalTrackCacheIndex final {
+  public:
+    static constexpr std::size_t kShardCount = 16;
+
+    explicit GlobalTrackCacheIndex(std::size_t minCapacity = 0) {
+        for (auto& shard : m_shards) {
+            shard.entries.reserve(minCapacity / kShardCount);
+        }
+    }
+    GlobalTrackCacheIndex(const GlobalTrackCacheIndex&) = delete;
+    GlobalTrackCacheIndex& operator=(const GlobalTrackCacheIndex&) = delete;
+
+    bool empty() const {
+        return std::all_of(m_shards.cbegin(), m_shards.cend(), [](const Shard& shard) {
+            return shard.entries.empty();
+        });
+    }
+
+    std::size_t size() const {
+        std::size_t size = 0;
+        for (const auto& shard : m_shards) {
+            size += shard.entries.size();
+        }
+        return size;
+    }
+
+    /// Returns nullptr if the key is not indexed.
+    GlobalTrackCacheEntryPointer find(const Key& key) const {
+        const Shard& shard = shardOf(key);
+        const auto i = shard.entries.find(key);
+        if (i == shard.entries.end()) {
+            return nullptr;
+        }
+        return i->second;
+    }
+
+    /// Same as find() but can be used without locking the cache.
+    GlobalTrackCacheEntryPointer findShared(const Key& key) const {
+        const Shard& shard = shardOf(key);
+        const auto locked = lockMutex(&shard.mutex);
+        const auto i = shard.entries.find(key);
+        if (i == shard.entries.end()) {
+            return nullptr;
+        }
+        return i->second;
+    }
+
+    /// Returns false if the key is already indexed.
+    bool insert(const Key& key, GlobalTrackCacheEntryPointer entryPtr) {
+        Shard& shard = shardOf(key);
+        const auto locked = lockMutex(&shard.mutex);
+        return shard.entries.emplace(key, std::move(entryPtr)).second;
+    }
+
+    /// Returns true if the key has been indexed.
+    bool erase(const Key& key) {
+        Shard& shard = shardOf(key);
+        const auto locked = lockMutex(&shard.mutex);
+        return shard.entries.erase(key) > 0;
+    }
+
+    template<typename Fn>
+    void forEach(Fn fn) const {
+        for (const auto& shard : m_shards) {
+            for (const auto& entry : shard.entries) {
+                fn(entry.first, entry.second);
+            }
+        }
+    }
+
+  private:
+    struct Shard {
+        mutable QMutex mutex;
+        std::unordered_map<Key, GlobalTrackCacheEntryPointer, Hash> entries;
+    };
+
+    const Shard& shardOf(const Key& key) const {
+        return m_shards[Hash()(key) % kShardCount];
+    }
+    Shard& shardOf(const Key& key) {
+        return m_shards[Hash()(key) % kShardCount];
+    }
+
+    std::array<Shard, kShardCount> m_shards;
+};
+
 class GlobalTrackCacheLocker {
 public:
     GlobalTrackCacheLocker();
@@ -105,6 +231,14 @@ public:
     // of the callback and disables the cache permanently.
     void deactivateCache() const;
 
+    /// Keep up to the given number of recently used tracks alive after
+    /// the last reference outside of the cache has been released. Only
+    /// unmodified tracks are retained, modified tracks are saved and
+    /// evicted as usual. Retained tracks don't keep their waveforms in
+    /// memory. Disabled if 0 (default).
+    void setRetainedTrackCapacity(std::size_t capacity) const;
+    std::size_t getRetainedTrackCount() const;
+
     bool isEmpty() const;
 
     // Lookup an existing Track object in the cache
@@ -215,6 +349,15 @@ class GlobalTrackCache : public QObject {
     // Deleter callbacks for the smart-pointer
     static void evictAndSaveCachedTrack(GlobalTrackCacheEntryPointer cacheEntryPtr);
 
+    /// Lookup an existing Track object in the cache without locking
+    /// the whole cache if possible. Tracks that are currently in use
+    /// are found by only locking a single shard of the cache index.
+    /// All other cases are handled by GlobalTrackCacheLocker.
+    static TrackPointer lookupTrackById(
+            const TrackId& trackId);
+    static TrackPointer lookupTrackByRef(
+            const TrackRef& trackRef);
+
   private slots:
     void slotEvictAndSave(GlobalTrackCacheEntryPointer cacheEntryPtr);
 
@@ -244,6 +387,7 @@ class GlobalTrackCache : public QObject {
     QSet<TrackId> getCachedTrackIds() const;
 
     TrackPointer revive(GlobalTrackCacheEntryPointer entryPtr);
+    TrackPointer reviveShared(GlobalTrackCacheEntry& entry) const;
 
     void resolve(
             GlobalTrackCacheResolver* /*in/out*/ pCacheResolver,
@@ -259,6 +403,7 @@ class GlobalTrackCache : public QObject {
             const TrackRef& trackRef,
             TrackId trackId);
 
+    void setIncompleteTrack(TrackPointer incompleteTrack);
     void discardIncompleteTrack();
 
     void purgeTrackId(TrackId trackId);
@@ -266,6 +411,10 @@ class GlobalTrackCache : public QObject {
     bool tryEvict(Track* plainPtr);
     bool isCached(Track* plainPtr) const;
 
+    bool tryRetain(const GlobalTrackCacheEntryPointer& cacheEntryPtr);
+    void unretain(Track* plainPtr);
+    void trimRetainedTracks(std::size_t capacity);
+
     bool isEmpty() const;
 
     void deactivate();
@@ -284,12 +433,38 @@ class GlobalTrackCache : public QObject {
     // m_isTrackCompleted will be signaled once the asynchronous loading has been completed.
     TrackPointer m_incompleteTrack;
     QWaitCondition m_isTrackCompleted;
+    // Mirrors m_incompleteTrack for lookups without locking the cache
+    std::atomic<const Track*> m_incompleteTrackPlainPtr;
+
+    struct TrackIdHash {
+        std::size_t operator()(const TrackId& trackId) const {
+            return trackId.hash();
+        }
+    };
+    struct CanonicalLocationHash {
+        std::size_t operator()(const QString& canonicalLocation) const {
+            return qHash(canonicalLocation);
+        }
+    };
 
     // This caches the unsaved Tracks by ID
-    typedef std::unordered_map<TrackId, GlobalTrackCacheEntryPointer, TrackId::hash_fun_t> TracksById;
+    typedef GlobalTrackCacheIndex<TrackId, TrackIdHash> TracksById;
     TracksById m_tracksById;
 
     // This caches the unsaved Tracks by location
-    typedef std::map<QString, GlobalTrackCacheEntryPointer> TracksByCanonicalLocation;
+    typedef GlobalTrackCacheIndex<QString, CanonicalLocationHash> TracksByCanonicalLocation;
     TracksByCanonicalLocation m_tracksByCanonicalLocation;
+
+    // The retention tier holds strong references to recently used tracks,
+    // ordered from least to most recently used.
+    std::size_t m_retainedTrackCapacity;
+    typedef std::list<TrackPointer> RetainedTracks;
+    RetainedTracks m_retainedTracks;
+    std::unordered_map<Track*, RetainedTracks::iterator> m_retainedTrackIndex;
+
+    // Releasing the last reference of a track while the cache is locked
+    // would deadlock when evicting it. References that have been dropped
+    // from the retention tier are released by GlobalTrackCacheLocker
+    // after unlocking the cache.
+    std::vector<TrackPointer> m_releasedTracks;
 };
@@ -51,6 +51,7 @@ CmdlineArgs::CmdlineArgs()
         : m_startInFullscreen(false), // Initialize vars
           m_startAutoDJ(false),
           m_rescanLibrary(false),
+          m_analyze(false),
           m_controllerDebug(false),
           m_controllerAbortOnWarning(false),
           m_developer(false),
@@ -196,6 +197,35 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
                             : QString());
     parser.addOption(rescanLibrary);
 
+    const QCommandLineOption analyze(QStringLiteral("analyze"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Analyzes the given files and directories, "
+                                      "or the whole library if none are given, "
+                                      "without starting the user interface. Mixxx "
+                                      "exits when the analysis is finished.")
+                            : QString());
+    parser.addOption(analyze);
+
+    const QCommandLineOption exportAnalysisCache(QStringLiteral("export-analysis-cache"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Exports the cached analysis results into a file "
+                                      "that can be imported on another computer, "
+                                      "then exits. Combined with --analyze the export "
+                                      "happens after the analysis.")
+                            : QString(),
+            QStringLiteral("file"));
+    parser.addOption(exportAnalysisCache);
+
+    const QCommandLineOption importAnalysisCache(QStringLiteral("import-analysis-cache"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Imports cached analysis results from a file "
+                                      "written by --export-analysis-cache, then exits. "
+                                      "Combined with --analyze the import happens "
+                                      "before the analysis.")
+                            : QString(),
+            QStringLiteral("file"));
+    parser.addOption(importAnalysisCache);
+
     // An option with a value
     const QCommandLineOption settingsPath(QStringLiteral("settings-path"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
@@ -425,6 +455,10 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
         m_rescanLibrary = true;
     }
 
+    m_analyze = parser.isSet(analyze);
+    m_exportAnalysisCache = parser.value(exportAnalysisCache);
+    m_importAnalysisCache = parser.value(importAnalysisCache);
+
     if (parser.isSet(settingsPath)) {
         m_settingsPath = parser.value(settingsPath);
         if (!m_settingsPath.endsWith("/")) {
@@ -36,6 +36,25 @@ class CmdlineArgs final {
     bool getRescanLibrary() const {
         return m_rescanLibrary;
     }
+    /// Analyze the tracks in getMusicFiles() or the whole library
+    /// without starting the GUI, then exit
+    bool getAnalyze() const {
+        return m_analyze;
+    }
+    /// Export the analysis cache into this file without starting the GUI
+    const QString& getExportAnalysisCache() const {
+        return m_exportAnalysisCache;
+    }
+    /// Import the analysis cache from this file without starting the GUI
+    const QString& getImportAnalysisCache() const {
+        return m_importAnalysisCache;
+    }
+    /// Run one of the headless actions above instead of the GUI
+    bool getHeadless() const {
+        return m_analyze ||
+                !m_exportAnalysisCache.isEmpty() ||
+                !m_importAnalysisCache.isEmpty();
+    }
     bool getControllerDebug() const {
         return m_controllerDebug;
     }
@@ -100,6 +119,9 @@ class CmdlineArgs final {
     bool m_startInFullscreen;       // Start in fullscreen mode
     bool m_startAutoDJ;
     bool m_rescanLibrary;
+    bool m_analyze;
+    QString m_exportAnalysisCache;
+    QString m_importAnalysisCache;
     bool m_controllerDebug;
     bool m_controllerPreviewScreens;
     bool m_controllerAbortOnWarning; // Controller Engine will be stricter
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QSqlDatabase>
+#include <QStringList>
 #include <QtDebug>
 
 #include "util/string.h"
@@ -29,6 +30,9 @@ class DbConnection final {
         QString filePath;
         QString userName;
         QString password;
+        // Statements like "PRAGMA ..." that are executed on every
+        // pooled connection after it has been opened
+        QStringList pragmas;
     };
 
     // All constructors are reserved for DbConnectionPool!!
@@ -1,5 +1,8 @@
 #include "util/db/dbconnectionpool.h"
 
+#include <QSqlError>
+#include <QSqlQuery>
+
 #include "util/logger.h"
 
 
@@ -32,6 +35,19 @@ bool DbConnectionPool::createThreadLocalConnection() {
                 << *pConnection;
         return false; // abort
     }
+    // The connection is still usable if the profile could not be
+    // applied, e.g. if the database is in use by another process
+    QSqlQuery query(*pConnection);
+    for (const auto& pragma : m_pragmas) {
+        if (!query.exec(pragma)) {
+            kLogger.warning()
+                    << "Failed to apply"
+                    << pragma
+                    << "to thread-local database connection"
+                    << *pConnection
+                    << query.lastError();
+        }
+    }
 
     // m_threadLocalConnections takes the ownership of pConnection
     m_threadLocalConnections.setLocalData(pConnection.release());
@@ -56,6 +72,7 @@ DbConnectionPool::DbConnectionPool(
         const DbConnection::Params& params,
         const QString& connectionName)
     : m_prototypeConnection(params, connectionName),
+      m_pragmas(params.pragmas),
       m_connectionCounter(0) {
 }
 
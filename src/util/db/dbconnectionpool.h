@@ -55,6 +55,8 @@ class DbConnectionPool final {
 
     const DbConnection m_prototypeConnection;
 
+    const QStringList m_pragmas;
+
     QAtomicInt m_connectionCounter;
 
     QThreadStorage<DbConnection*> m_threadLocalConnections;
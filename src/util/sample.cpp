@@ -443,6 +443,53 @@ SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
     return clipping;
 }
 
+// static
+SampleUtil::CLIP_STATUS SampleUtil::meterPerChannel(CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        CSAMPLE* pfSquaredL,
+        CSAMPLE* pfSquaredR,
+        CSAMPLE* pfPeakL,
+        CSAMPLE* pfPeakR,
+        const CSAMPLE* pBuffer,
+        SINT numSamples) {
+    CSAMPLE fAbsL = CSAMPLE_ZERO;
+    CSAMPLE fAbsR = CSAMPLE_ZERO;
+    CSAMPLE fSquaredL = CSAMPLE_ZERO;
+    CSAMPLE fSquaredR = CSAMPLE_ZERO;
+    CSAMPLE fPeakL = CSAMPLE_ZERO;
+    CSAMPLE fPeakR = CSAMPLE_ZERO;
+
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples / 2; ++i) {
+        const CSAMPLE l = pBuffer[i * 2];
+        const CSAMPLE r = pBuffer[i * 2 + 1];
+        const CSAMPLE absl = fabs(l);
+        const CSAMPLE absr = fabs(r);
+        fAbsL += absl;
+        fAbsR += absr;
+        fSquaredL += l * l;
+        fSquaredR += r * r;
+        // Using std::max here prevents vectorizing
+        fPeakL = absl > fPeakL ? absl : fPeakL;
+        fPeakR = absr > fPeakR ? absr : fPeakR;
+    }
+
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    *pfSquaredL = fSquaredL;
+    *pfSquaredR = fSquaredR;
+    *pfPeakL = fPeakL;
+    *pfPeakR = fPeakR;
+    SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
+    if (fPeakL > CSAMPLE_PEAK) {
+        clipping |= SampleUtil::CLIPPING_LEFT;
+    }
+    if (fPeakR > CSAMPLE_PEAK) {
+        clipping |= SampleUtil::CLIPPING_RIGHT;
+    }
+    return clipping;
+}
+
 // static
 CSAMPLE SampleUtil::sumSquared(const CSAMPLE* pBuffer, SINT numSamples) {
     CSAMPLE sumSq = CSAMPLE_ZERO;
@@ -472,6 +519,25 @@ CSAMPLE SampleUtil::maxAbsAmplitude(const CSAMPLE* pBuffer, SINT numSamples) {
     return max;
 }
 
+// static
+void SampleUtil::maxAbsPerChannel(CSAMPLE* pfMaxL,
+        CSAMPLE* pfMaxR,
+        const CSAMPLE* pBuffer,
+        SINT numSamples) {
+    CSAMPLE fMaxL = CSAMPLE_ZERO;
+    CSAMPLE fMaxR = CSAMPLE_ZERO;
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples / 2; ++i) {
+        const CSAMPLE absl = fabs(pBuffer[i * 2]);
+        const CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
+        // Using std::max here prevents vectorizing
+        fMaxL = absl > fMaxL ? absl : fMaxL;
+        fMaxR = absr > fMaxR ? absr : fMaxR;
+    }
+    *pfMaxL = fMaxL;
+    *pfMaxR = fMaxR;
+}
+
 // static
 void SampleUtil::copyClampBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc, SINT iNumSamples) {
@@ -228,6 +228,19 @@ class SampleUtil {
     static CLIP_STATUS sumAbsPerChannel(CSAMPLE* pfAbsL, CSAMPLE* pfAbsR,
             const CSAMPLE* pBuffer, SINT numSamples);
 
+    // Meters both channels of a stereo buffer in a single pass. For each
+    // channel the sum of the absolute values, the sum of the squared values
+    // and the largest absolute value are stored.
+    // The return value tells whether there is clipping in pBuffer or not.
+    static CLIP_STATUS meterPerChannel(CSAMPLE* pfAbsL,
+            CSAMPLE* pfAbsR,
+            CSAMPLE* pfSquaredL,
+            CSAMPLE* pfSquaredR,
+            CSAMPLE* pfPeakL,
+            CSAMPLE* pfPeakR,
+            const CSAMPLE* pBuffer,
+            SINT numSamples);
+
     // Returns the sum of the squared values of the buffer.
     static CSAMPLE sumSquared(const CSAMPLE* pBuffer, SINT numSamples);
 
@@ -236,6 +249,13 @@ class SampleUtil {
 
     static CSAMPLE maxAbsAmplitude(const CSAMPLE* pBuffer, SINT numSamples);
 
+    // Stores the largest absolute value of each channel of a stereo
+    // buffer in pfMaxL and pfMaxR, or 0 if the buffer is empty.
+    static void maxAbsPerChannel(CSAMPLE* pfMaxL,
+            CSAMPLE* pfMaxR,
+            const CSAMPLE* pBuffer,
+            SINT numSamples);
+
     // Copies every sample in pSrc to pDest, limiting the values in pDest
     // to the valid range of CSAMPLE. pDest and pSrc must not overlap.
     static void copyClampBuffer(CSAMPLE* pDest, const CSAMPLE* pSrc,
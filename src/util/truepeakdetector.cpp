@@ -0,0 +1,93 @@
+#include "util/truepeakdetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/math.h"
+
+namespace {
+
+// Polyphase FIR coefficients for 4x oversampling from ITU-R BS.1770-4,
+// Annex 2, Table 1
+// clang-format off
+constexpr CSAMPLE kCoefficients[TruePeakDetector::kPhases][TruePeakDetector::kTapsPerPhase] = {
+        {0.0017089843750f, 0.0109863281250f, -0.0196533203125f, 0.0332031250000f,
+                -0.0594482421875f, 0.1373291015625f, 0.9721679687500f, -0.1022949218750f,
+                0.0476074218750f, -0.0266113281250f, 0.0148925781250f, -0.0083007812500f},
+        {-0.0291748046875f, 0.0292968750000f, -0.0517578125000f, 0.0891113281250f,
+                -0.1665039062500f, 0.4650878906250f, 0.7797851562500f, -0.2003173828125f,
+                0.1015625000000f, -0.0582275390625f, 0.0330810546875f, -0.0189208984375f},
+        {-0.0189208984375f, 0.0330810546875f, -0.0582275390625f, 0.1015625000000f,
+                -0.2003173828125f, 0.7797851562500f, 0.4650878906250f, -0.1665039062500f,
+                0.0891113281250f, -0.0517578125000f, 0.0292968750000f, -0.0291748046875f},
+        {-0.0083007812500f, 0.0148925781250f, -0.0266113281250f, 0.0476074218750f,
+                -0.1022949218750f, 0.9721679687500f, 0.1373291015625f, -0.0594482421875f,
+                0.0332031250000f, -0.0196533203125f, 0.0109863281250f, 0.0017089843750f},
+};
+// clang-format on
+
+} // anonymous namespace
+
+TruePeakDetector::TruePeakDetector() {
+    reset();
+}
+
+void TruePeakDetector::reset() {
+    for (auto& history : m_history) {
+        history.fill(CSAMPLE_ZERO);
+    }
+}
+
+void TruePeakDetector::process(CSAMPLE* pfPeakL,
+        CSAMPLE* pfPeakR,
+        const CSAMPLE* pIn,
+        SINT numSamples) {
+    const SINT numFrames = numSamples / mixxx::kEngineChannelOutputCount;
+    CSAMPLE peaks[mixxx::kEngineChannelOutputCount] = {CSAMPLE_ZERO, CSAMPLE_ZERO};
+    // Processing in chunks keeps the working set small and in the cache
+    for (SINT frame = 0; frame < numFrames; frame += kChunkFrames) {
+        const SINT chunkFrames = math_min(kChunkFrames, numFrames - frame);
+        for (int channel = 0; channel < mixxx::kEngineChannelOutputCount; ++channel) {
+            peaks[channel] = math_max(peaks[channel],
+                    processChannel(channel,
+                            pIn + frame * mixxx::kEngineChannelOutputCount,
+                            chunkFrames));
+        }
+    }
+    *pfPeakL = peaks[0];
+    *pfPeakR = peaks[1];
+}
+
+CSAMPLE TruePeakDetector::processChannel(int channel, const CSAMPLE* pIn, SINT numFrames) {
+    constexpr int kHistorySize = kTapsPerPhase - 1;
+    auto& history = m_history[channel];
+    std::copy(history.begin(), history.end(), m_input.begin());
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        m_input[kHistorySize + i] = pIn[i * mixxx::kEngineChannelOutputCount + channel];
+    }
+
+    CSAMPLE peak = CSAMPLE_ZERO;
+    for (int phase = 0; phase < kPhases; ++phase) {
+        std::fill(m_output.begin(), m_output.begin() + numFrames, CSAMPLE_ZERO);
+        // Looping over the taps first allows to vectorize the inner loop
+        for (int tap = 0; tap < kTapsPerPhase; ++tap) {
+            const CSAMPLE coefficient = kCoefficients[phase][tap];
+            const CSAMPLE* pTapInput = m_input.data() + kHistorySize - tap;
+            // note: LOOP VECTORIZED.
+            for (SINT i = 0; i < numFrames; ++i) {
+                m_output[i] += coefficient * pTapInput[i];
+            }
+        }
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numFrames; ++i) {
+            const CSAMPLE absOutput = std::fabs(m_output[i]);
+            peak = absOutput > peak ? absOutput : peak;
+        }
+    }
+
+    std::copy(m_input.begin() + numFrames,
+            m_input.begin() + numFrames + kHistorySize,
+            history.begin());
+    return peak;
+}
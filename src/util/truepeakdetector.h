@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+
+#include "engine/engine.h"
+#include "util/types.h"
+
+/// Estimates the true peak of a stereo signal, i.e. the peak of the
+/// reconstructed signal between the samples, which can exceed the sample
+/// peak and clip after D/A conversion or lossy encoding. The signal is
+/// oversampled 4 times with the interpolation filter from ITU-R BS.1770-4,
+/// Annex 2.
+///
+/// The detector keeps the last samples of the previous buffer, so a
+/// single instance must be used for one continuous signal.
+class TruePeakDetector final {
+  public:
+    TruePeakDetector();
+
+    void reset();
+
+    /// Stores the largest absolute value of the oversampled signal of
+    /// each channel of the interleaved stereo buffer pIn.
+    void process(CSAMPLE* pfPeakL,
+            CSAMPLE* pfPeakR,
+            const CSAMPLE* pIn,
+            SINT numSamples);
+
+    static constexpr int kTapsPerPhase = 12;
+    static constexpr int kPhases = 4;
+
+  private:
+    static constexpr SINT kChunkFrames = 256;
+
+    CSAMPLE processChannel(int channel, const CSAMPLE* pIn, SINT numFrames);
+
+    // The last kTapsPerPhase - 1 samples of each channel
+    std::array<std::array<CSAMPLE, kTapsPerPhase - 1>,
+            mixxx::kEngineChannelOutputCount>
+            m_history;
+    // One chunk of a single channel, preceded by its history
+    std::array<CSAMPLE, kChunkFrames + kTapsPerPhase - 1> m_input;
+    std::array<CSAMPLE, kChunkFrames> m_output;
+};
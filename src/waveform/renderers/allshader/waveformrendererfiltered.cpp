@@ -50,10 +50,6 @@ bool WaveformRendererFiltered::preprocessInner() {
         return false;
     }
 
-    const WaveformData* data = waveform->data();
-    if (data == nullptr) {
-        return false;
-    }
 #ifdef __STEM__
     auto stemInfo = pTrack->getStemInfo();
     // If this track is a stem track, skip the rendering
@@ -68,8 +64,17 @@ bool WaveformRendererFiltered::preprocessInner() {
     const float invDevicePixelRatio = 1.f / devicePixelRatio;
     const float halfPixelSize = 0.5f / devicePixelRatio;
 
+    // Read from the coarsest level of the mip-map pyramid that still
+    // provides at least one visual frame per pixel
+    const int level = waveform->getLevelForVisualFramesPerPixel(
+            (m_waveformRenderer->getLastDisplayedPosition() -
+                    m_waveformRenderer->getFirstDisplayedPosition()) *
+            (dataSize / 2) / pixelLength);
+    const int levelDataSize = waveform->getLevelDataSize(level);
+
     // See waveformrenderersimple.cpp for a detailed explanation of the frame and index calculation
-    const int visualFramesSize = dataSize / 2;
+    const double visualFramesSize =
+            static_cast<double>(dataSize / 2) / Waveform::getLevelReduction(level);
     const double firstVisualFrame =
             m_waveformRenderer->getFirstDisplayedPosition() * visualFramesSize;
     const double lastVisualFrame =
@@ -78,6 +83,10 @@ bool WaveformRendererFiltered::preprocessInner() {
     // Represents the # of visual frames per horizontal pixel.
     const double visualIncrementPerPixel =
             (lastVisualFrame - firstVisualFrame) / static_cast<double>(pixelLength);
+    // Only the blocks of the visible range are decoded
+    const WaveformData* levelData = waveform->getLevelData(level,
+            static_cast<int>(firstVisualFrame - visualIncrementPerPixel) * 2,
+            (static_cast<int>(lastVisualFrame + visualIncrementPerPixel) + 2) * 2);
 
     // Per-band gain from the EQ knobs.
     float allGain(1.0);
@@ -149,7 +158,7 @@ bool WaveformRendererFiltered::preprocessInner() {
 
         const int visualIndexStart = std::max(visualFrameStart * 2, 0);
         const int visualIndexStop =
-                std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2, dataSize - 1);
+                std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2, levelDataSize - 1);
 
         const float fpos = static_cast<float>(pos) * invDevicePixelRatio;
 
@@ -158,7 +167,7 @@ bool WaveformRendererFiltered::preprocessInner() {
         uchar u8max[3][2]{};
         for (int chn = 0; chn < 2; chn++) {
             for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                const WaveformData& waveformData = data[i];
+                const WaveformData& waveformData = levelData[i];
 
                 u8max[0][chn] = math_max(u8max[0][chn], waveformData.filtered.low);
                 u8max[1][chn] = math_max(u8max[1][chn], waveformData.filtered.mid);
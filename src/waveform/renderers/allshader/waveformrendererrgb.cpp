@@ -60,10 +60,6 @@ bool WaveformRendererRGB::preprocessInner() {
         return false;
     }
 
-    const WaveformData* data = waveform->data();
-    if (data == nullptr) {
-        return false;
-    }
 #ifdef __STEM__
     auto stemInfo = pTrack->getStemInfo();
     // If this track is a stem track, skip the rendering
@@ -78,8 +74,17 @@ bool WaveformRendererRGB::preprocessInner() {
     const float invDevicePixelRatio = 1.f / devicePixelRatio;
     const float halfPixelSize = 0.5f / devicePixelRatio;
 
+    // Read from the coarsest level of the mip-map pyramid that still
+    // provides at least one visual frame per pixel
+    const int level = waveform->getLevelForVisualFramesPerPixel(
+            (m_waveformRenderer->getLastDisplayedPosition(positionType) -
+                    m_waveformRenderer->getFirstDisplayedPosition(positionType)) *
+            (dataSize / 2) / pixelLength);
+    const int levelDataSize = waveform->getLevelDataSize(level);
+
     // See waveformrenderersimple.cpp for a detailed explanation of the frame and index calculation
-    const int visualFramesSize = dataSize / 2;
+    const double visualFramesSize =
+            static_cast<double>(dataSize / 2) / Waveform::getLevelReduction(level);
     const double firstVisualFrame =
             m_waveformRenderer->getFirstDisplayedPosition(positionType) * visualFramesSize;
     const double lastVisualFrame =
@@ -88,6 +93,10 @@ bool WaveformRendererRGB::preprocessInner() {
     // Represents the # of visual frames per horizontal pixel.
     const double visualIncrementPerPixel =
             (lastVisualFrame - firstVisualFrame) / static_cast<double>(pixelLength);
+    // Only the blocks of the visible range are decoded
+    const WaveformData* levelData = waveform->getLevelData(level,
+            static_cast<int>(firstVisualFrame - visualIncrementPerPixel) * 2,
+            (static_cast<int>(lastVisualFrame + visualIncrementPerPixel) + 2) * 2);
 
     // Per-band gain from the EQ knobs.
     float allGain(1.0), lowGain(1.0), midGain(1.0), highGain(1.0);
@@ -142,7 +151,7 @@ bool WaveformRendererRGB::preprocessInner() {
 
         const int visualIndexStart = std::max(visualFrameStart * 2, 0);
         const int visualIndexStop =
-                std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2, dataSize - 1);
+                std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2, levelDataSize - 1);
 
         const float fpos = static_cast<float>(pos) * invDevicePixelRatio;
 
@@ -159,7 +168,7 @@ bool WaveformRendererRGB::preprocessInner() {
             int signalChn = splitLeftRight ? chn : 0;
             // data is interleaved left / right
             for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                const WaveformData& waveformData = data[i];
+                const WaveformData& waveformData = levelData[i];
 
                 u8maxLow[signalChn] = math_max(u8maxLow[signalChn], waveformData.filtered.low);
                 u8maxMid[signalChn] = math_max(u8maxMid[signalChn], waveformData.filtered.mid);
@@ -47,10 +47,6 @@ bool WaveformRendererSimple::preprocessInner() {
         return false;
     }
 
-    const WaveformData* data = waveform->data();
-    if (data == nullptr) {
-        return false;
-    }
 #ifdef __STEM__
     auto stemInfo = pTrack->getStemInfo();
     // If this track is a stem track, skip the rendering
@@ -65,11 +61,20 @@ bool WaveformRendererSimple::preprocessInner() {
     const float invDevicePixelRatio = 1.f / devicePixelRatio;
     const float halfPixelSize = 0.5f / devicePixelRatio;
 
+    // Read from the coarsest level of the mip-map pyramid that still
+    // provides at least one visual frame per pixel
+    const int level = waveform->getLevelForVisualFramesPerPixel(
+            (m_waveformRenderer->getLastDisplayedPosition() -
+                    m_waveformRenderer->getFirstDisplayedPosition()) *
+            (dataSize / 2) / pixelLength);
+    const int levelDataSize = waveform->getLevelDataSize(level);
+
     // Note that waveform refers to the visual waveform, not to audio samples.
     //
     // WaveformData* data contains the L and R waveform values interleaved. In the calculations
     // below, 'frame' refers to the index of such an L-R pair.
-    const int visualFramesSize = dataSize / 2;
+    const double visualFramesSize =
+            static_cast<double>(dataSize / 2) / Waveform::getLevelReduction(level);
     // Calculate the first and last frame to draw, from the normalized display position
     const double firstVisualFrame =
             m_waveformRenderer->getFirstDisplayedPosition() * visualFramesSize;
@@ -79,6 +84,10 @@ bool WaveformRendererSimple::preprocessInner() {
     // Represents the # of visual frames per horizontal pixel.
     const double visualIncrementPerPixel =
             (lastVisualFrame - firstVisualFrame) / static_cast<double>(pixelLength);
+    // Only the blocks of the visible range are decoded
+    const WaveformData* levelData = waveform->getLevelData(level,
+            static_cast<int>(firstVisualFrame - visualIncrementPerPixel) * 2,
+            (static_cast<int>(lastVisualFrame + visualIncrementPerPixel) + 2) * 2);
 
     // Per-band gain from the EQ knobs.
     float allGain{1.0};
@@ -122,7 +131,7 @@ bool WaveformRendererSimple::preprocessInner() {
 
         const int visualIndexStart = std::max(visualFrameStart * 2, 0);
         const int visualIndexStop =
-                std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2, dataSize - 1);
+                std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2, levelDataSize - 1);
 
         const float fpos = static_cast<float>(pos) * invDevicePixelRatio;
 
@@ -131,7 +140,7 @@ bool WaveformRendererSimple::preprocessInner() {
         for (int chn = 0; chn < 2; chn++) {
             // data is interleaved left / right
             for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                const WaveformData& waveformData = data[i];
+                const WaveformData& waveformData = levelData[i];
 
                 u8maxAllChn[chn] = math_max(u8maxAllChn[chn], waveformData.filtered.all);
             }
@@ -130,10 +130,6 @@ bool WaveformRendererStem::preprocessInner() {
         return false;
     }
 
-    const WaveformData* data = waveform->data();
-    if (data == nullptr) {
-        return false;
-    }
     // If this waveform doesn't contain stem data, skip the rendering
     if (!waveform->hasStem()) {
         return false;
@@ -148,8 +144,17 @@ bool WaveformRendererStem::preprocessInner() {
     const float invDevicePixelRatio = kPixelPerStrip / devicePixelRatio;
     const float halfStripSize = kPixelPerStrip / 2.0f / devicePixelRatio;
 
+    // Read from the coarsest level of the mip-map pyramid that still
+    // provides at least one visual frame per pixel
+    const int level = waveform->getLevelForVisualFramesPerPixel(
+            (m_waveformRenderer->getLastDisplayedPosition(positionType) -
+                    m_waveformRenderer->getFirstDisplayedPosition(positionType)) *
+            (dataSize / 2) / stripLength);
+    const int levelDataSize = waveform->getLevelDataSize(level);
+
     // See waveformrenderersimple.cpp for a detailed explanation of the frame and index calculation
-    const int visualFramesSize = dataSize / 2;
+    const double visualFramesSize =
+            static_cast<double>(dataSize / 2) / Waveform::getLevelReduction(level);
     const double firstVisualFrame =
             m_waveformRenderer->getFirstDisplayedPosition(positionType) * visualFramesSize;
     const double lastVisualFrame =
@@ -158,6 +163,10 @@ bool WaveformRendererStem::preprocessInner() {
     // Represents the # of visual frames per horizontal pixel.
     const double visualIncrementPerPixel =
             (lastVisualFrame - firstVisualFrame) / static_cast<double>(stripLength);
+    // Only the blocks of the visible range are decoded
+    const WaveformData* levelData = waveform->getLevelData(level,
+            static_cast<int>(firstVisualFrame - visualIncrementPerPixel) * 2,
+            (static_cast<int>(lastVisualFrame + visualIncrementPerPixel) + 2) * 2);
 
     // Per-band gain from the EQ knobs.
     float allGain(1.0);
@@ -208,7 +217,7 @@ bool WaveformRendererStem::preprocessInner() {
 
                 const int visualIndexStart = std::max(visualFrameStart * 2, 0);
                 const int visualIndexStop =
-                        std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2, dataSize - 1);
+                        std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2, levelDataSize - 1);
 
                 const float fVisualIdx = static_cast<float>(visualIdx) * invDevicePixelRatio;
 
@@ -218,7 +227,7 @@ bool WaveformRendererStem::preprocessInner() {
                 for (int chn = 0; chn < 2; chn++) {
                     // data is interleaved left / right
                     for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                        const WaveformData& waveformData = data[i];
+                        const WaveformData& waveformData = levelData[i];
 
                         u8max = math_max(u8max, waveformData.stems[stemIdx]);
                     }
@@ -1,13 +1,206 @@
 #include "waveform/waveform.h"
 
+#include <QFile>
 #include <QtDebug>
+#include <QtEndian>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <utility>
 
 #include "analyzer/constants.h"
 #include "engine/engine.h"
 #include "proto/waveform.pb.h"
+#include "util/math.h"
 
 using namespace mixxx::track;
 
+namespace {
+
+// Scanning fewer visual frames is cheap enough without another level
+constexpr int kMinLevelVisualFrames = 256;
+
+// The size of the next level including the last, incomplete pair of
+// visual frames
+int reducedDataSize(int dataSize) {
+    return (dataSize / 2 + 1) / 2 * 2;
+}
+
+void reduceLevel(
+        std::vector<WaveformData>* pLevel,
+        const WaveformData* pData,
+        int dataSize,
+        int stemCount) {
+    const int visualFrames = dataSize / 2;
+    pLevel->assign(reducedDataSize(dataSize), {});
+    for (int frame = 0; frame < static_cast<int>(pLevel->size()) / 2; ++frame) {
+        const int first = frame * 2;
+        const int second = math_min(first + 1, visualFrames - 1);
+        for (int chn = 0; chn < ChannelCount; ++chn) {
+            const WaveformData& a = pData[first * 2 + chn];
+            const WaveformData& b = pData[second * 2 + chn];
+            WaveformData& reduced = (*pLevel)[frame * 2 + chn];
+            reduced.filtered.low = math_max(a.filtered.low, b.filtered.low);
+            reduced.filtered.mid = math_max(a.filtered.mid, b.filtered.mid);
+            reduced.filtered.high = math_max(a.filtered.high, b.filtered.high);
+            reduced.filtered.all = math_max(a.filtered.all, b.filtered.all);
+            for (int stemIdx = 0; stemIdx < stemCount; ++stemIdx) {
+                reduced.stems[stemIdx] = math_max(a.stems[stemIdx], b.stems[stemIdx]);
+            }
+        }
+    }
+}
+
+// All levels with fewer visual frames are scanned directly
+std::vector<std::vector<WaveformData>> reduceLevels(
+        const WaveformData* pData,
+        int dataSize,
+        int stemCount) {
+    std::vector<std::vector<WaveformData>> levels;
+    for (int levelDataSize = reducedDataSize(dataSize);
+            levelDataSize / 2 >= kMinLevelVisualFrames;
+            levelDataSize = reducedDataSize(levelDataSize)) {
+        // Moving the previous levels keeps their data in place
+        std::vector<WaveformData>& level = levels.emplace_back();
+        reduceLevel(&level, pData, dataSize, stemCount);
+        pData = level.data();
+        dataSize = static_cast<int>(level.size());
+    }
+    return levels;
+}
+
+// The flat layout of version 3 starts with FlatHeader, followed by one
+// FlatLevel for each level of the mip-map pyramid including level 0, one
+// FlatBlock for each block of all levels and the data of all blocks.
+// Each level is split into blocks of blockSize elements that are
+// compressed independently, so they can be decoded on first access
+// instead of when loading the waveform. A block stores one plane per band
+// and stem. The values of each plane are delta-encoded between subsequent
+// visual frames of the same channel before they are compressed with
+// qCompress(). The tables are covered by tableChecksum, each block by its
+// own checksum. All numbers are little-endian.
+constexpr char kFlatMagic[8] = {'M', 'i', 'x', 'x', 'x', 'W', 'F', '\0'};
+constexpr quint32 kFlatVersion = 3;
+
+// 4096 visual frames, i.e. about 9 seconds of audio at the default visual
+// sample rate. Must be a multiple of ChannelCount.
+constexpr int kFlatBlockSize = 8192;
+constexpr quint32 kMaxFlatBlockSize = 1 << 20;
+// Keeps the size of the padded texture within the range of int
+constexpr quint32 kMaxFlatDataSize = 1 << 28;
+constexpr quint32 kMaxFlatLevelCount = 32;
+
+struct FlatHeader {
+    char magic[8];
+    quint32 version;
+    quint32 stemCount;
+    quint32 levelCount;
+    quint32 blockSize;
+    quint64 visualSampleRate;
+    quint64 audioVisualRatio;
+    // qChecksum() of the level and block tables
+    quint32 tableChecksum;
+    quint32 reserved;
+};
+static_assert(sizeof(FlatHeader) == 48);
+
+struct FlatLevel {
+    quint32 dataSize;
+    quint32 firstBlock;
+};
+static_assert(sizeof(FlatLevel) == 8);
+
+struct FlatBlock {
+    quint64 offset;
+    quint32 size;
+    // qChecksum() of the stored, compressed data
+    quint32 checksum;
+};
+static_assert(sizeof(FlatBlock) == 16);
+
+constexpr int kFilteredOffset = offsetof(WaveformData, filtered);
+constexpr int kFilteredPlaneCount = sizeof(WaveformFilteredData);
+constexpr int kStemsOffset = offsetof(WaveformData, stems);
+
+quint32 flatChecksum(const char* pData, int size) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return qChecksum(QByteArrayView(pData, size));
+#else
+    return qChecksum(pData, static_cast<uint>(size));
+#endif
+}
+
+// The filtered bands are followed by the stems
+int planeByteOffset(int plane) {
+    return plane < kFilteredPlaneCount
+            ? kFilteredOffset + plane
+            : kStemsOffset + plane - kFilteredPlaneCount;
+}
+
+QByteArray encodeBlock(
+        const WaveformData* pData,
+        int dataSize,
+        int stemCount) {
+    const int planeCount = kFilteredPlaneCount + stemCount;
+    const auto* pIn = reinterpret_cast<const unsigned char*>(pData);
+    QByteArray planes(planeCount * dataSize, '\0');
+    auto* pOut = reinterpret_cast<unsigned char*>(planes.data());
+    for (int plane = 0; plane < planeCount; ++plane) {
+        const unsigned char* pValues = pIn + planeByteOffset(plane);
+        unsigned char* pPlane = pOut + plane * dataSize;
+        for (int i = 0; i < dataSize; ++i) {
+            const unsigned char previous = i >= ChannelCount
+                    ? pValues[(i - ChannelCount) * sizeof(WaveformData)]
+                    : 0;
+            pPlane[i] = static_cast<unsigned char>(
+                    pValues[i * sizeof(WaveformData)] - previous);
+        }
+    }
+    return qCompress(planes);
+}
+
+bool decodeBlock(
+        const QByteArray& block,
+        WaveformData* pData,
+        int dataSize,
+        int stemCount) {
+    const int planeCount = kFilteredPlaneCount + stemCount;
+    const QByteArray planes = qUncompress(block);
+    if (planes.size() != planeCount * dataSize) {
+        return false;
+    }
+    const auto* pIn = reinterpret_cast<const unsigned char*>(planes.constData());
+    auto* pOut = reinterpret_cast<unsigned char*>(pData);
+    for (int plane = 0; plane < planeCount; ++plane) {
+        const unsigned char* pPlane = pIn + plane * dataSize;
+        unsigned char* pValues = pOut + planeByteOffset(plane);
+        for (int i = 0; i < dataSize; ++i) {
+            const unsigned char previous = i >= ChannelCount
+                    ? pValues[(i - ChannelCount) * sizeof(WaveformData)]
+                    : 0;
+            pValues[i * sizeof(WaveformData)] =
+                    static_cast<unsigned char>(pPlane[i] + previous);
+        }
+    }
+    return true;
+}
+
+quint64 doubleToLittleEndian(double value) {
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return qToLittleEndian(bits);
+}
+
+double doubleFromLittleEndian(quint64 littleEndian) {
+    const quint64 bits = qFromLittleEndian(littleEndian);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // anonymous namespace
+
 // Return the smallest power of 2 which is greater than the desired size when
 // squared.
 int computeTextureStride(int size) {
@@ -18,14 +211,22 @@ int computeTextureStride(int size) {
     return stride;
 }
 
+void Waveform::FreeDeleter::operator()(WaveformData* pData) const {
+    std::free(pData);
+}
+
 Waveform::Waveform(const QByteArray& data)
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
           m_dataSize(0),
+          m_pData(nullptr),
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(computeTextureStride(0)),
-          m_completion(-1) {
+          m_completion(-1),
+          m_stemCount(0),
+          m_levelCount(0),
+          m_flatBlockSize(0) {
     readByteArray(data);
 }
 
@@ -38,11 +239,14 @@ Waveform::Waveform(
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
           m_dataSize(0),
+          m_pData(nullptr),
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(1024),
           m_completion(-1),
-          m_stemCount(stemCount) {
+          m_stemCount(stemCount),
+          m_levelCount(0),
+          m_flatBlockSize(0) {
     int numberOfVisualSamples = 0;
     if (audioSampleRate > 0) {
         if (maxVisualSamples == -1) {
@@ -76,6 +280,248 @@ Waveform::Waveform(
 Waveform::~Waveform() {
 }
 
+// static
+Waveform* Waveform::mapFlatFile(const QString& fileName) {
+    Waveform* pWaveform = new Waveform();
+    auto pFile = std::make_unique<QFile>(fileName);
+    if (!pFile->open(QIODevice::ReadOnly) ||
+            pFile->size() > std::numeric_limits<int>::max()) {
+        qDebug() << "ERROR: Could not open waveform file" << fileName;
+        return pWaveform;
+    }
+    // The mapping is released when the file is closed
+    const uchar* pMapped = pFile->map(0, pFile->size());
+    if (!pMapped) {
+        qDebug() << "ERROR: Could not map waveform from file" << fileName;
+        return pWaveform;
+    }
+    pWaveform->m_flatData = QByteArray::fromRawData(
+            reinterpret_cast<const char*>(pMapped), static_cast<int>(pFile->size()));
+    if (!pWaveform->readFlatData()) {
+        qDebug() << "ERROR: Could not read waveform from file" << fileName;
+        pWaveform->resetFlatData();
+        return pWaveform;
+    }
+    pWaveform->m_pFlatFile = std::move(pFile);
+    pWaveform->m_saveState = SaveState::Saved;
+    return pWaveform;
+}
+
+void Waveform::resetFlatData() {
+    m_flatData.clear();
+    m_flatBlocks.clear();
+    m_firstFlatBlocks.clear();
+    m_flatBlocksDecoded.reset();
+    m_flatDecoded.reset();
+    m_levelData.clear();
+    m_levelCount = 0;
+    m_stemCount = 0;
+    resize(0);
+    m_saveState = SaveState::NotSaved;
+}
+
+bool Waveform::readFlatData() {
+    const char* pFlat = m_flatData.constData();
+    const quint64 flatSize = m_flatData.size();
+    if (flatSize < sizeof(FlatHeader)) {
+        return false;
+    }
+    FlatHeader header;
+    std::memcpy(&header, pFlat, sizeof(header));
+    const quint32 stemCount = qFromLittleEndian(header.stemCount);
+    const quint32 levelCount = qFromLittleEndian(header.levelCount);
+    const quint32 blockSize = qFromLittleEndian(header.blockSize);
+    if (std::memcmp(header.magic, kFlatMagic, sizeof(kFlatMagic)) != 0 ||
+            qFromLittleEndian(header.version) != kFlatVersion ||
+            stemCount > mixxx::kMaxSupportedStems ||
+            levelCount < 1 ||
+            levelCount > kMaxFlatLevelCount ||
+            blockSize == 0 ||
+            blockSize > kMaxFlatBlockSize ||
+            blockSize % ChannelCount != 0 ||
+            sizeof(FlatHeader) + levelCount * sizeof(FlatLevel) > flatSize) {
+        qDebug() << "ERROR: Unsupported or corrupt waveform header";
+        return false;
+    }
+
+    std::vector<int> levelDataSizes;
+    std::vector<int> firstBlocks;
+    quint64 blockCount = 0;
+    for (quint32 levelIdx = 0; levelIdx < levelCount; ++levelIdx) {
+        FlatLevel level;
+        std::memcpy(&level,
+                pFlat + sizeof(FlatHeader) + levelIdx * sizeof(FlatLevel),
+                sizeof(level));
+        const quint32 dataSize = qFromLittleEndian(level.dataSize);
+        const quint32 expectedDataSize = levelIdx == 0
+                ? dataSize
+                : static_cast<quint32>(reducedDataSize(levelDataSizes.back()));
+        if (dataSize != expectedDataSize ||
+                dataSize > kMaxFlatDataSize ||
+                qFromLittleEndian(level.firstBlock) != blockCount) {
+            qDebug() << "ERROR: Corrupt waveform level" << levelIdx;
+            return false;
+        }
+        levelDataSizes.push_back(static_cast<int>(dataSize));
+        firstBlocks.push_back(static_cast<int>(blockCount));
+        blockCount += (dataSize + blockSize - 1) / blockSize;
+    }
+    const quint64 tablesSize = levelCount * sizeof(FlatLevel) + blockCount * sizeof(FlatBlock);
+    if (sizeof(FlatHeader) + tablesSize > flatSize ||
+            flatChecksum(pFlat + sizeof(FlatHeader), static_cast<int>(tablesSize)) !=
+                    qFromLittleEndian(header.tableChecksum)) {
+        qDebug() << "ERROR: Corrupt waveform block table";
+        return false;
+    }
+
+    // The blocks are decoded into a buffer that is padded for the texture
+    // renderers like m_data. calloc() does not touch the pages of blocks
+    // that are never decoded on most platforms.
+    const int textureStride = computeTextureStride(levelDataSizes[0]);
+    std::size_t decodedSize = static_cast<std::size_t>(textureStride) * textureStride;
+    for (quint32 levelIdx = 1; levelIdx < levelCount; ++levelIdx) {
+        decodedSize += levelDataSizes[levelIdx];
+    }
+    m_flatDecoded.reset(static_cast<WaveformData*>(
+            std::calloc(decodedSize, sizeof(WaveformData))));
+    if (!m_flatDecoded) {
+        qDebug() << "ERROR: Could not allocate" << decodedSize << "waveform elements";
+        return false;
+    }
+
+    const int flatBlockSize = static_cast<int>(blockSize);
+    std::vector<EncodedBlock> blocks;
+    blocks.reserve(blockCount);
+    std::vector<LevelData> levelData;
+    WaveformData* pDecoded = m_flatDecoded.get();
+    for (quint32 levelIdx = 0; levelIdx < levelCount; ++levelIdx) {
+        const int dataSize = levelDataSizes[levelIdx];
+        if (levelIdx > 0) {
+            levelData.push_back(LevelData{pDecoded, dataSize});
+        }
+        for (int first = 0; first < dataSize; first += flatBlockSize) {
+            FlatBlock block;
+            std::memcpy(&block,
+                    pFlat + sizeof(FlatHeader) + levelCount * sizeof(FlatLevel) +
+                            blocks.size() * sizeof(FlatBlock),
+                    sizeof(block));
+            const quint64 offset = qFromLittleEndian(block.offset);
+            const quint32 size = qFromLittleEndian(block.size);
+            if (offset > flatSize || size > flatSize - offset) {
+                qDebug() << "ERROR: Corrupt waveform block" << blocks.size();
+                return false;
+            }
+            blocks.push_back(EncodedBlock{pFlat + offset,
+                    static_cast<int>(size),
+                    qFromLittleEndian(block.checksum),
+                    pDecoded + first,
+                    math_min(flatBlockSize, dataSize - first)});
+        }
+        pDecoded += levelIdx == 0 ? textureStride * textureStride : dataSize;
+    }
+
+    m_stemCount = static_cast<int>(stemCount);
+    m_dataSize = levelDataSizes[0];
+    m_textureStride = textureStride;
+    m_pData = m_flatDecoded.get();
+    m_visualSampleRate = doubleFromLittleEndian(header.visualSampleRate);
+    m_audioVisualRatio = doubleFromLittleEndian(header.audioVisualRatio);
+    m_flatBlocks = std::move(blocks);
+    m_firstFlatBlocks = std::move(firstBlocks);
+    m_flatBlockSize = flatBlockSize;
+    m_flatBlocksDecoded = std::make_unique<QAtomicInt[]>(m_flatBlocks.size());
+    m_levelData = std::move(levelData);
+    m_levelCount = static_cast<int>(m_levelData.size());
+    m_completion = m_dataSize;
+    return true;
+}
+
+void Waveform::decodeFlatBlock(int blockIdx) const {
+    const auto locker = lockMutex(&m_flatMutex);
+    if (m_flatBlocksDecoded[blockIdx].loadAcquire()) {
+        // Decoded by another thread in the meantime
+        return;
+    }
+    const EncodedBlock& block = m_flatBlocks[blockIdx];
+    if (flatChecksum(block.pData, block.size) != block.checksum ||
+            !decodeBlock(QByteArray::fromRawData(block.pData, block.size),
+                    block.pDecoded,
+                    block.decodedSize,
+                    m_stemCount)) {
+        // Shown as silence instead of failing on every access
+        qDebug() << "WARNING: Corrupt waveform block" << blockIdx;
+        std::memset(block.pDecoded, 0, block.decodedSize * sizeof(WaveformData));
+    }
+    m_flatBlocksDecoded[blockIdx].storeRelease(1);
+}
+
+// static
+bool Waveform::isFlatByteArray(const QByteArray& data) {
+    return data.startsWith(QByteArray::fromRawData(kFlatMagic, sizeof(kFlatMagic)));
+}
+
+QByteArray Waveform::toFlatByteArray() const {
+    if (!m_flatData.isNull()) {
+        // Deep copy, the data might be mapped
+        return QByteArray(m_flatData.constData(), m_flatData.size());
+    }
+
+    // All levels are stored, so they don't need to be rebuilt after loading
+    std::vector<LevelData> levels{LevelData{m_pData, m_dataSize}};
+    std::vector<std::vector<WaveformData>> reducedLevels;
+    if (getLevelCount() > 1) {
+        levels.insert(levels.end(), m_levelData.begin(), m_levelData.end());
+    } else {
+        reducedLevels = reduceLevels(m_pData, m_dataSize, m_stemCount);
+        for (const auto& level : reducedLevels) {
+            levels.push_back(LevelData{level.data(), static_cast<int>(level.size())});
+        }
+    }
+
+    QByteArray tables;
+    std::vector<QByteArray> blocks;
+    for (const auto& level : levels) {
+        const FlatLevel flatLevel{
+                qToLittleEndian(static_cast<quint32>(level.dataSize)),
+                qToLittleEndian(static_cast<quint32>(blocks.size()))};
+        tables.append(reinterpret_cast<const char*>(&flatLevel), sizeof(flatLevel));
+        for (int first = 0; first < level.dataSize; first += kFlatBlockSize) {
+            blocks.push_back(encodeBlock(level.pData + first,
+                    math_min(kFlatBlockSize, level.dataSize - first),
+                    m_stemCount));
+        }
+    }
+    quint64 offset = sizeof(FlatHeader) + tables.size() + blocks.size() * sizeof(FlatBlock);
+    for (const auto& block : blocks) {
+        const FlatBlock flatBlock{
+                qToLittleEndian(offset),
+                qToLittleEndian(static_cast<quint32>(block.size())),
+                qToLittleEndian(flatChecksum(block.constData(), block.size()))};
+        tables.append(reinterpret_cast<const char*>(&flatBlock), sizeof(flatBlock));
+        offset += block.size();
+    }
+
+    FlatHeader header;
+    std::memcpy(header.magic, kFlatMagic, sizeof(kFlatMagic));
+    header.version = qToLittleEndian(kFlatVersion);
+    header.stemCount = qToLittleEndian(static_cast<quint32>(m_stemCount));
+    header.levelCount = qToLittleEndian(static_cast<quint32>(levels.size()));
+    header.blockSize = qToLittleEndian(static_cast<quint32>(kFlatBlockSize));
+    header.visualSampleRate = doubleToLittleEndian(m_visualSampleRate);
+    header.audioVisualRatio = doubleToLittleEndian(m_audioVisualRatio);
+    header.tableChecksum = qToLittleEndian(flatChecksum(tables.constData(), tables.size()));
+    header.reserved = 0;
+
+    QByteArray data;
+    data.reserve(static_cast<int>(offset));
+    data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    data.append(tables);
+    for (const auto& block : blocks) {
+        data.append(block);
+    }
+    return data;
+}
+
 QByteArray Waveform::toByteArray() const {
     io::Waveform waveform;
     waveform.set_visual_sample_rate(m_visualSampleRate);
@@ -120,8 +566,9 @@ QByteArray Waveform::toByteArray() const {
     high->set_channels(mixxx::kEngineChannelOutputCount);
 
     int dataSize = getDataSize();
+    const WaveformData* pData = getLevelData(0);
     for (int i = 0; i < dataSize; ++i) {
-        const WaveformData& datum = m_data.at(i);
+        const WaveformData& datum = pData[i];
         all->add_value(datum.filtered.all);
         low->add_value(datum.filtered.low);
         mid->add_value(datum.filtered.mid);
@@ -133,7 +580,7 @@ QByteArray Waveform::toByteArray() const {
         stem->set_units(io::Waveform::RMS);
         stem->set_channels(mixxx::kEngineChannelOutputCount);
         for (int i = 0; i < dataSize; ++i) {
-            const WaveformData& datum = m_data.at(i);
+            const WaveformData& datum = pData[i];
             stem->add_value(datum.stems[stemIdx]);
         }
         stemIdx++;
@@ -156,6 +603,18 @@ void Waveform::readByteArray(const QByteArray& data) {
         return;
     }
 
+    if (isFlatByteArray(data)) {
+        // Decoded lazily like a mapped file
+        m_flatData = data;
+        if (readFlatData()) {
+            m_saveState = SaveState::Saved;
+        } else {
+            qDebug() << "ERROR: Could not read flat waveform of size" << data.size();
+            resetFlatData();
+        }
+        return;
+    }
+
     io::Waveform waveform;
 
     if (!waveform.ParseFromArray(data.constData(), data.size())) {
@@ -238,16 +697,82 @@ void Waveform::readByteArray(const QByteArray& data) {
     m_saveState = SaveState::Saved;
 }
 
+const WaveformData* Waveform::getLevelData(int level, int first, int end) const {
+    const WaveformData* pData;
+    if (level == 0) {
+        pData = m_pData;
+    } else {
+        DEBUG_ASSERT(level > 0 && level < getLevelCount());
+        pData = m_levelData[level - 1].pData;
+    }
+    if (m_flatBlocks.empty()) {
+        return pData;
+    }
+    first = math_max(first, 0);
+    end = math_min(end, getLevelDataSize(level));
+    if (first >= end) {
+        return pData;
+    }
+    const int firstBlock = m_firstFlatBlocks[level];
+    for (int blockIdx = firstBlock + first / m_flatBlockSize;
+            blockIdx <= firstBlock + (end - 1) / m_flatBlockSize;
+            ++blockIdx) {
+        if (!m_flatBlocksDecoded[blockIdx].loadAcquire()) {
+            decodeFlatBlock(blockIdx);
+        }
+    }
+    return pData;
+}
+
+int Waveform::getLevelDataSize(int level) const {
+    if (level == 0) {
+        return getDataSize();
+    }
+    DEBUG_ASSERT(level > 0 && level < getLevelCount());
+    return m_levelData[level - 1].dataSize;
+}
+
+int Waveform::getLevelForVisualFramesPerPixel(double visualFramesPerPixel) const {
+    const int levelCount = getLevelCount();
+    int level = 0;
+    while (level + 1 < levelCount &&
+            getLevelReduction(level + 1) <= visualFramesPerPixel) {
+        ++level;
+    }
+    return level;
+}
+
+void Waveform::updateLevels() {
+    // The flat layout stores all levels
+    if (m_levelCount.loadAcquire() > 0 || !m_flatBlocks.empty()) {
+        return;
+    }
+    // Readers don't access m_levels until the count has been published
+    m_levels = reduceLevels(m_data.data(), m_dataSize, m_stemCount);
+    updateLevelData();
+    m_levelCount.storeRelease(static_cast<int>(m_levels.size()));
+}
+
+void Waveform::updateLevelData() {
+    m_levelData.clear();
+    m_levelData.reserve(m_levels.size());
+    for (const auto& level : m_levels) {
+        m_levelData.push_back(LevelData{level.data(), static_cast<int>(level.size())});
+    }
+}
+
 void Waveform::resize(int size) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.resize(m_textureStride * m_textureStride);
+    m_pData = m_data.data();
 }
 
 void Waveform::assign(int size) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.assign(m_textureStride * m_textureStride, {});
+    m_pData = m_data.data();
     m_saveState = SaveState::SavePending;
 }
 
@@ -255,6 +780,7 @@ void Waveform::dump() const {
     qDebug() << "Waveform" << this
              << "size(" + QString::number(getDataSize()) + ")"
              << "stems(" + QString::number(m_stemCount) + ")"
+             << "levels(" + QString::number(getLevelCount()) + ")"
              << "textureStride(" + QString::number(m_textureStride) + ")"
              << "completion(" + QString::number(getCompletion()) + ")"
              << "visualSampleRate(" + QString::number(m_visualSampleRate) + ")"
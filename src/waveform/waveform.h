@@ -5,13 +5,17 @@
 #include <QMutex>
 #include <QSharedPointer>
 #include <QString>
+#include <memory>
 #include <vector>
 
 #include "analyzer/constants.h"
 #include "audio/signalinfo.h"
+#include "util/assert.h"
 #include "util/class.h"
 #include "util/compatibility/qmutex.h"
 
+class QFile;
+
 enum BandIndex { AllBand = 0,
     Low = 1,
     Mid = 2,
@@ -49,6 +53,13 @@ class Waveform {
 
     virtual ~Waveform();
 
+    // Maps a waveform that has been stored by toFlatByteArray() into
+    // memory instead of loading it. Only the header and the tables are
+    // read, each block is paged in and decoded when it is accessed first.
+    // The compressed pages are shared with all other mappings of the same
+    // file. The waveform is empty if the file could not be mapped.
+    static Waveform* mapFlatFile(const QString& fileName);
+
     int getId() const {
         const auto locker = lockMutex(&m_mutex);
         return m_id;
@@ -81,6 +92,14 @@ class Waveform {
 
     QByteArray toByteArray() const;
 
+    // A versioned layout of the waveform data including all levels of the
+    // mip-map pyramid. The levels are split into blocks of a fixed size
+    // that are delta-encoded and compressed independently, so they can be
+    // decoded on demand, see mapFlatFile(). The constructor reads it the
+    // same way.
+    QByteArray toFlatByteArray() const;
+    static bool isFlatByteArray(const QByteArray& data);
+
     SaveState saveState() const {
         return m_saveState;
     }
@@ -110,40 +129,85 @@ class Waveform {
     // the constructor runs.
     inline int getTextureStride() const { return m_textureStride; }
 
-    // We do not lock the mutex since m_data is not resized after the
-    // constructor runs.
-    inline int getTextureSize() const { return static_cast<int>(m_data.size()); }
+    // We do not lock the mutex since m_textureStride is not changed after
+    // the constructor runs.
+    inline int getTextureSize() const { return m_textureStride * m_textureStride; }
 
     // Atomically get the number of data elements in this Waveform. We do not
     // lock the mutex since m_dataSize is not changed after the constructor
     // runs.
     inline int getDataSize() const { return m_dataSize; }
 
-    inline const WaveformData& get(int i) const { return m_data[i];}
-    inline unsigned char getLow(int i) const { return m_data[i].filtered.low;}
-    inline unsigned char getMid(int i) const { return m_data[i].filtered.mid;}
-    inline unsigned char getHigh(int i) const { return m_data[i].filtered.high;}
-    inline unsigned char getAll(int i) const { return m_data[i].filtered.all;}
+    // Decodes the block that contains the element if needed
+    inline const WaveformData& get(int i) const { return getLevelData(0, i, i + 1)[i];}
+    inline unsigned char getLow(int i) const { return get(i).filtered.low;}
+    inline unsigned char getMid(int i) const { return get(i).filtered.mid;}
+    inline unsigned char getHigh(int i) const { return get(i).filtered.high;}
+    inline unsigned char getAll(int i) const { return get(i).filtered.all;}
 
     // We do not lock the mutex since m_data is not resized after the
-    // constructor runs.
-    WaveformData* data() { return &m_data[0];}
+    // constructor runs. Waveforms read from the flat layout are read-only.
+    WaveformData* data() {
+        DEBUG_ASSERT(m_flatBlocks.empty());
+        return &m_data[0];
+    }
 
-    // We do not lock the mutex since m_data is not resized after the
-    // constructor runs.
-    const WaveformData* data() const { return &m_data[0];}
+    // Decodes all blocks of level 0 if needed. Renderers that only read
+    // the visible range use getLevelData() with a range instead.
+    const WaveformData* data() const { return getLevelData(0);}
 
     bool hasStem() const {
         return m_stemCount > 0;
     }
 
+    // The waveform data is complemented by a mip-map pyramid. Each level
+    // halves the number of visual frames of the previous level by taking
+    // the maximum of two adjacent visual frames for every band and stem.
+    // Level 0 is the waveform data itself. The reduced levels are only
+    // present after updateLevels() has been invoked or if the waveform has
+    // been read from the flat layout, which stores all of them. The
+    // protobuf layout of toByteArray() does not store them.
+    int getLevelCount() const {
+        return m_levelCount.loadAcquire() + 1;
+    }
+
+    // The number of visual frames in the waveform data per visual frame
+    // in the given level
+    static int getLevelReduction(int level) {
+        return 1 << level;
+    }
+
+    // Interleaved like the waveform data. The data of the reduced levels
+    // is not padded. If the waveform has been read from the flat layout,
+    // only the elements in [first, end) are valid. The blocks that contain
+    // them are decoded on first access.
+    const WaveformData* getLevelData(int level, int first, int end) const;
+    const WaveformData* getLevelData(int level) const {
+        return getLevelData(level, 0, getLevelDataSize(level));
+    }
+    int getLevelDataSize(int level) const;
+
+    // Selects the coarsest level that still provides at least one visual
+    // frame for every pixel, so renderers only need to read O(pixels)
+    // data at any zoom level.
+    int getLevelForVisualFramesPerPixel(double visualFramesPerPixel) const;
+
+    // Builds the reduced levels from the completed waveform data unless
+    // they are already present. Renderers may use them immediately.
+    void updateLevels();
+
     void dump() const;
 
   private:
     void readByteArray(const QByteArray& data);
+    bool readFlatData();
+    void resetFlatData();
+    void decodeFlatBlock(int blockIdx) const;
     void resize(int size);
     void assign(int size);
 
+    void updateLevelData();
+
     inline WaveformData& at(int i) { return m_data[i];}
     inline unsigned char& low(int i) { return m_data[i].filtered.low;}
     inline unsigned char& mid(int i) { return m_data[i].filtered.mid;}
@@ -169,6 +233,9 @@ class Waveform {
     // TODO(XXX): In the future we should switch to QVector and use the raw data
     // pointer when performance matters.
     std::vector<WaveformData> m_data;
+    // Points either to m_data or to the decoded data of a flat waveform.
+    // Not allowed to change after the constructor runs.
+    const WaveformData* m_pData;
     // Not allowed to change after the constructor runs.
     double m_visualSampleRate;
     // Not allowed to change after the constructor runs.
@@ -185,6 +252,42 @@ class Waveform {
     // The number of stem contained in waveform samples. 0 if not a stem waveform
     int m_stemCount;
 
+    // The reduced levels 1..n of the mip-map pyramid. Only modified before
+    // m_levelCount is published, so readers do not need to lock the mutex.
+    struct LevelData {
+        const WaveformData* pData;
+        int dataSize;
+    };
+    std::vector<std::vector<WaveformData>> m_levels;
+    std::vector<LevelData> m_levelData;
+    QAtomicInt m_levelCount;
+
+    // The compressed blocks of all levels if the waveform has been read
+    // from the flat layout, empty otherwise
+    struct EncodedBlock {
+        const char* pData;
+        int size;
+        quint32 checksum;
+        WaveformData* pDecoded;
+        int decodedSize;
+    };
+    struct FreeDeleter {
+        void operator()(WaveformData* pData) const;
+    };
+    // Either mapped from m_pFlatFile or owned
+    QByteArray m_flatData;
+    std::unique_ptr<QFile> m_pFlatFile;
+    std::vector<EncodedBlock> m_flatBlocks;
+    // The index of the first block of each level including level 0
+    std::vector<int> m_firstFlatBlocks;
+    int m_flatBlockSize;
+    // Set once the block has been decoded into m_flatDecoded
+    std::unique_ptr<QAtomicInt[]> m_flatBlocksDecoded;
+    // The decoded data of all levels, level 0 is padded like m_data
+    std::unique_ptr<WaveformData, FreeDeleter> m_flatDecoded;
+    // Serializes decoding, readers don't lock it for decoded blocks
+    mutable QMutex m_flatMutex;
+
     mutable QMutex m_mutex;
 
     DISALLOW_COPY_AND_ASSIGN(Waveform);
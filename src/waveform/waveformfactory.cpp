@@ -4,7 +4,9 @@
 // static
 Waveform* WaveformFactory::loadWaveformFromAnalysis(
         const AnalysisDao::AnalysisInfo& analysis) {
-    Waveform* pWaveform = new Waveform(analysis.data);
+    Waveform* pWaveform = analysis.mappableDataPath.isEmpty()
+            ? new Waveform(analysis.data)
+            : Waveform::mapFlatFile(analysis.mappableDataPath);
     pWaveform->setId(analysis.analysisId);
     pWaveform->setVersion(analysis.version);
     pWaveform->setDescription(analysis.description);
@@ -1339,18 +1339,10 @@ TrackPointer WTrackMenu::getFirstTrackPointer() const {
 }
 
 TrackPointerList WTrackMenu::getTrackPointers() const {
-    TrackPointerList tracks;
     if (m_pTrackModel) {
-        for (const auto& index : m_trackIndexList) {
-            const auto pTrack = m_pTrackModel->getTrack(index);
-            if (pTrack) {
-                tracks.append(pTrack);
-            }
-        }
-    } else {
-        tracks.append(m_pTrack);
+        return m_pTrackModel->getTracks(m_trackIndexList);
     }
-    return tracks;
+    return TrackPointerList{m_pTrack};
 }
 
 std::unique_ptr<mixxx::TrackPointerIterator> WTrackMenu::newTrackPointerIterator() const {
@@ -2721,11 +2713,7 @@ void WTrackMenu::slotShowDlgTrackInfo() {
                         m_trackProperty.clear();
                     }
                 });
-        QList<TrackPointer> tracks;
-        tracks.reserve(getTrackCount());
-        for (int i = 0; i < m_trackIndexList.size(); i++) {
-            tracks.append(m_pTrackModel->getTrack(m_trackIndexList.at(i)));
-        }
+        const TrackPointerList tracks = m_pTrackModel->getTracks(m_trackIndexList);
         m_pDlgTrackInfoMulti->loadTracks(tracks);
         m_pDlgTrackInfoMulti->show();
         m_pDlgTrackInfoMulti->focusField(m_trackProperty);
@@ -199,6 +199,9 @@ void WTrackTableView::loadTrackModel(QAbstractItemModel* model, bool restoreStat
 
     m_sorting = pTrackModel->hasCapabilities(TrackModel::Capability::Sorting);
 
+    // A pending search of the previous model must not restore its state
+    disconnect(m_searchFinishedConnection);
+
     // If the model has not changed there's no need to exchange the headers
     // which would cause a small GUI freeze
     if (getTrackModel() == pTrackModel) {
@@ -636,25 +639,41 @@ void WTrackTableView::onSearch(const QString& text) {
     QList<TrackId> selectedTracks = getSelectedTrackIds();
     TrackId prevTrack = getCurrentTrackId();
     saveCurrentIndex();
+    disconnect(m_searchFinishedConnection);
     pTrackModel->search(text);
-    if (queryIsLessSpecific) {
-        // If the user removed query terms, we try to select the same
-        // tracks as before
-        setCurrentTrackId(prevTrack, m_prevColumn);
-        setSelectedTracks(selectedTracks);
-    } else {
-        // The user created a more specific search query, try to restore a
-        // previous state
-        if (!restoreCurrentViewState()) {
-            // We found no saved state for this query, try to select the
-            // tracks last active, if they are part of the result set
-            if (!setCurrentTrackId(prevTrack, m_prevColumn)) {
-                // if the last focused track is not present try to focus the
-                // respective index and scroll there
-                restoreCurrentIndex();
-            }
+    const auto restoreViewState = [this, queryIsLessSpecific, selectedTracks, prevTrack]() {
+        if (queryIsLessSpecific) {
+            // If the user removed query terms, we try to select the same
+            // tracks as before
+            setCurrentTrackId(prevTrack, m_prevColumn);
             setSelectedTracks(selectedTracks);
+        } else {
+            // The user created a more specific search query, try to restore a
+            // previous state
+            if (!restoreCurrentViewState()) {
+                // We found no saved state for this query, try to select the
+                // tracks last active, if they are part of the result set
+                if (!setCurrentTrackId(prevTrack, m_prevColumn)) {
+                    // if the last focused track is not present try to focus the
+                    // respective index and scroll there
+                    restoreCurrentIndex();
+                }
+                setSelectedTracks(selectedTracks);
+            }
         }
+    };
+    // The results of the search might only be available later
+    auto* pSqlTableModel = qobject_cast<BaseSqlTableModel*>(model());
+    if (pSqlTableModel && pSqlTableModel->isSearchPending()) {
+        m_searchFinishedConnection = connect(pSqlTableModel,
+                &BaseSqlTableModel::searchFinished,
+                this,
+                [this, restoreViewState]() {
+                    disconnect(m_searchFinishedConnection);
+                    restoreViewState();
+                });
+    } else {
+        restoreViewState();
     }
 }
 
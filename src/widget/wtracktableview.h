@@ -196,6 +196,9 @@ class WTrackTableView : public WLibraryTableView {
     bool m_selectionChangedSinceLastGuiTick;
     bool m_loadCachedOnly;
 
+    // Restores the view state after an asynchronous search has finished
+    QMetaObject::Connection m_searchFinishedConnection;
+
     ControlProxy* m_pCOTGuiTick;
     ControlProxy* m_pKeyNotation;
     ControlProxy* m_pSortColumn;